@@ -0,0 +1,246 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file allocator.c
+ * \brief Pluggable memory allocator used by all modules of a protocol stack
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/allocator/allocator.h"
+
+/**
+ * \brief Number of bytes in front of each arena allocation storing its size
+ */
+#define ALLOCATOR_ARENA_HEADER_SIZE                                           \
+	((sizeof (size_t) + ALLOCATOR_ARENA_ALIGNMENT - 1)                          \
+			& ~(size_t)(ALLOCATOR_ARENA_ALIGNMENT - 1))
+
+/**
+ * \brief Allocates memory
+ *
+ * \param allocator Allocator to be used (NULL for system heap)
+ * \param size Number of bytes to be allocated
+ * \return void*   Allocated memory or   NULL in case of error
+ */
+void *
+allocator_malloc (const Allocator *allocator, size_t size)
+{
+	if (allocator == NULL)
+	{
+		return malloc (size);
+	}
+	return allocator->allocate (allocator->context, size);
+}
+
+/**
+ * \brief Resizes memory (semantics of `realloc()`)
+ *
+ * \param allocator Allocator that allocated   ptr (NULL for system heap)
+ * \param ptr Memory to be resized (might be   NULL)
+ * \param size New number of bytes
+ * \return void*   Resized memory or   NULL in case of error (  ptr stays
+ * valid)
+ */
+void *
+allocator_realloc (const Allocator *allocator, void *ptr, size_t size)
+{
+	if (allocator == NULL)
+	{
+		return realloc (ptr, size);
+	}
+	return allocator->reallocate (allocator->context, ptr, size);
+}
+
+/**
+ * \brief Releases memory
+ *
+ * \param allocator Allocator that allocated   ptr (NULL for system heap)
+ * \param ptr Memory to be released (might be   NULL)
+ */
+void
+allocator_free (const Allocator *allocator, void *ptr)
+{
+	if (ptr == NULL)
+	{
+		return;
+	}
+	if (allocator == NULL)
+	{
+		free (ptr);
+		return;
+	}
+	allocator->release (allocator->context, ptr);
+}
+
+/**
+ * \brief Releases all memory of allocator at once
+ *
+ * \param allocator Allocator to be reset (NULL for system heap)
+ */
+void
+allocator_reset (const Allocator *allocator)
+{
+	if ((allocator != NULL) && (allocator->reset != NULL))
+	{
+		allocator->reset (allocator->context);
+	}
+}
+
+/**
+ * \brief \ref allocator_allocatefunction_t for \ref AllocatorArena
+ */
+static void *
+allocator_arena_allocate (void *context, size_t size)
+{
+	AllocatorArena *arena = (AllocatorArena *)context;
+
+	/* Each allocation is preceded by its size (for reallocations) */
+	size_t aligned = (size + ALLOCATOR_ARENA_ALIGNMENT - 1)
+			& ~(size_t)(ALLOCATOR_ARENA_ALIGNMENT - 1);
+	if ((aligned < size) || ((arena->size - arena->used)
+			< (ALLOCATOR_ARENA_HEADER_SIZE + aligned)))
+	{
+		return NULL;
+	}
+	uint8_t *block = arena->buffer + arena->used;
+	memcpy (block, &size, sizeof (size_t));
+	arena->last = arena->used;
+	arena->used += ALLOCATOR_ARENA_HEADER_SIZE + aligned;
+	if (arena->used > arena->peak)
+	{
+		arena->peak = arena->used;
+	}
+	return block + ALLOCATOR_ARENA_HEADER_SIZE;
+}
+
+/**
+ * \brief \ref allocator_releasefunction_t for \ref AllocatorArena
+ */
+static void
+allocator_arena_release (void *context, void *ptr)
+{
+	AllocatorArena *arena = (AllocatorArena *)context;
+
+	/* Only most recent allocation can be given back before reset */
+	uint8_t *block = (uint8_t *)ptr - ALLOCATOR_ARENA_HEADER_SIZE;
+	if ((arena->last != SIZE_MAX) && (block == (arena->buffer + arena->last)))
+	{
+		arena->used = arena->last;
+		arena->last = SIZE_MAX;
+	}
+}
+
+/**
+ * \brief \ref allocator_reallocatefunction_t for \ref AllocatorArena
+ */
+static void *
+allocator_arena_reallocate (void *context, void *ptr, size_t size)
+{
+	AllocatorArena *arena = (AllocatorArena *)context;
+	if (ptr == NULL)
+	{
+		return allocator_arena_allocate (context, size);
+	}
+
+	uint8_t *block = (uint8_t *)ptr - ALLOCATOR_ARENA_HEADER_SIZE;
+	size_t old_size;
+	memcpy (&old_size, block, sizeof (size_t));
+
+	/* Most recent allocation is resized in place */
+	if ((arena->last != SIZE_MAX) && (block == (arena->buffer + arena->last)))
+	{
+		size_t aligned = (size + ALLOCATOR_ARENA_ALIGNMENT - 1)
+				& ~(size_t)(ALLOCATOR_ARENA_ALIGNMENT - 1);
+		if ((aligned < size) || ((arena->size - arena->last)
+				< (ALLOCATOR_ARENA_HEADER_SIZE + aligned)))
+		{
+			return NULL;
+		}
+		memcpy (block, &size, sizeof (size_t));
+		arena->used = arena->last + ALLOCATOR_ARENA_HEADER_SIZE + aligned;
+		if (arena->used > arena->peak)
+		{
+			arena->peak = arena->used;
+		}
+		return ptr;
+	}
+
+	/* Otherwise move to new allocation */
+	uint8_t *resized = allocator_arena_allocate (context, size);
+	if (resized == NULL)
+	{
+		return NULL;
+	}
+	memcpy (resized, ptr, old_size < size ? old_size : size);
+	return resized;
+}
+
+/**
+ * \brief \ref allocator_resetfunction_t for \ref AllocatorArena
+ */
+static void
+allocator_arena_reset_function (void *context)
+{
+	allocator_arena_reset ((AllocatorArena *)context);
+}
+
+/**
+ * \brief Initializes arena serving memory from given buffer
+ *
+ * \param arena Arena to be initialized
+ * \param buffer Memory to be served by arena (aligned to \ref
+ * ALLOCATOR_ARENA_ALIGNMENT)
+ * \param size Number of bytes in   buffer
+ * \return const Allocator*   Allocator hooks of arena
+ */
+const Allocator *
+allocator_arena_initialize (AllocatorArena *arena, void *buffer, size_t size)
+{
+	arena->allocator.allocate = allocator_arena_allocate;
+	arena->allocator.reallocate = allocator_arena_reallocate;
+	arena->allocator.release = allocator_arena_release;
+	arena->allocator.reset = allocator_arena_reset_function;
+	arena->allocator.context = arena;
+	arena->buffer = (uint8_t *)buffer;
+	arena->size = size;
+	arena->used = 0;
+	arena->last = SIZE_MAX;
+	arena->peak = 0;
+	return &arena->allocator;
+}
+
+/**
+ * \brief Releases all memory served by arena at once
+ *
+ * \param arena Arena to be reset
+ */
+void
+allocator_arena_reset (AllocatorArena *arena)
+{
+	arena->used = 0;
+	arena->last = SIZE_MAX;
+}
@@ -133,7 +133,7 @@ apdu_decode (APDU *apdu, uint8_t *data, size_t data_len)
 	}
 
 	/* Copy data */
-	apdu->data = malloc (apdu->lc);
+	apdu->data = allocator_malloc (apdu->allocator, apdu->lc);
 	if (apdu->data == NULL)
 	{
 		return IFX_ERROR (LIBAPDU, APDU_DECODE, OUT_OF_MEMORY);
@@ -154,7 +154,7 @@ apdu_decode (APDU *apdu, uint8_t *data, size_t data_len)
 		/* ISO7816-3 Case 4S requires LC to also have short form */
 		if (extended_length)
 		{
-			free (apdu->data);
+			allocator_free (apdu->allocator, apdu->data);
 			apdu->data = NULL;
 			return IFX_ERROR (LIBAPDU, APDU_DECODE, EXTENDED_LENGTH_MISMATCH);
 		}
@@ -177,7 +177,7 @@ apdu_decode (APDU *apdu, uint8_t *data, size_t data_len)
 		/* ISO7816-3 Case 4E requires LC to also have extended form */
 		if (!extended_length)
 		{
-			free (apdu->data);
+			allocator_free (apdu->allocator, apdu->data);
 			apdu->data = NULL;
 			return IFX_ERROR (LIBAPDU, APDU_DECODE, EXTENDED_LENGTH_MISMATCH);
 		}
@@ -196,44 +196,42 @@ apdu_decode (APDU *apdu, uint8_t *data, size_t data_len)
 	}
 
 	/* Otherwise incorrect data */
-	free (apdu->data);
+	allocator_free (apdu->allocator, apdu->data);
 	apdu->data = NULL;
 
 	return IFX_ERROR (LIBAPDU, APDU_DECODE, LC_MISMATCH);
 }
 
 /**
- * \brief Encodes \ref APDU to its binary representation
+ * \brief Calculates number of bytes in binary representation of \ref APDU
  *
- * \param apdu APDU  to be encoded
- * \param buffer Buffer to store encoded data in
- * \param buffer_len Pointer for storing number of bytes in   buffer
- * \return int   APDU_ENCODE_SUCCESS if successful, any other value in case of
- * error
+ * \param apdu APDU to be encoded
+ * \return size_t Number of bytes \ref apdu_encode_into(APDU*, uint8_t*,
+ * size_t, size_t*) will write
  */
-int
-apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
+size_t
+apdu_encoded_size (const APDU *apdu)
 {
-	/* Calculate required buffer size (minimum 4 bytes for header) */
-	size_t buffer_size = 4 + apdu->lc;
+	/* Minimum 4 bytes for header */
+	size_t encoded_size = 4 + apdu->lc;
 	bool extended_length = (apdu->lc > 0xff) || (apdu->le > APDU_LE_ANY);
 	if (extended_length)
 	{
 		/* ISO7816-3 Case 3E or 4E */
 		if (apdu->lc > 0)
 		{
-			buffer_size += 3;
+			encoded_size += 3;
 
 			/* ISO7816-3 Case 4E */
 			if (apdu->le > 0)
 			{
-				buffer_size += 2;
+				encoded_size += 2;
 			}
 		}
 		/* ISO7816-3 Case 2E */
 		else
 		{
-			buffer_size += 3;
+			encoded_size += 3;
 		}
 	}
 	else
@@ -241,28 +239,50 @@ apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
 		/* ISO7816-3 Case 3S or 4S */
 		if (apdu->lc > 0)
 		{
-			buffer_size += 1;
+			encoded_size += 1;
 		}
 
 		/* ISO7816-3 Case 2S or 4S */
 		if (apdu->le > 0)
 		{
-			buffer_size += 1;
+			encoded_size += 1;
 		}
 	}
+	return encoded_size;
+}
 
-	/* Allocate memory for buffer */
-	*buffer = malloc (buffer_size);
-	if (*buffer == NULL)
+/**
+ * \brief Encodes \ref APDU to its binary representation into caller provided
+ * buffer
+ *
+ * \details Lets callers reserve room around the APDU (e.g. for the framing of
+ * a protocol layer, see \ref protocol_get_headroom(Protocol*, size_t*,
+ * size_t*)) so that it is encoded right where it is transmitted from.
+ *
+ * \param apdu APDU to be encoded
+ * \param buffer Buffer to store encoded data in
+ * \param buffer_size Number of bytes available in   buffer
+ * \param encoded_len Pointer for storing number of bytes written to   buffer
+ * \return int   APDU_ENCODE_SUCCESS if successful, any other value in case of
+ * error
+ */
+int
+apdu_encode_into (APDU *apdu, uint8_t *buffer, size_t buffer_size,
+		size_t *encoded_len)
+{
+	/* Validate that APDU fits into buffer */
+	size_t encoded_size = apdu_encoded_size (apdu);
+	if ((buffer == NULL) || (buffer_size < encoded_size))
 	{
-		return IFX_ERROR (LIBAPDU, APDU_ENCODE, OUT_OF_MEMORY);
+		return IFX_ERROR (LIBAPDU, APDU_ENCODE, ILLEGAL_ARGUMENT);
 	}
+	bool extended_length = (apdu->lc > 0xff) || (apdu->le > APDU_LE_ANY);
 
 	/* Encode header information */
-	(*buffer)[0] = apdu->cla;
-	(*buffer)[1] = apdu->ins;
-	(*buffer)[2] = apdu->p1;
-	(*buffer)[3] = apdu->p2;
+	buffer[0] = apdu->cla;
+	buffer[1] = apdu->ins;
+	buffer[2] = apdu->p1;
+	buffer[3] = apdu->p2;
 
 	/* ISO7816-3 Case 3 or Case 4 */
 	if (apdu->lc > 0x00)
@@ -272,18 +292,18 @@ apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
 		/* ISO7816-3 Case 3E or Case 4E */
 		if (extended_length)
 		{
-			(*buffer)[offset] = 0x00;
-			(*buffer)[offset + 1] = (apdu->lc & 0xff00) >> 8;
-			(*buffer)[offset + 2] = apdu->lc & 0xff;
+			buffer[offset] = 0x00;
+			buffer[offset + 1] = (apdu->lc & 0xff00) >> 8;
+			buffer[offset + 2] = apdu->lc & 0xff;
 			offset += 3;
 		}
 		/* ISO7816-3 Case 3S or Case 4S */
 		else
 		{
-			(*buffer)[offset] = apdu->lc & 0xff;
+			buffer[offset] = apdu->lc & 0xff;
 			offset += 1;
 		}
-		memcpy ((*buffer) + offset, apdu->data, apdu->lc);
+		memcpy (buffer + offset, apdu->data, apdu->lc);
 		offset += apdu->lc;
 
 		/* ISO7816-3 Case 4 */
@@ -295,13 +315,13 @@ apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
 				/* Special case 0x10000 extends to {0x00, 0x00} */
 				if (apdu->le == APDU_LE_ANY_EXTENDED)
 				{
-					(*buffer)[offset] = 0x00;
-					(*buffer)[offset + 1] = 0x00;
+					buffer[offset] = 0x00;
+					buffer[offset + 1] = 0x00;
 				}
 				else
 				{
-					(*buffer)[offset] = (apdu->le & 0xff00) >> 8;
-					(*buffer)[offset + 1] = apdu->le & 0xff;
+					buffer[offset] = (apdu->le & 0xff00) >> 8;
+					buffer[offset + 1] = apdu->le & 0xff;
 				}
 			}
 			/* ISO7816-3 Case 4S */
@@ -310,11 +330,11 @@ apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
 				/* Special case 0x100 extends to {0x00} */
 				if (apdu->le == APDU_LE_ANY)
 				{
-					(*buffer)[offset] = 0x00;
+					buffer[offset] = 0x00;
 				}
 				else
 				{
-					(*buffer)[offset] = apdu->le & 0xff;
+					buffer[offset] = apdu->le & 0xff;
 				}
 			}
 		}
@@ -328,17 +348,17 @@ apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
 			/* ISO7816-3 Case 2E */
 			if (extended_length)
 			{
-				(*buffer)[4] = 0x00;
+				buffer[4] = 0x00;
 				/* Special case 0x10000 extends to {0x00, 0x00} */
 				if (apdu->le == APDU_LE_ANY_EXTENDED)
 				{
-					(*buffer)[5] = 0x00;
-					(*buffer)[6] = 0x00;
+					buffer[5] = 0x00;
+					buffer[6] = 0x00;
 				}
 				else
 				{
-					(*buffer)[5] = (apdu->le & 0xff00) >> 8;
-					(*buffer)[6] = apdu->le & 0xff;
+					buffer[5] = (apdu->le & 0xff00) >> 8;
+					buffer[6] = apdu->le & 0xff;
 				}
 			}
 			/* ISO7816-3 Case 2S */
@@ -347,20 +367,49 @@ apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
 				/* Special case 0x100 extends to {0x00} */
 				if (apdu->le == APDU_LE_ANY)
 				{
-					(*buffer)[4] = 0x00;
+					buffer[4] = 0x00;
 				}
 				else
 				{
-					(*buffer)[4] = apdu->le & 0xff;
+					buffer[4] = apdu->le & 0xff;
 				}
 			}
 		}
 	}
 
-	*buffer_len = buffer_size;
+	*encoded_len = encoded_size;
 	return APDU_ENCODE_SUCCESS;
 }
 
+/**
+ * \brief Encodes \ref APDU to its binary representation
+ *
+ * \param apdu APDU  to be encoded
+ * \param buffer Buffer to store encoded data in
+ * \param buffer_len Pointer for storing number of bytes in   buffer
+ * \return int   APDU_ENCODE_SUCCESS if successful, any other value in case of
+ * error
+ */
+int
+apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len)
+{
+	/* Allocate memory for buffer */
+	size_t buffer_size = apdu_encoded_size (apdu);
+	*buffer = allocator_malloc (apdu->allocator, buffer_size);
+	if (*buffer == NULL)
+	{
+		return IFX_ERROR (LIBAPDU, APDU_ENCODE, OUT_OF_MEMORY);
+	}
+
+	int status = apdu_encode_into (apdu, *buffer, buffer_size, buffer_len);
+	if (status != APDU_ENCODE_SUCCESS)
+	{
+		allocator_free (apdu->allocator, *buffer);
+		*buffer = NULL;
+	}
+	return status;
+}
+
 /**
  * \brief Frees memory associated with \ref APDU object (but not object itself)
  *
@@ -375,7 +424,7 @@ apdu_destroy (APDU *apdu)
 {
 	if ((apdu->lc > 0) && (apdu->data != NULL))
 	{
-		free (apdu->data);
+		allocator_free (apdu->allocator, apdu->data);
 	}
 	apdu->data = NULL;
 	apdu->lc = 0;
@@ -404,7 +453,8 @@ apduresponse_decode (APDUResponse *response, uint8_t *data, size_t data_len)
 	response->len = data_len - 2;
 	if (data_len > 2)
 	{
-		response->data = malloc (response->len);
+		response->data = allocator_malloc (response->allocator,
+				response->len);
 		if (response->data == NULL)
 		{
 			return IFX_ERROR (LIBAPDU, APDURESPONSE_DECODE, OUT_OF_MEMORY);
@@ -415,6 +465,38 @@ apduresponse_decode (APDUResponse *response, uint8_t *data, size_t data_len)
 	{
 		response->data = NULL;
 	}
+	response->borrowed = false;
+
+	/* Decode status word */
+	response->sw = (data[response->len] << 8) | data[response->len + 1];
+
+	return APDURESPONSE_DECODE_SUCCESS;
+}
+
+/**
+ * \brief Decodes binary data to a view in \ref APDUResponse object without
+ * copying response data
+ *
+ * \param response APDU response object to store values in
+ * \param data Binary data to be decoded (referenced by   response)
+ * \param data_len Number of bytes in   data
+ * \return int   APDURESPONSE_DECODE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+apduresponse_decode_view (APDUResponse *response, uint8_t *data,
+		size_t data_len)
+{
+	/* Minimum APDU response length 2 bytes -> status word only */
+	if (data_len < 2)
+	{
+		return IFX_ERROR (LIBAPDU, APDURESPONSE_DECODE, TOO_LITTLE_DATA);
+	}
+
+	/* Reference data */
+	response->len = data_len - 2;
+	response->data = (response->len > 0) ? data : NULL;
+	response->borrowed = true;
 
 	/* Decode status word */
 	response->sw = (data[response->len] << 8) | data[response->len + 1];
@@ -436,7 +518,8 @@ apduresponse_encode (APDUResponse *response, uint8_t **buffer,
 		size_t *buffer_len)
 {
 	/* Allocate memory for buffer */
-	*buffer = malloc (response->len + 2);
+	*buffer = allocator_malloc (response->allocator,
+			response->len + 2);
 	if (*buffer == NULL)
 	{
 		return IFX_ERROR (LIBAPDU, APDURESPONSE_ENCODE, OUT_OF_MEMORY);
@@ -471,10 +554,11 @@ apduresponse_encode (APDUResponse *response, uint8_t **buffer,
 void
 apduresponse_destroy (APDUResponse *response)
 {
-	if ((response->len > 0) && (response->data != NULL))
+	if ((response->len > 0) && (response->data != NULL) && !response->borrowed)
 	{
-		free (response->data);
+		allocator_free (response->allocator, response->data);
 	}
 	response->data = NULL;
 	response->len = 0;
+	response->borrowed = false;
 }
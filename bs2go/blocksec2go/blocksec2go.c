@@ -26,6 +26,7 @@
  * C-API for implementation of Blockchain Security 2 Go Starter Kit v2 command set. 
  */
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -34,6 +35,9 @@
 #include "bs2go/blocksec2go/blocksec2go.h"
 #include "bs2go/apdu/apdu.h"
 #include "bs2go/blocksec2go/status.h"
+#include "bs2go/crc/crc.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/t1prime/t1prime.h"
 
 
 /**
@@ -56,6 +60,87 @@
  */
 #define BLOCK2GO_NEXT_OCCURANCE 0x01
 
+/**
+ * \brief Maximum number of bytes in a (short) response APDU including status
+ * word
+ */
+#define BLOCK2GO_RESPONSE_MAX_LEN (256 + 2)
+
+/**
+ * \brief Maximum number of bytes of APDU header including LC
+ */
+#define BLOCK2GO_APDU_HEADER_MAX_LEN 7
+
+/**
+ * \brief Maximum number of bytes of APDU LE
+ */
+#define BLOCK2GO_APDU_LE_MAX_LEN 3
+
+/**
+ * \brief Number of bytes of T=1' I block prologue and APDU CLA and INS that
+ * are constant for a given command and N(S)
+ */
+#define BLOCK2GO_FRAME_HEADER_LEN 6
+
+/**
+ * \brief Precomputed part of T=1' I blocks carrying an APDU with parameters
+ *
+ * \details Only P1, P2 and command data need to be filled in and the CRC is
+ * continued over just those bytes.
+ */
+typedef struct Block2GoFrameTemplate
+{
+	uint8_t header[2][BLOCK2GO_FRAME_HEADER_LEN]; /**< NAD, PCB, LEN, CLA and
+                                                    INS for N(S) = 0 and
+                                                    N(S) = 1 */
+	CRC16 crc[2]; /**< CRC state after header for N(S) = 0 and N(S) = 1 */
+} Block2GoFrameTemplate;
+
+/**
+ * \brief Precompiled T=1' I blocks of SELECT (00 A4 04 00 0D
+ * D2760000041502000100000001) for N(S) = 0 and N(S) = 1
+ */
+static const uint8_t block2go_select_frame[2][T1PRIME_FRAME_SIZE (18)] = {
+		{ 0x21, 0x00, 0x00, 0x12, 0x00, 0xA4, 0x04, 0x00, 0x0D, 0xD2, 0x76,
+				0x00, 0x00, 0x04, 0x15, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+				0xB3, 0xA6 },
+		{ 0x21, 0x40, 0x00, 0x12, 0x00, 0xA4, 0x04, 0x00, 0x0D, 0xD2, 0x76,
+				0x00, 0x00, 0x04, 0x15, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+				0x00, 0x7B } };
+
+/**
+ * \brief Precompiled T=1' I blocks of GET STATUS (00 B0 DF 20) for N(S) = 0
+ * and N(S) = 1
+ */
+static const uint8_t block2go_get_status_frame[2][T1PRIME_FRAME_SIZE (4)] = {
+		{ 0x21, 0x00, 0x00, 0x04, 0x00, 0xB0, 0xDF, 0x20, 0xEE, 0x9F },
+		{ 0x21, 0x40, 0x00, 0x04, 0x00, 0xB0, 0xDF, 0x20, 0x29, 0x99 } };
+
+/**
+ * \brief Precompiled T=1' I blocks of ENABLE PROTECTED MODE (00 D0 00 00) for
+ * N(S) = 0 and N(S) = 1
+ */
+static const uint8_t
+block2go_enable_protected_mode_frame[2][T1PRIME_FRAME_SIZE (4)] = {
+		{ 0x21, 0x00, 0x00, 0x04, 0x00, 0xD0, 0x00, 0x00, 0x16, 0x23 },
+		{ 0x21, 0x40, 0x00, 0x04, 0x00, 0xD0, 0x00, 0x00, 0xD1, 0x25 } };
+
+/**
+ * \brief Frame template of GENERATE SIGNATURE (00 18 P1 P2 20 <32 bytes>)
+ */
+static const Block2GoFrameTemplate block2go_generate_signature_template = {
+		.header = { { 0x21, 0x00, 0x00, 0x25, 0x00, 0x18 },
+				{ 0x21, 0x40, 0x00, 0x25, 0x00, 0x18 } },
+		.crc = { { CRC16_CCITT_X25, 0x2F74 }, { CRC16_CCITT_X25, 0xEE56 } } };
+
+/**
+ * \brief Frame template of GET KEY INFO (00 16 P1 P2)
+ */
+static const Block2GoFrameTemplate block2go_get_key_info_template = {
+		.header = { { 0x21, 0x00, 0x00, 0x04, 0x00, 0x16 },
+				{ 0x21, 0x40, 0x00, 0x04, 0x00, 0x16 } },
+		.crc = { { CRC16_CCITT_X25, 0x9FED }, { CRC16_CCITT_X25, 0x5ECF } } };
+
 /**
  * \brief Converts a 4 byte uint8_t array into a uint32_t.
  *
@@ -130,50 +215,348 @@ static void get_label_length (uint8_t *data, size_t *byte_length,
 }
 
 /**
- * \brief Sends APDU and receives response APDU.
+ * \brief Splits APDU into header, command data and LE segments without
+ * copying command data.
+ *
+ * \param apdu[in] APDU which is to be encoded
+ * \param header[out] buffer for CLA, INS, P1, P2 and LC
+ * \param le[out] buffer for LE
+ * \param segments[out] segments referencing header, command data and LE
+ */
+static void encode_apdu_segments (APDU *apdu,
+		uint8_t header[BLOCK2GO_APDU_HEADER_MAX_LEN],
+		uint8_t le[BLOCK2GO_APDU_LE_MAX_LEN],
+		ProtocolSegment segments[3])
+{
+	bool extended_length = (apdu->lc > 0xff) || (apdu->le > APDU_LE_ANY);
+	size_t header_len = 4;
+	size_t le_len = 0;
+
+	header[0] = apdu->cla;
+	header[1] = apdu->ins;
+	header[2] = apdu->p1;
+	header[3] = apdu->p2;
+
+	/* ISO7816-3 Case 3 or Case 4 */
+	if (apdu->lc > 0)
+	{
+		if (extended_length)
+		{
+			header[4] = 0x00;
+			header[5] = (apdu->lc & 0xff00) >> 8;
+			header[6] = apdu->lc & 0xff;
+			header_len = 7;
+		}
+		else
+		{
+			header[4] = apdu->lc & 0xff;
+			header_len = 5;
+		}
+	}
+	/* ISO7816-3 Case 2E starts LE with marker byte */
+	else if ((apdu->le > 0) && extended_length)
+	{
+		le[le_len++] = 0x00;
+	}
+
+	/* ISO7816-3 Case 2 or Case 4 */
+	if (apdu->le > 0)
+	{
+		if (extended_length)
+		{
+			/* Special case 0x10000 extends to {0x00, 0x00} */
+			le[le_len++] = (apdu->le & 0xff00) >> 8;
+			le[le_len++] = apdu->le & 0xff;
+		}
+		else
+		{
+			/* Special case 0x100 extends to {0x00} */
+			le[le_len++] = apdu->le & 0xff;
+		}
+	}
+
+	segments[0].data = header;
+	segments[0].len = header_len;
+	segments[1].data = apdu->data;
+	segments[1].len = apdu->lc;
+	segments[2].data = le;
+	segments[2].len = le_len;
+}
+
+/**
+ * \brief Takes status word from the last two bytes of a response scattered
+ * over segments.
+ *
+ * \param response[in] segments holding response data
+ * \param response_count[in] number of segments in   response
+ * \param response_len[in] number of bytes scattered into   response
+ * \param data_len[out] number of response bytes without status word
+ * \param sw[out] status word
+ *
+ * \retval APDUDECODE_SUCCESS in case of success
+ * \retval APDURESPONSE_DECODE TOO_LITTLE_DATA if there is no status word
+ */
+static int decode_status_word (const ProtocolSegment *response,
+		size_t response_count, size_t response_len, size_t *data_len,
+		uint16_t *sw)
+{
+	if (response_len < 2)
+	{
+		return IFX_ERROR (LIBAPDU, APDURESPONSE_DECODE, TOO_LITTLE_DATA);
+	}
+
+	uint8_t status_word[2];
+	protocol_segments_gather (response, response_count, response_len - 2,
+			status_word, 2);
+	*sw = (status_word[0] << 8) | status_word[1];
+	*data_len = response_len - 2;
+	return APDURESPONSE_DECODE_SUCCESS;
+}
+
+/**
+ * \brief Returns number of command data bytes per APDU for commands split
+ * into several APDUs.
+ *
+ * \details With BLOCK2GO_EXTENDED_LENGTH all data goes into a single Case 3E
+ * APDU. Otherwise the data is split into as few short APDUs as possible with
+ * balanced sizes. If the IFSC negotiated by T=1' allows it without an
+ * additional APDU, the chunks are enlarged so that every APDU but the last
+ * exactly fills whole I blocks.
+ *
+ * \param protocol[in] instance of activated protocol to use
+ * \param data_len[in] total number of command data bytes
+ *
+ * \return size_t maximum number of command data bytes per APDU
+ */
+static size_t command_data_chunk_len (Protocol *protocol, size_t data_len)
+{
+#if BLOCK2GO_EXTENDED_LENGTH
+	if (data_len <= 0xffff)
+	{
+		return data_len;
+	}
+#endif
+	if (data_len <= 0xff)
+	{
+		return 0xff;
+	}
+
+	/* Fewest short APDUs, data spread evenly across them */
+	size_t count = (data_len + 0xff - 1) / 0xff;
+	size_t chunk_len = (data_len + count - 1) / count;
+
+	/* Short APDU without LE has CLA, INS, P1, P2 and LC in front of data */
+	size_t ifsc;
+	if ((protocol->_layer_id == T1PRIME_PROTOCOLLAYER_ID)
+			&& (t1prime_get_ifsc (protocol, &ifsc) == PROTOCOL_GETPROPERTY_SUCCESS)
+			&& (ifsc > 0))
+	{
+		size_t aligned = ((5 + chunk_len + ifsc - 1) / ifsc) * ifsc - 5;
+		if (aligned <= 0xff)
+		{
+			chunk_len = aligned;
+		}
+	}
+	return chunk_len;
+}
+
+/**
+ * \brief Sends APDU and receives response APDU into caller provided segments.
+ *
+ * \details Short APDUs are encoded right into a frame buffer with the
+ * headroom and tailroom of the protocol layer, longer ones are sent as
+ * header, command data and LE segments. Response data is scattered into
+ *   response in order, the status word is taken from the last two bytes
+ * received wherever they ended up.
  *
  * \param protocol[in] instance of activated protocol to use
  * \param apdu[in] APDU which is to be sent
- * \param resp[out] decoded response APDU
+ * \param response[in] segments to store response data in
+ * \param response_count[in] number of segments in   response
+ * \param data_len[out] number of response bytes without status word
+ * \param sw[out] status word
  *
  * \retval APDUDECODE_SUCCESS in case of success
  * \retval others indicate failures from lower layers
  */
-static int exchange_apdu (Protocol *protocol, APDU *apdu, APDUResponse *resp)
+static int exchange_apdu_into (Protocol *protocol, APDU *apdu,
+		const ProtocolSegment *response, size_t response_count,
+		size_t *data_len, uint16_t *sw)
 {
+	size_t response_len = 0;
+	int status;
+
+	/* Encode short APDUs right into the frame of the protocol layer */
+	size_t headroom;
+	size_t tailroom;
+	protocol_get_headroom (protocol, &headroom, &tailroom);
+	size_t encoded_size = apdu_encoded_size (apdu);
+	if (((headroom + tailroom) > 0)
+			&& ((headroom + encoded_size + tailroom)
+					<= T1PRIME_FRAME_SIZE (APDU_SHORT_MAX_LEN)))
+	{
+		uint8_t frame[T1PRIME_FRAME_SIZE (APDU_SHORT_MAX_LEN)];
+		size_t encoded_len = 0;
+		status = apdu_encode_into (apdu, frame + headroom, encoded_size,
+				&encoded_len);
+		if (status == APDU_ENCODE_SUCCESS)
+		{
+			status = protocol_transceive_inplace (protocol, frame, encoded_len,
+					response, response_count, &response_len);
+		}
+	}
+	/* Otherwise send command data without joining it */
+	else
+	{
+		uint8_t header[BLOCK2GO_APDU_HEADER_MAX_LEN];
+		uint8_t le[BLOCK2GO_APDU_LE_MAX_LEN];
+		ProtocolSegment command[3];
+		encode_apdu_segments (apdu, header, le, command);
+		status = protocol_transceive_iov (protocol, command, 3, response,
+				response_count, &response_len);
+	}
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	return decode_status_word (response, response_count, response_len,
+			data_len, sw);
+}
 
-	memset (resp, 0, sizeof (APDUResponse));
-
-	uint8_t *encoded;
-	size_t encoded_len;
-	int status = apdu_encode (apdu, &encoded, &encoded_len);
+/**
+ * \brief Sends APDU precompiled into T=1' frames and receives response APDU
+ * into caller provided segments.
+ *
+ * \details Falls back to encoding   apdu if   protocol is not a T=1' layer.
+ *
+ * \param protocol[in] instance of activated protocol to use
+ * \param frames[in] encoded I blocks for N(S) = 0 and N(S) = 1
+ * \param frame_len[in] number of bytes in each frame
+ * \param apdu[in] APDU carried by   frames
+ * \param response[in] segments to store response data in
+ * \param response_count[in] number of segments in   response
+ * \param data_len[out] number of response bytes without status word
+ * \param sw[out] status word
+ *
+ * \retval APDUDECODE_SUCCESS in case of success
+ * \retval others indicate failures from lower layers
+ */
+static int exchange_frame_into (Protocol *protocol,
+		const uint8_t *const frames[2], size_t frame_len, APDU *apdu,
+		const ProtocolSegment *response, size_t response_count,
+		size_t *data_len, uint16_t *sw)
+{
+	if (protocol->_layer_id != T1PRIME_PROTOCOLLAYER_ID)
+	{
+		return exchange_apdu_into (protocol, apdu, response, response_count,
+				data_len, sw);
+	}
 
-	if (status != APDU_ENCODE_SUCCESS)
+	size_t response_len = 0;
+	int status = t1prime_transceive_frame_iov (protocol, frames, frame_len,
+			response, response_count, &response_len);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
 	{
 		return status;
 	}
+	return decode_status_word (response, response_count, response_len,
+			data_len, sw);
+}
 
-	uint8_t *response = 0;
-	size_t response_len;
-
-	status = protocol_transceive (protocol, encoded, encoded_len, &response,
-			&response_len);
+/**
+ * \brief Sends short APDU without LE using a frame template and receives
+ * response APDU into caller provided segments.
+ *
+ * \details Only the frame for the current N(S) is completed. The CRC is
+ * continued from the template over P1, P2, LC and command data.
+ *
+ * \param protocol[in] instance of activated protocol to use
+ * \param template[in] precomputed header and CRC state of   apdu
+ * \param apdu[in] APDU which is to be sent
+ * \param response[in] segments to store response data in
+ * \param response_count[in] number of segments in   response
+ * \param data_len[out] number of response bytes without status word
+ * \param sw[out] status word
+ *
+ * \retval APDUDECODE_SUCCESS in case of success
+ * \retval others indicate failures from lower layers
+ */
+static int exchange_template_into (Protocol *protocol,
+		const Block2GoFrameTemplate *template, APDU *apdu,
+		const ProtocolSegment *response, size_t response_count,
+		size_t *data_len, uint16_t *sw)
+{
+	uint8_t send_counter;
+	if ((protocol->_layer_id != T1PRIME_PROTOCOLLAYER_ID)
+			|| (t1prime_get_send_counter (protocol, &send_counter)
+					!= PROTOCOL_GETPROPERTY_SUCCESS))
+	{
+		return exchange_apdu_into (protocol, apdu, response, response_count,
+				data_len, sw);
+	}
 
-	free (encoded);
-	if (status == PROTOCOL_TRANSCEIVE_SUCCESS)
+	/* Complete frame for current N(S) */
+	uint8_t frame[T1PRIME_FRAME_SIZE (5 + 0xff)];
+	size_t frame_len = BLOCK_PROLOGUE_LENGTH + 4;
+	memcpy (frame, template->header[send_counter], BLOCK2GO_FRAME_HEADER_LEN);
+	frame[BLOCK2GO_FRAME_HEADER_LEN] = apdu->p1;
+	frame[BLOCK2GO_FRAME_HEADER_LEN + 1] = apdu->p2;
+	if (apdu->lc > 0)
 	{
+		frame[frame_len++] = apdu->lc;
+		memcpy (frame + frame_len, apdu->data, apdu->lc);
+		frame_len += apdu->lc;
+	}
+	CRC16 crc = template->crc[send_counter];
+	crc16_update (&crc, frame + BLOCK2GO_FRAME_HEADER_LEN,
+			frame_len - BLOCK2GO_FRAME_HEADER_LEN);
+	uint16_t checksum = crc16_final (&crc);
+	frame[frame_len++] = (checksum & 0xff00) >> 8;
+	frame[frame_len++] = checksum & 0xff;
+
+	const uint8_t *frames[2] = { NULL, NULL };
+	frames[send_counter] = frame;
+	return exchange_frame_into (protocol, frames, frame_len, apdu, response,
+			response_count, data_len, sw);
+}
 
-		status = apduresponse_decode (resp, response, response_len);
+/**
+ * \brief Sends APDU and receives response APDU.
+ *
+ * \param protocol[in] instance of activated protocol to use
+ * \param apdu[in] APDU which is to be sent
+ * \param received[in] buffer to receive response APDU into
+ * \param resp[out] response APDU viewing into   received
+ *
+ * \retval APDUDECODE_SUCCESS in case of success
+ * \retval others indicate failures from lower layers
+ */
+static int exchange_apdu (Protocol *protocol, APDU *apdu,
+		uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN], APDUResponse *resp)
+{
+	memset (resp, 0, sizeof (APDUResponse));
+
+	ProtocolSegment response = { .data = received,
+			.len = BLOCK2GO_RESPONSE_MAX_LEN };
+	size_t data_len = 0;
+	uint16_t sw = 0;
+	int status = exchange_apdu_into (protocol, apdu, &response, 1, &data_len,
+			&sw);
+	if (status != APDURESPONSE_DECODE_SUCCESS)
+	{
+		return status;
 	}
-	free (response);
-	return status;
+	return apduresponse_decode_view (resp, received, data_len + 2);
 }
 
 /* SELECT */
-int block2go_select (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
-		char **version)
+int block2go_select_into (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
+		char *version, size_t version_size)
 {
-	*version = NULL;
+	if ((id == NULL) || (version == NULL) || (version_size == 0))
+	{
+		return IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_SELECT, ILLEGAL_ARGUMENT);
+	}
 	uint8_t aid[13] = { 0xD2, 0x76, 0x00, 0x00, 0x04, 0x15, 0x02,
 			0x00, 0x01, 0x00, 0x00, 0x00, 0x01 };
 	APDU apdu = { .cla = 0x00,
@@ -184,30 +567,65 @@ int block2go_select (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
 			.data = aid,
 			.le = 0 };
 
-	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	/* ID and version are received directly into caller storage */
+	uint8_t status_word[2];
+	ProtocolSegment response[3] = {
+			{ .data = id, .len = BLOCK2GO_ID_LEN },
+			{ .data = (uint8_t *)version, .len = version_size },
+			{ .data = status_word, .len = sizeof (status_word) } };
+	const uint8_t *const frames[2] = { block2go_select_frame[0],
+			block2go_select_frame[1] };
+	size_t data_len;
+	uint16_t sw;
+	int status = exchange_frame_into (protocol, frames,
+			sizeof (block2go_select_frame[0]), &apdu, response, 3, &data_len,
+			&sw);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
-		if (decoded.sw != 0x9000)
+		if (sw != 0x9000)
 		{
 			status = BLOCK2GO_SELECT_SE_FAIL;
 		}
-		else if (decoded.len < 12)
+		else if ((data_len < 12)
+				|| ((data_len - BLOCK2GO_ID_LEN) >= version_size))
 		{
 			status = BLOCK2GO_SELECT_INVALID_DATA_LENGTH;
 		}
 		else
 		{
 			status = BLOCK2GO_SELECT_SUCCESS;
-			memcpy (id, decoded.data, BLOCK2GO_ID_LEN);
-			const size_t version_len = decoded.len - BLOCK2GO_ID_LEN;
-			*version = (char *)malloc (version_len + 1);
-			memcpy (*version, decoded.data + BLOCK2GO_ID_LEN, version_len);
-			(*version)[version_len] = 0;
+			version[data_len - BLOCK2GO_ID_LEN] = 0;
 		}
 	}
-	apduresponse_destroy (&decoded);
+	return status;
+}
+
+int block2go_select (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
+		char **version)
+{
+	*version = NULL;
+	protocol_reset_transaction_allocator (protocol);
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	char *buffer = (char *)allocator_malloc (allocator,
+			BLOCK2GO_VERSION_MAX_LEN);
+	if (buffer == NULL)
+	{
+		return IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_SELECT, OUT_OF_MEMORY);
+	}
+
+	int status = block2go_select_into (protocol, id, buffer,
+			BLOCK2GO_VERSION_MAX_LEN);
+	if (status != BLOCK2GO_SELECT_SUCCESS)
+	{
+		allocator_free (allocator, buffer);
+		return status;
+	}
+
+	/* Give back unused space */
+	char *shrunk = (char *)allocator_realloc (allocator, buffer,
+			strlen (buffer) + 1);
+	*version = (shrunk != NULL) ? shrunk : buffer;
 	return status;
 }
 
@@ -215,6 +633,7 @@ int block2go_select (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
 static int block2go_generate_key (Protocol *protocol, block2go_curve curve,
 		block2go_key_type key_type, uint8_t *keyslot)
 {
+	protocol_reset_transaction_allocator (protocol);
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x02,
 			.p1 = curve,
@@ -223,8 +642,9 @@ static int block2go_generate_key (Protocol *protocol, block2go_curve curve,
 			.data = NULL,
 			.le = 0 };
 
+	uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN];
 	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	int status = exchange_apdu (protocol, &apdu, received, &decoded);
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
 		if (decoded.sw != 0x9000)
@@ -264,11 +684,10 @@ int block2go_generate_key_permanent (Protocol *protocol, block2go_curve curve,
 
 /* GET KEY INFO */
 
-static int block2go_get_key_info (Protocol *protocol, uint8_t key_index, uint8_t key_type,
-		block2go_curve *curve, uint32_t *global_counter,
-		uint32_t *counter, uint8_t **public_key)
+static int block2go_get_key_info_into (Protocol *protocol, uint8_t key_index,
+		uint8_t key_type, block2go_curve *curve, uint32_t *global_counter,
+		uint32_t *counter, uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN])
 {
-	*public_key = NULL;
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x16,
 			.p1 = key_index,
@@ -277,30 +696,61 @@ static int block2go_get_key_info (Protocol *protocol, uint8_t key_index, uint8_t
 			.data = NULL,
 			.le = 0x00 };
 
-	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	/* Public key is received directly into caller storage */
+	uint8_t info[9];
+	uint8_t status_word[2];
+	ProtocolSegment response[3] = {
+			{ .data = info, .len = sizeof (info) },
+			{ .data = public_key, .len = BLOCK2GO_PUBLIC_KEY_LEN },
+			{ .data = status_word, .len = sizeof (status_word) } };
+	size_t data_len;
+	uint16_t sw;
+	int status = exchange_template_into (protocol,
+			&block2go_get_key_info_template, &apdu, response, 3, &data_len, &sw);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
-		if (decoded.sw != 0x9000)
+		if (sw != 0x9000)
 		{
 			status = BLOCK2GO_GET_KEY_INFO_SE_FAIL;
 		}
-		else if (decoded.len != BLOCK2GO_PUBLIC_KEY_LEN + 9)
+		else if (data_len != BLOCK2GO_PUBLIC_KEY_LEN + 9)
 		{
 			status = BLOCK2GO_GET_KEY_INFO_INVALID_DATA_LENGTH;
 		}
 		else
 		{
 			status = BLOCK2GO_GET_KEY_INFO_SUCCESS;
-			*curve = (block2go_curve)decoded.data[0];
-			*global_counter = uint8_to_uint32 (decoded.data + 1);
-			*counter = uint8_to_uint32 (decoded.data + 5);
-			*public_key = (uint8_t *)malloc (BLOCK2GO_PUBLIC_KEY_LEN);
-			memcpy (*public_key, decoded.data + 9, BLOCK2GO_PUBLIC_KEY_LEN);
+			*curve = (block2go_curve)info[0];
+			*global_counter = uint8_to_uint32 (info + 1);
+			*counter = uint8_to_uint32 (info + 5);
 		}
 	}
-	apduresponse_destroy (&decoded);
+	return status;
+}
+
+static int block2go_get_key_info (Protocol *protocol, uint8_t key_index, uint8_t key_type,
+		block2go_curve *curve, uint32_t *global_counter,
+		uint32_t *counter, uint8_t **public_key)
+{
+	*public_key = NULL;
+	protocol_reset_transaction_allocator (protocol);
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	uint8_t *key = (uint8_t *)allocator_malloc (allocator,
+			BLOCK2GO_PUBLIC_KEY_LEN);
+	if (key == NULL)
+	{
+		return IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_GET_KEY_INFO, OUT_OF_MEMORY);
+	}
+
+	int status = block2go_get_key_info_into (protocol, key_index, key_type,
+			curve, global_counter, counter, key);
+	if (status != BLOCK2GO_GET_KEY_INFO_SUCCESS)
+	{
+		allocator_free (allocator, key);
+		return status;
+	}
+	*public_key = key;
 	return status;
 }
 
@@ -322,12 +772,30 @@ int block2go_get_key_info_permanent (Protocol *protocol, uint8_t key_index,
 			global_counter, counter, public_key);
 }
 
+int block2go_get_key_info_session_into (Protocol *protocol,
+		block2go_curve *curve, uint32_t *global_counter, uint32_t *counter,
+		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN])
+{
+	return block2go_get_key_info_into (protocol, 0x00,
+			BLOCK2GO_KEY_TYPE_SESSION, curve, global_counter, counter,
+			public_key);
+}
+
+int block2go_get_key_info_permanent_into (Protocol *protocol,
+		uint8_t key_index, block2go_curve *curve, uint32_t *global_counter,
+		uint32_t *counter, uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN])
+{
+	return block2go_get_key_info_into (protocol, key_index,
+			BLOCK2GO_KEY_TYPE_PERMANENT, curve, global_counter, counter,
+			public_key);
+}
+
 /* ENCRYPTED KEYIMPORT */
 
 int block2go_encrypted_keyimport (Protocol *protocol, block2go_curve curve,
 		uint8_t seed[BLOCK2GO_SEED_LEN])
 {
-
+	protocol_reset_transaction_allocator (protocol);
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x20,
 			.p1 = curve,
@@ -336,8 +804,9 @@ int block2go_encrypted_keyimport (Protocol *protocol, block2go_curve curve,
 			.data = seed,
 			.le = 0x00 };
 
+	uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN];
 	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	int status = exchange_apdu (protocol, &apdu, received, &decoded);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
@@ -359,23 +828,61 @@ int block2go_encrypted_keyimport (Protocol *protocol, block2go_curve curve,
 }
 
 /* GENERATE SIGNATURE */
-static int block2go_generate_signature (Protocol *protocol, uint8_t keyslot,
-		block2go_key_type keytype,
+int block2go_generate_signature_encode (uint8_t key_index,
+		block2go_key_type key_type,
 		uint8_t data_to_sign[32],
-		uint32_t *global_counter, uint32_t *counter,
-		uint8_t **signature, size_t *signature_len)
+		uint8_t **encoded, size_t *encoded_len)
 {
-	*signature = NULL;
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x18,
-			.p1 = keyslot,
-			.p2 = keytype,
+			.p1 = key_index,
+			.p2 = key_type,
 			.lc = 0x20,
 			.data = data_to_sign,
 			.le = 0x00 };
 
+	return apdu_encode (&apdu, encoded, encoded_len);
+}
+
+int block2go_generate_signature_encode_into (uint8_t key_index,
+		block2go_key_type key_type,
+		uint8_t data_to_sign[32],
+		uint8_t *encoded, size_t encoded_size, size_t *encoded_len)
+{
+	APDU apdu = { .cla = 0x00,
+			.ins = 0x18,
+			.p1 = key_index,
+			.p2 = key_type,
+			.lc = 0x20,
+			.data = data_to_sign,
+			.le = 0x00 };
+
+	return apdu_encode_into (&apdu, encoded, encoded_size, encoded_len);
+}
+
+/**
+ * \brief Parses response APDU to GENERATE SIGNATURE command without copying
+ * the signature.
+ *
+ * \param response[in] response APDU as received from secure element
+ * \param response_len[in] length of response APDU in bytes
+ * \param global_counter[out] buffer to copy remaining signatures of the card
+ * into
+ * \param counter[out] buffer to copy remaining signatures for the given key
+ * into
+ * \param signature[out] pointer to signature within   response
+ * \param signature_len[out] buffer to copy length of the signature in bytes
+ * into
+ *
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_SUCCESS in case of success
+ * \retval others indicate failures
+ */
+static int generate_signature_parse (uint8_t *response, size_t response_len,
+		uint32_t *global_counter, uint32_t *counter,
+		const uint8_t **signature, size_t *signature_len)
+{
 	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	int status = apduresponse_decode_view (&decoded, response, response_len);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
@@ -392,12 +899,129 @@ static int block2go_generate_signature (Protocol *protocol, uint8_t keyslot,
 			status = BLOCK2GO_GENERATE_SIGNATURE_SUCCESS;
 			*global_counter = uint8_to_uint32 (decoded.data);
 			*counter = uint8_to_uint32 (decoded.data + 4);
+			*signature = decoded.data + 8;
 			*signature_len = decoded.len - 8;
-			*signature = (uint8_t *)malloc (*signature_len);
-			memcpy (*signature, decoded.data + 8, *signature_len);
 		}
 	}
-	apduresponse_destroy (&decoded);
+	return status;
+}
+
+int block2go_generate_signature_decode (uint8_t *response, size_t response_len,
+		uint32_t *global_counter, uint32_t *counter,
+		uint8_t **signature, size_t *signature_len,
+		const Allocator *allocator)
+{
+	*signature = NULL;
+	const uint8_t *view;
+	int status = generate_signature_parse (response, response_len,
+			global_counter, counter, &view, signature_len);
+	if (status != BLOCK2GO_GENERATE_SIGNATURE_SUCCESS)
+	{
+		return status;
+	}
+
+	*signature = (uint8_t *)allocator_malloc (allocator, *signature_len);
+	if (*signature == NULL)
+	{
+		return BLOCK2GO_GENERATE_SIGNATURE_OUT_OF_MEMORY;
+	}
+	memcpy (*signature, view, *signature_len);
+	return status;
+}
+
+int block2go_generate_signature_decode_into (uint8_t *response,
+		size_t response_len, uint32_t *global_counter, uint32_t *counter,
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len)
+{
+	const uint8_t *view;
+	size_t view_len;
+	int status = generate_signature_parse (response, response_len,
+			global_counter, counter, &view, &view_len);
+	if (status != BLOCK2GO_GENERATE_SIGNATURE_SUCCESS)
+	{
+		return status;
+	}
+	if (view_len > BLOCK2GO_SIGNATURE_MAX_LEN)
+	{
+		return BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH;
+	}
+
+	memcpy (signature, view, view_len);
+	*signature_len = view_len;
+	return status;
+}
+
+static int block2go_generate_signature_into (Protocol *protocol,
+		uint8_t keyslot, block2go_key_type keytype, uint8_t data_to_sign[32],
+		uint32_t *global_counter, uint32_t *counter,
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len)
+{
+	APDU apdu = { .cla = 0x00,
+			.ins = 0x18,
+			.p1 = keyslot,
+			.p2 = keytype,
+			.lc = 0x20,
+			.data = data_to_sign,
+			.le = 0x00 };
+
+	/* Signature is received directly into caller storage */
+	uint8_t counters[8];
+	uint8_t status_word[2];
+	ProtocolSegment response[3] = {
+			{ .data = counters, .len = sizeof (counters) },
+			{ .data = signature, .len = BLOCK2GO_SIGNATURE_MAX_LEN },
+			{ .data = status_word, .len = sizeof (status_word) } };
+	size_t data_len;
+	uint16_t sw;
+	int status = exchange_template_into (protocol,
+			&block2go_generate_signature_template, &apdu, response, 3, &data_len,
+			&sw);
+
+	if (status == APDURESPONSE_DECODE_SUCCESS)
+	{
+		if (sw != 0x9000)
+		{
+			status = BLOCK2GO_GENERATE_SIGNATURE_FAIL;
+		}
+		else if (data_len < 16)
+		{ /* counter (8) + signature (>= 8) */
+			status = BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH;
+		}
+		else
+		{
+			status = BLOCK2GO_GENERATE_SIGNATURE_SUCCESS;
+			*global_counter = uint8_to_uint32 (counters);
+			*counter = uint8_to_uint32 (counters + 4);
+			*signature_len = data_len - 8;
+		}
+	}
+	return status;
+}
+
+static int block2go_generate_signature (Protocol *protocol, uint8_t keyslot,
+		block2go_key_type keytype,
+		uint8_t data_to_sign[32],
+		uint32_t *global_counter, uint32_t *counter,
+		uint8_t **signature, size_t *signature_len)
+{
+	*signature = NULL;
+	protocol_reset_transaction_allocator (protocol);
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	uint8_t *buffer = (uint8_t *)allocator_malloc (allocator,
+			BLOCK2GO_SIGNATURE_MAX_LEN);
+	if (buffer == NULL)
+	{
+		return BLOCK2GO_GENERATE_SIGNATURE_OUT_OF_MEMORY;
+	}
+
+	int status = block2go_generate_signature_into (protocol, keyslot, keytype,
+			data_to_sign, global_counter, counter, buffer, signature_len);
+	if (status != BLOCK2GO_GENERATE_SIGNATURE_SUCCESS)
+	{
+		allocator_free (allocator, buffer);
+		return status;
+	}
+	*signature = buffer;
 	return status;
 }
 
@@ -423,11 +1047,30 @@ int block2go_generate_signature_permanent (Protocol *protocol, uint8_t key_index
 			global_counter, counter, signature, signature_len);
 }
 
+int block2go_generate_signature_session_into (Protocol *protocol,
+		uint8_t data_to_sign[32], uint32_t *global_counter, uint32_t *counter,
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len)
+{
+	return block2go_generate_signature_into (protocol, 0x00,
+			BLOCK2GO_KEY_TYPE_SESSION, data_to_sign, global_counter, counter,
+			signature, signature_len);
+}
+
+int block2go_generate_signature_permanent_into (Protocol *protocol,
+		uint8_t key_index, uint8_t data_to_sign[32], uint32_t *global_counter,
+		uint32_t *counter, uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN],
+		size_t *signature_len)
+{
+	return block2go_generate_signature_into (protocol, key_index,
+			BLOCK2GO_KEY_TYPE_PERMANENT, data_to_sign, global_counter, counter,
+			signature, signature_len);
+}
+
 /* CREATE KEY LABEL */
 int block2go_create_key_label (Protocol *protocol, uint8_t key_index,
 		uint16_t key_label_size, uint32_t *memory)
 {
-
+	protocol_reset_transaction_allocator (protocol);
 	uint8_t data[2] = { key_label_size >> 8, key_label_size & 0x00FF };
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x1D,
@@ -437,8 +1080,9 @@ int block2go_create_key_label (Protocol *protocol, uint8_t key_index,
 			.data = data,
 			.le = 0x04 };
 
+	uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN];
 	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	int status = exchange_apdu (protocol, &apdu, received, &decoded);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
@@ -465,16 +1109,19 @@ int block2go_create_key_label (Protocol *protocol, uint8_t key_index,
 int block2go_update_key_label (Protocol *protocol, uint8_t key_index,
 		uint8_t *key_label, uint16_t key_label_size)
 {
-
-	uint8_t block_len_max = 160; /* to be determined */
-
 	if (key_label_size + 1 >= 1024)
 	{
 		return BLOCK2GO_UPDATE_KEY_LABEL_OUT_OF_MEMORY;
 	}
 	int status = BLOCK2GO_UPDATE_KEY_LABEL_SUCCESS;
 
-	uint8_t *data = (uint8_t *)malloc (key_label_size + 6);
+	protocol_reset_transaction_allocator (protocol);
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	uint8_t *data = (uint8_t *)allocator_malloc (allocator, key_label_size + 6);
+	if (data == NULL)
+	{
+		return BLOCK2GO_UPDATE_KEY_LABEL_OUT_OF_MEMORY;
+	}
 	uint8_t *write_ptr = data;
 
 	*write_ptr++ = 0xDF;
@@ -484,19 +1131,19 @@ int block2go_update_key_label (Protocol *protocol, uint8_t key_index,
 	memcpy (write_ptr, key_label, key_label_size);
 	write_ptr += key_label_size;
 
-	uint16_t data_length = (uintptr_t)write_ptr - (uintptr_t)data;
-	uint8_t num_blocks = (data_length - 1) / block_len_max + 1;
-	for (uint8_t block = 1; block <= num_blocks; block++)
+	size_t data_length = (uintptr_t)write_ptr - (uintptr_t)data;
+	size_t chunk_len = command_data_chunk_len (protocol, data_length);
+	uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN];
+	for (size_t offset = 0, sequence_num = 0; offset < data_length;
+			offset += chunk_len, sequence_num++)
 	{
-
-		uint8_t sequence_num = block - 1;
 		uint8_t p1 = BLOCK2GO_MORE_BLOCKS;
-		uint8_t data_len = block_len_max;
+		size_t data_len = chunk_len;
 
-		if (block == num_blocks)
+		if (data_length - offset <= chunk_len)
 		{
 			p1 = BLOCK2GO_LAST_BLOCK;
-			data_len = (uint8_t)data_length;
+			data_len = data_length - offset;
 		}
 
 		APDU apdu = { .cla = 0x00,
@@ -504,17 +1151,11 @@ int block2go_update_key_label (Protocol *protocol, uint8_t key_index,
 				.p1 = p1,
 				.p2 = sequence_num,
 				.lc = data_len,
-				.data = data + sequence_num * block_len_max,
+				.data = data + offset,
 				.le = 0x00 };
 
-		if (block < num_blocks)
-		{
-			/* decrease data_length accordingly */
-			data_length = data_length - block_len_max;
-		}
-
 		APDUResponse decoded;
-		status = exchange_apdu (protocol, &apdu, &decoded);
+		status = exchange_apdu (protocol, &apdu, received, &decoded);
 		if (status == APDURESPONSE_DECODE_SUCCESS)
 		{
 			if (decoded.sw != 0x9000)
@@ -532,15 +1173,16 @@ int block2go_update_key_label (Protocol *protocol, uint8_t key_index,
 			break;
 		}
 	}
-	free (data);
+	allocator_free (allocator, data);
 	return status;
 }
 
 /* GET KEY LABEL */
-int block2go_get_key_label (Protocol *protocol, uint8_t key_index,
-		uint8_t **key_label, uint16_t *key_label_length)
+int block2go_get_key_label_into (Protocol *protocol, uint8_t key_index,
+		uint8_t *key_label, uint16_t key_label_size,
+		uint16_t *key_label_length)
 {
-	*key_label = NULL;
+	*key_label_length = 0;
 
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x1F,
@@ -549,78 +1191,79 @@ int block2go_get_key_label (Protocol *protocol, uint8_t key_index,
 			.lc = 0x00,
 			.data = NULL,
 			.le = 0x00 };
-	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
 
-	uint16_t label_length = 0;
-	uint16_t label_received = 0;
-	if (status == APDURESPONSE_DECODE_SUCCESS)
+	/* Label is delivered in several occurances as long as SE answers 6310 */
+	uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN];
+	ProtocolSegment response = { .data = received, .len = sizeof (received) };
+	uint16_t sw = 0x6310;
+	while (sw == 0x6310)
 	{
-		if (decoded.sw == 0x9000 || decoded.sw == 0x6310)
+		size_t data_len;
+		int status = exchange_apdu_into (protocol, &apdu, &response, 1,
+				&data_len, &sw);
+		if (status != APDURESPONSE_DECODE_SUCCESS)
 		{
-			if (((decoded.data[0] << 8) | decoded.data[1]) != 0xDF1F)
-			{
-				status = BLOCK2GO_GET_KEY_LABEL_KEY_LABEL_TAG_MISSING;
-			}
-			else if (decoded.len == 0)
-			{
-				status = BLOCK2GO_GET_KEY_LABEL_INVALID_DATA_LENGTH;
-			}
-			else
-			{
-				size_t byte_length = 0;
-				get_label_length (decoded.data, &byte_length, &label_length);
-				*key_label = (uint8_t *)malloc (label_length);
-				memcpy (*key_label, decoded.data + 2 + byte_length,
-						label_length);
-				label_received += label_length;
-				*key_label_length += label_length;
-				while (decoded.sw == 0x9000 || decoded.sw == 0x6310)
-				{
-					if (decoded.sw == 0x9000)
-					{
-						apduresponse_destroy (&decoded);
-						return BLOCK2GO_GET_KEY_LABEL_SUCCESS;
-					}
-					else if (decoded.sw == 0x6310)
-					{
-						apdu.p2 = BLOCK2GO_NEXT_OCCURANCE;
-						status = exchange_apdu (protocol, &apdu, &decoded);
-						if (status == APDURESPONSE_DECODE_SUCCESS)
-						{
-							get_label_length (decoded.data, &byte_length,
-									&label_length);
-							*key_label_length += label_length;
-							*key_label = (uint8_t *)realloc (*key_label,
-									*key_label_length);
-							memcpy (*key_label + label_received,
-									decoded.data + 2 + byte_length,
-									label_length);
-							label_received += label_length;
-						}
-					}
-					else
-					{
-						apduresponse_destroy (&decoded);
-						return BLOCK2GO_GET_KEY_LABEL_FAIL;
-					}
-				}
-			}
+			return status;
 		}
-		else
+		if ((sw != 0x9000) && (sw != 0x6310))
 		{
-			apduresponse_destroy (&decoded);
 			return BLOCK2GO_GET_KEY_LABEL_FAIL;
 		}
+		if ((data_len < 3) || (((received[0] << 8) | received[1]) != 0xDF1F))
+		{
+			return BLOCK2GO_GET_KEY_LABEL_KEY_LABEL_TAG_MISSING;
+		}
+
+		size_t byte_length = 0;
+		uint16_t label_length = 0;
+		get_label_length (received, &byte_length, &label_length);
+		/* Announcing more without delivering any would never terminate */
+		if (((2 + byte_length + label_length) > data_len)
+				|| ((*key_label_length + label_length) > key_label_size)
+				|| ((label_length == 0) && (sw == 0x6310)))
+		{
+			return BLOCK2GO_GET_KEY_LABEL_INVALID_DATA_LENGTH;
+		}
+		memcpy (key_label + *key_label_length, received + 2 + byte_length,
+				label_length);
+		*key_label_length += label_length;
+		apdu.p2 = BLOCK2GO_NEXT_OCCURANCE;
 	}
-	apduresponse_destroy (&decoded);
+	return BLOCK2GO_GET_KEY_LABEL_SUCCESS;
+}
+
+int block2go_get_key_label (Protocol *protocol, uint8_t key_index,
+		uint8_t **key_label, uint16_t *key_label_length)
+{
+	*key_label = NULL;
+	protocol_reset_transaction_allocator (protocol);
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	uint8_t *buffer = (uint8_t *)allocator_malloc (allocator,
+			BLOCK2GO_KEY_LABEL_MAX_LEN);
+	if (buffer == NULL)
+	{
+		return IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_GET_KEY_LABEL, OUT_OF_MEMORY);
+	}
+
+	int status = block2go_get_key_label_into (protocol, key_index, buffer,
+			BLOCK2GO_KEY_LABEL_MAX_LEN, key_label_length);
+	if ((status != BLOCK2GO_GET_KEY_LABEL_SUCCESS) || (*key_label_length == 0))
+	{
+		allocator_free (allocator, buffer);
+		return status;
+	}
+
+	/* Give back unused space */
+	uint8_t *shrunk = (uint8_t *)allocator_realloc (allocator, buffer,
+			*key_label_length);
+	*key_label = (shrunk != NULL) ? shrunk : buffer;
 	return status;
 }
 
 /* GET RANDOM */
-int block2go_get_random (Protocol *protocol, uint8_t length, uint8_t **random_num)
+int block2go_get_random_into (Protocol *protocol, uint8_t length,
+		uint8_t *random_num)
 {
-
 	APDU apdu = { .cla = 0x00,
 			.ins = 0x1A,
 			.p1 = length,
@@ -628,26 +1271,53 @@ int block2go_get_random (Protocol *protocol, uint8_t length, uint8_t **random_nu
 			.lc = 0x00,
 			.data = NULL,
 			.le = 0 };
-	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+
+	/* Random number is received directly into caller storage */
+	uint8_t status_word[2];
+	ProtocolSegment response[2] = {
+			{ .data = random_num, .len = length },
+			{ .data = status_word, .len = sizeof (status_word) } };
+	size_t data_len;
+	uint16_t sw;
+	int status = exchange_apdu_into (protocol, &apdu, response, 2, &data_len,
+			&sw);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
-		if (decoded.sw != 0x9000)
+		if (sw != 0x9000)
 		{
 			status = BLOCK2GO_GET_RANDOM_FAIL;
 		}
-		else if (decoded.len != length)
+		else if (data_len != length)
 		{
 			status = BLOCK2GO_GET_RANDOM_INVALID_DATA_LENGTH;
 		}
 		else
 		{
-			*random_num = (uint8_t *)malloc (length);
-			memcpy (*random_num, decoded.data, length);
+			status = BLOCK2GO_GET_RANDOM_SUCCESS;
 		}
 	}
-	apduresponse_destroy (&decoded);
+	return status;
+}
+
+int block2go_get_random (Protocol *protocol, uint8_t length, uint8_t **random_num)
+{
+	*random_num = NULL;
+	protocol_reset_transaction_allocator (protocol);
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	uint8_t *buffer = (uint8_t *)allocator_malloc (allocator, length);
+	if (buffer == NULL)
+	{
+		return IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_GET_RANDOM, OUT_OF_MEMORY);
+	}
+
+	int status = block2go_get_random_into (protocol, length, buffer);
+	if (status != BLOCK2GO_GET_RANDOM_SUCCESS)
+	{
+		allocator_free (allocator, buffer);
+		return status;
+	}
+	*random_num = buffer;
 	return status;
 }
 
@@ -659,9 +1329,21 @@ int block2go_verify_signature (Protocol *protocol, block2go_curve curve,
 		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN])
 {
 
-	uint8_t signature_len = signature[1] + 2; /* + 6 from ANS.1 DER format */
-	uint8_t data_len = 1 + message_len + signature_len + BLOCK2GO_PUBLIC_KEY_LEN;
-	uint8_t *data = (uint8_t *)malloc (data_len);
+	protocol_reset_transaction_allocator (protocol);
+	size_t signature_len = signature[1] + 2; /* + 6 from ANS.1 DER format */
+	size_t data_len = 1 + message_len + signature_len + BLOCK2GO_PUBLIC_KEY_LEN;
+#if !BLOCK2GO_EXTENDED_LENGTH
+	if (data_len > 0xff)
+	{
+		return BLOCK2GO_VERIFY_SIGNATURE_ILLEGAL_ARGUMENT;
+	}
+#endif
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	uint8_t *data = (uint8_t *)allocator_malloc (allocator, data_len);
+	if (data == NULL)
+	{
+		return BLOCK2GO_VERIFY_SIGNATURE_OUT_OF_MEMORY;
+	}
 	data[0] = message_len;
 
 	memcpy (data + 1, message, message_len);
@@ -676,9 +1358,10 @@ int block2go_verify_signature (Protocol *protocol, block2go_curve curve,
 			.data = data,
 			.le = 0x00 };
 
+	uint8_t received[BLOCK2GO_RESPONSE_MAX_LEN];
 	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
-	free (data);
+	int status = exchange_apdu (protocol, &apdu, received, &decoded);
+	allocator_free (allocator, data);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
@@ -699,7 +1382,7 @@ int block2go_verify_signature (Protocol *protocol, block2go_curve curve,
 
 int block2go_enable_protected_mode (Protocol *protocol)
 {
-
+	protocol_reset_transaction_allocator (protocol);
 	APDU apdu = { .cla = 0x00,
 			.ins = 0xD0,
 			.p1 = 0x00,
@@ -708,16 +1391,25 @@ int block2go_enable_protected_mode (Protocol *protocol)
 			.data = NULL,
 			.le = 0x00 };
 
-	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	/* Only a status word is expected */
+	uint8_t status_word[2];
+	ProtocolSegment response = { .data = status_word,
+			.len = sizeof (status_word) };
+	const uint8_t *const frames[2] = { block2go_enable_protected_mode_frame[0],
+			block2go_enable_protected_mode_frame[1] };
+	size_t data_len;
+	uint16_t sw;
+	int status = exchange_frame_into (protocol, frames,
+			sizeof (block2go_enable_protected_mode_frame[0]), &apdu, &response,
+			1, &data_len, &sw);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
-		if (decoded.sw != 0x9000)
+		if (sw != 0x9000)
 		{
 			status = BLOCK2GO_ENABLE_PROTECTED_MODE_FAIL;
 		}
-		else if (decoded.len != 0)
+		else if (data_len != 0)
 		{
 			status = BLOCK2GO_ENABLE_PROTECTED_MODE_INVALID_DATA_LENGTH;
 		}
@@ -726,14 +1418,13 @@ int block2go_enable_protected_mode (Protocol *protocol)
 			status = BLOCK2GO_ENABLE_PROTECTED_MODE_SUCCESS;
 		}
 	}
-	apduresponse_destroy (&decoded);
 	return status;
 }
 
 /* GET STATUS */
 int block2go_get_status (Protocol *protocol, block2go_session_type *status_info)
 {
-
+	protocol_reset_transaction_allocator (protocol);
 	APDU apdu = { .cla = 0x00,
 			.ins = 0xB0,
 			.p1 = 0xDF,
@@ -742,25 +1433,35 @@ int block2go_get_status (Protocol *protocol, block2go_session_type *status_info)
 			.data = NULL,
 			.le = 0x00 };
 
-	APDUResponse decoded;
-	int status = exchange_apdu (protocol, &apdu, &decoded);
+	/* Session type and status word are received into stack buffers */
+	uint8_t session_type;
+	uint8_t status_word[2];
+	ProtocolSegment response[2] = {
+			{ .data = &session_type, .len = sizeof (session_type) },
+			{ .data = status_word, .len = sizeof (status_word) } };
+	const uint8_t *const frames[2] = { block2go_get_status_frame[0],
+			block2go_get_status_frame[1] };
+	size_t data_len;
+	uint16_t sw;
+	int status = exchange_frame_into (protocol, frames,
+			sizeof (block2go_get_status_frame[0]), &apdu, response, 2, &data_len,
+			&sw);
 
 	if (status == APDURESPONSE_DECODE_SUCCESS)
 	{
-		if (decoded.sw != 0x9000)
+		if (sw != 0x9000)
 		{
 			status = BLOCK2GO_GET_STATUS_FAIL;
 		}
-		else if (decoded.len != 1)
+		else if (data_len != 1)
 		{
 			status = BLOCK2GO_GET_STATUS_INVALID_DATA_LENGTH;
 		}
 		else
 		{
 			status = BLOCK2GO_GET_STATUS_SUCCESS;
-			*status_info = (block2go_session_type) * (decoded.data);
+			*status_info = (block2go_session_type)session_type;
 		}
 	}
-	apduresponse_destroy (&decoded);
 	return status;
 }
@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file clock-hal.c
+ * \brief System clock and timer based clock of firmware builds using the
+ * PSoC6 HAL
+ */
+#ifdef CY_USING_HAL
+
+#include <stddef.h>
+
+#include "cyhal.h"
+
+#include "bs2go/clock/clock.h"
+
+/**
+ * \brief Frequency of free running timer used as time source in [Hz]
+ */
+#define CLOCK_HAL_TIMER_FREQUENCY 1000000u
+
+/**
+ * \brief \ref clock_nowfunction_t of system clock
+ *
+ * \details No hardware timer is reserved for the system clock, install a
+ * \ref ClockHAL to measure time.
+ */
+int
+clock_system_now (void *context, uint64_t *now)
+{
+	(void)context;
+	(void)now;
+	return IFX_ERROR (LIBCLOCK, CLOCK_NOW, CLOCK_UNAVAILABLE);
+}
+
+/**
+ * \brief \ref clock_sleepfunction_t of system clock
+ */
+void
+clock_system_sleep (void *context, uint32_t duration)
+{
+	(void)context;
+	if (duration >= 1000u)
+	{
+		cyhal_system_delay_ms (duration / 1000u);
+	}
+	if ((duration % 1000u) > 0)
+	{
+		cyhal_system_delay_us ((uint16_t)(duration % 1000u));
+	}
+}
+
+/**
+ * \brief \ref clock_nowfunction_t for \ref ClockHAL
+ */
+static int
+clock_hal_now (void *context, uint64_t *now)
+{
+	ClockHAL *clock = (ClockHAL *)context;
+	uint32_t value = cyhal_timer_read (clock->timer);
+	if (value < clock->last)
+	{
+		clock->high += (uint64_t)clock->period + 1u;
+	}
+	clock->last = value;
+	*now = clock->high + value;
+	return CLOCK_NOW_SUCCESS;
+}
+
+/**
+ * \brief Initializes clock based on hardware timer
+ *
+ * \param clock Clock to be initialized
+ * \param timer Timer already initialized via `cyhal_timer_init()`
+ * \return int   CLOCK_HAL_INITIALIZE_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+clock_hal_initialize (ClockHAL *clock, cyhal_timer_t *timer)
+{
+	if ((clock == NULL) || (timer == NULL))
+	{
+		return IFX_ERROR (LIBCLOCK, CLOCK_HAL_INITIALIZE, ILLEGAL_ARGUMENT);
+	}
+
+	/* 32 bit period is rejected by 16 bit counters */
+	cyhal_timer_cfg_t config = { .is_continuous = true,
+			.direction = CYHAL_TIMER_DIR_UP,
+			.is_compare = false,
+			.period = 0xffffffffu,
+			.compare_value = 0,
+			.value = 0 };
+	if (cyhal_timer_configure (timer, &config) != CY_RSLT_SUCCESS)
+	{
+		config.period = 0xffffu;
+		if (cyhal_timer_configure (timer, &config) != CY_RSLT_SUCCESS)
+		{
+			return IFX_ERROR (LIBCLOCK, CLOCK_HAL_INITIALIZE, CLOCK_UNAVAILABLE);
+		}
+	}
+	if ((cyhal_timer_set_frequency (timer, CLOCK_HAL_TIMER_FREQUENCY)
+				!= CY_RSLT_SUCCESS)
+			|| (cyhal_timer_start (timer) != CY_RSLT_SUCCESS))
+	{
+		return IFX_ERROR (LIBCLOCK, CLOCK_HAL_INITIALIZE, CLOCK_UNAVAILABLE);
+	}
+
+	clock->clock.now = clock_hal_now;
+	clock->clock.sleep = clock_system_sleep;
+	clock->clock.context = clock;
+	clock->timer = timer;
+	clock->period = config.period;
+	clock->last = 0;
+	clock->high = 0;
+	return CLOCK_HAL_INITIALIZE_SUCCESS;
+}
+
+#endif /* CY_USING_HAL */
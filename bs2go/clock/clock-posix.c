@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file clock-posix.c
+ * \brief System clock of host builds based on POSIX monotonic clock
+ */
+#ifndef CY_USING_HAL
+
+#include <errno.h>
+#include <time.h>
+
+#include "bs2go/clock/clock.h"
+
+/**
+ * \brief \ref clock_nowfunction_t of system clock
+ */
+int
+clock_system_now (void *context, uint64_t *now)
+{
+	(void)context;
+	struct timespec time;
+	if (clock_gettime (CLOCK_MONOTONIC, &time) != 0)
+	{
+		return IFX_ERROR (LIBCLOCK, CLOCK_NOW, CLOCK_UNAVAILABLE);
+	}
+	*now = ((uint64_t)time.tv_sec * 1000000u) + ((uint64_t)time.tv_nsec / 1000u);
+	return CLOCK_NOW_SUCCESS;
+}
+
+/**
+ * \brief \ref clock_sleepfunction_t of system clock
+ */
+void
+clock_system_sleep (void *context, uint32_t duration)
+{
+	(void)context;
+	struct timespec delay = { .tv_sec = (time_t)(duration / 1000000u),
+			.tv_nsec = (long)(duration % 1000000u) * 1000 };
+	while ((nanosleep (&delay, &delay) != 0) && (errno == EINTR))
+	{
+	}
+}
+
+#endif /* CY_USING_HAL */
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file clock.c
+ * \brief Pluggable time source used by all modules of a protocol stack
+ */
+#include <stddef.h>
+
+#include "bs2go/clock/clock.h"
+
+/**
+ * \brief Reads current time
+ *
+ * \param clock Clock to be used (NULL for system clock)
+ * \param now Buffer to store monotonic time in [us] in (0 in case of error)
+ * \return int   CLOCK_NOW_SUCCESS if successful, any other value in case of
+ * error
+ */
+int
+clock_now (const Clock *clock, uint64_t *now)
+{
+	if (now == NULL)
+	{
+		return IFX_ERROR (LIBCLOCK, CLOCK_NOW, ILLEGAL_ARGUMENT);
+	}
+	int status = (clock == NULL) ? clock_system_now (NULL, now)
+			: clock->now (clock->context, now);
+	if (status != CLOCK_NOW_SUCCESS)
+	{
+		*now = 0;
+	}
+	return status;
+}
+
+/**
+ * \brief Waits for given time
+ *
+ * \param clock Clock to be used (NULL for system clock)
+ * \param duration Time to wait in [us]
+ */
+void
+clock_sleep (const Clock *clock, uint32_t duration)
+{
+	if (duration == 0)
+	{
+		return;
+	}
+	if (clock == NULL)
+	{
+		clock_system_sleep (NULL, duration);
+		return;
+	}
+	clock->sleep (clock->context, duration);
+}
+
+/**
+ * \brief \ref clock_nowfunction_t for \ref ClockVirtual
+ */
+static int
+clock_virtual_now (void *context, uint64_t *now)
+{
+	*now = ((ClockVirtual *)context)->now;
+	return CLOCK_NOW_SUCCESS;
+}
+
+/**
+ * \brief \ref clock_sleepfunction_t for \ref ClockVirtual
+ */
+static void
+clock_virtual_sleep (void *context, uint32_t duration)
+{
+	((ClockVirtual *)context)->now += duration;
+}
+
+/**
+ * \brief Initializes virtual clock starting at given time
+ *
+ * \param clock Virtual clock to be initialized
+ * \param start Initial time in [us]
+ * \return const Clock*   Clock hooks of virtual clock
+ */
+const Clock *
+clock_virtual_initialize (ClockVirtual *clock, uint64_t start)
+{
+	clock->clock.now = clock_virtual_now;
+	clock->clock.sleep = clock_virtual_sleep;
+	clock->clock.context = clock;
+	clock->now = start;
+	return &clock->clock;
+}
+
+/**
+ * \brief Advances virtual clock without sleeping on it
+ *
+ * \param clock Virtual clock to be advanced
+ * \param duration Time to be added in [us]
+ */
+void
+clock_virtual_advance (ClockVirtual *clock, uint64_t duration)
+{
+	clock->now += duration;
+}
@@ -26,58 +26,674 @@
  * \file crc.c
  * \brief Reusable CRC algorithms
  */
+#include <stdbool.h>
+
 #include "bs2go/crc/crc.h"
 
+#if CRC16_CLMUL
+#include <immintrin.h>
+#endif
+
+#if (CRC16_SLICE_BY != 0) && (CRC16_SLICE_BY != 1) && (CRC16_SLICE_BY != 4) \
+		&& (CRC16_SLICE_BY != 8)
+#error "CRC16_SLICE_BY must be one of 0, 1, 4 or 8"
+#endif
+
 /**
- * \brief Calculates 16 bit CRC according to CCITT x.25 specification.
+ * \brief Reflected polynomial used by CCITT x.25 and MCRF4xx
+ */
+#define CRC16_POLYNOMIAL_CCITT 0x8408
+
+/**
+ * \brief Reflected polynomial effectively used by G+D T=1
+ *
+ * \details The original bit-serial implementation XORs 0x10810 into a 16 bit
+ * register before shifting, so only 0x0810 takes effect which equals a
+ * reflected polynomial of 0x0408.
+ */
+#define CRC16_POLYNOMIAL_T1GD 0x0408
+
+#if CRC16_SLICE_BY > 0
+
+/**
+ * \brief Number of lookup tables per polynomial for selected engine
+ */
+#define CRC16_TABLE_COUNT CRC16_SLICE_BY
+
+/*
+ * Lookup tables for reflected 16 bit CRCs.
+ *
+ * Table [0] holds the register value after shifting in a single byte, table
+ * [k] the value after shifting in that byte followed by k zero bytes:
+ *   table[0][i] = 8 bit-serial steps over i
+ *   table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff]
  *
+ * Generated by tests/test_crc_tables.c (run with -p), which also checks on
+ * every host test run that the values below still match.
+ */
+static const uint16_t crc16_table_8408[CRC16_TABLE_COUNT][256] = {
+	{
+		0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
+		0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
+		0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
+		0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
+		0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
+		0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
+		0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
+		0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
+		0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
+		0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
+		0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
+		0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
+		0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
+		0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
+		0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
+		0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
+		0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
+		0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
+		0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
+		0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
+		0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
+		0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
+		0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
+		0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
+		0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
+		0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
+		0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
+		0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
+		0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
+		0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
+		0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
+		0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78,
+	},
+#if CRC16_SLICE_BY >= 4
+	{
+		0x0000, 0x19d8, 0x33b0, 0x2a68, 0x6760, 0x7eb8, 0x54d0, 0x4d08,
+		0xcec0, 0xd718, 0xfd70, 0xe4a8, 0xa9a0, 0xb078, 0x9a10, 0x83c8,
+		0x9591, 0x8c49, 0xa621, 0xbff9, 0xf2f1, 0xeb29, 0xc141, 0xd899,
+		0x5b51, 0x4289, 0x68e1, 0x7139, 0x3c31, 0x25e9, 0x0f81, 0x1659,
+		0x2333, 0x3aeb, 0x1083, 0x095b, 0x4453, 0x5d8b, 0x77e3, 0x6e3b,
+		0xedf3, 0xf42b, 0xde43, 0xc79b, 0x8a93, 0x934b, 0xb923, 0xa0fb,
+		0xb6a2, 0xaf7a, 0x8512, 0x9cca, 0xd1c2, 0xc81a, 0xe272, 0xfbaa,
+		0x7862, 0x61ba, 0x4bd2, 0x520a, 0x1f02, 0x06da, 0x2cb2, 0x356a,
+		0x4666, 0x5fbe, 0x75d6, 0x6c0e, 0x2106, 0x38de, 0x12b6, 0x0b6e,
+		0x88a6, 0x917e, 0xbb16, 0xa2ce, 0xefc6, 0xf61e, 0xdc76, 0xc5ae,
+		0xd3f7, 0xca2f, 0xe047, 0xf99f, 0xb497, 0xad4f, 0x8727, 0x9eff,
+		0x1d37, 0x04ef, 0x2e87, 0x375f, 0x7a57, 0x638f, 0x49e7, 0x503f,
+		0x6555, 0x7c8d, 0x56e5, 0x4f3d, 0x0235, 0x1bed, 0x3185, 0x285d,
+		0xab95, 0xb24d, 0x9825, 0x81fd, 0xccf5, 0xd52d, 0xff45, 0xe69d,
+		0xf0c4, 0xe91c, 0xc374, 0xdaac, 0x97a4, 0x8e7c, 0xa414, 0xbdcc,
+		0x3e04, 0x27dc, 0x0db4, 0x146c, 0x5964, 0x40bc, 0x6ad4, 0x730c,
+		0x8ccc, 0x9514, 0xbf7c, 0xa6a4, 0xebac, 0xf274, 0xd81c, 0xc1c4,
+		0x420c, 0x5bd4, 0x71bc, 0x6864, 0x256c, 0x3cb4, 0x16dc, 0x0f04,
+		0x195d, 0x0085, 0x2aed, 0x3335, 0x7e3d, 0x67e5, 0x4d8d, 0x5455,
+		0xd79d, 0xce45, 0xe42d, 0xfdf5, 0xb0fd, 0xa925, 0x834d, 0x9a95,
+		0xafff, 0xb627, 0x9c4f, 0x8597, 0xc89f, 0xd147, 0xfb2f, 0xe2f7,
+		0x613f, 0x78e7, 0x528f, 0x4b57, 0x065f, 0x1f87, 0x35ef, 0x2c37,
+		0x3a6e, 0x23b6, 0x09de, 0x1006, 0x5d0e, 0x44d6, 0x6ebe, 0x7766,
+		0xf4ae, 0xed76, 0xc71e, 0xdec6, 0x93ce, 0x8a16, 0xa07e, 0xb9a6,
+		0xcaaa, 0xd372, 0xf91a, 0xe0c2, 0xadca, 0xb412, 0x9e7a, 0x87a2,
+		0x046a, 0x1db2, 0x37da, 0x2e02, 0x630a, 0x7ad2, 0x50ba, 0x4962,
+		0x5f3b, 0x46e3, 0x6c8b, 0x7553, 0x385b, 0x2183, 0x0beb, 0x1233,
+		0x91fb, 0x8823, 0xa24b, 0xbb93, 0xf69b, 0xef43, 0xc52b, 0xdcf3,
+		0xe999, 0xf041, 0xda29, 0xc3f1, 0x8ef9, 0x9721, 0xbd49, 0xa491,
+		0x2759, 0x3e81, 0x14e9, 0x0d31, 0x4039, 0x59e1, 0x7389, 0x6a51,
+		0x7c08, 0x65d0, 0x4fb8, 0x5660, 0x1b68, 0x02b0, 0x28d8, 0x3100,
+		0xb2c8, 0xab10, 0x8178, 0x98a0, 0xd5a8, 0xcc70, 0xe618, 0xffc0,
+	},
+	{
+		0x0000, 0x5adc, 0xb5b8, 0xef64, 0x6361, 0x39bd, 0xd6d9, 0x8c05,
+		0xc6c2, 0x9c1e, 0x737a, 0x29a6, 0xa5a3, 0xff7f, 0x101b, 0x4ac7,
+		0x8595, 0xdf49, 0x302d, 0x6af1, 0xe6f4, 0xbc28, 0x534c, 0x0990,
+		0x4357, 0x198b, 0xf6ef, 0xac33, 0x2036, 0x7aea, 0x958e, 0xcf52,
+		0x033b, 0x59e7, 0xb683, 0xec5f, 0x605a, 0x3a86, 0xd5e2, 0x8f3e,
+		0xc5f9, 0x9f25, 0x7041, 0x2a9d, 0xa698, 0xfc44, 0x1320, 0x49fc,
+		0x86ae, 0xdc72, 0x3316, 0x69ca, 0xe5cf, 0xbf13, 0x5077, 0x0aab,
+		0x406c, 0x1ab0, 0xf5d4, 0xaf08, 0x230d, 0x79d1, 0x96b5, 0xcc69,
+		0x0676, 0x5caa, 0xb3ce, 0xe912, 0x6517, 0x3fcb, 0xd0af, 0x8a73,
+		0xc0b4, 0x9a68, 0x750c, 0x2fd0, 0xa3d5, 0xf909, 0x166d, 0x4cb1,
+		0x83e3, 0xd93f, 0x365b, 0x6c87, 0xe082, 0xba5e, 0x553a, 0x0fe6,
+		0x4521, 0x1ffd, 0xf099, 0xaa45, 0x2640, 0x7c9c, 0x93f8, 0xc924,
+		0x054d, 0x5f91, 0xb0f5, 0xea29, 0x662c, 0x3cf0, 0xd394, 0x8948,
+		0xc38f, 0x9953, 0x7637, 0x2ceb, 0xa0ee, 0xfa32, 0x1556, 0x4f8a,
+		0x80d8, 0xda04, 0x3560, 0x6fbc, 0xe3b9, 0xb965, 0x5601, 0x0cdd,
+		0x461a, 0x1cc6, 0xf3a2, 0xa97e, 0x257b, 0x7fa7, 0x90c3, 0xca1f,
+		0x0cec, 0x5630, 0xb954, 0xe388, 0x6f8d, 0x3551, 0xda35, 0x80e9,
+		0xca2e, 0x90f2, 0x7f96, 0x254a, 0xa94f, 0xf393, 0x1cf7, 0x462b,
+		0x8979, 0xd3a5, 0x3cc1, 0x661d, 0xea18, 0xb0c4, 0x5fa0, 0x057c,
+		0x4fbb, 0x1567, 0xfa03, 0xa0df, 0x2cda, 0x7606, 0x9962, 0xc3be,
+		0x0fd7, 0x550b, 0xba6f, 0xe0b3, 0x6cb6, 0x366a, 0xd90e, 0x83d2,
+		0xc915, 0x93c9, 0x7cad, 0x2671, 0xaa74, 0xf0a8, 0x1fcc, 0x4510,
+		0x8a42, 0xd09e, 0x3ffa, 0x6526, 0xe923, 0xb3ff, 0x5c9b, 0x0647,
+		0x4c80, 0x165c, 0xf938, 0xa3e4, 0x2fe1, 0x753d, 0x9a59, 0xc085,
+		0x0a9a, 0x5046, 0xbf22, 0xe5fe, 0x69fb, 0x3327, 0xdc43, 0x869f,
+		0xcc58, 0x9684, 0x79e0, 0x233c, 0xaf39, 0xf5e5, 0x1a81, 0x405d,
+		0x8f0f, 0xd5d3, 0x3ab7, 0x606b, 0xec6e, 0xb6b2, 0x59d6, 0x030a,
+		0x49cd, 0x1311, 0xfc75, 0xa6a9, 0x2aac, 0x7070, 0x9f14, 0xc5c8,
+		0x09a1, 0x537d, 0xbc19, 0xe6c5, 0x6ac0, 0x301c, 0xdf78, 0x85a4,
+		0xcf63, 0x95bf, 0x7adb, 0x2007, 0xac02, 0xf6de, 0x19ba, 0x4366,
+		0x8c34, 0xd6e8, 0x398c, 0x6350, 0xef55, 0xb589, 0x5aed, 0x0031,
+		0x4af6, 0x102a, 0xff4e, 0xa592, 0x2997, 0x734b, 0x9c2f, 0xc6f3,
+	},
+	{
+		0x0000, 0x1cbb, 0x3976, 0x25cd, 0x72ec, 0x6e57, 0x4b9a, 0x5721,
+		0xe5d8, 0xf963, 0xdcae, 0xc015, 0x9734, 0x8b8f, 0xae42, 0xb2f9,
+		0xc3a1, 0xdf1a, 0xfad7, 0xe66c, 0xb14d, 0xadf6, 0x883b, 0x9480,
+		0x2679, 0x3ac2, 0x1f0f, 0x03b4, 0x5495, 0x482e, 0x6de3, 0x7158,
+		0x8f53, 0x93e8, 0xb625, 0xaa9e, 0xfdbf, 0xe104, 0xc4c9, 0xd872,
+		0x6a8b, 0x7630, 0x53fd, 0x4f46, 0x1867, 0x04dc, 0x2111, 0x3daa,
+		0x4cf2, 0x5049, 0x7584, 0x693f, 0x3e1e, 0x22a5, 0x0768, 0x1bd3,
+		0xa92a, 0xb591, 0x905c, 0x8ce7, 0xdbc6, 0xc77d, 0xe2b0, 0xfe0b,
+		0x16b7, 0x0a0c, 0x2fc1, 0x337a, 0x645b, 0x78e0, 0x5d2d, 0x4196,
+		0xf36f, 0xefd4, 0xca19, 0xd6a2, 0x8183, 0x9d38, 0xb8f5, 0xa44e,
+		0xd516, 0xc9ad, 0xec60, 0xf0db, 0xa7fa, 0xbb41, 0x9e8c, 0x8237,
+		0x30ce, 0x2c75, 0x09b8, 0x1503, 0x4222, 0x5e99, 0x7b54, 0x67ef,
+		0x99e4, 0x855f, 0xa092, 0xbc29, 0xeb08, 0xf7b3, 0xd27e, 0xcec5,
+		0x7c3c, 0x6087, 0x454a, 0x59f1, 0x0ed0, 0x126b, 0x37a6, 0x2b1d,
+		0x5a45, 0x46fe, 0x6333, 0x7f88, 0x28a9, 0x3412, 0x11df, 0x0d64,
+		0xbf9d, 0xa326, 0x86eb, 0x9a50, 0xcd71, 0xd1ca, 0xf407, 0xe8bc,
+		0x2d6e, 0x31d5, 0x1418, 0x08a3, 0x5f82, 0x4339, 0x66f4, 0x7a4f,
+		0xc8b6, 0xd40d, 0xf1c0, 0xed7b, 0xba5a, 0xa6e1, 0x832c, 0x9f97,
+		0xeecf, 0xf274, 0xd7b9, 0xcb02, 0x9c23, 0x8098, 0xa555, 0xb9ee,
+		0x0b17, 0x17ac, 0x3261, 0x2eda, 0x79fb, 0x6540, 0x408d, 0x5c36,
+		0xa23d, 0xbe86, 0x9b4b, 0x87f0, 0xd0d1, 0xcc6a, 0xe9a7, 0xf51c,
+		0x47e5, 0x5b5e, 0x7e93, 0x6228, 0x3509, 0x29b2, 0x0c7f, 0x10c4,
+		0x619c, 0x7d27, 0x58ea, 0x4451, 0x1370, 0x0fcb, 0x2a06, 0x36bd,
+		0x8444, 0x98ff, 0xbd32, 0xa189, 0xf6a8, 0xea13, 0xcfde, 0xd365,
+		0x3bd9, 0x2762, 0x02af, 0x1e14, 0x4935, 0x558e, 0x7043, 0x6cf8,
+		0xde01, 0xc2ba, 0xe777, 0xfbcc, 0xaced, 0xb056, 0x959b, 0x8920,
+		0xf878, 0xe4c3, 0xc10e, 0xddb5, 0x8a94, 0x962f, 0xb3e2, 0xaf59,
+		0x1da0, 0x011b, 0x24d6, 0x386d, 0x6f4c, 0x73f7, 0x563a, 0x4a81,
+		0xb48a, 0xa831, 0x8dfc, 0x9147, 0xc666, 0xdadd, 0xff10, 0xe3ab,
+		0x5152, 0x4de9, 0x6824, 0x749f, 0x23be, 0x3f05, 0x1ac8, 0x0673,
+		0x772b, 0x6b90, 0x4e5d, 0x52e6, 0x05c7, 0x197c, 0x3cb1, 0x200a,
+		0x92f3, 0x8e48, 0xab85, 0xb73e, 0xe01f, 0xfca4, 0xd969, 0xc5d2,
+	},
+#endif
+#if CRC16_SLICE_BY >= 8
+	{
+		0x0000, 0x0b44, 0x1688, 0x1dcc, 0x2d10, 0x2654, 0x3b98, 0x30dc,
+		0x5a20, 0x5164, 0x4ca8, 0x47ec, 0x7730, 0x7c74, 0x61b8, 0x6afc,
+		0xb440, 0xbf04, 0xa2c8, 0xa98c, 0x9950, 0x9214, 0x8fd8, 0x849c,
+		0xee60, 0xe524, 0xf8e8, 0xf3ac, 0xc370, 0xc834, 0xd5f8, 0xdebc,
+		0x6091, 0x6bd5, 0x7619, 0x7d5d, 0x4d81, 0x46c5, 0x5b09, 0x504d,
+		0x3ab1, 0x31f5, 0x2c39, 0x277d, 0x17a1, 0x1ce5, 0x0129, 0x0a6d,
+		0xd4d1, 0xdf95, 0xc259, 0xc91d, 0xf9c1, 0xf285, 0xef49, 0xe40d,
+		0x8ef1, 0x85b5, 0x9879, 0x933d, 0xa3e1, 0xa8a5, 0xb569, 0xbe2d,
+		0xc122, 0xca66, 0xd7aa, 0xdcee, 0xec32, 0xe776, 0xfaba, 0xf1fe,
+		0x9b02, 0x9046, 0x8d8a, 0x86ce, 0xb612, 0xbd56, 0xa09a, 0xabde,
+		0x7562, 0x7e26, 0x63ea, 0x68ae, 0x5872, 0x5336, 0x4efa, 0x45be,
+		0x2f42, 0x2406, 0x39ca, 0x328e, 0x0252, 0x0916, 0x14da, 0x1f9e,
+		0xa1b3, 0xaaf7, 0xb73b, 0xbc7f, 0x8ca3, 0x87e7, 0x9a2b, 0x916f,
+		0xfb93, 0xf0d7, 0xed1b, 0xe65f, 0xd683, 0xddc7, 0xc00b, 0xcb4f,
+		0x15f3, 0x1eb7, 0x037b, 0x083f, 0x38e3, 0x33a7, 0x2e6b, 0x252f,
+		0x4fd3, 0x4497, 0x595b, 0x521f, 0x62c3, 0x6987, 0x744b, 0x7f0f,
+		0x8a55, 0x8111, 0x9cdd, 0x9799, 0xa745, 0xac01, 0xb1cd, 0xba89,
+		0xd075, 0xdb31, 0xc6fd, 0xcdb9, 0xfd65, 0xf621, 0xebed, 0xe0a9,
+		0x3e15, 0x3551, 0x289d, 0x23d9, 0x1305, 0x1841, 0x058d, 0x0ec9,
+		0x6435, 0x6f71, 0x72bd, 0x79f9, 0x4925, 0x4261, 0x5fad, 0x54e9,
+		0xeac4, 0xe180, 0xfc4c, 0xf708, 0xc7d4, 0xcc90, 0xd15c, 0xda18,
+		0xb0e4, 0xbba0, 0xa66c, 0xad28, 0x9df4, 0x96b0, 0x8b7c, 0x8038,
+		0x5e84, 0x55c0, 0x480c, 0x4348, 0x7394, 0x78d0, 0x651c, 0x6e58,
+		0x04a4, 0x0fe0, 0x122c, 0x1968, 0x29b4, 0x22f0, 0x3f3c, 0x3478,
+		0x4b77, 0x4033, 0x5dff, 0x56bb, 0x6667, 0x6d23, 0x70ef, 0x7bab,
+		0x1157, 0x1a13, 0x07df, 0x0c9b, 0x3c47, 0x3703, 0x2acf, 0x218b,
+		0xff37, 0xf473, 0xe9bf, 0xe2fb, 0xd227, 0xd963, 0xc4af, 0xcfeb,
+		0xa517, 0xae53, 0xb39f, 0xb8db, 0x8807, 0x8343, 0x9e8f, 0x95cb,
+		0x2be6, 0x20a2, 0x3d6e, 0x362a, 0x06f6, 0x0db2, 0x107e, 0x1b3a,
+		0x71c6, 0x7a82, 0x674e, 0x6c0a, 0x5cd6, 0x5792, 0x4a5e, 0x411a,
+		0x9fa6, 0x94e2, 0x892e, 0x826a, 0xb2b6, 0xb9f2, 0xa43e, 0xaf7a,
+		0xc586, 0xcec2, 0xd30e, 0xd84a, 0xe896, 0xe3d2, 0xfe1e, 0xf55a,
+	},
+	{
+		0x0000, 0x042b, 0x0856, 0x0c7d, 0x10ac, 0x1487, 0x18fa, 0x1cd1,
+		0x2158, 0x2573, 0x290e, 0x2d25, 0x31f4, 0x35df, 0x39a2, 0x3d89,
+		0x42b0, 0x469b, 0x4ae6, 0x4ecd, 0x521c, 0x5637, 0x5a4a, 0x5e61,
+		0x63e8, 0x67c3, 0x6bbe, 0x6f95, 0x7344, 0x776f, 0x7b12, 0x7f39,
+		0x8560, 0x814b, 0x8d36, 0x891d, 0x95cc, 0x91e7, 0x9d9a, 0x99b1,
+		0xa438, 0xa013, 0xac6e, 0xa845, 0xb494, 0xb0bf, 0xbcc2, 0xb8e9,
+		0xc7d0, 0xc3fb, 0xcf86, 0xcbad, 0xd77c, 0xd357, 0xdf2a, 0xdb01,
+		0xe688, 0xe2a3, 0xeede, 0xeaf5, 0xf624, 0xf20f, 0xfe72, 0xfa59,
+		0x02d1, 0x06fa, 0x0a87, 0x0eac, 0x127d, 0x1656, 0x1a2b, 0x1e00,
+		0x2389, 0x27a2, 0x2bdf, 0x2ff4, 0x3325, 0x370e, 0x3b73, 0x3f58,
+		0x4061, 0x444a, 0x4837, 0x4c1c, 0x50cd, 0x54e6, 0x589b, 0x5cb0,
+		0x6139, 0x6512, 0x696f, 0x6d44, 0x7195, 0x75be, 0x79c3, 0x7de8,
+		0x87b1, 0x839a, 0x8fe7, 0x8bcc, 0x971d, 0x9336, 0x9f4b, 0x9b60,
+		0xa6e9, 0xa2c2, 0xaebf, 0xaa94, 0xb645, 0xb26e, 0xbe13, 0xba38,
+		0xc501, 0xc12a, 0xcd57, 0xc97c, 0xd5ad, 0xd186, 0xddfb, 0xd9d0,
+		0xe459, 0xe072, 0xec0f, 0xe824, 0xf4f5, 0xf0de, 0xfca3, 0xf888,
+		0x05a2, 0x0189, 0x0df4, 0x09df, 0x150e, 0x1125, 0x1d58, 0x1973,
+		0x24fa, 0x20d1, 0x2cac, 0x2887, 0x3456, 0x307d, 0x3c00, 0x382b,
+		0x4712, 0x4339, 0x4f44, 0x4b6f, 0x57be, 0x5395, 0x5fe8, 0x5bc3,
+		0x664a, 0x6261, 0x6e1c, 0x6a37, 0x76e6, 0x72cd, 0x7eb0, 0x7a9b,
+		0x80c2, 0x84e9, 0x8894, 0x8cbf, 0x906e, 0x9445, 0x9838, 0x9c13,
+		0xa19a, 0xa5b1, 0xa9cc, 0xade7, 0xb136, 0xb51d, 0xb960, 0xbd4b,
+		0xc272, 0xc659, 0xca24, 0xce0f, 0xd2de, 0xd6f5, 0xda88, 0xdea3,
+		0xe32a, 0xe701, 0xeb7c, 0xef57, 0xf386, 0xf7ad, 0xfbd0, 0xfffb,
+		0x0773, 0x0358, 0x0f25, 0x0b0e, 0x17df, 0x13f4, 0x1f89, 0x1ba2,
+		0x262b, 0x2200, 0x2e7d, 0x2a56, 0x3687, 0x32ac, 0x3ed1, 0x3afa,
+		0x45c3, 0x41e8, 0x4d95, 0x49be, 0x556f, 0x5144, 0x5d39, 0x5912,
+		0x649b, 0x60b0, 0x6ccd, 0x68e6, 0x7437, 0x701c, 0x7c61, 0x784a,
+		0x8213, 0x8638, 0x8a45, 0x8e6e, 0x92bf, 0x9694, 0x9ae9, 0x9ec2,
+		0xa34b, 0xa760, 0xab1d, 0xaf36, 0xb3e7, 0xb7cc, 0xbbb1, 0xbf9a,
+		0xc0a3, 0xc488, 0xc8f5, 0xccde, 0xd00f, 0xd424, 0xd859, 0xdc72,
+		0xe1fb, 0xe5d0, 0xe9ad, 0xed86, 0xf157, 0xf57c, 0xf901, 0xfd2a,
+	},
+	{
+		0x0000, 0x9fd5, 0x37bb, 0xa86e, 0x6f76, 0xf0a3, 0x58cd, 0xc718,
+		0xdeec, 0x4139, 0xe957, 0x7682, 0xb19a, 0x2e4f, 0x8621, 0x19f4,
+		0xb5c9, 0x2a1c, 0x8272, 0x1da7, 0xdabf, 0x456a, 0xed04, 0x72d1,
+		0x6b25, 0xf4f0, 0x5c9e, 0xc34b, 0x0453, 0x9b86, 0x33e8, 0xac3d,
+		0x6383, 0xfc56, 0x5438, 0xcbed, 0x0cf5, 0x9320, 0x3b4e, 0xa49b,
+		0xbd6f, 0x22ba, 0x8ad4, 0x1501, 0xd219, 0x4dcc, 0xe5a2, 0x7a77,
+		0xd64a, 0x499f, 0xe1f1, 0x7e24, 0xb93c, 0x26e9, 0x8e87, 0x1152,
+		0x08a6, 0x9773, 0x3f1d, 0xa0c8, 0x67d0, 0xf805, 0x506b, 0xcfbe,
+		0xc706, 0x58d3, 0xf0bd, 0x6f68, 0xa870, 0x37a5, 0x9fcb, 0x001e,
+		0x19ea, 0x863f, 0x2e51, 0xb184, 0x769c, 0xe949, 0x4127, 0xdef2,
+		0x72cf, 0xed1a, 0x4574, 0xdaa1, 0x1db9, 0x826c, 0x2a02, 0xb5d7,
+		0xac23, 0x33f6, 0x9b98, 0x044d, 0xc355, 0x5c80, 0xf4ee, 0x6b3b,
+		0xa485, 0x3b50, 0x933e, 0x0ceb, 0xcbf3, 0x5426, 0xfc48, 0x639d,
+		0x7a69, 0xe5bc, 0x4dd2, 0xd207, 0x151f, 0x8aca, 0x22a4, 0xbd71,
+		0x114c, 0x8e99, 0x26f7, 0xb922, 0x7e3a, 0xe1ef, 0x4981, 0xd654,
+		0xcfa0, 0x5075, 0xf81b, 0x67ce, 0xa0d6, 0x3f03, 0x976d, 0x08b8,
+		0x861d, 0x19c8, 0xb1a6, 0x2e73, 0xe96b, 0x76be, 0xded0, 0x4105,
+		0x58f1, 0xc724, 0x6f4a, 0xf09f, 0x3787, 0xa852, 0x003c, 0x9fe9,
+		0x33d4, 0xac01, 0x046f, 0x9bba, 0x5ca2, 0xc377, 0x6b19, 0xf4cc,
+		0xed38, 0x72ed, 0xda83, 0x4556, 0x824e, 0x1d9b, 0xb5f5, 0x2a20,
+		0xe59e, 0x7a4b, 0xd225, 0x4df0, 0x8ae8, 0x153d, 0xbd53, 0x2286,
+		0x3b72, 0xa4a7, 0x0cc9, 0x931c, 0x5404, 0xcbd1, 0x63bf, 0xfc6a,
+		0x5057, 0xcf82, 0x67ec, 0xf839, 0x3f21, 0xa0f4, 0x089a, 0x974f,
+		0x8ebb, 0x116e, 0xb900, 0x26d5, 0xe1cd, 0x7e18, 0xd676, 0x49a3,
+		0x411b, 0xdece, 0x76a0, 0xe975, 0x2e6d, 0xb1b8, 0x19d6, 0x8603,
+		0x9ff7, 0x0022, 0xa84c, 0x3799, 0xf081, 0x6f54, 0xc73a, 0x58ef,
+		0xf4d2, 0x6b07, 0xc369, 0x5cbc, 0x9ba4, 0x0471, 0xac1f, 0x33ca,
+		0x2a3e, 0xb5eb, 0x1d85, 0x8250, 0x4548, 0xda9d, 0x72f3, 0xed26,
+		0x2298, 0xbd4d, 0x1523, 0x8af6, 0x4dee, 0xd23b, 0x7a55, 0xe580,
+		0xfc74, 0x63a1, 0xcbcf, 0x541a, 0x9302, 0x0cd7, 0xa4b9, 0x3b6c,
+		0x9751, 0x0884, 0xa0ea, 0x3f3f, 0xf827, 0x67f2, 0xcf9c, 0x5049,
+		0x49bd, 0xd668, 0x7e06, 0xe1d3, 0x26cb, 0xb91e, 0x1170, 0x8ea5,
+	},
+	{
+		0x0000, 0x81bf, 0x0b6f, 0x8ad0, 0x16de, 0x9761, 0x1db1, 0x9c0e,
+		0x2dbc, 0xac03, 0x26d3, 0xa76c, 0x3b62, 0xbadd, 0x300d, 0xb1b2,
+		0x5b78, 0xdac7, 0x5017, 0xd1a8, 0x4da6, 0xcc19, 0x46c9, 0xc776,
+		0x76c4, 0xf77b, 0x7dab, 0xfc14, 0x601a, 0xe1a5, 0x6b75, 0xeaca,
+		0xb6f0, 0x374f, 0xbd9f, 0x3c20, 0xa02e, 0x2191, 0xab41, 0x2afe,
+		0x9b4c, 0x1af3, 0x9023, 0x119c, 0x8d92, 0x0c2d, 0x86fd, 0x0742,
+		0xed88, 0x6c37, 0xe6e7, 0x6758, 0xfb56, 0x7ae9, 0xf039, 0x7186,
+		0xc034, 0x418b, 0xcb5b, 0x4ae4, 0xd6ea, 0x5755, 0xdd85, 0x5c3a,
+		0x65f1, 0xe44e, 0x6e9e, 0xef21, 0x732f, 0xf290, 0x7840, 0xf9ff,
+		0x484d, 0xc9f2, 0x4322, 0xc29d, 0x5e93, 0xdf2c, 0x55fc, 0xd443,
+		0x3e89, 0xbf36, 0x35e6, 0xb459, 0x2857, 0xa9e8, 0x2338, 0xa287,
+		0x1335, 0x928a, 0x185a, 0x99e5, 0x05eb, 0x8454, 0x0e84, 0x8f3b,
+		0xd301, 0x52be, 0xd86e, 0x59d1, 0xc5df, 0x4460, 0xceb0, 0x4f0f,
+		0xfebd, 0x7f02, 0xf5d2, 0x746d, 0xe863, 0x69dc, 0xe30c, 0x62b3,
+		0x8879, 0x09c6, 0x8316, 0x02a9, 0x9ea7, 0x1f18, 0x95c8, 0x1477,
+		0xa5c5, 0x247a, 0xaeaa, 0x2f15, 0xb31b, 0x32a4, 0xb874, 0x39cb,
+		0xcbe2, 0x4a5d, 0xc08d, 0x4132, 0xdd3c, 0x5c83, 0xd653, 0x57ec,
+		0xe65e, 0x67e1, 0xed31, 0x6c8e, 0xf080, 0x713f, 0xfbef, 0x7a50,
+		0x909a, 0x1125, 0x9bf5, 0x1a4a, 0x8644, 0x07fb, 0x8d2b, 0x0c94,
+		0xbd26, 0x3c99, 0xb649, 0x37f6, 0xabf8, 0x2a47, 0xa097, 0x2128,
+		0x7d12, 0xfcad, 0x767d, 0xf7c2, 0x6bcc, 0xea73, 0x60a3, 0xe11c,
+		0x50ae, 0xd111, 0x5bc1, 0xda7e, 0x4670, 0xc7cf, 0x4d1f, 0xcca0,
+		0x266a, 0xa7d5, 0x2d05, 0xacba, 0x30b4, 0xb10b, 0x3bdb, 0xba64,
+		0x0bd6, 0x8a69, 0x00b9, 0x8106, 0x1d08, 0x9cb7, 0x1667, 0x97d8,
+		0xae13, 0x2fac, 0xa57c, 0x24c3, 0xb8cd, 0x3972, 0xb3a2, 0x321d,
+		0x83af, 0x0210, 0x88c0, 0x097f, 0x9571, 0x14ce, 0x9e1e, 0x1fa1,
+		0xf56b, 0x74d4, 0xfe04, 0x7fbb, 0xe3b5, 0x620a, 0xe8da, 0x6965,
+		0xd8d7, 0x5968, 0xd3b8, 0x5207, 0xce09, 0x4fb6, 0xc566, 0x44d9,
+		0x18e3, 0x995c, 0x138c, 0x9233, 0x0e3d, 0x8f82, 0x0552, 0x84ed,
+		0x355f, 0xb4e0, 0x3e30, 0xbf8f, 0x2381, 0xa23e, 0x28ee, 0xa951,
+		0x439b, 0xc224, 0x48f4, 0xc94b, 0x5545, 0xd4fa, 0x5e2a, 0xdf95,
+		0x6e27, 0xef98, 0x6548, 0xe4f7, 0x78f9, 0xf946, 0x7396, 0xf229,
+	},
+#endif
+};
+
+static const uint16_t crc16_table_0408[CRC16_TABLE_COUNT][256] = {
+	{
+		0x0000, 0x0089, 0x0112, 0x019b, 0x0224, 0x02ad, 0x0336, 0x03bf,
+		0x0448, 0x04c1, 0x055a, 0x05d3, 0x066c, 0x06e5, 0x077e, 0x07f7,
+		0x0081, 0x0008, 0x0193, 0x011a, 0x02a5, 0x022c, 0x03b7, 0x033e,
+		0x04c9, 0x0440, 0x05db, 0x0552, 0x06ed, 0x0664, 0x07ff, 0x0776,
+		0x0102, 0x018b, 0x0010, 0x0099, 0x0326, 0x03af, 0x0234, 0x02bd,
+		0x054a, 0x05c3, 0x0458, 0x04d1, 0x076e, 0x07e7, 0x067c, 0x06f5,
+		0x0183, 0x010a, 0x0091, 0x0018, 0x03a7, 0x032e, 0x02b5, 0x023c,
+		0x05cb, 0x0542, 0x04d9, 0x0450, 0x07ef, 0x0766, 0x06fd, 0x0674,
+		0x0204, 0x028d, 0x0316, 0x039f, 0x0020, 0x00a9, 0x0132, 0x01bb,
+		0x064c, 0x06c5, 0x075e, 0x07d7, 0x0468, 0x04e1, 0x057a, 0x05f3,
+		0x0285, 0x020c, 0x0397, 0x031e, 0x00a1, 0x0028, 0x01b3, 0x013a,
+		0x06cd, 0x0644, 0x07df, 0x0756, 0x04e9, 0x0460, 0x05fb, 0x0572,
+		0x0306, 0x038f, 0x0214, 0x029d, 0x0122, 0x01ab, 0x0030, 0x00b9,
+		0x074e, 0x07c7, 0x065c, 0x06d5, 0x056a, 0x05e3, 0x0478, 0x04f1,
+		0x0387, 0x030e, 0x0295, 0x021c, 0x01a3, 0x012a, 0x00b1, 0x0038,
+		0x07cf, 0x0746, 0x06dd, 0x0654, 0x05eb, 0x0562, 0x04f9, 0x0470,
+		0x0408, 0x0481, 0x051a, 0x0593, 0x062c, 0x06a5, 0x073e, 0x07b7,
+		0x0040, 0x00c9, 0x0152, 0x01db, 0x0264, 0x02ed, 0x0376, 0x03ff,
+		0x0489, 0x0400, 0x059b, 0x0512, 0x06ad, 0x0624, 0x07bf, 0x0736,
+		0x00c1, 0x0048, 0x01d3, 0x015a, 0x02e5, 0x026c, 0x03f7, 0x037e,
+		0x050a, 0x0583, 0x0418, 0x0491, 0x072e, 0x07a7, 0x063c, 0x06b5,
+		0x0142, 0x01cb, 0x0050, 0x00d9, 0x0366, 0x03ef, 0x0274, 0x02fd,
+		0x058b, 0x0502, 0x0499, 0x0410, 0x07af, 0x0726, 0x06bd, 0x0634,
+		0x01c3, 0x014a, 0x00d1, 0x0058, 0x03e7, 0x036e, 0x02f5, 0x027c,
+		0x060c, 0x0685, 0x071e, 0x0797, 0x0428, 0x04a1, 0x053a, 0x05b3,
+		0x0244, 0x02cd, 0x0356, 0x03df, 0x0060, 0x00e9, 0x0172, 0x01fb,
+		0x068d, 0x0604, 0x079f, 0x0716, 0x04a9, 0x0420, 0x05bb, 0x0532,
+		0x02c5, 0x024c, 0x03d7, 0x035e, 0x00e1, 0x0068, 0x01f3, 0x017a,
+		0x070e, 0x0787, 0x061c, 0x0695, 0x052a, 0x05a3, 0x0438, 0x04b1,
+		0x0346, 0x03cf, 0x0254, 0x02dd, 0x0162, 0x01eb, 0x0070, 0x00f9,
+		0x078f, 0x0706, 0x069d, 0x0614, 0x05ab, 0x0522, 0x04b9, 0x0430,
+		0x03c7, 0x034e, 0x02d5, 0x025c, 0x01e3, 0x016a, 0x00f1, 0x0078,
+	},
+#if CRC16_SLICE_BY >= 4
+	{
+		0x0000, 0x00c9, 0x0192, 0x015b, 0x0324, 0x03ed, 0x02b6, 0x027f,
+		0x0648, 0x0681, 0x07da, 0x0713, 0x056c, 0x05a5, 0x04fe, 0x0437,
+		0x0481, 0x0448, 0x0513, 0x05da, 0x07a5, 0x076c, 0x0637, 0x06fe,
+		0x02c9, 0x0200, 0x035b, 0x0392, 0x01ed, 0x0124, 0x007f, 0x00b6,
+		0x0113, 0x01da, 0x0081, 0x0048, 0x0237, 0x02fe, 0x03a5, 0x036c,
+		0x075b, 0x0792, 0x06c9, 0x0600, 0x047f, 0x04b6, 0x05ed, 0x0524,
+		0x0592, 0x055b, 0x0400, 0x04c9, 0x06b6, 0x067f, 0x0724, 0x07ed,
+		0x03da, 0x0313, 0x0248, 0x0281, 0x00fe, 0x0037, 0x016c, 0x01a5,
+		0x0226, 0x02ef, 0x03b4, 0x037d, 0x0102, 0x01cb, 0x0090, 0x0059,
+		0x046e, 0x04a7, 0x05fc, 0x0535, 0x074a, 0x0783, 0x06d8, 0x0611,
+		0x06a7, 0x066e, 0x0735, 0x07fc, 0x0583, 0x054a, 0x0411, 0x04d8,
+		0x00ef, 0x0026, 0x017d, 0x01b4, 0x03cb, 0x0302, 0x0259, 0x0290,
+		0x0335, 0x03fc, 0x02a7, 0x026e, 0x0011, 0x00d8, 0x0183, 0x014a,
+		0x057d, 0x05b4, 0x04ef, 0x0426, 0x0659, 0x0690, 0x07cb, 0x0702,
+		0x07b4, 0x077d, 0x0626, 0x06ef, 0x0490, 0x0459, 0x0502, 0x05cb,
+		0x01fc, 0x0135, 0x006e, 0x00a7, 0x02d8, 0x0211, 0x034a, 0x0383,
+		0x044c, 0x0485, 0x05de, 0x0517, 0x0768, 0x07a1, 0x06fa, 0x0633,
+		0x0204, 0x02cd, 0x0396, 0x035f, 0x0120, 0x01e9, 0x00b2, 0x007b,
+		0x00cd, 0x0004, 0x015f, 0x0196, 0x03e9, 0x0320, 0x027b, 0x02b2,
+		0x0685, 0x064c, 0x0717, 0x07de, 0x05a1, 0x0568, 0x0433, 0x04fa,
+		0x055f, 0x0596, 0x04cd, 0x0404, 0x067b, 0x06b2, 0x07e9, 0x0720,
+		0x0317, 0x03de, 0x0285, 0x024c, 0x0033, 0x00fa, 0x01a1, 0x0168,
+		0x01de, 0x0117, 0x004c, 0x0085, 0x02fa, 0x0233, 0x0368, 0x03a1,
+		0x0796, 0x075f, 0x0604, 0x06cd, 0x04b2, 0x047b, 0x0520, 0x05e9,
+		0x066a, 0x06a3, 0x07f8, 0x0731, 0x054e, 0x0587, 0x04dc, 0x0415,
+		0x0022, 0x00eb, 0x01b0, 0x0179, 0x0306, 0x03cf, 0x0294, 0x025d,
+		0x02eb, 0x0222, 0x0379, 0x03b0, 0x01cf, 0x0106, 0x005d, 0x0094,
+		0x04a3, 0x046a, 0x0531, 0x05f8, 0x0787, 0x074e, 0x0615, 0x06dc,
+		0x0779, 0x07b0, 0x06eb, 0x0622, 0x045d, 0x0494, 0x05cf, 0x0506,
+		0x0131, 0x01f8, 0x00a3, 0x006a, 0x0215, 0x02dc, 0x0387, 0x034e,
+		0x03f8, 0x0331, 0x026a, 0x02a3, 0x00dc, 0x0015, 0x014e, 0x0187,
+		0x05b0, 0x0579, 0x0422, 0x04eb, 0x0694, 0x065d, 0x0706, 0x07cf,
+	},
+	{
+		0x0000, 0x02cd, 0x059a, 0x0757, 0x0325, 0x01e8, 0x06bf, 0x0472,
+		0x064a, 0x0487, 0x03d0, 0x011d, 0x056f, 0x07a2, 0x00f5, 0x0238,
+		0x0485, 0x0648, 0x011f, 0x03d2, 0x07a0, 0x056d, 0x023a, 0x00f7,
+		0x02cf, 0x0002, 0x0755, 0x0598, 0x01ea, 0x0327, 0x0470, 0x06bd,
+		0x011b, 0x03d6, 0x0481, 0x064c, 0x023e, 0x00f3, 0x07a4, 0x0569,
+		0x0751, 0x059c, 0x02cb, 0x0006, 0x0474, 0x06b9, 0x01ee, 0x0323,
+		0x059e, 0x0753, 0x0004, 0x02c9, 0x06bb, 0x0476, 0x0321, 0x01ec,
+		0x03d4, 0x0119, 0x064e, 0x0483, 0x00f1, 0x023c, 0x056b, 0x07a6,
+		0x0236, 0x00fb, 0x07ac, 0x0561, 0x0113, 0x03de, 0x0489, 0x0644,
+		0x047c, 0x06b1, 0x01e6, 0x032b, 0x0759, 0x0594, 0x02c3, 0x000e,
+		0x06b3, 0x047e, 0x0329, 0x01e4, 0x0596, 0x075b, 0x000c, 0x02c1,
+		0x00f9, 0x0234, 0x0563, 0x07ae, 0x03dc, 0x0111, 0x0646, 0x048b,
+		0x032d, 0x01e0, 0x06b7, 0x047a, 0x0008, 0x02c5, 0x0592, 0x075f,
+		0x0567, 0x07aa, 0x00fd, 0x0230, 0x0642, 0x048f, 0x03d8, 0x0115,
+		0x07a8, 0x0565, 0x0232, 0x00ff, 0x048d, 0x0640, 0x0117, 0x03da,
+		0x01e2, 0x032f, 0x0478, 0x06b5, 0x02c7, 0x000a, 0x075d, 0x0590,
+		0x046c, 0x06a1, 0x01f6, 0x033b, 0x0749, 0x0584, 0x02d3, 0x001e,
+		0x0226, 0x00eb, 0x07bc, 0x0571, 0x0103, 0x03ce, 0x0499, 0x0654,
+		0x00e9, 0x0224, 0x0573, 0x07be, 0x03cc, 0x0101, 0x0656, 0x049b,
+		0x06a3, 0x046e, 0x0339, 0x01f4, 0x0586, 0x074b, 0x001c, 0x02d1,
+		0x0577, 0x07ba, 0x00ed, 0x0220, 0x0652, 0x049f, 0x03c8, 0x0105,
+		0x033d, 0x01f0, 0x06a7, 0x046a, 0x0018, 0x02d5, 0x0582, 0x074f,
+		0x01f2, 0x033f, 0x0468, 0x06a5, 0x02d7, 0x001a, 0x074d, 0x0580,
+		0x07b8, 0x0575, 0x0222, 0x00ef, 0x049d, 0x0650, 0x0107, 0x03ca,
+		0x065a, 0x0497, 0x03c0, 0x010d, 0x057f, 0x07b2, 0x00e5, 0x0228,
+		0x0010, 0x02dd, 0x058a, 0x0747, 0x0335, 0x01f8, 0x06af, 0x0462,
+		0x02df, 0x0012, 0x0745, 0x0588, 0x01fa, 0x0337, 0x0460, 0x06ad,
+		0x0495, 0x0658, 0x010f, 0x03c2, 0x07b0, 0x057d, 0x022a, 0x00e7,
+		0x0741, 0x058c, 0x02db, 0x0016, 0x0464, 0x06a9, 0x01fe, 0x0333,
+		0x010b, 0x03c6, 0x0491, 0x065c, 0x022e, 0x00e3, 0x07b4, 0x0579,
+		0x03c4, 0x0109, 0x065e, 0x0493, 0x00e1, 0x022c, 0x057b, 0x07b6,
+		0x058e, 0x0743, 0x0014, 0x02d9, 0x06ab, 0x0466, 0x0331, 0x01fc,
+	},
+	{
+		0x0000, 0x00eb, 0x01d6, 0x013d, 0x03ac, 0x0347, 0x027a, 0x0291,
+		0x0758, 0x07b3, 0x068e, 0x0665, 0x04f4, 0x041f, 0x0522, 0x05c9,
+		0x06a1, 0x064a, 0x0777, 0x079c, 0x050d, 0x05e6, 0x04db, 0x0430,
+		0x01f9, 0x0112, 0x002f, 0x00c4, 0x0255, 0x02be, 0x0383, 0x0368,
+		0x0553, 0x05b8, 0x0485, 0x046e, 0x06ff, 0x0614, 0x0729, 0x07c2,
+		0x020b, 0x02e0, 0x03dd, 0x0336, 0x01a7, 0x014c, 0x0071, 0x009a,
+		0x03f2, 0x0319, 0x0224, 0x02cf, 0x005e, 0x00b5, 0x0188, 0x0163,
+		0x04aa, 0x0441, 0x057c, 0x0597, 0x0706, 0x07ed, 0x06d0, 0x063b,
+		0x02b7, 0x025c, 0x0361, 0x038a, 0x011b, 0x01f0, 0x00cd, 0x0026,
+		0x05ef, 0x0504, 0x0439, 0x04d2, 0x0643, 0x06a8, 0x0795, 0x077e,
+		0x0416, 0x04fd, 0x05c0, 0x052b, 0x07ba, 0x0751, 0x066c, 0x0687,
+		0x034e, 0x03a5, 0x0298, 0x0273, 0x00e2, 0x0009, 0x0134, 0x01df,
+		0x07e4, 0x070f, 0x0632, 0x06d9, 0x0448, 0x04a3, 0x059e, 0x0575,
+		0x00bc, 0x0057, 0x016a, 0x0181, 0x0310, 0x03fb, 0x02c6, 0x022d,
+		0x0145, 0x01ae, 0x0093, 0x0078, 0x02e9, 0x0202, 0x033f, 0x03d4,
+		0x061d, 0x06f6, 0x07cb, 0x0720, 0x05b1, 0x055a, 0x0467, 0x048c,
+		0x056e, 0x0585, 0x04b8, 0x0453, 0x06c2, 0x0629, 0x0714, 0x07ff,
+		0x0236, 0x02dd, 0x03e0, 0x030b, 0x019a, 0x0171, 0x004c, 0x00a7,
+		0x03cf, 0x0324, 0x0219, 0x02f2, 0x0063, 0x0088, 0x01b5, 0x015e,
+		0x0497, 0x047c, 0x0541, 0x05aa, 0x073b, 0x07d0, 0x06ed, 0x0606,
+		0x003d, 0x00d6, 0x01eb, 0x0100, 0x0391, 0x037a, 0x0247, 0x02ac,
+		0x0765, 0x078e, 0x06b3, 0x0658, 0x04c9, 0x0422, 0x051f, 0x05f4,
+		0x069c, 0x0677, 0x074a, 0x07a1, 0x0530, 0x05db, 0x04e6, 0x040d,
+		0x01c4, 0x012f, 0x0012, 0x00f9, 0x0268, 0x0283, 0x03be, 0x0355,
+		0x07d9, 0x0732, 0x060f, 0x06e4, 0x0475, 0x049e, 0x05a3, 0x0548,
+		0x0081, 0x006a, 0x0157, 0x01bc, 0x032d, 0x03c6, 0x02fb, 0x0210,
+		0x0178, 0x0193, 0x00ae, 0x0045, 0x02d4, 0x023f, 0x0302, 0x03e9,
+		0x0620, 0x06cb, 0x07f6, 0x071d, 0x058c, 0x0567, 0x045a, 0x04b1,
+		0x028a, 0x0261, 0x035c, 0x03b7, 0x0126, 0x01cd, 0x00f0, 0x001b,
+		0x05d2, 0x0539, 0x0404, 0x04ef, 0x067e, 0x0695, 0x07a8, 0x0743,
+		0x042b, 0x04c0, 0x05fd, 0x0516, 0x0787, 0x076c, 0x0651, 0x06ba,
+		0x0373, 0x0398, 0x02a5, 0x024e, 0x00df, 0x0034, 0x0109, 0x01e2,
+	},
+#endif
+#if CRC16_SLICE_BY >= 8
+	{
+		0x0000, 0x02dd, 0x05ba, 0x0767, 0x0365, 0x01b8, 0x06df, 0x0402,
+		0x06ca, 0x0417, 0x0370, 0x01ad, 0x05af, 0x0772, 0x0015, 0x02c8,
+		0x0585, 0x0758, 0x003f, 0x02e2, 0x06e0, 0x043d, 0x035a, 0x0187,
+		0x034f, 0x0192, 0x06f5, 0x0428, 0x002a, 0x02f7, 0x0590, 0x074d,
+		0x031b, 0x01c6, 0x06a1, 0x047c, 0x007e, 0x02a3, 0x05c4, 0x0719,
+		0x05d1, 0x070c, 0x006b, 0x02b6, 0x06b4, 0x0469, 0x030e, 0x01d3,
+		0x069e, 0x0443, 0x0324, 0x01f9, 0x05fb, 0x0726, 0x0041, 0x029c,
+		0x0054, 0x0289, 0x05ee, 0x0733, 0x0331, 0x01ec, 0x068b, 0x0456,
+		0x0636, 0x04eb, 0x038c, 0x0151, 0x0553, 0x078e, 0x00e9, 0x0234,
+		0x00fc, 0x0221, 0x0546, 0x079b, 0x0399, 0x0144, 0x0623, 0x04fe,
+		0x03b3, 0x016e, 0x0609, 0x04d4, 0x00d6, 0x020b, 0x056c, 0x07b1,
+		0x0579, 0x07a4, 0x00c3, 0x021e, 0x061c, 0x04c1, 0x03a6, 0x017b,
+		0x052d, 0x07f0, 0x0097, 0x024a, 0x0648, 0x0495, 0x03f2, 0x012f,
+		0x03e7, 0x013a, 0x065d, 0x0480, 0x0082, 0x025f, 0x0538, 0x07e5,
+		0x00a8, 0x0275, 0x0512, 0x07cf, 0x03cd, 0x0110, 0x0677, 0x04aa,
+		0x0662, 0x04bf, 0x03d8, 0x0105, 0x0507, 0x07da, 0x00bd, 0x0260,
+		0x047d, 0x06a0, 0x01c7, 0x031a, 0x0718, 0x05c5, 0x02a2, 0x007f,
+		0x02b7, 0x006a, 0x070d, 0x05d0, 0x01d2, 0x030f, 0x0468, 0x06b5,
+		0x01f8, 0x0325, 0x0442, 0x069f, 0x029d, 0x0040, 0x0727, 0x05fa,
+		0x0732, 0x05ef, 0x0288, 0x0055, 0x0457, 0x068a, 0x01ed, 0x0330,
+		0x0766, 0x05bb, 0x02dc, 0x0001, 0x0403, 0x06de, 0x01b9, 0x0364,
+		0x01ac, 0x0371, 0x0416, 0x06cb, 0x02c9, 0x0014, 0x0773, 0x05ae,
+		0x02e3, 0x003e, 0x0759, 0x0584, 0x0186, 0x035b, 0x043c, 0x06e1,
+		0x0429, 0x06f4, 0x0193, 0x034e, 0x074c, 0x0591, 0x02f6, 0x002b,
+		0x024b, 0x0096, 0x07f1, 0x052c, 0x012e, 0x03f3, 0x0494, 0x0649,
+		0x0481, 0x065c, 0x013b, 0x03e6, 0x07e4, 0x0539, 0x025e, 0x0083,
+		0x07ce, 0x0513, 0x0274, 0x00a9, 0x04ab, 0x0676, 0x0111, 0x03cc,
+		0x0104, 0x03d9, 0x04be, 0x0663, 0x0261, 0x00bc, 0x07db, 0x0506,
+		0x0150, 0x038d, 0x04ea, 0x0637, 0x0235, 0x00e8, 0x078f, 0x0552,
+		0x079a, 0x0547, 0x0220, 0x00fd, 0x04ff, 0x0622, 0x0145, 0x0398,
+		0x04d5, 0x0608, 0x016f, 0x03b2, 0x07b0, 0x056d, 0x020a, 0x00d7,
+		0x021f, 0x00c2, 0x07a5, 0x0578, 0x017a, 0x03a7, 0x04c0, 0x061d,
+	},
+	{
+		0x0000, 0x006a, 0x00d4, 0x00be, 0x01a8, 0x01c2, 0x017c, 0x0116,
+		0x0350, 0x033a, 0x0384, 0x03ee, 0x02f8, 0x0292, 0x022c, 0x0246,
+		0x06a0, 0x06ca, 0x0674, 0x061e, 0x0708, 0x0762, 0x07dc, 0x07b6,
+		0x05f0, 0x059a, 0x0524, 0x054e, 0x0458, 0x0432, 0x048c, 0x04e6,
+		0x0551, 0x053b, 0x0585, 0x05ef, 0x04f9, 0x0493, 0x042d, 0x0447,
+		0x0601, 0x066b, 0x06d5, 0x06bf, 0x07a9, 0x07c3, 0x077d, 0x0717,
+		0x03f1, 0x039b, 0x0325, 0x034f, 0x0259, 0x0233, 0x028d, 0x02e7,
+		0x00a1, 0x00cb, 0x0075, 0x001f, 0x0109, 0x0163, 0x01dd, 0x01b7,
+		0x02b3, 0x02d9, 0x0267, 0x020d, 0x031b, 0x0371, 0x03cf, 0x03a5,
+		0x01e3, 0x0189, 0x0137, 0x015d, 0x004b, 0x0021, 0x009f, 0x00f5,
+		0x0413, 0x0479, 0x04c7, 0x04ad, 0x05bb, 0x05d1, 0x056f, 0x0505,
+		0x0743, 0x0729, 0x0797, 0x07fd, 0x06eb, 0x0681, 0x063f, 0x0655,
+		0x07e2, 0x0788, 0x0736, 0x075c, 0x064a, 0x0620, 0x069e, 0x06f4,
+		0x04b2, 0x04d8, 0x0466, 0x040c, 0x051a, 0x0570, 0x05ce, 0x05a4,
+		0x0142, 0x0128, 0x0196, 0x01fc, 0x00ea, 0x0080, 0x003e, 0x0054,
+		0x0212, 0x0278, 0x02c6, 0x02ac, 0x03ba, 0x03d0, 0x036e, 0x0304,
+		0x0566, 0x050c, 0x05b2, 0x05d8, 0x04ce, 0x04a4, 0x041a, 0x0470,
+		0x0636, 0x065c, 0x06e2, 0x0688, 0x079e, 0x07f4, 0x074a, 0x0720,
+		0x03c6, 0x03ac, 0x0312, 0x0378, 0x026e, 0x0204, 0x02ba, 0x02d0,
+		0x0096, 0x00fc, 0x0042, 0x0028, 0x013e, 0x0154, 0x01ea, 0x0180,
+		0x0037, 0x005d, 0x00e3, 0x0089, 0x019f, 0x01f5, 0x014b, 0x0121,
+		0x0367, 0x030d, 0x03b3, 0x03d9, 0x02cf, 0x02a5, 0x021b, 0x0271,
+		0x0697, 0x06fd, 0x0643, 0x0629, 0x073f, 0x0755, 0x07eb, 0x0781,
+		0x05c7, 0x05ad, 0x0513, 0x0579, 0x046f, 0x0405, 0x04bb, 0x04d1,
+		0x07d5, 0x07bf, 0x0701, 0x076b, 0x067d, 0x0617, 0x06a9, 0x06c3,
+		0x0485, 0x04ef, 0x0451, 0x043b, 0x052d, 0x0547, 0x05f9, 0x0593,
+		0x0175, 0x011f, 0x01a1, 0x01cb, 0x00dd, 0x00b7, 0x0009, 0x0063,
+		0x0225, 0x024f, 0x02f1, 0x029b, 0x038d, 0x03e7, 0x0359, 0x0333,
+		0x0284, 0x02ee, 0x0250, 0x023a, 0x032c, 0x0346, 0x03f8, 0x0392,
+		0x01d4, 0x01be, 0x0100, 0x016a, 0x007c, 0x0016, 0x00a8, 0x00c2,
+		0x0424, 0x044e, 0x04f0, 0x049a, 0x058c, 0x05e6, 0x0558, 0x0532,
+		0x0774, 0x071e, 0x07a0, 0x07ca, 0x06dc, 0x06b6, 0x0608, 0x0662,
+	},
+	{
+		0x0000, 0x065c, 0x04a9, 0x02f5, 0x0143, 0x071f, 0x05ea, 0x03b6,
+		0x0286, 0x04da, 0x062f, 0x0073, 0x03c5, 0x0599, 0x076c, 0x0130,
+		0x050c, 0x0350, 0x01a5, 0x07f9, 0x044f, 0x0213, 0x00e6, 0x06ba,
+		0x078a, 0x01d6, 0x0323, 0x057f, 0x06c9, 0x0095, 0x0260, 0x043c,
+		0x0209, 0x0455, 0x06a0, 0x00fc, 0x034a, 0x0516, 0x07e3, 0x01bf,
+		0x008f, 0x06d3, 0x0426, 0x027a, 0x01cc, 0x0790, 0x0565, 0x0339,
+		0x0705, 0x0159, 0x03ac, 0x05f0, 0x0646, 0x001a, 0x02ef, 0x04b3,
+		0x0583, 0x03df, 0x012a, 0x0776, 0x04c0, 0x029c, 0x0069, 0x0635,
+		0x0412, 0x024e, 0x00bb, 0x06e7, 0x0551, 0x030d, 0x01f8, 0x07a4,
+		0x0694, 0x00c8, 0x023d, 0x0461, 0x07d7, 0x018b, 0x037e, 0x0522,
+		0x011e, 0x0742, 0x05b7, 0x03eb, 0x005d, 0x0601, 0x04f4, 0x02a8,
+		0x0398, 0x05c4, 0x0731, 0x016d, 0x02db, 0x0487, 0x0672, 0x002e,
+		0x061b, 0x0047, 0x02b2, 0x04ee, 0x0758, 0x0104, 0x03f1, 0x05ad,
+		0x049d, 0x02c1, 0x0034, 0x0668, 0x05de, 0x0382, 0x0177, 0x072b,
+		0x0317, 0x054b, 0x07be, 0x01e2, 0x0254, 0x0408, 0x06fd, 0x00a1,
+		0x0191, 0x07cd, 0x0538, 0x0364, 0x00d2, 0x068e, 0x047b, 0x0227,
+		0x0035, 0x0669, 0x049c, 0x02c0, 0x0176, 0x072a, 0x05df, 0x0383,
+		0x02b3, 0x04ef, 0x061a, 0x0046, 0x03f0, 0x05ac, 0x0759, 0x0105,
+		0x0539, 0x0365, 0x0190, 0x07cc, 0x047a, 0x0226, 0x00d3, 0x068f,
+		0x07bf, 0x01e3, 0x0316, 0x054a, 0x06fc, 0x00a0, 0x0255, 0x0409,
+		0x023c, 0x0460, 0x0695, 0x00c9, 0x037f, 0x0523, 0x07d6, 0x018a,
+		0x00ba, 0x06e6, 0x0413, 0x024f, 0x01f9, 0x07a5, 0x0550, 0x030c,
+		0x0730, 0x016c, 0x0399, 0x05c5, 0x0673, 0x002f, 0x02da, 0x0486,
+		0x05b6, 0x03ea, 0x011f, 0x0743, 0x04f5, 0x02a9, 0x005c, 0x0600,
+		0x0427, 0x027b, 0x008e, 0x06d2, 0x0564, 0x0338, 0x01cd, 0x0791,
+		0x06a1, 0x00fd, 0x0208, 0x0454, 0x07e2, 0x01be, 0x034b, 0x0517,
+		0x012b, 0x0777, 0x0582, 0x03de, 0x0068, 0x0634, 0x04c1, 0x029d,
+		0x03ad, 0x05f1, 0x0704, 0x0158, 0x02ee, 0x04b2, 0x0647, 0x001b,
+		0x062e, 0x0072, 0x0287, 0x04db, 0x076d, 0x0131, 0x03c4, 0x0598,
+		0x04a8, 0x02f4, 0x0001, 0x065d, 0x05eb, 0x03b7, 0x0142, 0x071e,
+		0x0322, 0x057e, 0x078b, 0x01d7, 0x0261, 0x043d, 0x06c8, 0x0094,
+		0x01a4, 0x07f8, 0x050d, 0x0351, 0x00e7, 0x06bb, 0x044e, 0x0212,
+	},
+	{
+		0x0000, 0x04ef, 0x01cf, 0x0520, 0x039e, 0x0771, 0x0251, 0x06be,
+		0x073c, 0x03d3, 0x06f3, 0x021c, 0x04a2, 0x004d, 0x056d, 0x0182,
+		0x0669, 0x0286, 0x07a6, 0x0349, 0x05f7, 0x0118, 0x0438, 0x00d7,
+		0x0155, 0x05ba, 0x009a, 0x0475, 0x02cb, 0x0624, 0x0304, 0x07eb,
+		0x04c3, 0x002c, 0x050c, 0x01e3, 0x075d, 0x03b2, 0x0692, 0x027d,
+		0x03ff, 0x0710, 0x0230, 0x06df, 0x0061, 0x048e, 0x01ae, 0x0541,
+		0x02aa, 0x0645, 0x0365, 0x078a, 0x0134, 0x05db, 0x00fb, 0x0414,
+		0x0596, 0x0179, 0x0459, 0x00b6, 0x0608, 0x02e7, 0x07c7, 0x0328,
+		0x0197, 0x0578, 0x0058, 0x04b7, 0x0209, 0x06e6, 0x03c6, 0x0729,
+		0x06ab, 0x0244, 0x0764, 0x038b, 0x0535, 0x01da, 0x04fa, 0x0015,
+		0x07fe, 0x0311, 0x0631, 0x02de, 0x0460, 0x008f, 0x05af, 0x0140,
+		0x00c2, 0x042d, 0x010d, 0x05e2, 0x035c, 0x07b3, 0x0293, 0x067c,
+		0x0554, 0x01bb, 0x049b, 0x0074, 0x06ca, 0x0225, 0x0705, 0x03ea,
+		0x0268, 0x0687, 0x03a7, 0x0748, 0x01f6, 0x0519, 0x0039, 0x04d6,
+		0x033d, 0x07d2, 0x02f2, 0x061d, 0x00a3, 0x044c, 0x016c, 0x0583,
+		0x0401, 0x00ee, 0x05ce, 0x0121, 0x079f, 0x0370, 0x0650, 0x02bf,
+		0x032e, 0x07c1, 0x02e1, 0x060e, 0x00b0, 0x045f, 0x017f, 0x0590,
+		0x0412, 0x00fd, 0x05dd, 0x0132, 0x078c, 0x0363, 0x0643, 0x02ac,
+		0x0547, 0x01a8, 0x0488, 0x0067, 0x06d9, 0x0236, 0x0716, 0x03f9,
+		0x027b, 0x0694, 0x03b4, 0x075b, 0x01e5, 0x050a, 0x002a, 0x04c5,
+		0x07ed, 0x0302, 0x0622, 0x02cd, 0x0473, 0x009c, 0x05bc, 0x0153,
+		0x00d1, 0x043e, 0x011e, 0x05f1, 0x034f, 0x07a0, 0x0280, 0x066f,
+		0x0184, 0x056b, 0x004b, 0x04a4, 0x021a, 0x06f5, 0x03d5, 0x073a,
+		0x06b8, 0x0257, 0x0777, 0x0398, 0x0526, 0x01c9, 0x04e9, 0x0006,
+		0x02b9, 0x0656, 0x0376, 0x0799, 0x0127, 0x05c8, 0x00e8, 0x0407,
+		0x0585, 0x016a, 0x044a, 0x00a5, 0x061b, 0x02f4, 0x07d4, 0x033b,
+		0x04d0, 0x003f, 0x051f, 0x01f0, 0x074e, 0x03a1, 0x0681, 0x026e,
+		0x03ec, 0x0703, 0x0223, 0x06cc, 0x0072, 0x049d, 0x01bd, 0x0552,
+		0x067a, 0x0295, 0x07b5, 0x035a, 0x05e4, 0x010b, 0x042b, 0x00c4,
+		0x0146, 0x05a9, 0x0089, 0x0466, 0x02d8, 0x0637, 0x0317, 0x07f8,
+		0x0013, 0x04fc, 0x01dc, 0x0533, 0x038d, 0x0762, 0x0242, 0x06ad,
+		0x072f, 0x03c0, 0x06e0, 0x020f, 0x04b1, 0x005e, 0x057e, 0x0191,
+	},
+#endif
+};
+
+
+/**
+ * \brief Table driven update of reflected 16 bit CRC register
+ *
+ * \param table Lookup tables for polynomial (\ref CRC16_TABLE_COUNT entries)
+ * \param crc Current CRC register value
  * \param data Data to calculate CRC over
  * \param data_len Number of bytes in data
- * \return uint16_t CRC over data
+ * \return uint16_t Updated CRC register value
  */
-uint16_t
-crc16_ccitt_x25 (uint8_t *data, size_t data_len)
+static uint16_t
+crc16_reflected_update (const uint16_t (*table)[256], uint16_t crc,
+		const uint8_t *data, size_t data_len)
 {
-	uint16_t crc = 0xffff;
+#if CRC16_SLICE_BY >= 8
+	while (data_len >= 8)
+	{
+		crc ^= data[0] | (data[1] << 8);
+		crc = table[7][crc & 0xff] ^ table[6][crc >> 8] ^ table[5][data[2]]
+				^ table[4][data[3]] ^ table[3][data[4]] ^ table[2][data[5]]
+				^ table[1][data[6]] ^ table[0][data[7]];
+		data += 8;
+		data_len -= 8;
+	}
+#endif
+#if CRC16_SLICE_BY >= 4
+	while (data_len >= 4)
+	{
+		crc ^= data[0] | (data[1] << 8);
+		crc = table[3][crc & 0xff] ^ table[2][crc >> 8] ^ table[1][data[2]]
+				^ table[0][data[3]];
+		data += 4;
+		data_len -= 4;
+	}
+#endif
 	for (size_t i = 0; i < data_len; i++)
 	{
-		uint8_t b = data[i];
-		crc ^= b;
-		for (size_t j = 0; j < 8; j++)
-		{
-			if ((crc & 1) != 0)
-			{
-				crc = (crc >> 1) ^ 0x8408;
-			}
-			else
-			{
-				crc = crc >> 1;
-			}
-		}
+		crc = (crc >> 8) ^ table[0][(crc ^ data[i]) & 0xff];
 	}
-	return crc ^ 0xffff;
+	return crc;
 }
 
+#else
+
 /**
- * \brief Calculates 16 bit CRC according to MCRF4xx specification
+ * \brief Bit-serial update of reflected 16 bit CRC register
  *
+ * \param polynomial Reflected CRC polynomial
+ * \param crc Current CRC register value
  * \param data Data to calculate CRC over
  * \param data_len Number of bytes in data
- * \return uint16_t CRC over data
+ * \return uint16_t Updated CRC register value
  */
-uint16_t
-crc16_mcrf4xx (uint8_t *data, size_t data_len)
+static uint16_t
+crc16_reflected_update (uint16_t polynomial, uint16_t crc,
+		const uint8_t *data, size_t data_len)
 {
-	uint16_t crc = 0xffff;
 	for (size_t i = 0; i < data_len; i++)
 	{
-		uint8_t b = data[i];
-		crc ^= b;
+		crc ^= data[i];
 		for (size_t j = 0; j < 8; j++)
 		{
 			if ((crc & 1) != 0)
 			{
-				crc = (crc >> 1) ^ 0x8408;
+				crc = (crc >> 1) ^ polynomial;
 			}
 			else
 			{
@@ -88,6 +704,243 @@ crc16_mcrf4xx (uint8_t *data, size_t data_len)
 	return crc;
 }
 
+#endif
+
+/**
+ * \brief Selects CRC engine argument for polynomial
+ *
+ * \details Lookup tables for table driven engines, plain polynomial for the
+ * bit-serial engine.
+ */
+#if CRC16_SLICE_BY > 0
+#define CRC16_ENGINE(table, polynomial) (table)
+#else
+#define CRC16_ENGINE(table, polynomial) (polynomial)
+#endif
+
+#if CRC16_CLMUL
+
+/**
+ * \brief Minimum number of bytes for which the carry-less multiplication
+ * kernel is used
+ *
+ * \details Shorter inputs are faster with the lookup tables.
+ */
+#define CRC16_CLMUL_THRESHOLD 32
+
+/*
+ * Folding constants for the reflected 0x8408 polynomial P(x).
+ *
+ * A 128 bit block loaded from memory holds the polynomial bit-reflected, so
+ * the low quadword H carries the terms x^127..x^64 and the high quadword L
+ * the terms x^63..x^0. Folding a block forward by n bits computes
+ *   H * (x^(n + 64) mod P) + L * (x^n mod P)
+ * Reflected carry-less products are implicitly multiplied by x, so the
+ * constants below are x^(n + 63) mod P and x^(n - 1) mod P in 64 bit
+ * reflected form.
+ */
+#define CRC16_CLMUL_FOLD128_H 0xa95d000000000000ull /**< x^191 mod P */
+#define CRC16_CLMUL_FOLD128_L 0x7eea000000000000ull /**< x^127 mod P */
+#define CRC16_CLMUL_FOLD512_H 0x9822000000000000ull /**< x^575 mod P */
+#define CRC16_CLMUL_FOLD512_L 0x7f90000000000000ull /**< x^511 mod P */
+
+/**
+ * \brief Folds 128 bit block forward and adds next block
+ */
+__attribute__ ((target ("sse2,pclmul"))) static inline __m128i
+crc16_clmul_fold (__m128i block, __m128i constants, __m128i next)
+{
+	__m128i h = _mm_clmulepi64_si128 (block, constants, 0x00);
+	__m128i l = _mm_clmulepi64_si128 (block, constants, 0x11);
+	return _mm_xor_si128 (_mm_xor_si128 (h, l), next);
+}
+
+/**
+ * \brief Carry-less multiplication update of reflected 0x8408 CRC register
+ *
+ * \param crc Current CRC register value
+ * \param data Data to calculate CRC over (at least 16 bytes)
+ * \param data_len Number of bytes in data
+ * \return uint16_t Updated CRC register value
+ */
+__attribute__ ((target ("sse2,pclmul"))) static uint16_t
+crc16_clmul_update (uint16_t crc, const uint8_t *data, size_t data_len)
+{
+	/* Initial register value is added to the first two message bytes */
+	__m128i x0 = _mm_xor_si128 (_mm_loadu_si128 ((const __m128i *)data),
+			_mm_cvtsi32_si128 (crc));
+	data += 16;
+	data_len -= 16;
+
+	/* Fold four independent lanes while enough data available */
+	if (data_len >= 48)
+	{
+		const __m128i fold512 = _mm_set_epi64x (
+				(long long)CRC16_CLMUL_FOLD512_L, (long long)CRC16_CLMUL_FOLD512_H);
+		__m128i x1 = _mm_loadu_si128 ((const __m128i *)(data + 0));
+		__m128i x2 = _mm_loadu_si128 ((const __m128i *)(data + 16));
+		__m128i x3 = _mm_loadu_si128 ((const __m128i *)(data + 32));
+		data += 48;
+		data_len -= 48;
+		while (data_len >= 64)
+		{
+			x0 = crc16_clmul_fold (x0, fold512,
+					_mm_loadu_si128 ((const __m128i *)(data + 0)));
+			x1 = crc16_clmul_fold (x1, fold512,
+					_mm_loadu_si128 ((const __m128i *)(data + 16)));
+			x2 = crc16_clmul_fold (x2, fold512,
+					_mm_loadu_si128 ((const __m128i *)(data + 32)));
+			x3 = crc16_clmul_fold (x3, fold512,
+					_mm_loadu_si128 ((const __m128i *)(data + 48)));
+			data += 64;
+			data_len -= 64;
+		}
+
+		/* Combine lanes */
+		const __m128i fold128 = _mm_set_epi64x (
+				(long long)CRC16_CLMUL_FOLD128_L, (long long)CRC16_CLMUL_FOLD128_H);
+		x0 = crc16_clmul_fold (x0, fold128, x1);
+		x0 = crc16_clmul_fold (x0, fold128, x2);
+		x0 = crc16_clmul_fold (x0, fold128, x3);
+	}
+
+	/* Fold remaining full blocks */
+	const __m128i fold128 = _mm_set_epi64x (
+			(long long)CRC16_CLMUL_FOLD128_L, (long long)CRC16_CLMUL_FOLD128_H);
+	while (data_len >= 16)
+	{
+		x0 = crc16_clmul_fold (x0, fold128,
+				_mm_loadu_si128 ((const __m128i *)data));
+		data += 16;
+		data_len -= 16;
+	}
+
+	/* Folded block is congruent to the message so far -> reduce via tables */
+	uint8_t folded[16];
+	_mm_storeu_si128 ((__m128i *)folded, x0);
+	crc = crc16_reflected_update (
+			CRC16_ENGINE (crc16_table_8408, CRC16_POLYNOMIAL_CCITT), 0x0000, folded,
+			sizeof (folded));
+	return crc16_reflected_update (
+			CRC16_ENGINE (crc16_table_8408, CRC16_POLYNOMIAL_CCITT), crc, data,
+			data_len);
+}
+
+/**
+ * \brief Checks whether carry-less multiplication kernel can be used
+ *
+ * \details Probes CPU features once. Correctness of the kernel is covered by
+ * the conformance tests, not checked at runtime.
+ *
+ * \return bool true if \ref crc16_clmul_update can be used
+ */
+static bool
+crc16_clmul_available (void)
+{
+	static int available = -1;
+	if (available < 0)
+	{
+		__builtin_cpu_init ();
+		available = (__builtin_cpu_supports ("sse2")
+				&& __builtin_cpu_supports ("pclmul")) ? 1 : 0;
+	}
+	return available == 1;
+}
+
+#endif
+
+/**
+ * \brief Starts incremental 16 bit CRC calculation
+ *
+ * \param ctx CRC state to be initialized
+ * \param algorithm CRC algorithm to be used
+ */
+void
+crc16_init (CRC16 *ctx, crc16_algorithm algorithm)
+{
+	ctx->algorithm = algorithm;
+	ctx->crc = 0xffff;
+}
+
+/**
+ * \brief Feeds data into incremental 16 bit CRC calculation
+ *
+ * \param ctx CRC state initialized by \ref crc16_init
+ * \param data Data to calculate CRC over
+ * \param data_len Number of bytes in data
+ */
+void
+crc16_update (CRC16 *ctx, const uint8_t *data, size_t data_len)
+{
+	if (ctx->algorithm == CRC16_T1GD)
+	{
+		ctx->crc = crc16_reflected_update (
+				CRC16_ENGINE (crc16_table_0408, CRC16_POLYNOMIAL_T1GD), ctx->crc,
+				data, data_len);
+	}
+#if CRC16_CLMUL
+	else if ((data_len >= CRC16_CLMUL_THRESHOLD) && crc16_clmul_available ())
+	{
+		ctx->crc = crc16_clmul_update (ctx->crc, data, data_len);
+	}
+#endif
+	else
+	{
+		ctx->crc = crc16_reflected_update (
+				CRC16_ENGINE (crc16_table_8408, CRC16_POLYNOMIAL_CCITT), ctx->crc,
+				data, data_len);
+	}
+}
+
+/**
+ * \brief Finishes incremental 16 bit CRC calculation
+ *
+ * \param ctx CRC state initialized by \ref crc16_init
+ * \return uint16_t CRC over all data fed into ctx
+ */
+uint16_t
+crc16_final (const CRC16 *ctx)
+{
+	/* Only CCITT x.25 uses a final XOR value */
+	if (ctx->algorithm == CRC16_CCITT_X25)
+	{
+		return ctx->crc ^ 0xffff;
+	}
+	return ctx->crc;
+}
+
+/**
+ * \brief Calculates 16 bit CRC according to CCITT x.25 specification.
+ *
+ * \param data Data to calculate CRC over
+ * \param data_len Number of bytes in data
+ * \return uint16_t CRC over data
+ */
+uint16_t
+crc16_ccitt_x25 (uint8_t *data, size_t data_len)
+{
+	CRC16 ctx;
+	crc16_init (&ctx, CRC16_CCITT_X25);
+	crc16_update (&ctx, data, data_len);
+	return crc16_final (&ctx);
+}
+
+/**
+ * \brief Calculates 16 bit CRC according to MCRF4xx specification
+ *
+ * \param data Data to calculate CRC over
+ * \param data_len Number of bytes in data
+ * \return uint16_t CRC over data
+ */
+uint16_t
+crc16_mcrf4xx (uint8_t *data, size_t data_len)
+{
+	CRC16 ctx;
+	crc16_init (&ctx, CRC16_MCRF4XX);
+	crc16_update (&ctx, data, data_len);
+	return crc16_final (&ctx);
+}
+
 /**
  * \brief Calculates 16 bit CRC according to G+D T=1 protocol specification
  *
@@ -100,21 +953,10 @@ crc16_mcrf4xx (uint8_t *data, size_t data_len)
 uint16_t
 crc16_t1gd (uint8_t *data, size_t data_len)
 {
-	uint16_t crc = 0xffff;
-	for (size_t i = 0; i < data_len; i++)
-	{
-		uint8_t b = data[i];
-		for (size_t j = 0; j < 8; j++)
-		{
-			if ((crc ^ b) & 0x01)
-			{
-				crc ^= 0x10810;
-			}
-			crc >>= 1;
-			b >>= 1;
-		}
-	}
-	return crc;
+	CRC16 ctx;
+	crc16_init (&ctx, CRC16_T1GD);
+	crc16_update (&ctx, data, data_len);
+	return crc16_final (&ctx);
 }
 
 /**
@@ -0,0 +1,183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file allocator.h
+ * \brief Pluggable memory allocator used by all modules of a protocol stack
+ */
+#ifndef _IFX_ALLOCATOR_H_
+#define _IFX_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief Allocation function of an \ref Allocator
+ *
+ * \param context \ref Allocator.context
+ * \param size Number of bytes to be allocated
+ * \return void*   Allocated memory or   NULL in case of error
+ */
+typedef void *(*allocator_allocatefunction_t) (void *context, size_t size);
+
+/**
+ * \brief Reallocation function of an \ref Allocator (semantics of `realloc()`)
+ *
+ * \param context \ref Allocator.context
+ * \param ptr Memory to be resized (might be   NULL)
+ * \param size New number of bytes
+ * \return void*   Resized memory or   NULL in case of error (  ptr stays
+ * valid)
+ */
+typedef void *(*allocator_reallocatefunction_t) (void *context, void *ptr,
+		size_t size);
+
+/**
+ * \brief Release function of an \ref Allocator
+ *
+ * \param context \ref Allocator.context
+ * \param ptr Memory to be released (never   NULL)
+ */
+typedef void (*allocator_releasefunction_t) (void *context, void *ptr);
+
+/**
+ * \brief Reset function of an \ref Allocator releasing all memory at once
+ *
+ * \param context \ref Allocator.context
+ */
+typedef void (*allocator_resetfunction_t) (void *context);
+
+/**
+ * \brief Memory allocator hooks (e.g. system heap, TLSF pool, bump arena)
+ *
+ * \details Installed per protocol stack via \ref
+ * protocol_set_allocator(Protocol*, const Allocator*) and \ref
+ * protocol_set_transaction_allocator(Protocol*, const Allocator*).   NULL
+ * allocators refer to the system heap (`malloc()` / `free()`).
+ */
+typedef struct Allocator
+{
+	allocator_allocatefunction_t allocate;     /**< Allocates memory */
+	allocator_reallocatefunction_t reallocate; /**< Resizes memory */
+	allocator_releasefunction_t release;       /**< Releases memory */
+	allocator_resetfunction_t reset; /**< Releases all memory at once (might be
+                                      NULL if not supported) */
+	void *context; /**< Allocator specific data passed to all functions */
+} Allocator;
+
+/**
+ * \brief Allocates memory
+ *
+ * \param allocator Allocator to be used (NULL for system heap)
+ * \param size Number of bytes to be allocated
+ * \return void*   Allocated memory or   NULL in case of error
+ */
+void *allocator_malloc (const Allocator *allocator, size_t size);
+
+/**
+ * \brief Resizes memory (semantics of `realloc()`)
+ *
+ * \param allocator Allocator that allocated   ptr (NULL for system heap)
+ * \param ptr Memory to be resized (might be   NULL)
+ * \param size New number of bytes
+ * \return void*   Resized memory or   NULL in case of error (  ptr stays
+ * valid)
+ */
+void *allocator_realloc (const Allocator *allocator, void *ptr, size_t size);
+
+/**
+ * \brief Releases memory
+ *
+ * \param allocator Allocator that allocated   ptr (NULL for system heap)
+ * \param ptr Memory to be released (might be   NULL)
+ */
+void allocator_free (const Allocator *allocator, void *ptr);
+
+/**
+ * \brief Releases all memory of allocator at once
+ *
+ * \details Does nothing for allocators without \ref Allocator.reset (e.g.
+ * system heap).
+ *
+ * \param allocator Allocator to be reset (NULL for system heap)
+ */
+void allocator_reset (const Allocator *allocator);
+
+/**
+ * \brief Alignment of memory handed out by \ref AllocatorArena
+ */
+#ifndef ALLOCATOR_ARENA_ALIGNMENT
+#define ALLOCATOR_ARENA_ALIGNMENT 8u
+#endif
+
+/**
+ * \brief Bump allocator serving memory from a fixed buffer
+ *
+ * \details Allocations are carved off the buffer one after another and are
+ * only given back all at once by \ref allocator_arena_reset. Releasing or
+ * resizing the most recent allocation is done in place, releasing any other
+ * allocation does nothing. Used as transaction allocator it makes
+ * Blocksec2Go commands run without touching the system heap.
+ */
+typedef struct AllocatorArena
+{
+	Allocator allocator; /**< Hooks to be installed, refer to this arena */
+	uint8_t *buffer;     /**< Memory served by arena */
+	size_t size;         /**< Number of bytes in buffer */
+	size_t used;         /**< Number of bytes currently used */
+	size_t last;         /**< Offset of most recent allocation (SIZE_MAX if
+                            none) */
+	size_t peak;         /**< Largest number of bytes used since
+                            initialization */
+} AllocatorArena;
+
+/**
+ * \brief Initializes arena serving memory from given buffer
+ *
+ * \param arena Arena to be initialized
+ * \param buffer Memory to be served by arena (aligned to \ref
+ * ALLOCATOR_ARENA_ALIGNMENT)
+ * \param size Number of bytes in   buffer
+ * \return const Allocator*   Allocator hooks of arena
+ */
+const Allocator *allocator_arena_initialize (AllocatorArena *arena,
+		void *buffer, size_t size);
+
+/**
+ * \brief Releases all memory served by arena at once
+ *
+ * \param arena Arena to be reset
+ */
+void allocator_arena_reset (AllocatorArena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IFX_ALLOCATOR_H_ */
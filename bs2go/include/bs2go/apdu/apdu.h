@@ -29,9 +29,11 @@
 #ifndef _IFX_APDU_H_
 #define _IFX_APDU_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#include "bs2go/allocator/allocator.h"
 #include "bs2go/error/error.h"
 
 #ifdef __cplusplus
@@ -83,6 +85,14 @@ typedef struct
 	 * \brief Expected number of bytes in response
 	 */
 	size_t le;
+
+	/**
+	 * \brief Allocator for \ref APDU.data and encodings (might be   NULL for
+	 * system heap)
+	 *
+	 * \details Must be set before decoding.
+	 */
+	const Allocator *allocator;
 } APDU;
 
 /**
@@ -160,6 +170,39 @@ int apdu_decode (APDU *apdu, uint8_t *data, size_t data_len);
  */
 int apdu_encode (APDU *apdu, uint8_t **buffer, size_t *buffer_len);
 
+/**
+ * \brief Maximum number of bytes in binary representation of short length
+ * \ref APDU (ISO7816-3 Case 4S)
+ */
+#define APDU_SHORT_MAX_LEN (4 + 1 + 0xff + 1)
+
+/**
+ * \brief Calculates number of bytes in binary representation of \ref APDU
+ *
+ * \param apdu APDU to be encoded
+ * \return size_t Number of bytes \ref apdu_encode_into(APDU*, uint8_t*,
+ * size_t, size_t*) will write
+ */
+size_t apdu_encoded_size (const APDU *apdu);
+
+/**
+ * \brief Encodes \ref APDU to its binary representation into caller provided
+ * buffer
+ *
+ * \details Lets callers reserve room around the APDU (e.g. for the framing of
+ * a protocol layer, see \ref protocol_get_headroom(Protocol*, size_t*,
+ * size_t*)) so that it is encoded right where it is transmitted from.
+ *
+ * \param apdu APDU to be encoded
+ * \param buffer Buffer to store encoded data in
+ * \param buffer_size Number of bytes available in   buffer
+ * \param encoded_len Pointer for storing number of bytes written to   buffer
+ * \return int   APDU_ENCODE_SUCCESS if successful, any other value in case
+ * of error
+ */
+int apdu_encode_into (APDU *apdu, uint8_t *buffer, size_t buffer_size,
+		size_t *encoded_len);
+
 /**
  * \brief Frees memory associated with \ref APDU object (but not object
  * itself)
@@ -192,6 +235,24 @@ typedef struct
 	 * \brief APDU response status word
 	 */
 	uint16_t sw;
+
+	/**
+	 * \brief Allocator for \ref APDUResponse.data and encodings (might be
+	 *   NULL for system heap)
+	 *
+	 * \details Must be set before decoding.
+	 */
+	const Allocator *allocator;
+
+	/**
+	 * \brief   true if \ref APDUResponse.data points into the buffer it has
+	 * been decoded from instead of being allocated
+	 *
+	 * \details Set by \ref apduresponse_decode_view(APDUResponse*, uint8_t*,
+	 * size_t). Borrowed data is not freed by \ref
+	 * apduresponse_destroy(APDUResponse*).
+	 */
+	bool borrowed;
 } APDUResponse;
 
 /**
@@ -219,6 +280,22 @@ typedef struct
 int apduresponse_decode (APDUResponse *response, uint8_t *data,
 		size_t data_len);
 
+/**
+ * \brief Decodes binary data to a view in \ref APDUResponse object without
+ * copying response data
+ *
+ * \details \ref APDUResponse.data points into   data, which must stay valid
+ * as long as the response is used.
+ *
+ * \param response APDU response object to store values in
+ * \param data Binary data to be decoded
+ * \param data_len Number of bytes in   data
+ * \return int   APDURESPONSE_DECODE_SUCCESS if successful, any other value
+ * in case of error
+ */
+int apduresponse_decode_view (APDUResponse *response, uint8_t *data,
+		size_t data_len);
+
 /**
  * \brief IFX error encoding function identifier for \ref
  * apduresponse_encode(APDUResponse*, uint8_t**, size_t*)
@@ -24,6 +24,16 @@
 
 /** \file blocksec2go.h
  * C-API for implementation of Blockchain Security 2 Go Starter Kit v2 command set. 
+ *
+ * Results handed out to the caller are allocated with the transaction
+ * allocator of the protocol stack (see \ref
+ * protocol_set_transaction_allocator(Protocol*, const Allocator*)) and are
+ * released with \ref allocator_free(const Allocator*, void*). Every command
+ * resets a dedicated transaction allocator on entry, so results stay valid
+ * until the next command on the same protocol stack.
+ *
+ * The `_into` variants write results into fixed size storage owned by the
+ * caller instead and neither allocate nor reset the transaction allocator.
  */
 
 
@@ -44,11 +54,42 @@
  */
 #define BLOCK2GO_PUBLIC_KEY_LEN 65
 
+/**
+ * \brief Maximum length of an ASN.1 DER encoded ECDSA signature
+ */
+#define BLOCK2GO_SIGNATURE_MAX_LEN 72
+
+/**
+ * \brief Maximum size of the zero terminated version string returned by SELECT
+ */
+#define BLOCK2GO_VERSION_MAX_LEN (256 - BLOCK2GO_ID_LEN + 1)
+
+/**
+ * \brief Maximum length of a key label
+ */
+#define BLOCK2GO_KEY_LABEL_MAX_LEN 1022
+
 /**
  * \brief Length of the seed for encrypted key import
  */
 #define BLOCK2GO_SEED_LEN 16
 
+/**
+ * \brief Length of encoded GENERATE SIGNATURE command APDU
+ */
+#define BLOCK2GO_GENERATE_SIGNATURE_APDU_LEN (4 + 1 + 32)
+
+/**
+ * \brief Set to 1 if the secure element accepts extended length APDUs
+ *
+ * \details Commands with more than 255 bytes of command data (e.g. UPDATE KEY
+ * LABEL) are then sent as a single ISO7816-3 Case 3E APDU. Otherwise they are
+ * split into short APDUs sized to fit into one T=1' I block each.
+ */
+#ifndef BLOCK2GO_EXTENDED_LENGTH
+#define BLOCK2GO_EXTENDED_LENGTH 0
+#endif
+
 /**
  * \brief I2C address of Blocksec2Go card
  */
@@ -102,6 +143,24 @@ typedef enum
 int block2go_select (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
 		char **version);
 
+/**
+ * \brief SELECT the Blockchain Security 2Go application without allocating.
+ *
+ * \param[in] protocol      instance of activated protocol to use
+ * \param[out] id           buffer to copy SE id to
+ * \param[out] version      buffer to copy zero terminated version string to
+ * \param[in] version_size  size of version buffer in bytes, at most
+ * BLOCK2GO_VERSION_MAX_LEN is needed
+ *
+ * \retval BLOCK2GO_SELECT_SUCCESS in case of success
+ * \retval BLOCK2GO_SELECT_SE_FAIL SE indicated error
+ * \retval BLOCK2GO_SELECT_INVALID_DATA_LENGTH unexpectedly short response or
+ * version not fitting into buffer
+ * \retval others indicate failures from lower layers
+ */
+int block2go_select_into (Protocol *protocol, uint8_t id[BLOCK2GO_ID_LEN],
+		char *version, size_t version_size);
+
 /**
  * \brief Creates new ECC public/private keypair for a session.
  *
@@ -178,6 +237,51 @@ int block2go_get_key_info_permanent (Protocol *protocol, uint8_t key_index,
 		uint32_t *global_counter,
 		uint32_t *counter, uint8_t **public_key);
 
+/**
+ * \brief Same as block2go_get_key_info_session() but copies the public key
+ * into caller provided storage.
+ *
+ * \param[in] protocol    instance of activated protocol to use
+ * \param[out] curve      ECC-curve used for encryption
+ * \param[out] global_counter buffer to copy remaining signatures of the card
+ * into
+ * \param[out] counter    buffer to copy remaining signatures for the given key
+ * into
+ * \param[out] public_key buffer to copy uncompressed public key into
+ *
+ * \retval BLOCK2GO_GET_KEY_INFO_SUCCESS in case of success
+ * \retval BLOCK2GO_GET_KEY_INFO_SE_FAIL SE indicated error
+ * \retval BLOCK2GO_GET_KEY_INFO_INVALID_DATA_LENGTH unexpectedly
+ * short/long response
+ * \retval others indicate failures from lower layers
+ */
+int block2go_get_key_info_session_into (Protocol *protocol,
+		block2go_curve *curve, uint32_t *global_counter, uint32_t *counter,
+		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN]);
+
+/**
+ * \brief Same as block2go_get_key_info_permanent() but copies the public key
+ * into caller provided storage.
+ *
+ * \param[in] protocol    instance of activated protocol to use
+ * \param[in] key_index   key index for which info should be given
+ * \param[out] curve      ECC-curve used for encryption
+ * \param[out] global_counter buffer to copy remaining signatures of the card
+ * into
+ * \param[out] counter    buffer to copy remaining signatures for the given key
+ * into
+ * \param[out] public_key buffer to copy uncompressed public key into
+ *
+ * \retval BLOCK2GO_GET_KEY_INFO_SUCCESS in case of success
+ * \retval BLOCK2GO_GET_KEY_INFO_SE_FAIL SE indicated error
+ * \retval BLOCK2GO_GET_KEY_INFO_INVALID_DATA_LENGTH unexpectedly
+ * short/long response
+ * \retval others indicate failures from lower layers
+ */
+int block2go_get_key_info_permanent_into (Protocol *protocol,
+		uint8_t key_index, block2go_curve *curve, uint32_t *global_counter,
+		uint32_t *counter, uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN]);
+
 /**
  * \brief Creates a new key pair by deriving the private key from a given seed.
  * The encrypted key is stored with the key slot index 0.
@@ -195,6 +299,99 @@ int block2go_get_key_info_permanent (Protocol *protocol, uint8_t key_index,
 int block2go_encrypted_keyimport (Protocol *protocol, block2go_curve curve,
 		uint8_t seed[BLOCK2GO_SEED_LEN]);
 
+/**
+ * \brief Encodes GENERATE SIGNATURE command APDU without sending it, e.g. for
+ * driving several secure elements via non-blocking transceive.
+ *
+ * \param[in] key_index     key index for which signature should be generated
+ * \param[in] key_type      type of key to be used
+ * \param[in] data_to_sign  hashed data that should be signed
+ * \param[out] encoded      buffer for storing encoded command APDU
+ * \param[out] encoded_len  buffer to copy length of the command APDU into
+ *
+ * \note encoded has to be freed by the caller
+ *
+ * \retval APDU_ENCODE_SUCCESS in case of success
+ * \retval others indicate failures from lower layers
+ */
+int block2go_generate_signature_encode (uint8_t key_index,
+		block2go_key_type key_type, uint8_t data_to_sign[32],
+		uint8_t **encoded, size_t *encoded_len);
+
+/**
+ * \brief Encodes GENERATE SIGNATURE command APDU into caller provided buffer,
+ * e.g. right behind the headroom of a frame buffer.
+ *
+ * \param[in] key_index     key index for which signature should be generated
+ * \param[in] key_type      type of key to be used
+ * \param[in] data_to_sign  hashed data that should be signed
+ * \param[out] encoded      buffer for storing encoded command APDU
+ * \param[in] encoded_size  number of bytes available in encoded (at least
+ * BLOCK2GO_GENERATE_SIGNATURE_APDU_LEN)
+ * \param[out] encoded_len  buffer to copy length of the command APDU into
+ *
+ * \retval APDU_ENCODE_SUCCESS in case of success
+ * \retval others indicate failures from lower layers
+ */
+int block2go_generate_signature_encode_into (uint8_t key_index,
+		block2go_key_type key_type, uint8_t data_to_sign[32],
+		uint8_t *encoded, size_t encoded_size, size_t *encoded_len);
+
+/**
+ * \brief Decodes response APDU to GENERATE SIGNATURE command.
+ *
+ * \param[in] response      response APDU as received from secure element
+ * \param[in] response_len  length of response APDU in bytes
+ * \param[out] global_counter buffer to copy remaining signatures of the card
+ * into
+ * \param[out] counter buffer to copy remaining signatures for the given key
+ * into
+ * \param[out] signature     buffer for storing ANS.1 DER encoded signature
+ * \param[out] signature_len buffer to copy length of the signature in bytes
+ * into
+ * \param[in] allocator     allocator for signature (NULL for system heap),
+ * e.g. transaction allocator of the protocol stack response was received with
+ *
+ * \note signature has to be freed by the caller via   allocator
+ *
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_SUCCESS in case of success
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_FAIL SE indicated error
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH unexpectedly
+ * short response
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_OUT_OF_MEMORY no memory for signature
+ * \retval others indicate failures from lower layers
+ */
+int block2go_generate_signature_decode (uint8_t *response, size_t response_len,
+		uint32_t *global_counter, uint32_t *counter, uint8_t **signature,
+		size_t *signature_len, const Allocator *allocator);
+
+/**
+ * \brief Decodes response APDU to GENERATE SIGNATURE command into caller
+ * provided storage.
+ *
+ * \details Counters are read from   response in place and the signature is
+ * copied exactly once.
+ *
+ * \param[in] response      response APDU as received from secure element
+ * \param[in] response_len  length of response APDU in bytes
+ * \param[out] global_counter buffer to copy remaining signatures of the card
+ * into
+ * \param[out] counter buffer to copy remaining signatures for the given key
+ * into
+ * \param[out] signature     buffer to copy ASN.1 DER encoded signature into
+ * \param[out] signature_len buffer to copy length of the signature in bytes
+ * into
+ *
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_SUCCESS in case of success
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_FAIL SE indicated error
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH unexpectedly
+ * short/long response
+ * \retval others indicate failures from lower layers
+ */
+int block2go_generate_signature_decode_into (uint8_t *response,
+		size_t response_len, uint32_t *global_counter, uint32_t *counter,
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len);
+
 /**
  * \brief Signs a given block of prehashed data using the stored private key
  * that is associated with the session key.
@@ -244,6 +441,56 @@ int block2go_generate_signature_permanent (
 		uint32_t *global_counter, uint32_t *counter, uint8_t **signature,
 		size_t *signature_len);
 
+/**
+ * \brief Same as block2go_generate_signature_session() but copies the
+ * signature into caller provided storage.
+ *
+ * \param[in] protocol       instance of activated protocol to use
+ * \param[in] data_to_sign   hashed data that should be signed
+ * \param[out] global_counter buffer to copy remaining signatures of the card
+ * into
+ * \param[out] counter       buffer to copy remaining signatures for the
+ * session key into
+ * \param[out] signature     buffer to copy ASN.1 DER encoded signature into
+ * \param[out] signature_len buffer to copy length of the signature in bytes
+ * into
+ *
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_SUCCESS in case of success
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_FAIL SE indicated error
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH unexpectedly short
+ * response
+ * \retval others indicate failures from lower layers
+ */
+int block2go_generate_signature_session_into (Protocol *protocol,
+		uint8_t data_to_sign[32], uint32_t *global_counter, uint32_t *counter,
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len);
+
+/**
+ * \brief Same as block2go_generate_signature_permanent() but copies the
+ * signature into caller provided storage.
+ *
+ * \param[in] protocol       instance of activated protocol to use
+ * \param[in] key_index      key index for which signature should be generated
+ * \param[in] data_to_sign   hashed data that should be signed
+ * \param[out] global_counter buffer to copy remaining signatures of the card
+ * into
+ * \param[out] counter       buffer to copy remaining signatures for the given
+ * key into
+ * \param[out] signature     buffer to copy ASN.1 DER encoded signature into
+ * \param[out] signature_len buffer to copy length of the signature in bytes
+ * into
+ *
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_SUCCESS in case of success
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_FAIL SE indicated error
+ * \retval BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH unexpectedly short
+ * response
+ * \retval others indicate failures from lower layers
+ */
+int block2go_generate_signature_permanent_into (Protocol *protocol,
+		uint8_t key_index, uint8_t data_to_sign[32], uint32_t *global_counter,
+		uint32_t *counter, uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN],
+		size_t *signature_len);
+
 /**
  * \brief Allocates storage of given size (between 01H to 400H) in persistent
  * memory to store metadata for a given key.
@@ -298,6 +545,29 @@ int block2go_update_key_label (Protocol *protocol, uint8_t key_index,
 int block2go_get_key_label (Protocol *protocol, uint8_t key_index,
 		uint8_t **key_label, uint16_t *key_label_length);
 
+/**
+ * \brief Same as block2go_get_key_label() but copies the key label into
+ * caller provided storage.
+ *
+ * \param[in] protocol          instance of activated protocol to use
+ * \param[in] key_index         key index for which label should be returned
+ * \param[out] key_label        buffer to copy key label into
+ * \param[in] key_label_size    size of key_label in bytes, at most
+ * BLOCK2GO_KEY_LABEL_MAX_LEN is needed
+ * \param[out] key_label_length buffer to copy length of key label into
+ *
+ * \retval BLOCK2GO_GET_KEY_LABEL_SUCCESS in case of success
+ * \retval BLOCK2GO_GET_KEY_LABEL_FAIL SE indicated error
+ * \retval BLOCK2GO_GET_KEY_LABEL_KEY_LABEL_TAG_MISSING malformed response
+ * \retval BLOCK2GO_GET_KEY_LABEL_INVALID_DATA_LENGTH malformed response,
+ * empty occurrence announcing more (6310) or key label not fitting into
+ * buffer
+ * \retval others indicate failures from lower layers
+ */
+int block2go_get_key_label_into (Protocol *protocol, uint8_t key_index,
+		uint8_t *key_label, uint16_t key_label_size,
+		uint16_t *key_label_length);
+
 /**
  * \brief Returns a random number having a given length.
  *
@@ -316,6 +586,24 @@ int block2go_get_key_label (Protocol *protocol, uint8_t key_index,
 int block2go_get_random (Protocol *protocol, uint8_t length,
 		uint8_t **random_num);
 
+/**
+ * \brief Same as block2go_get_random() but copies the random number into
+ * caller provided storage.
+ *
+ * \param[in] protocol    instance of activated protocol to use
+ * \param[in] length      length of random number
+ * \param[out] random_num buffer of at least length bytes to copy random
+ * number into
+ *
+ * \retval BLOCK2GO_GET_RANDOM_SUCCESS in case of success
+ * \retval BLOCK2GO_GET_RANDOM_FAIL SE indicated error
+ * \retval BLOCK2GO_GET_RANDOM_INVALID_DATA_LENGTH unexpectedly
+ * short/long response
+ * \retval others indicate failures from lower layers
+ */
+int block2go_get_random_into (Protocol *protocol, uint8_t length,
+		uint8_t *random_num);
+
 /**
  * \brief Checks whether a given ECDSA signature is valid.
  *
@@ -330,6 +618,9 @@ int block2go_get_random (Protocol *protocol, uint8_t length,
  * \retval BLOCK2GO_VERIFY_SIGNATURE_SE_FAIL SE indicated error
  * \retval BLOCK2GO_VERIFY_SIGNATURE_TOO_LITTLE_DATA unexpectedly
  * short/long response
+ * \retval BLOCK2GO_VERIFY_SIGNATURE_ILLEGAL_ARGUMENT command data exceeds a
+ * short APDU and BLOCK2GO_EXTENDED_LENGTH is not set
+ * \retval BLOCK2GO_VERIFY_SIGNATURE_OUT_OF_MEMORY no memory for command data
  * \retval others indicate failures from lower layers
  */
 int block2go_verify_signature (Protocol *protocol, block2go_curve curve,
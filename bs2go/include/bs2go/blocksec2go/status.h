@@ -258,6 +258,15 @@
 #define BLOCK2GO_GENERATE_SIGNATURE_INVALID_DATA_LENGTH                       \
   IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_GENERATE_SIGNATURE, INVALID_DATA_LENGTH)
 
+/**
+ * \brief IFX error code for unsuccessful call of
+ * block2go_generate_signature_permanent(),
+ * block2go_generate_signature_session() and
+ * block2go_generate_signature_decode() due to insufficient memory
+ */
+#define BLOCK2GO_GENERATE_SIGNATURE_OUT_OF_MEMORY                             \
+  IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_GENERATE_SIGNATURE, OUT_OF_MEMORY)
+
 /**
  * \brief IFX error code for unsuccessful call of block2go_create_key_label()
  * due to card failure
@@ -342,6 +351,20 @@
 #define BLOCK2GO_VERIFY_SIGNATURE_INVALID_DATA_LENGTH                         \
   IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_VERIFY_SIGNATURE, INVALID_DATA_LENGTH)
 
+/**
+ * \brief IFX error code for unsuccessful call of block2go_verify_signature()
+ * due to command data exceeding a short APDU without extended length support
+ */
+#define BLOCK2GO_VERIFY_SIGNATURE_ILLEGAL_ARGUMENT                            \
+  IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_VERIFY_SIGNATURE, ILLEGAL_ARGUMENT)
+
+/**
+ * \brief IFX error code for unsuccessful call of block2go_verify_signature()
+ * due to insufficient memory for command data
+ */
+#define BLOCK2GO_VERIFY_SIGNATURE_OUT_OF_MEMORY                               \
+  IFX_ERROR (LIBBLOCK2GO, BLOCK2GO_VERIFY_SIGNATURE, OUT_OF_MEMORY)
+
 /**
  * \brief IFX error code for unsuccessful call of
  * block2go_enable_protected_mode() due to card failure
@@ -0,0 +1,218 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file clock.h
+ * \brief Pluggable time source used by all modules of a protocol stack
+ */
+#ifndef _IFX_CLOCK_H_
+#define _IFX_CLOCK_H_
+
+#include <stdint.h>
+
+#include "bs2go/error/error.h"
+
+#ifdef CY_USING_HAL
+#include "cyhal.h"
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief IFX error code module identifer
+ */
+#define LIBCLOCK 0x3b
+
+/**
+ * \brief IFX error encoding function identifier for \ref clock_now(const
+ * Clock*, uint64_t*)
+ */
+#define CLOCK_NOW 0x01
+
+/**
+ * \brief Return code for successful calls to \ref clock_now(const Clock*,
+ * uint64_t*)
+ */
+#define CLOCK_NOW_SUCCESS SUCCESS
+
+/**
+ * \brief IFX error code reason if a clock has no time source (e.g. no
+ * hardware timer has been assigned)
+ */
+#define CLOCK_UNAVAILABLE 0x01
+
+/**
+ * \brief Time source function of a \ref Clock
+ *
+ * \param context \ref Clock.context
+ * \param now Buffer to store monotonic time in [us] in
+ * \return int   CLOCK_NOW_SUCCESS if successful, any other value in case of
+ * error
+ */
+typedef int (*clock_nowfunction_t) (void *context, uint64_t *now);
+
+/**
+ * \brief Sleep function of a \ref Clock
+ *
+ * \param context \ref Clock.context
+ * \param duration Time to wait in [us]
+ */
+typedef void (*clock_sleepfunction_t) (void *context, uint32_t duration);
+
+/**
+ * \brief Time source and sleep hooks (e.g. HAL timer, POSIX, virtual time)
+ *
+ * \details Installed per protocol stack via \ref protocol_set_clock(Protocol*,
+ * const Clock*).   NULL clocks refer to the system clock (PSoC6 HAL in
+ * firmware builds defining `CY_USING_HAL`, POSIX monotonic clock otherwise).
+ */
+typedef struct Clock
+{
+	clock_nowfunction_t now;     /**< Returns current time */
+	clock_sleepfunction_t sleep; /**< Waits for given time */
+	void *context; /**< Clock specific data passed to all functions */
+} Clock;
+
+/**
+ * \brief Reads current time
+ *
+ * \param clock Clock to be used (NULL for system clock)
+ * \param now Buffer to store monotonic time in [us] in (0 in case of error)
+ * \return int   CLOCK_NOW_SUCCESS if successful, any other value in case of
+ * error
+ */
+int clock_now (const Clock *clock, uint64_t *now);
+
+/**
+ * \brief Waits for given time
+ *
+ * \param clock Clock to be used (NULL for system clock)
+ * \param duration Time to wait in [us]
+ */
+void clock_sleep (const Clock *clock, uint32_t duration);
+
+/**
+ * \brief \ref clock_nowfunction_t of system clock
+ *
+ * \details Implemented by clock-hal.c or clock-posix.c depending on
+ * `CY_USING_HAL`. Firmware builds do not reserve a hardware timer on their
+ * own, so the system clock only sleeps there and reading the time fails with
+ * reason \ref CLOCK_UNAVAILABLE. Install a \ref ClockHAL to measure time.
+ */
+int clock_system_now (void *context, uint64_t *now);
+
+/**
+ * \brief \ref clock_sleepfunction_t of system clock
+ *
+ * \details Implemented by clock-hal.c or clock-posix.c depending on
+ * `CY_USING_HAL`.
+ */
+void clock_system_sleep (void *context, uint32_t duration);
+
+/**
+ * \brief Clock whose time only advances when slept on
+ *
+ * \details Sleeping returns immediately and adds the duration to the current
+ * time, so host tests and benchmarks of a whole protocol stack run without
+ * waiting while still observing exact simulated latencies.
+ */
+typedef struct ClockVirtual
+{
+	Clock clock;  /**< Hooks to be installed, refer to this clock */
+	uint64_t now; /**< Current time in [us] */
+} ClockVirtual;
+
+/**
+ * \brief Initializes virtual clock starting at given time
+ *
+ * \param clock Virtual clock to be initialized
+ * \param start Initial time in [us]
+ * \return const Clock*   Clock hooks of virtual clock
+ */
+const Clock *clock_virtual_initialize (ClockVirtual *clock, uint64_t start);
+
+/**
+ * \brief Advances virtual clock without sleeping on it (e.g. to model time
+ * spent outside of the protocol stack)
+ *
+ * \param clock Virtual clock to be advanced
+ * \param duration Time to be added in [us]
+ */
+void clock_virtual_advance (ClockVirtual *clock, uint64_t duration);
+
+#ifdef CY_USING_HAL
+
+/**
+ * \brief IFX error encoding function identifier for \ref
+ * clock_hal_initialize(ClockHAL*, cyhal_timer_t*)
+ */
+#define CLOCK_HAL_INITIALIZE 0x02
+
+/**
+ * \brief Return code for successful calls to \ref
+ * clock_hal_initialize(ClockHAL*, cyhal_timer_t*)
+ */
+#define CLOCK_HAL_INITIALIZE_SUCCESS SUCCESS
+
+/**
+ * \brief Clock measuring time with a hardware timer owned by the application
+ *
+ * \details Sleeps like the system clock. The timer counts [us] and is
+ * extended to 64 bits in software, so the time must be read at least once per
+ * timer period (71 minutes for 32 bit, 65 ms for 16 bit counters).
+ */
+typedef struct ClockHAL
+{
+	Clock clock;          /**< Hooks to be installed, refer to this clock */
+	cyhal_timer_t *timer; /**< Free running timer counting [us] */
+	uint32_t period;      /**< Last value of timer before it wraps */
+	uint32_t last;        /**< Last timer value (to detect wraps) */
+	uint64_t high;        /**< Time accumulated by timer wraps */
+} ClockHAL;
+
+/**
+ * \brief Initializes clock based on hardware timer
+ *
+ * \details Configures   timer as free running 1 MHz up counter with the
+ * widest period it supports and starts it.
+ *
+ * \param clock Clock to be initialized
+ * \param timer Timer already initialized via `cyhal_timer_init()`, reserved
+ * for this clock until it is freed by the application
+ * \return int   CLOCK_HAL_INITIALIZE_SUCCESS if successful, any other value
+ * in case of error
+ */
+int clock_hal_initialize (ClockHAL *clock, cyhal_timer_t *timer);
+
+#endif /* CY_USING_HAL */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IFX_CLOCK_H_ */
@@ -37,6 +37,39 @@ extern "C"
 {
 #endif
 
+/**
+ * \brief Build option selecting the CRC16 engine (ROM / speed tradeoff)
+ *
+ * \details Number of bytes processed per table lookup round. The lookup
+ * tables are constant data placed in ROM, one set per CRC polynomial:
+ *          - 0: bit-serial loop, no tables
+ *          - 1: one 256-entry table (512 bytes per polynomial, default)
+ *          - 4: slice-by-4 (2 KiB per polynomial)
+ *          - 8: slice-by-8 (4 KiB per polynomial)
+ *
+ *          Set via the application Makefile, e.g. `DEFINES+=CRC16_SLICE_BY=8`
+ */
+#ifndef CRC16_SLICE_BY
+#define CRC16_SLICE_BY 1
+#endif
+
+/**
+ * \brief Build option enabling the carry-less multiplication CRC16 kernel
+ *
+ * \details Folds 16 byte blocks with PCLMULQDQ for the reflected 0x8408
+ * polynomial (\ref crc16_ccitt_x25, \ref crc16_mcrf4xx). Only available on
+ * x86 host builds with GCC or Clang and enabled there by default. The kernel
+ * is selected at runtime if the CPU supports it, otherwise the engine
+ * selected by \ref CRC16_SLICE_BY is used.
+ */
+#ifndef CRC16_CLMUL
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CRC16_CLMUL 1
+#else
+#define CRC16_CLMUL 0
+#endif
+#endif
+
 /**
  * \brief Calculates 16 bit CRC according to CCITT x.25 specification.
  *
@@ -66,6 +99,64 @@ uint16_t crc16_mcrf4xx (uint8_t *data, size_t data_len);
  */
 uint16_t crc16_t1gd (uint8_t *data, size_t data_len);
 
+/**
+ * \brief 16 bit CRC algorithms supported by incremental calculation
+ */
+typedef enum
+{
+	CRC16_CCITT_X25 = 0, /**< CCITT x.25, see \ref crc16_ccitt_x25 */
+	CRC16_MCRF4XX = 1,   /**< MCRF4xx, see \ref crc16_mcrf4xx */
+	CRC16_T1GD = 2       /**< G+D T=1, see \ref crc16_t1gd */
+} crc16_algorithm;
+
+/**
+ * \brief State of an incremental 16 bit CRC calculation
+ *
+ * \details Allows calculating a CRC over data that is not available in one
+ * contiguous buffer (e.g. protocol frames received in several parts).
+ *
+ * \code
+ *     CRC16 crc;
+ *     crc16_init (&crc, CRC16_CCITT_X25);
+ *     crc16_update (&crc, prologue, prologue_len);
+ *     crc16_update (&crc, information, information_len);
+ *     uint16_t result = crc16_final (&crc);
+ * \endcode
+ */
+typedef struct CRC16
+{
+	crc16_algorithm algorithm; /**< Algorithm used for calculation */
+	uint16_t crc;              /**< Current CRC register value */
+} CRC16;
+
+/**
+ * \brief Starts incremental 16 bit CRC calculation
+ *
+ * \param ctx CRC state to be initialized
+ * \param algorithm CRC algorithm to be used
+ */
+void crc16_init (CRC16 *ctx, crc16_algorithm algorithm);
+
+/**
+ * \brief Feeds data into incremental 16 bit CRC calculation
+ *
+ * \param ctx CRC state initialized by \ref crc16_init
+ * \param data Data to calculate CRC over
+ * \param data_len Number of bytes in   data
+ */
+void crc16_update (CRC16 *ctx, const uint8_t *data, size_t data_len);
+
+/**
+ * \brief Finishes incremental 16 bit CRC calculation
+ *
+ * \details Does not modify   ctx so the calculation can be continued
+ * afterwards.
+ *
+ * \param ctx CRC state initialized by \ref crc16_init
+ * \return uint16_t CRC over all data fed into   ctx
+ */
+uint16_t crc16_final (const CRC16 *ctx);
+
 /**
  * \brief Calculates 8 bit Longitudinal Redundancy Code (LRC)
  *
@@ -30,6 +30,7 @@
 #define _IFX_LOGGER_H_
 
 #include <stdarg.h>
+#include "bs2go/allocator/allocator.h"
 #include "bs2go/error/error.h"
 
 #ifdef __cplusplus
@@ -182,6 +183,27 @@ typedef int (*logger_logfunction_t)(Logger *self, const char *source, LogLevel l
  */
 int logger_set_level(Logger* self, LogLevel level);
 
+/**
+ * \brief IFX error encoding function identifier for \ref logger_set_allocator(Logger*, const Allocator*)
+ */
+#define LOGGER_SET_ALLOCATOR 0x02
+
+/**
+ * \brief Return code for successful calls to \ref logger_set_allocator(Logger*, const Allocator*)
+ */
+#define LOGGER_SET_ALLOCATOR_SUCCESS SUCCESS
+
+/**
+ * \brief Sets allocator used for formatting messages
+ *
+ * \details Format buffers only live for the duration of a single log call.
+ *
+ * \param self \ref Logger object to set allocator for
+ * \param allocator \ref Allocator to be used (might be \c NULL for system heap)
+ * \return int \c LOGGER_SET_ALLOCATOR_SUCCESS if successful, any other value in case of error
+ */
+int logger_set_allocator(Logger *self, const Allocator *allocator);
+
 /**
  * \brief Frees memory associated with \ref Logger object (but not object itself)
  *
@@ -232,6 +254,14 @@ struct Logger
      */
     LogLevel _level;
 
+    /**
+     * \brief Private member for optional \ref Allocator
+     *
+     * \details Set by \ref logger_set_allocator(Logger*, const Allocator*), do **NOT** set manually.
+     *          Might be \c NULL for system heap.
+     */
+    const Allocator *_allocator;
+
     /**
      * \brief Private member for generic logger data as \c void*
      *
@@ -33,6 +33,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "bs2go/allocator/allocator.h"
+#include "bs2go/clock/clock.h"
 #include "bs2go/error/error.h"
 #include "bs2go/logger/logger.h"
 
@@ -147,6 +149,166 @@ typedef int (*protocol_transceivefunction_t) (Protocol *self, uint8_t *data,
 int protocol_transceive (Protocol *self, uint8_t *data, size_t data_len,
 		uint8_t **response, size_t *response_len);
 
+/**
+ * \brief Function independent error reason if response does not fit into
+ * caller provided segments
+ */
+#define RESPONSE_TOO_LONG 0x8e
+
+/**
+ * \brief Contiguous part of data scattered over several buffers (e.g. APDU
+ * header, command data and LE)
+ */
+typedef struct ProtocolSegment
+{
+	uint8_t *data; /**< Start of segment (might be   NULL if   len is 0) */
+	size_t len;    /**< Number of bytes in segment */
+} ProtocolSegment;
+
+/**
+ * \brief Protocol layer specific transceive function for data scattered over
+ * several segments
+ *
+ * \details Command segments are sent as one message without being joined,
+ * response data is filled into the response segments in order. The last
+ * bytes received may end up anywhere in the response segments, use \ref
+ * protocol_segments_gather to extract them.
+ *
+ * \param self \ref Protocol stack for performing necessary operations
+ * \param command Segments of data to be send via protocol
+ * \param command_count Number of segments in   command
+ * \param response Segments to store response in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of received bytes in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in case of error
+ */
+typedef int (*protocol_transceiveiovfunction_t) (Protocol *self,
+		const ProtocolSegment *command,
+		size_t command_count,
+		const ProtocolSegment *response,
+		size_t response_count,
+		size_t *response_len);
+
+/**
+ * \brief Sends data scattered over several segments via protocol and reads
+ * back response into caller provided segments
+ *
+ * \details Uses \ref Protocol._transceive_iov if available and falls back to
+ * \ref protocol_transceive(Protocol*, uint8_t*, size_t, uint8_t**, size_t*)
+ * (joining command and copying response) otherwise.
+ *
+ * \param self \ref Protocol stack for performing necessary operations
+ * \param command Segments of data to be send via protocol
+ * \param command_count Number of segments in   command
+ * \param response Segments to store response in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of received bytes in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in case of error
+ */
+int protocol_transceive_iov (Protocol *self, const ProtocolSegment *command,
+		size_t command_count,
+		const ProtocolSegment *response,
+		size_t response_count, size_t *response_len);
+
+/**
+ * \brief Protocol layer specific transceive function for data encoded into
+ * caller provided room of the frame buffer
+ *
+ * \details   buffer starts with \ref Protocol._headroom reserved bytes,
+ * followed by   data_len bytes of data and \ref Protocol._tailroom reserved
+ * bytes. The layer may write its framing into the reserved bytes and send the
+ * data right from   buffer instead of copying it into a frame of its own.
+ *
+ * \param self \ref Protocol stack for performing necessary operations
+ * \param buffer Frame buffer holding data to be send via protocol
+ * \param data_len Number of data bytes in   buffer
+ * \param response Segments to store response in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of received bytes in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in case of error
+ */
+typedef int (*protocol_transceiveinplacefunction_t) (Protocol *self,
+		uint8_t *buffer,
+		size_t data_len,
+		const ProtocolSegment *response,
+		size_t response_count,
+		size_t *response_len);
+
+/**
+ * \brief Sends data encoded into caller provided room of a frame buffer via
+ * protocol and reads back response into caller provided segments
+ *
+ * \details   buffer must hold the headroom and tailroom reported by \ref
+ * protocol_get_headroom(Protocol*, size_t*, size_t*) around   data_len bytes
+ * of data. Uses \ref Protocol._transceive_inplace if available and falls
+ * back to \ref protocol_transceive_iov(Protocol*, const ProtocolSegment*,
+ * size_t, const ProtocolSegment*, size_t, size_t*) otherwise.
+ *
+ * \param self \ref Protocol stack for performing necessary operations
+ * \param buffer Frame buffer holding data to be send via protocol
+ * \param data_len Number of data bytes in   buffer
+ * \param response Segments to store response in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of received bytes in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in case of error
+ */
+int protocol_transceive_inplace (Protocol *self, uint8_t *buffer,
+		size_t data_len, const ProtocolSegment *response,
+		size_t response_count, size_t *response_len);
+
+/**
+ * \brief Returns number of bytes to be reserved in front of and behind data
+ * passed to \ref protocol_transceive_inplace(Protocol*, uint8_t*, size_t,
+ * const ProtocolSegment*, size_t, size_t*)
+ *
+ * \param self \ref Protocol object to get headroom for
+ * \param headroom Buffer to store number of bytes in front of data in
+ * \param tailroom Buffer to store number of bytes behind data in
+ */
+void protocol_get_headroom (Protocol *self, size_t *headroom,
+		size_t *tailroom);
+
+/**
+ * \brief Returns total number of bytes in segments
+ *
+ * \param segments Segments to be summed up
+ * \param count Number of segments in   segments
+ * \return size_t Sum of all segment lengths
+ */
+size_t protocol_segments_length (const ProtocolSegment *segments,
+		size_t count);
+
+/**
+ * \brief Copies bytes from segments (starting at given offset) into
+ * contiguous buffer
+ *
+ * \param segments Segments to copy from
+ * \param count Number of segments in   segments
+ * \param offset Offset of first byte to be copied within segments
+ * \param buffer Buffer to copy bytes into
+ * \param len Number of bytes to be copied
+ * \return size_t Number of bytes actually copied (less than   len if
+ * segments end before)
+ */
+size_t protocol_segments_gather (const ProtocolSegment *segments,
+		size_t count, size_t offset,
+		uint8_t *buffer, size_t len);
+
+/**
+ * \brief Copies contiguous data into segments (starting at given offset)
+ *
+ * \param segments Segments to copy into
+ * \param count Number of segments in   segments
+ * \param offset Offset of first byte to be written within segments
+ * \param data Data to be copied
+ * \param len Number of bytes in   data
+ * \return size_t Number of bytes actually copied (less than   len if
+ * segments end before)
+ */
+size_t protocol_segments_scatter (const ProtocolSegment *segments,
+		size_t count, size_t offset,
+		const uint8_t *data, size_t len);
+
 /**
  * \brief IFX error encoding function identifier for \ref
  * protocol_transmitfunction_t
@@ -202,6 +364,41 @@ typedef int (*protocol_receivefunction_t) (Protocol *self,
 		uint8_t **response,
 		size_t *response_len);
 
+/**
+ * \brief Protocol layer specific receive function reading into caller
+ * provided memory
+ *
+ * \details Avoids allocating a fresh response for every read, e.g. while
+ * polling a secure element.
+ *
+ * \param self \ref Protocol stack for performing necessary operations.
+ * \param buffer Buffer to store response in
+ * \param buffer_len Number of bytes to be read into   buffer
+ * \param received_len Buffer to store number of received bytes in (number of
+ * bytes in   buffer)
+ * \return int PROTOCOL_RECEIVE_SUCCESS if successful, any other value in case of error
+ */
+typedef int (*protocol_receiveintofunction_t) (Protocol *self,
+		uint8_t *buffer,
+		size_t buffer_len,
+		size_t *received_len);
+
+/**
+ * \brief Receives data into caller provided memory
+ *
+ * \details Uses \ref Protocol._receive_into if available and falls back to
+ * \ref Protocol._receive (copying the allocated response) otherwise.
+ *
+ * \param self \ref Protocol stack for performing necessary operations.
+ * \param buffer Buffer to store response in
+ * \param buffer_len Number of bytes to be read into   buffer
+ * \param received_len Buffer to store number of received bytes in (number of
+ * bytes in   buffer)
+ * \return int PROTOCOL_RECEIVE_SUCCESS if successful, any other value in case of error
+ */
+int protocol_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len);
+
 /**
  * \brief IFX error encoding function identifier for any protocol property
  * getter
@@ -261,6 +458,86 @@ void protocol_destroy (Protocol *self);
  */
   void protocol_set_logger (Protocol *self, Logger *logger);
 
+/**
+ * \brief Sets allocator to be used by protocol for long-lived memory
+ *
+ * \details Sets allocator for whole protocol stack, so all layers below will
+ * also use it (e.g. for protocol states and frame buffers). Must be set
+ * before the stack allocates anything (i.e. before activation) and must
+ * outlive the stack.
+ *
+ * \param self \ref Protocol object to set allocator for
+ * \param allocator \ref Allocator to be used (might be   NULL for system
+ * heap)
+ */
+void protocol_set_allocator (Protocol *self, const Allocator *allocator);
+
+/**
+ * \brief Sets allocator to be used by protocol for per-transaction memory
+ *
+ * \details Sets allocator for whole protocol stack, so all layers below will
+ * also use it. Responses handed out by \ref protocol_transceive(Protocol*,
+ * uint8_t*, size_t, uint8_t**, size_t*) and by \ref Protocol._receive of
+ * driver layers as well as results of higher level commands are allocated
+ * with it and must be released with \ref allocator_free(const Allocator*,
+ * void*). \ref protocol_receive_into(Protocol*, uint8_t*, size_t, size_t*)
+ * reads into caller memory and does not use it. A bump arena (\ref AllocatorArena) might be installed
+ * which is reset at the start of every Blocksec2Go command.
+ *
+ * \param self \ref Protocol object to set allocator for
+ * \param allocator \ref Allocator to be used (might be   NULL to use
+ * allocator set by \ref protocol_set_allocator(Protocol*, const Allocator*))
+ */
+void protocol_set_transaction_allocator (Protocol *self,
+		const Allocator *allocator);
+
+/**
+ * \brief Returns allocator used by protocol for long-lived memory
+ *
+ * \param self \ref Protocol object to get allocator for
+ * \return const Allocator*   Allocator to be used (  NULL for system heap)
+ */
+const Allocator *protocol_get_allocator (Protocol *self);
+
+/**
+ * \brief Returns allocator used by protocol for per-transaction memory
+ *
+ * \param self \ref Protocol object to get allocator for
+ * \return const Allocator*   Allocator to be used (  NULL for system heap)
+ */
+const Allocator *protocol_get_transaction_allocator (Protocol *self);
+
+/**
+ * \brief Releases all per-transaction memory at once
+ *
+ * \details Only resets an allocator installed via \ref
+ * protocol_set_transaction_allocator(Protocol*, const Allocator*), the
+ * long-lived allocator it falls back to is never reset.
+ *
+ * \param self \ref Protocol object to reset transaction allocator for
+ */
+void protocol_reset_transaction_allocator (Protocol *self);
+
+/**
+ * \brief Sets clock to be used by protocol for timing and waiting
+ *
+ * \details Sets clock for whole protocol stack, so all layers below will
+ * also use it (e.g. for polling delays and simulated latencies). Must
+ * outlive the stack.
+ *
+ * \param self \ref Protocol object to set clock for
+ * \param clock \ref Clock to be used (might be   NULL for system clock)
+ */
+void protocol_set_clock (Protocol *self, const Clock *clock);
+
+/**
+ * \brief Returns clock used by protocol for timing and waiting
+ *
+ * \param self \ref Protocol object to get clock for
+ * \return const Clock*   Clock to be used (  NULL for system clock)
+ */
+const Clock *protocol_get_clock (Protocol *self);
+
 /**
  * \brief IFX error encoding function identifier for \ref
  * protocollayer_initialize(Protocol*)
@@ -326,6 +603,44 @@ struct Protocol
 	 */
 	protocol_transceivefunction_t _transceive;
 
+	/**
+	 * \brief Private function for sending and receiving data scattered over
+	 * several segments at once
+	 *
+	 * \details Set by implementations initialization function, do **NOT** set
+	 * manually. Might be   NULL in which case \ref Protocol._transceive (or
+	 * \ref Protocol._transmit and \ref Protocol._receive) is used instead.
+	 */
+	protocol_transceiveiovfunction_t _transceive_iov;
+
+	/**
+	 * \brief Private function for sending data encoded into the headroom and
+	 * tailroom reserved by the caller
+	 *
+	 * \details Set by implementations initialization function, do **NOT** set
+	 * manually. Might be   NULL in which case \ref Protocol._transceive_iov
+	 * is used with the data only.
+	 */
+	protocol_transceiveinplacefunction_t _transceive_inplace;
+
+	/**
+	 * \brief Private number of bytes the layer prepends to data in \ref
+	 * Protocol._transceive_inplace
+	 *
+	 * \details Set by implementations initialization function, do **NOT** set
+	 * manually.
+	 */
+	size_t _headroom;
+
+	/**
+	 * \brief Private number of bytes the layer appends to data in \ref
+	 * Protocol._transceive_inplace
+	 *
+	 * \details Set by implementations initialization function, do **NOT** set
+	 * manually.
+	 */
+	size_t _tailroom;
+
 	/**
 	 * \brief Private function for sending data
 	 *
@@ -344,12 +659,21 @@ struct Protocol
 	 */
 	protocol_receivefunction_t _receive;
 
+	/**
+	 * \brief Private function for receiving data into caller provided memory
+	 *
+	 * \details Set by implementations initialization function, do **NOT** set
+	 * manually. Might be   NULL in which case \ref Protocol._receive is used
+	 * instead.
+	 */
+	protocol_receiveintofunction_t _receive_into;
+
 	/**
 	 * \brief Private destructor if further cleanup is necessary
 	 *
 	 * \details Set by implementations initialization function, do **NOT** set
-	 * manually. \ref protocol_destroy(Protocol*) will call `free()` for \ref
-	 * Protocol._properties . If any further cleanup necessary implement it in
+	 * manually. \ref protocol_destroy(Protocol*) will release \ref
+	 * Protocol._properties with \ref Protocol._allocator . If any further cleanup necessary implement it in
 	 * this function otherwise use   NULL
 	 */
 	protocol_destroyfunction_t _destructor;
@@ -362,6 +686,32 @@ struct Protocol
 	 */
 	 Logger *_logger;
 
+	/**
+	 * \brief Private member for optional \ref Allocator of long-lived memory
+	 *
+	 * \details Set by \ref protocol_set_allocator(Protocol*, const
+	 * Allocator*), do **NOT** set manually. Might be   NULL for system heap.
+	 */
+	const Allocator *_allocator;
+
+	/**
+	 * \brief Private member for optional \ref Allocator of per-transaction
+	 * memory
+	 *
+	 * \details Set by \ref protocol_set_transaction_allocator(Protocol*, const
+	 * Allocator*), do **NOT** set manually. Might be   NULL in which case \ref
+	 * Protocol._allocator is used.
+	 */
+	const Allocator *_transaction_allocator;
+
+	/**
+	 * \brief Private member for optional \ref Clock
+	 *
+	 * \details Set by \ref protocol_set_clock(Protocol*, const Clock*), do
+	 * **NOT** set manually. Might be   NULL for system clock.
+	 */
+	const Clock *_clock;
+
 	/**
 	 * \brief Private member for generic properties as   void*
 	 *
@@ -31,6 +31,7 @@
 #ifndef _IFX_PSOC6_I2C_H_
 #define _IFX_PSOC6_I2C_H_
 
+#include "cyhal.h"
 #include "bs2go/error/error.h"
 #include "bs2go/i2c/i2c.h"
 #include "bs2go/protocol/protocol.h"
@@ -54,6 +55,24 @@ extern "C"
  */
 int psoc6_i2c_initialize (Protocol *self);
 
+/**
+ * \brief Initializes \ref Protocol object for PSoC™ 6 driver layer talking to
+ * a secure element on the I2C bus on given pins
+ *
+ * \details Secure elements on the same pins share the I2C master, each
+ * driver layer keeps its own slave address and clock frequency. Use \ref
+ * i2c_set_slave_address(Protocol*, uint16_t) to address further secure
+ * elements on a bus.
+ *
+ * \param self \ref Protocol object to be initialized.
+ * \param sda Pin used as I2C SDA
+ * \param scl Pin used as I2C SCL
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error.
+ */
+int psoc6_i2c_initialize_bus (Protocol *self, cyhal_gpio_t sda,
+		cyhal_gpio_t scl);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,8 +30,10 @@
 #ifndef _PSOC6_I2C_H_
 #define _PSOC6_I2C_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "cyhal.h"
 #include "bs2go/protocol/protocol.h"
 
 #ifdef __cplusplus
@@ -39,6 +41,19 @@ extern "C"
 {
 #endif
 
+/**
+ * \brief I2C bus (SCB block) shared by all secure elements on the same pins
+ */
+typedef struct Psoc6I2CBus
+{
+	cyhal_i2c_t hal;          /**< HAL I2C master object */
+	cyhal_gpio_t sda;         /**< Pin used as I2C SDA */
+	cyhal_gpio_t scl;         /**< Pin used as I2C SCL */
+	uint32_t clock_frequency; /**< Clock frequency the bus is currently
+                                 configured for in [Hz] */
+	size_t references;        /**< Number of driver layers using the bus */
+} Psoc6I2CBus;
+
 /**
  * \brief State of I2C driver layer
  */
@@ -46,6 +61,11 @@ typedef struct ProtocolState
 {
 	uint16_t slave_address;   /**< I2C address currently in use */
 	uint32_t clock_frequency; /**< I2C clock frequency in [Hz] */
+	uint32_t max_clock_frequency; /**< Highest I2C clock frequency the board
+                                     supports in [Hz] */
+	Psoc6I2CBus *bus; /**< I2C bus the secure element is connected to */
+	const Allocator *allocator; /**< Allocator this state has been allocated
+                                   with */
 } ProtocolState;
 
 /**
@@ -66,6 +86,50 @@ typedef struct ProtocolState
  */
 #define I2C_DEFAULT_CLOCK_FREQUENCY ((uint32_t)400000)
 
+/**
+ * \brief Highest I2C clock frequency supported by the driver in [Hz]
+ *
+ * \details Fast-mode Plus. Boards whose pull-ups do not allow Fm+ can lower
+ * the ceiling at build time, faster requested frequencies are clamped to it.
+ */
+#ifndef I2C_MAX_CLOCK_FREQUENCY
+#define I2C_MAX_CLOCK_FREQUENCY ((uint32_t)1000000)
+#endif
+
+/**
+ * \brief Maximum number of I2C buses driven at the same time
+ */
+#ifndef PSOC6_I2C_MAX_BUSES
+#define PSOC6_I2C_MAX_BUSES 2
+#endif
+
+/**
+ * \brief Gets shared I2C bus on given pins, initializing it on first use
+ *
+ * \param sda Pin used as I2C SDA
+ * \param scl Pin used as I2C SCL
+ * \param frequency Initial I2C clock frequency in [Hz]
+ * \param bus_buffer Buffer to store bus in
+ * \return int   CY_RSLT_SUCCESS if successful, any other value in case of error
+ */
+int psoc6_i2c_bus_acquire (cyhal_gpio_t sda, cyhal_gpio_t scl,
+		uint32_t frequency, Psoc6I2CBus **bus_buffer);
+
+/**
+ * \brief Drops reference to shared I2C bus, deinitializing it once unused
+ *
+ * \param bus I2C bus to be released
+ */
+void psoc6_i2c_bus_release (Psoc6I2CBus *bus);
+
+/**
+ * \brief Switches shared I2C bus to clock frequency of given secure element
+ *
+ * \param protocol_state State of I2C driver layer of secure element
+ * \return int   CY_RSLT_SUCCESS if successful, any other value in case of error
+ */
+int psoc6_i2c_bus_configure (ProtocolState *protocol_state);
+
 /**
  * \brief \ref protocol_transmitfunction_t for PSoC™ 6 driver layer
  *
@@ -81,6 +145,14 @@ int psoc6_i2c_transmit (Protocol *self, uint8_t *data, size_t data_len);
 int psoc6_i2c_receive (Protocol *self, size_t expected_len, uint8_t **response,
 		size_t *response_len);
 
+/**
+ * \brief \ref protocol_receiveintofunction_t for PSoC™ 6 driver layer
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int psoc6_i2c_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len);
+
 /**
  * \brief \ref protocol_destroyfunction_t for PSoC™ 6 driver layer
  *
@@ -0,0 +1,152 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file replay.h
+ *
+ * \brief Driver layer answering from a recorded bus trace
+ *
+ * \details Host-side stand-in for the I2C driver layer replaying a trace
+ * dumped by the trace layer (\ref trace.h) of a real secure element session.
+ * Every frame the host transmits must match the next recorded transmission,
+ * the secure element's answer is then served from the recorded reads.
+ *
+ * Answers are reassembled to whole T=1' frames, so the host might read them
+ * in different chunks (e.g. coalesced reads) and poll at different times than
+ * the recorded host did. Recorded polls and not-ready reads (NAD 0x00 /
+ * 0xff) are skipped. An answer becomes readable once the time between the
+ * recorded transmission and the first recorded read of the answer has passed
+ * on the stack's \ref Clock (scaled by \ref ReplayConfig.time_scale), reads
+ * before that are not acknowledged. As recorded reads only happen after the
+ * secure element was ready, this is an upper bound of its processing time.
+ *
+ * Together with i2c-host.c, which dispatches the generic I2C API (\ref
+ * i2c.h) to it, the driver layer replaces psoc6-i2c.c (or sim-se.c) in host
+ * builds. Both are excluded from the firmware build via .cyignore.
+ *
+ * \example
+ *      Protocol driver, protocol;
+ *      replay_initialize (&driver, trace, trace_len, NULL);
+ *      t1prime_initialize (&protocol, &driver);
+ *      protocol_set_clock (&protocol, clock_virtual_initialize (&clock, 0));
+ *      protocol_activate (&protocol, &response, &response_len);
+ */
+#ifndef _IFX_REPLAY_H_
+#define _IFX_REPLAY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bs2go/error/error.h"
+#include "bs2go/i2c/i2c.h"
+#include "bs2go/protocol/protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief IFX error code module identifer
+ */
+#define LIBREPLAY 0x3a
+
+/**
+ * \brief IFX error code reason if recorded answer is not readable yet
+ */
+#define REPLAY_NACK 0x70
+
+/**
+ * \brief IFX error code reason if transmitted data does not match recording
+ */
+#define REPLAY_MISMATCH 0x71
+
+/**
+ * \brief IFX error code reason if recording has no further transmission
+ */
+#define REPLAY_END_OF_TRACE 0x72
+
+/**
+ * \brief Time scale replaying recorded timing unchanged
+ */
+#define REPLAY_TIME_SCALE_RECORDED 1000u
+
+/**
+ * \brief Behaviour of replay driver layer
+ */
+typedef struct ReplayConfig
+{
+	uint32_t time_scale; /**< Factor applied to recorded processing times in
+                            [1/1000] (0 answers immediately) */
+} ReplayConfig;
+
+/**
+ * \brief Activity counters of replay driver layer
+ */
+typedef struct ReplayStatistics
+{
+	size_t transmits;  /**< Number of matching transmissions */
+	size_t frames;     /**< Number of answers served */
+	size_t nacks;      /**< Number of reads before answer was readable */
+	size_t mismatches; /**< Number of transmissions not matching recording */
+	bool finished;     /**< Whether all recorded transmissions have been
+                          replayed */
+} ReplayStatistics;
+
+/**
+ * \brief Populates config replaying recorded timing unchanged
+ *
+ * \param config Config to be populated
+ */
+void replay_get_default_config (ReplayConfig *config);
+
+/**
+ * \brief Initializes \ref Protocol object for replay driver layer
+ *
+ * \param self \ref Protocol object to be initialized
+ * \param trace Dumped trace (must outlive the stack)
+ * \param trace_len Number of bytes in   trace
+ * \param config Behaviour of replay, copied (  NULL for default config)
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error
+ */
+int replay_initialize (Protocol *self, const uint8_t *trace, size_t trace_len,
+		const ReplayConfig *config);
+
+/**
+ * \brief Getter for activity counters of replay driver layer
+ *
+ * \param self Protocol stack containing replay driver layer
+ * \param statistics Buffer to store counters in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int replay_get_statistics (Protocol *self, ReplayStatistics *statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IFX_REPLAY_H_*/
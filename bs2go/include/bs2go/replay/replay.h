@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file replay.h
+ *
+ * \brief Internal definitions for replay driver layer
+ */
+#ifndef _REPLAY_H_
+#define _REPLAY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bs2go/allocator/allocator.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/replay/ifx/replay.h"
+#include "bs2go/t1prime/t1prime.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief Protocol Layer ID for replay driver layer
+ *
+ * \details Used to verify that correct protocol layer has called member
+ * functionality
+ */
+#define REPLAY_PROTOCOLLAYER_ID 0x3a
+
+/**
+ * \brief State of replay driver layer
+ */
+typedef struct ReplayProtocolState
+{
+	ReplayConfig config;         /**< Behaviour of replay */
+	ReplayStatistics statistics; /**< Activity counters */
+	const uint8_t *trace;        /**< Dumped trace */
+	size_t trace_len;            /**< Number of bytes in   trace */
+	size_t offset;               /**< Offset of next unconsumed event */
+	uint16_t slave_address;      /**< I2C address set by host */
+	uint32_t clock_frequency;    /**< I2C clock frequency set by host in
+                                    [Hz] */
+	uint8_t frame[T1PRIME_FRAME_SIZE (T1PRIME_MAX_IFS)]; /**< Recorded answer
+                                    reassembled from reads */
+	size_t frame_len;            /**< Number of bytes in   frame */
+	size_t frame_read;           /**< Number of bytes of   frame already
+                                    read by host */
+	uint64_t ready_at;           /**< Time   frame can be read at in [us] */
+	const Allocator *allocator;  /**< Allocator this state has been
+                                    allocated with */
+} ReplayProtocolState;
+
+/**
+ * \brief Returns current protocol state of replay driver layer
+ *
+ * \param self Protocol stack containing replay driver layer
+ * \param protocol_state_buffer Buffer to store protocol state in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int replay_get_protocol_state (Protocol *self,
+		ReplayProtocolState **protocol_state_buffer);
+
+/**
+ * \brief \ref protocol_transmitfunction_t for replay driver layer
+ *
+ * \see protocol_transmitfunction_t
+ */
+int replay_transmit (Protocol *self, uint8_t *data, size_t data_len);
+
+/**
+ * \brief \ref protocol_receivefunction_t for replay driver layer
+ *
+ * \see protocol_receivefunction_t
+ */
+int replay_receive (Protocol *self, size_t expected_len, uint8_t **response,
+		size_t *response_len);
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for replay driver layer
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int replay_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len);
+
+/**
+ * \brief \ref i2c_get_clock_frequency(Protocol*, uint32_t*) for replay driver
+ * layer
+ */
+int replay_i2c_get_clock_frequency (Protocol *self,
+		uint32_t *frequency_buffer);
+
+/**
+ * \brief \ref i2c_set_clock_frequency(Protocol*, uint32_t) for replay driver
+ * layer
+ */
+int replay_i2c_set_clock_frequency (Protocol *self, uint32_t frequency);
+
+/**
+ * \brief \ref i2c_get_slave_address(Protocol*, uint16_t*) for replay driver
+ * layer
+ */
+int replay_i2c_get_slave_address (Protocol *self, uint16_t *address_buffer);
+
+/**
+ * \brief \ref i2c_set_slave_address(Protocol*, uint16_t) for replay driver
+ * layer
+ */
+int replay_i2c_set_slave_address (Protocol *self, uint16_t address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _REPLAY_H_*/
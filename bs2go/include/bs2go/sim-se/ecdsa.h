@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file ecdsa.h
+ *
+ * \brief Software ECDSA of the simulated secure element
+ *
+ * \details Plain 256 bit Montgomery arithmetic for SEC-P256K1 and NIST-P256.
+ * Neither constant time nor hardened in any way, only meant to give the
+ * simulated secure element real signatures.
+ */
+#ifndef _SIM_SE_ECDSA_H_
+#define _SIM_SE_ECDSA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bs2go/blocksec2go/blocksec2go.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief IFX error code function identifier for \ref
+ * sim_se_ecdsa_public_key(block2go_curve, const uint8_t*, uint8_t*)
+ */
+#define SIM_SE_ECDSA_PUBLIC_KEY 0x01
+
+/**
+ * \brief IFX error code function identifier for \ref
+ * sim_se_ecdsa_sign(block2go_curve, const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*, size_t*)
+ */
+#define SIM_SE_ECDSA_SIGN 0x02
+
+/**
+ * \brief IFX error code function identifier for \ref
+ * sim_se_ecdsa_verify(block2go_curve, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*)
+ */
+#define SIM_SE_ECDSA_VERIFY 0x03
+
+/**
+ * \brief Return code for successful ECDSA operations
+ */
+#define SIM_SE_ECDSA_SUCCESS SUCCESS
+
+/**
+ * \brief IFX error code reason if signature does not match
+ */
+#define INVALID_SIGNATURE 0x01
+
+/**
+ * \brief Computes uncompressed public key (04 || X || Y) of private key
+ *
+ * \param curve ECC curve of key
+ * \param private_key Big endian private key, must be in [1, n - 1]
+ * \param public_key Buffer to store public key in
+ * \return int   SIM_SE_ECDSA_SUCCESS if successful, any other value in case
+ * of error
+ */
+int sim_se_ecdsa_public_key (block2go_curve curve,
+		const uint8_t private_key[32],
+		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN]);
+
+/**
+ * \brief Signs hash and encodes signature in ASN.1 DER format
+ *
+ * \details Fails with ILLEGAL_ARGUMENT for unusable nonces (0, >= n or
+ * leading to r = 0 or s = 0), callers simply retry with a fresh one.
+ *
+ * \param curve ECC curve of key
+ * \param private_key Big endian private key
+ * \param hash Big endian hash to be signed
+ * \param nonce Big endian per-signature secret k
+ * \param signature Buffer of BLOCK2GO_SIGNATURE_MAX_LEN bytes to store
+ * signature in
+ * \param signature_len Buffer to store number of bytes in   signature in
+ * \return int   SIM_SE_ECDSA_SUCCESS if successful, any other value in case
+ * of error
+ */
+int sim_se_ecdsa_sign (block2go_curve curve, const uint8_t private_key[32],
+		const uint8_t hash[32], const uint8_t nonce[32],
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len);
+
+/**
+ * \brief Verifies ASN.1 DER encoded signature of hash
+ *
+ * \details Hashes longer than 32 bytes are truncated to their leftmost 256
+ * bits.
+ *
+ * \param curve ECC curve of key
+ * \param hash Big endian hash that has been signed
+ * \param hash_len Number of bytes in   hash
+ * \param signature ASN.1 DER encoded signature
+ * \param signature_len Number of bytes in   signature
+ * \param public_key Uncompressed public key (04 || X || Y)
+ * \return int   SIM_SE_ECDSA_SUCCESS if signature is valid, any other value
+ * otherwise
+ */
+int sim_se_ecdsa_verify (block2go_curve curve, const uint8_t *hash,
+		size_t hash_len, const uint8_t *signature, size_t signature_len,
+		const uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SIM_SE_ECDSA_H_*/
@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file sim-se.h
+ *
+ * \brief Simulated Blockchain Security 2Go secure element driver layer
+ *
+ * \details Host-side stand-in for the I2C driver layer: frames written by the
+ * T=1' layer are answered by a model of the secure element implementing the
+ * GP T=1' data-link layer (CIP, RESYNCH, IFS, ABORT, WTX, SWR, chaining in
+ * both directions, NACK while busy) and the Blocksec2Go application (SELECT,
+ * GENERATE KEY, GET KEY INFO, GENERATE SIGNATURE, VERIFY SIGNATURE, GET
+ * RANDOM, key labels, GET STATUS, ENABLE PROTECTED MODE) with software ECDSA.
+ *
+ * Together with i2c-host.c, which dispatches the generic I2C API (\ref
+ * i2c.h) to it, the driver layer replaces psoc6-i2c.c in host builds. Both
+ * are excluded from the firmware build via .cyignore.
+ *
+ * \example
+ *      Protocol driver, protocol;
+ *      sim_se_initialize (&driver);
+ *      t1prime_initialize (&protocol, &driver);
+ *      protocol_activate (&protocol, &response, &response_len);
+ */
+#ifndef _IFX_SIM_SE_H_
+#define _IFX_SIM_SE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bs2go/error/error.h"
+#include "bs2go/i2c/i2c.h"
+#include "bs2go/protocol/protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief IFX error code module identifer
+ */
+#define LIBSIMSE 0x38
+
+/**
+ * \brief IFX error code reason if simulated secure element did not
+ * acknowledge a bus transaction because it is still busy
+ */
+#define SIM_SE_NACK 0x70
+
+/**
+ * \brief Behaviour and timing of simulated secure element
+ *
+ * \details All times are in [us] of the \ref Clock installed for the
+ * protocol stack (\ref protocol_set_clock(Protocol*, const Clock*)), so a
+ * \ref ClockVirtual runs whole sessions without waiting. A frame written to
+ * the secure element is answered once the respective time has passed, reads
+ * before that are not acknowledged (NACK), just like the real chip does while
+ * it is busy.
+ */
+typedef struct SimSEConfig
+{
+	uint16_t ifsc; /**< Maximum information field size of secure element
+                      announced in CIP */
+	uint16_t max_ifsd; /**< Largest IFSD acknowledged in S(IFS response),
+                          larger requests are answered with this value (0
+                          to reject S(IFS request)) */
+	uint16_t bwt;  /**< Block waiting time announced in CIP in [ms] */
+	uint16_t mcf;  /**< Maximum I2C clock frequency announced in CIP in
+                      [kHz] */
+	uint8_t mpot;  /**< Minimum polling time announced in CIP in [multiples
+                      of 100us] */
+	uint32_t block_time; /**< Time to answer S blocks, R blocks and chained
+                            I blocks */
+	uint32_t apdu_time;  /**< Processing time of APDUs without specific time
+                            below */
+	uint32_t generate_key_time;       /**< Processing time of GENERATE KEY */
+	uint32_t generate_signature_time; /**< Processing time of GENERATE
+                                         SIGNATURE */
+	uint32_t verify_signature_time;   /**< Processing time of VERIFY
+                                         SIGNATURE */
+	bool bus_timing; /**< Spend time of I2C transfers at current clock
+                        frequency on every read and write */
+	uint64_t seed;   /**< Seed for keys, nonces, GET RANDOM and card ID,
+                        equal seeds give reproducible sessions */
+} SimSEConfig;
+
+/**
+ * \brief Activity counters of simulated secure element
+ */
+typedef struct SimSEStatistics
+{
+	size_t frames_received; /**< Number of frames written by the host */
+	size_t frames_sent;     /**< Number of frames read by the host */
+	size_t nacks;           /**< Number of transactions not acknowledged as
+                               the secure element was busy */
+	size_t crc_errors;      /**< Number of frames with invalid CRC */
+	size_t retransmissions; /**< Number of frames sent again on request */
+	size_t wtx_requests;    /**< Number of S(WTX request) sent */
+	size_t apdus;           /**< Number of processed APDUs */
+	size_t signatures;      /**< Number of generated signatures */
+} SimSEStatistics;
+
+/**
+ * \brief Populates config with timing of a real Blockchain Security 2Go card
+ *
+ * \param config Config to be populated
+ */
+void sim_se_get_default_config (SimSEConfig *config);
+
+/**
+ * \brief Initializes \ref Protocol object for simulated secure element
+ * driver layer with default config
+ *
+ * \param self \ref Protocol object to be initialized.
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error.
+ */
+int sim_se_initialize (Protocol *self);
+
+/**
+ * \brief Initializes \ref Protocol object for simulated secure element
+ * driver layer with given config
+ *
+ * \param self \ref Protocol object to be initialized.
+ * \param config Behaviour and timing of secure element, copied
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error.
+ */
+int sim_se_initialize_config (Protocol *self, const SimSEConfig *config);
+
+/**
+ * \brief Getter for activity counters of simulated secure element
+ *
+ * \param self Protocol stack containing simulated secure element
+ * \param statistics Buffer to store counters in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int sim_se_get_statistics (Protocol *self, SimSEStatistics *statistics);
+
+/**
+ * \brief Injects link errors into the next bus transactions
+ *
+ * \details The next   nacks writes are not acknowledged, as if the address
+ * byte got lost on the bus, and the next   crc_errors frames read by the
+ * host carry an inverted CRC. Retransmitted frames count as new frames.
+ * Injected NACKs are counted in \ref SimSEStatistics like regular ones.
+ *
+ * \param self Protocol stack containing simulated secure element
+ * \param nacks Number of writes not to acknowledge
+ * \param crc_errors Number of frames to corrupt
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int sim_se_inject_errors (Protocol *self, size_t nacks, size_t crc_errors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IFX_SIM_SE_H_*/
@@ -0,0 +1,316 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file sim-se.h
+ *
+ * \brief Internal definitions for simulated secure element driver layer
+ */
+#ifndef _SIM_SE_H_
+#define _SIM_SE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bs2go/allocator/allocator.h"
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/t1prime/t1prime.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief Protocol Layer ID for simulated secure element driver layer
+ *
+ * \details Used to verify that correct protocol layer has called member
+ * functionality
+ */
+#define SIM_SE_PROTOCOLLAYER_ID 0x37
+
+/**
+ * \brief Node address of blocks sent by the secure element
+ */
+#define NAD_SE_TO_HD 0x12
+
+/**
+ * \brief Number of permanent keys the simulated secure element can hold
+ */
+#ifndef SIM_SE_MAX_KEYS
+#define SIM_SE_MAX_KEYS 16
+#endif
+
+/**
+ * \brief Largest command APDU the simulated secure element accepts (enough
+ * for extended length UPDATE KEY LABEL)
+ */
+#ifndef SIM_SE_COMMAND_MAX_LEN
+#define SIM_SE_COMMAND_MAX_LEN 1280
+#endif
+
+/**
+ * \brief Largest response APDU of the simulated secure element (short
+ * length)
+ */
+#define SIM_SE_RESPONSE_MAX_LEN (256 + 2)
+
+/**
+ * \brief Number of I2C clock frequencies set by the host kept for inspection
+ */
+#ifndef SIM_SE_CLOCK_FREQUENCY_LOG_LEN
+#define SIM_SE_CLOCK_FREQUENCY_LOG_LEN 16
+#endif
+
+/**
+ * \brief Memory available for key labels in [bytes]
+ */
+#ifndef SIM_SE_KEY_LABEL_MEMORY
+#define SIM_SE_KEY_LABEL_MEMORY 8192
+#endif
+
+/**
+ * \brief Number of key label bytes returned per GET KEY LABEL occurance
+ */
+#define SIM_SE_KEY_LABEL_CHUNK_LEN 0xf0
+
+/**
+ * \brief Signatures the card can generate in total
+ */
+#define SIM_SE_GLOBAL_COUNTER 1000000
+
+/**
+ * \brief Signatures that can be generated per key
+ */
+#define SIM_SE_KEY_COUNTER 100000
+
+/**
+ * \brief Version string returned by SELECT
+ */
+#define SIM_SE_VERSION "v1.0"
+
+/**
+ * \brief Default IFSC announced in CIP
+ */
+#define SIM_SE_DEFAULT_IFSC 0xfe
+
+/**
+ * \brief Default BWT announced in CIP in [ms]
+ */
+#define SIM_SE_DEFAULT_BWT 300
+
+/**
+ * \brief Default maximum I2C clock frequency announced in CIP in [kHz]
+ */
+#define SIM_SE_DEFAULT_MCF 1000
+
+/**
+ * \brief Key stored in simulated secure element
+ */
+typedef struct SimSEKey
+{
+	bool generated;        /**< Whether key slot holds a key */
+	block2go_curve curve;  /**< ECC curve of key */
+	uint8_t private_key[32]; /**< Big endian private key */
+	uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN]; /**< Uncompressed public
+                                                    key */
+	uint32_t counter;      /**< Remaining signatures of key */
+	uint16_t label_size;   /**< Space reserved by CREATE KEY LABEL */
+	uint16_t label_len;    /**< Length of current key label */
+	uint8_t label[BLOCK2GO_KEY_LABEL_MAX_LEN]; /**< Key label */
+} SimSEKey;
+
+/**
+ * \brief Command APDU as parsed by simulated secure element (data not copied)
+ */
+typedef struct SimSECommand
+{
+	uint8_t cla;         /**< Class byte */
+	uint8_t ins;         /**< Instruction byte */
+	uint8_t p1;          /**< Parameter byte 1 */
+	uint8_t p2;          /**< Parameter byte 2 */
+	const uint8_t *data; /**< Command data */
+	size_t lc;           /**< Number of bytes in   data */
+} SimSECommand;
+
+/**
+ * \brief State of simulated secure element driver layer
+ */
+typedef struct SimSEProtocolState
+{
+	SimSEConfig config;          /**< Behaviour and timing */
+	SimSEStatistics statistics;  /**< Activity counters */
+	uint16_t slave_address;      /**< I2C address set by host */
+	uint32_t clock_frequency;    /**< I2C clock frequency set by host in
+                                    [Hz] */
+	uint32_t clock_frequency_log[SIM_SE_CLOCK_FREQUENCY_LOG_LEN]; /**< Last
+                                    clock frequencies set by host in [Hz] */
+	size_t clock_frequency_changes; /**< Number of clock frequencies set by
+                                    host (also beyond log length) */
+	uint64_t random_state;       /**< Pseudo random generator state */
+
+	/* T=1' data-link layer */
+	uint8_t send_counter;        /**< N(S) of next I block sent */
+	uint8_t receive_counter;     /**< Expected N(S) of next received I
+                                    block */
+	size_t ifsd;                 /**< Maximum information field size of
+                                    host */
+	uint8_t frame[T1PRIME_FRAME_SIZE (SIM_SE_RESPONSE_MAX_LEN)]; /**< Last
+                                    frame sent, kept for retransmissions */
+	size_t frame_len;            /**< Number of bytes in   frame */
+	size_t frame_read;           /**< Number of bytes of   frame already
+                                    read by host */
+	uint64_t ready_at;           /**< Time   frame can be read at in [us] */
+	uint64_t done_at;            /**< Time APDU processing is done at while
+                                    waiting for S(WTX response) in [us] */
+	bool wtx_pending;            /**< S(WTX request) has been sent */
+	size_t inject_nacks;         /**< Number of next writes not
+                                    acknowledged */
+	size_t inject_crc_errors;    /**< Number of next frames sent with
+                                    invalid CRC */
+	bool frame_corrupt;          /**< CRC of   frame is inverted on the
+                                    current read */
+
+	/* APDU buffers */
+	uint8_t command[SIM_SE_COMMAND_MAX_LEN]; /**< Command APDU assembled
+                                                from I blocks */
+	size_t command_len;          /**< Number of bytes in   command */
+	bool command_overflow;       /**< Command APDU did not fit */
+	uint8_t response[SIM_SE_RESPONSE_MAX_LEN]; /**< Response APDU */
+	size_t response_len;         /**< Number of bytes in   response */
+	size_t response_sent;        /**< Number of bytes of   response already
+                                    sent in I blocks */
+
+	/* Blocksec2Go application */
+	uint8_t id[BLOCK2GO_ID_LEN]; /**< Card ID returned by SELECT */
+	bool protected_mode;         /**< Whether protected mode is enabled */
+	uint32_t global_counter;     /**< Remaining signatures of card */
+	SimSEKey session_key;        /**< Session key (not retained over
+                                    SELECT) */
+	SimSEKey keys[SIM_SE_MAX_KEYS]; /**< Permanent keys 1 .. */
+	size_t key_count;            /**< Number of permanent keys */
+	size_t label_memory;         /**< Remaining key label memory */
+	uint8_t label_update[BLOCK2GO_KEY_LABEL_MAX_LEN + 6]; /**< UPDATE KEY
+                                    LABEL data assembled over sequence */
+	size_t label_update_len;     /**< Number of bytes in   label_update */
+	uint8_t label_sequence;      /**< Expected next UPDATE KEY LABEL
+                                    sequence number */
+	uint8_t label_key;           /**< Key of ongoing GET KEY LABEL */
+	size_t label_offset;         /**< Key label bytes already returned by
+                                    GET KEY LABEL */
+
+	const Allocator *allocator;  /**< Allocator this state has been
+                                    allocated with */
+} SimSEProtocolState;
+
+/**
+ * \brief Returns current protocol state of simulated secure element driver
+ * layer
+ *
+ * \param self Protocol stack containing simulated secure element
+ * \param protocol_state_buffer Buffer to store protocol state in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int sim_se_get_protocol_state (Protocol *self,
+		SimSEProtocolState **protocol_state_buffer);
+
+/**
+ * \brief \ref protocol_transmitfunction_t for simulated secure element
+ *
+ * \see protocol_transmitfunction_t
+ */
+int sim_se_transmit (Protocol *self, uint8_t *data, size_t data_len);
+
+/**
+ * \brief \ref protocol_receivefunction_t for simulated secure element
+ *
+ * \see protocol_receivefunction_t
+ */
+int sim_se_receive (Protocol *self, size_t expected_len, uint8_t **response,
+		size_t *response_len);
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for simulated secure element
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int sim_se_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len);
+
+/**
+ * \brief \ref i2c_get_clock_frequency(Protocol*, uint32_t*) for simulated
+ * secure element
+ */
+int sim_se_i2c_get_clock_frequency (Protocol *self,
+		uint32_t *frequency_buffer);
+
+/**
+ * \brief \ref i2c_set_clock_frequency(Protocol*, uint32_t) for simulated
+ * secure element
+ */
+int sim_se_i2c_set_clock_frequency (Protocol *self, uint32_t frequency);
+
+/**
+ * \brief \ref i2c_get_slave_address(Protocol*, uint16_t*) for simulated
+ * secure element
+ */
+int sim_se_i2c_get_slave_address (Protocol *self, uint16_t *address_buffer);
+
+/**
+ * \brief \ref i2c_set_slave_address(Protocol*, uint16_t) for simulated
+ * secure element
+ */
+int sim_se_i2c_set_slave_address (Protocol *self, uint16_t address);
+
+/**
+ * \brief Processes frame written by the host and queues the answer
+ *
+ * \param protocol_state Simulated secure element
+ * \param frame Frame as written by the host
+ * \param frame_len Number of bytes in   frame
+ * \param now Current time in [us]
+ */
+void sim_se_frame_handle (SimSEProtocolState *protocol_state,
+		const uint8_t *frame, size_t frame_len, uint64_t now);
+
+/**
+ * \brief Executes Blocksec2Go command APDU and stores response APDU
+ *
+ * \param protocol_state Simulated secure element
+ * \param command Command APDU
+ * \param command_len Number of bytes in   command
+ * \return uint32_t   Processing time of command in [us]
+ */
+uint32_t sim_se_apdu_handle (SimSEProtocolState *protocol_state,
+		const uint8_t *command, size_t command_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SIM_SE_H_*/
@@ -29,9 +29,12 @@
 #ifndef _T1PRIME_DATASTRUCTURES_H_
 #define _T1PRIME_DATASTRUCTURES_H_
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "bs2go/error/error.h"
+#include "bs2go/protocol/protocol.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -94,6 +97,12 @@ typedef struct Block
 	uint8_t pcb;             /**< Protocol Control Byte (PCB) */
 	size_t information_size; /**< Number of bytes in \ref Block.information */
 	uint8_t *information;    /**< Actual block data */
+	bool borrowed;           /**< \c true if \ref Block.information points into
+                                a buffer the block does not own (e.g. a frame
+                                buffer of \ref T1PrimeProtocolState) */
+	const Allocator *allocator; /**< Allocator for owned information fields
+                                   and encodings (NULL for system heap), must
+                                   be set before decoding */
 } Block;
 
 /**
@@ -120,6 +129,23 @@ int t1prime_block_decode (Block *block, uint8_t *data, size_t data_len);
 int t1prime_block_encode (Block *block, uint8_t **buffer,
 		size_t *buffer_len);
 
+/**
+ * \brief Encodes \ref Block to its binary representation in a caller provided
+ * buffer
+ *
+ * \details \ref Block.information may already point to offset
+ * \ref BLOCK_PROLOGUE_LENGTH of   buffer in which case it is not copied.
+ *
+ * \param block Block to be encoded
+ * \param buffer Buffer to store encoded data in
+ * \param buffer_size Number of bytes available in   buffer
+ * \param encoded_len Pointer for storing number of bytes written to   buffer
+ * \return int   T1PRIME_BLOCK_ENCODE_SUCCESS if successful, any other value
+ * in case of error
+ */
+int t1prime_block_encode_into (Block *block, uint8_t *buffer,
+		size_t buffer_size, size_t *encoded_len);
+
 /**
  * \brief Frees memory associated with \ref Block object (but not object
  * itself)
@@ -128,7 +154,8 @@ int t1prime_block_encode (Block *block, uint8_t **buffer,
  * \ref t1prime_block_decode(Block*, uint8_t *, size_t)). Users would need to
  * manually check which members have been dynamically allocated and free them
  * themselves. Calling this function will ensure that all dynamically
- * allocated members have been freed.
+ * allocated members have been freed. Borrowed information fields (see
+ * \ref Block.borrowed) are left untouched.
  *
  * \param block Block object whose data shall be freed
  */
@@ -215,6 +242,9 @@ typedef struct CIP
 	uint8_t *dllp;    /**< Data-link layer parameters */
 	uint8_t hb_len;   /**< Number of bytes in \ref CIP.hb */
 	uint8_t *hb;      /**< Historical bytes */
+	const Allocator *allocator; /**< Allocator for iin, plp, dllp and hb
+                                   (NULL for system heap), must be set before
+                                   decoding */
 } CIP;
 
 /**
@@ -251,7 +281,7 @@ int t1prime_cip_validate (CIP *cip);
  * \example
  *      uint8_t encoded[] = {...};
  *      size_t encoded_len = sizeof(encoded);
- *      CIP cip;
+ *      CIP cip = { .allocator = NULL };
  *      t1prime_cip_decode(&cip, encoded, encoded_len);  Might allocate
  * several buffers t1prime_cip_destroy(&cip);
  *
@@ -358,6 +388,80 @@ void t1prime_i2c_plp_destroy (I2CPLP *plp);
 
 
 
+/**
+ * \brief Communication statistics of T=1' protocol
+ */
+typedef struct T1PrimeStatistics
+{
+	size_t transactions;    /**< Number of bus transactions (reads and writes) */
+	size_t bytes_written;   /**< Number of bytes written to the bus */
+	size_t bytes_read;      /**< Number of bytes read from the bus */
+	size_t blocks_sent;     /**< Number of transmitted blocks */
+	size_t blocks_received; /**< Number of successfully received blocks */
+	size_t apdus;           /**< Number of completed T=1' transceive calls */
+	size_t wtx_requests;    /**< Number of S(WTX request) blocks received */
+	size_t wtx_extension;   /**< Sum of granted waiting time extensions in
+                               [ms] */
+} T1PrimeStatistics;
+
+/**
+ * \brief Phases of a (non-blocking) T=1' exchange
+ */
+typedef enum t1prime_exchange_phase
+{
+	T1PRIME_EXCHANGE_IDLE = 0, /**< No exchange in progress */
+	T1PRIME_EXCHANGE_TRANSMIT, /**< Next block needs to be sent */
+	T1PRIME_EXCHANGE_RECEIVE,  /**< Polling for response block */
+	T1PRIME_EXCHANGE_COMPLETE  /**< Exchange finished, result not collected */
+} t1prime_exchange_phase;
+
+/**
+ * \brief State of an ongoing T=1' exchange driven by \ref
+ * t1prime_transceive_poll(Protocol*, uint32_t*)
+ */
+typedef struct T1PrimeExchange
+{
+	t1prime_exchange_phase phase; /**< Current phase of the exchange */
+	bool block_only; /**< Exchange ends with first valid response block */
+	int status;      /**< Final status once exchange is complete */
+	Block request;   /**< Block currently exchanged with secure element */
+	Block to_send;   /**< Block to be sent next (request or retry R block) */
+	Block response;  /**< Last received block */
+	size_t tries;    /**< Number of retries for current request */
+	bool retransmit; /**< to_send is identical to the block sent last */
+	uint32_t elapsed;  /**< Time spent polling in [multiple of 100us] */
+	uint32_t deadline; /**< Polling deadline in [multiple of 100us] */
+	uint32_t interval; /**< Current backoff interval in [multiple of 100us] */
+	uint32_t wait;     /**< Time until next poll in [multiple of 100us] */
+	uint32_t apdu_elapsed; /**< Time the secure element has been processing
+                              the current APDU in [multiple of 100us] */
+	const ProtocolSegment *command; /**< Command data segments (borrowed
+                                       from caller) */
+	size_t command_count; /**< Number of segments in command */
+	ProtocolSegment command_data; /**< Single command segment for contiguous
+                                     command data */
+	const uint8_t *frame; /**< Precompiled frame of the I block carrying the
+                             whole command (borrowed from caller), NULL if
+                             none */
+	size_t data_len; /**< Number of bytes in command */
+	size_t offset;   /**< Offset of I block currently sent in command */
+	size_t chunk_size; /**< Number of bytes in I block currently sent */
+	bool receiving;    /**< Secure element started sending response */
+	bool aborted;      /**< Chain has been aborted */
+	const Allocator *allocator; /**< Allocator response_data is allocated
+                                   with */
+	uint8_t *response_data; /**< Response data received so far */
+	size_t response_len;    /**< Number of bytes in response_data */
+	size_t response_capacity; /**< Number of bytes allocated for
+                                 response_data */
+	const ProtocolSegment *response_segments; /**< Caller provided segments
+                                                 to scatter response into,
+                                                 NULL to collect response
+                                                 in response_data */
+	size_t response_segment_count; /**< Number of segments in
+                                     response_segments */
+} T1PrimeExchange;
+
 /**
  * \brief State of T=1' protocol keeping track of sequence counters,
  * information field sizes, etc.
@@ -369,8 +473,29 @@ typedef struct
 	size_t ifsc; /**< Current maximum size of SE information field in [byte] */
 	uint8_t send_counter; /**< Current sequence counter of transmitted I blocks */
 	uint8_t receive_counter; /**< Current sequence counter of received I blocks */
-	size_t wtx_delay; /**< Waiting time extension delay between transmission
-                         and reception */
+	size_t wtx_delay; /**< Extended block waiting time in [ms] granted via
+                         S(WTX request) for the next response, 0 if none */
+	size_t ifsd; /**< Current maximum size of host information field in [byte] */
+	size_t max_ifsd; /**< Largest host information field size negotiated
+                        during activation in [byte] */
+	uint8_t *tx_frame; /**< Frame buffer for encoding outgoing blocks */
+	size_t tx_frame_size; /**< Number of bytes available in tx_frame */
+	size_t tx_frame_len; /**< Length of block last encoded into tx_frame */
+	uint8_t *rx_frame; /**< Frame buffer for receiving incoming blocks */
+	size_t rx_frame_size; /**< Number of bytes available in rx_frame */
+	uint8_t link_errors; /**< Consecutive link errors at current I2C clock
+                            frequency */
+	bool coalesced_read; /**< Read whole frames in a single bus transaction */
+	size_t rx_hint; /**< Expected information field size of next I block */
+	T1PrimeStatistics statistics; /**< Communication statistics */
+	uint8_t apdu_ins; /**< Instruction byte of APDU currently processed */
+	bool apdu_pending; /**< Next received block answers APDU in apdu_ins */
+	uint16_t processing_time[256]; /**< Learned (EWMA) secure element
+                                      processing time per APDU instruction in
+                                      [multiple of 100us], 0 if unknown */
+	T1PrimeExchange exchange; /**< Ongoing (non-blocking) exchange */
+	const Allocator *allocator; /**< Allocator this state and its frame
+                                   buffers have been allocated with */
 } T1PrimeProtocolState;
 
 #ifdef __cplusplus
@@ -29,8 +29,11 @@
 #ifndef _IFX_T1PRIME_H_
 #define _IFX_T1PRIME_H_
 
+#include <stdbool.h>
+
 #include "bs2go/error/error.h"
 #include "bs2go/protocol/protocol.h"
+#include "bs2go/t1prime/ifx/datastructures.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -52,6 +55,175 @@ extern "C"
    */
   int t1prime_initialize (Protocol *self, Protocol *driver);
 
+/**
+ * \brief Status code of \ref t1prime_transceive_poll(Protocol*, uint32_t*) if
+ * exchange is still in progress (not an error)
+ */
+#define T1PRIME_TRANSCEIVE_PENDING 0x01
+
+  /**
+   * \brief Starts non-blocking exchange of command data with the secure
+   * element
+   *
+   * \details No bus traffic is generated until \ref
+   * t1prime_transceive_poll(Protocol*, uint32_t*) is called.   data is
+   * referenced (not copied) and must stay valid until \ref
+   * t1prime_transceive_finish(Protocol*, uint8_t**, size_t*) has been called.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param data Command data to be sent
+   * \param data_len Number of bytes in   data
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started,
+   * any other value in case of error
+   */
+  int t1prime_transceive_begin (Protocol *self, uint8_t *data,
+                                size_t data_len);
+
+  /**
+   * \brief Starts non-blocking exchange of command data scattered over
+   * several segments with the secure element
+   *
+   * \details Segments are referenced (not copied) and must stay valid until
+   * \ref t1prime_transceive_finish_iov(Protocol*, size_t*) has been called.
+   * Response data is scattered into   response in order.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param command Segments of command data to be sent
+   * \param command_count Number of segments in   command
+   * \param response Segments to store response data in (NULL to collect
+   * response via \ref t1prime_transceive_finish(Protocol*, uint8_t**,
+   * size_t*) instead)
+   * \param response_count Number of segments in   response
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started,
+   * any other value in case of error
+   */
+  int t1prime_transceive_begin_iov (Protocol *self,
+                                    const ProtocolSegment *command,
+                                    size_t command_count,
+                                    const ProtocolSegment *response,
+                                    size_t response_count);
+
+  /**
+   * \brief Starts non-blocking exchange of a command precompiled into T=1'
+   * frames
+   *
+   * \details Each frame is a complete I block (NAD, PCB, LEN, information
+   * field and CRC) carrying the whole command, one for N(S) = 0 and one for
+   * N(S) = 1. The frame matching the current N(S) is sent as is without
+   * encoding it or calculating its CRC. Frames may be NULL for an N(S) not
+   * prepared by the caller (see \ref t1prime_get_send_counter(Protocol*,
+   * uint8_t*)). If no frame matches or the command does not fit into a
+   * single I block, the information field is chained as usual. Frames are
+   * referenced (not copied) and must stay valid until the exchange has been
+   * finished.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param frames Encoded I blocks for N(S) = 0 and N(S) = 1
+   * \param frame_len Number of bytes in each frame
+   * \param response Segments to store response data in (NULL to collect
+   * response via \ref t1prime_transceive_finish(Protocol*, uint8_t**,
+   * size_t*) instead)
+   * \param response_count Number of segments in   response
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started,
+   * any other value in case of error
+   */
+  int t1prime_transceive_begin_frame (Protocol *self,
+                                      const uint8_t *const frames[2],
+                                      size_t frame_len,
+                                      const ProtocolSegment *response,
+                                      size_t response_count);
+
+  /**
+   * \brief Starts non-blocking exchange of command data encoded into a frame
+   * buffer with room for the T=1' prologue and CRC
+   *
+   * \details   buffer holds BLOCK_PROLOGUE_LENGTH reserved bytes, followed by
+   *   data_len bytes of command data and BLOCK_EPILOGUE_LENGTH reserved
+   * bytes (\ref T1PRIME_FRAME_SIZE(data_len) bytes in total). If the command
+   * fits into a single I block, prologue and CRC are written around the data
+   * and the frame is sent right from   buffer, otherwise the data is chained
+   * as usual.   buffer is referenced (not copied) and must stay valid until
+   * the exchange has been finished.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param buffer Frame buffer holding command data
+   * \param data_len Number of command data bytes in   buffer
+   * \param response Segments to store response data in (NULL to collect
+   * response via \ref t1prime_transceive_finish(Protocol*, uint8_t**,
+   * size_t*) instead)
+   * \param response_count Number of segments in   response
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started,
+   * any other value in case of error
+   */
+  int t1prime_transceive_begin_inplace (Protocol *self, uint8_t *buffer,
+                                        size_t data_len,
+                                        const ProtocolSegment *response,
+                                        size_t response_count);
+
+  /**
+   * \brief Blocking exchange of a command precompiled into T=1' frames
+   *
+   * \details See \ref t1prime_transceive_begin_frame for how   frames are
+   * used.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param frames Encoded I blocks for N(S) = 0 and N(S) = 1
+   * \param frame_len Number of bytes in each frame
+   * \param response Segments to store response data in
+   * \param response_count Number of segments in   response
+   * \param response_len Buffer to store number of bytes scattered into
+   * response in
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_transceive_frame_iov (Protocol *self,
+                                    const uint8_t *const frames[2],
+                                    size_t frame_len,
+                                    const ProtocolSegment *response,
+                                    size_t response_count,
+                                    size_t *response_len);
+
+  /**
+   * \brief Advances exchange started by \ref
+   * t1prime_transceive_begin(Protocol*, uint8_t*, size_t) by at most one bus
+   * operation
+   *
+   * \details Covers chaining, R block retransmissions, S(WTX) and S(IFS)
+   * requests. Timeouts are accounted based on the returned wait times, so
+   * callers should call this function again once   wait_us has passed.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param wait_us Buffer to store time until next call in [us] in
+   * \return int   T1PRIME_TRANSCEIVE_PENDING if exchange is still in progress,
+   * PROTOCOL_TRANSCEIVE_SUCCESS if response is ready to be collected, any
+   * other value in case of error
+   */
+  int t1prime_transceive_poll (Protocol *self, uint32_t *wait_us);
+
+  /**
+   * \brief Collects result of exchange and resets exchange state
+   *
+   * \param self T=1' protocol stack to be used
+   * \param response Buffer to store response data in
+   * \param response_len Buffer to store number of bytes in   response in
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_transceive_finish (Protocol *self, uint8_t **response,
+                                 size_t *response_len);
+
+  /**
+   * \brief Collects result of exchange started by \ref
+   * t1prime_transceive_begin_iov and resets exchange state
+   *
+   * \param self T=1' protocol stack to be used
+   * \param response_len Buffer to store number of bytes scattered into
+   * response segments in
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value
+   * in case of error (RESPONSE_TOO_LONG if segments were too small)
+   */
+  int t1prime_transceive_finish_iov (Protocol *self, size_t *response_len);
+
   /**
    * \brief Sets maximum information field size of the host device (IFSD)
    *
@@ -62,6 +234,36 @@ extern "C"
    */
   int t1prime_set_ifsd (Protocol *self, size_t ifsd);
 
+  /**
+   * \brief Sends S(IFS request) to the secure element and returns the IFSD it
+   * acknowledged
+   *
+   * \details Does not change the IFSD of   self, the receive frame buffer
+   * must already be able to hold blocks of   ifsd bytes.
+   *
+   * \param self T=1' protocol stack to be used
+   * \param ifsd IFS value to be requested
+   * \param ifsd_buffer Buffer to store IFS value of S(IFS response) in
+   * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_negotiate_ifsd (Protocol *self, size_t ifsd,
+                              size_t *ifsd_buffer);
+
+  /**
+   * \brief Sets largest information field size of the host device (IFSD)
+   * negotiated during activation
+   *
+   * \details Defaults to the maximum allowed IFS (0xff9). Lower values limit
+   * the size of the receive frame buffer at the cost of more chaining.
+   *
+   * \param self T=1' protocol stack to configure
+   * \param max_ifsd Largest IFSD to be advertised
+   * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_set_max_ifsd (Protocol *self, size_t max_ifsd);
+
   /**
    * \brief Returns current block waiting time (BWT) in [ms]
    *
@@ -82,6 +284,42 @@ extern "C"
    */
   int t1prime_set_bwt (Protocol *self, uint16_t bwt);
 
+  /**
+   * \brief Enables or disables coalesced frame reads
+   *
+   * \details In coalesced mode NAD, prologue and the expected information
+   * field (based on the previous I block, at most IFSD) are fetched in a
+   * single bus transaction. A follow-up read is only issued if the length
+   * field announces more data. Disabled by default.
+   *
+   * \param self T=1' protocol stack to configure
+   * \param enable   true to enable coalesced frame reads
+   * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_set_coalesced_read (Protocol *self, bool enable);
+
+  /**
+   * \brief Returns communication statistics collected since initialization
+   * or last reset
+   *
+   * \param self T=1' protocol stack to get statistics for
+   * \param statistics_buffer Buffer to store statistics in
+   * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_get_statistics (Protocol *self,
+                              T1PrimeStatistics *statistics_buffer);
+
+  /**
+   * \brief Resets communication statistics
+   *
+   * \param self T=1' protocol stack to reset statistics for
+   * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_reset_statistics (Protocol *self);
+
 #ifdef __cplusplus
 }
 #endif
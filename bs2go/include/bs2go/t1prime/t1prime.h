@@ -31,7 +31,6 @@
 
 
 #include <stdint.h>
-#include "cyhal.h"
 
 #include "bs2go/protocol/protocol.h"
 #include "bs2go/t1prime/ifx/datastructures.h"
@@ -306,6 +305,29 @@ extern "C"
   int t1prime_transceive (Protocol *self, uint8_t *data, size_t data_len,
                           uint8_t **response, size_t *response_len);
 
+  /**
+   * \brief \ref protocol_transceiveiovfunction_t for Global Platform T=1'
+   * protocol
+   *
+   * \see protocol_transceiveiovfunction_t
+   */
+  int t1prime_transceive_iov (Protocol *self, const ProtocolSegment *command,
+                              size_t command_count,
+                              const ProtocolSegment *response,
+                              size_t response_count, size_t *response_len);
+
+  /**
+   * \brief \ref protocol_transceiveinplacefunction_t for Global Platform T=1'
+   * protocol
+   *
+   * \see protocol_transceiveinplacefunction_t
+   */
+  int t1prime_transceive_inplace (Protocol *self, uint8_t *buffer,
+                                  size_t data_len,
+                                  const ProtocolSegment *response,
+                                  size_t response_count,
+                                  size_t *response_len);
+
   /**
    * \brief \ref protocol_destroyfunction_t for Global Platform T=1' protocol
    *
@@ -321,6 +343,12 @@ extern "C"
  */
 #define INVALID_BLOCK 0x61
 
+/**
+ * \brief Error reason if secure element did not answer within block waiting
+ * time (BWT)
+ */
+#define RECEIVE_TIMEOUT 0x62
+
 /**
  * \brief Node address byte (NAD) for transmission from host device to secure
  * element
@@ -337,6 +365,34 @@ extern "C"
    */
   int t1prime_block_transmit (Protocol *self, Block *block);
 
+  /**
+   * \brief Sends \ref Block to secure element again
+   *
+   * \details Reuses the frame still encoded in the transmit buffer if it
+   * matches the given block, falls back to \ref
+   * t1prime_block_transmit(Protocol*, Block*) otherwise.
+   *
+   * \param self Protocol stack for performing necessary operations
+   * \param block Block object that has been sent to secure element before
+   * \return int   PROTOCOL_TRANSMIT_SUCCESS if successful, any other value in
+   * case of error
+   */
+  int t1prime_block_retransmit (Protocol *self, Block *block);
+
+  /**
+   * \brief Sends already encoded frame to secure element
+   *
+   * \param self Protocol stack for performing necessary operations
+   * \param protocol_state T=1' protocol state to update statistics of
+   * \param frame Encoded frame to be sent
+   * \param frame_len Number of bytes in   frame
+   * \return int   PROTOCOL_TRANSMIT_SUCCESS if successful, any other value in
+   * case of error
+   */
+  int t1prime_frame_transmit (Protocol *self,
+                              T1PrimeProtocolState *protocol_state,
+                              const uint8_t *frame, size_t frame_len);
+
   /**
    * \brief Reads \ref Block from secure element
    *
@@ -347,6 +403,157 @@ extern "C"
    */
   int t1prime_block_receive (Protocol *self, Block *block);
 
+  /**
+   * \brief Prepares polling timing for next response block
+   *
+   * \details A pending waiting time extension replaces BWT as deadline for
+   * this block only.
+   *
+   * \param protocol_state T=1' protocol state to prepare polling for
+   */
+  void t1prime_poll_start (T1PrimeProtocolState *protocol_state);
+
+  /**
+   * \brief Performs single polling attempt for \ref Block from secure
+   * element
+   *
+   * \param self Protocol stack for performing necessary operations
+   * \param protocol_state T=1' protocol state holding polling timing
+   * \param block Block object to store received data in
+   * \return int   PROTOCOL_RECEIVE_SUCCESS if block has been received,
+   * T1PRIME_TRANSCEIVE_PENDING if secure element is not ready yet, any other
+   * value in case of error
+   */
+  int t1prime_block_poll (Protocol *self,
+                          T1PrimeProtocolState *protocol_state, Block *block);
+
+  /**
+   * \brief Drives current exchange until it completes by waiting in between
+   * polling attempts
+   *
+   * \param self T=1' protocol stack to be used
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_exchange_run (Protocol *self);
+
+  /**
+   * \brief Schedules new request block for transmission
+   *
+   * \param protocol_state T=1' protocol state holding exchange
+   * \param request Block to be sent (information field is referenced)
+   */
+  void t1prime_exchange_send (T1PrimeProtocolState *protocol_state,
+                              Block *request);
+
+  /**
+   * \brief Prepares I block carrying current chunk of command data
+   *
+   * \param protocol_state T=1' protocol state holding exchange
+   * \param request Block to be populated
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_exchange_chunk (T1PrimeProtocolState *protocol_state,
+                              Block *request);
+
+  /**
+   * \brief Finishes exchange with given status
+   *
+   * \param protocol_state T=1' protocol state holding exchange
+   * \param status Final status of the exchange
+   */
+  void t1prime_exchange_complete (T1PrimeProtocolState *protocol_state,
+                                  int status);
+
+  /**
+   * \brief Validates received block against current request and schedules
+   * retries
+   *
+   * \param protocol_state T=1' protocol state holding exchange
+   * \param status Status of receiving the response block
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if valid response block has
+   * been received, T1PRIME_TRANSCEIVE_PENDING if retry has been scheduled,
+   * any other value in case of error
+   */
+  int t1prime_exchange_validate (T1PrimeProtocolState *protocol_state,
+                                 int status);
+
+  /**
+   * \brief Decides on next step of T=1' transceive logic based on received
+   * block
+   *
+   * \param protocol_state T=1' protocol state holding exchange
+   * \return int   T1PRIME_TRANSCEIVE_PENDING if next block has been
+   * scheduled, PROTOCOL_TRANSCEIVE_SUCCESS if complete response has been
+   * received, any other value in case of error
+   */
+  int t1prime_exchange_handle (T1PrimeProtocolState *protocol_state);
+
+  /**
+   * \brief Keeps track of link errors and steps down the I2C clock frequency
+   * once they pile up
+   *
+   * \param self Protocol stack for performing necessary operations
+   * \param protocol_state T=1' protocol state
+   * \param status Status of last bus operation or received block
+   * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_link_update (Protocol *self,
+                           T1PrimeProtocolState *protocol_state, int status);
+
+  /**
+   * \brief Appends information field of received I block to response of
+   * exchange
+   *
+   * \param protocol_state T=1' protocol state holding exchange
+   * \param data Information field to be appended
+   * \param data_len Number of bytes in data
+   * \param more Whether more I blocks will follow in chain
+   * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_exchange_append (T1PrimeProtocolState *protocol_state,
+                               const uint8_t *data, size_t data_len,
+                               bool more);
+
+  /**
+   * \brief Reads data from driver layer into buffer and keeps track of bus
+   * statistics
+   *
+   * \param self Protocol stack for performing necessary operations
+   * \param protocol_state T=1' protocol state to update statistics in
+   * \param buffer Buffer to store received data in
+   * \param expected_len Number of bytes to be read
+   * \return int   PROTOCOL_RECEIVE_SUCCESS if exactly   expected_len bytes
+   * have been read, any other value in case of error
+   */
+  int t1prime_bus_receive (Protocol *self,
+                           T1PrimeProtocolState *protocol_state,
+                           uint8_t *buffer, size_t expected_len);
+
+  /**
+   * \brief Waits for given time before next polling attempt
+   *
+   * \details Sleeps on the \ref Clock installed for the protocol stack.
+   *
+   * \param self Protocol stack to wait for
+   * \param duration Time to wait in [multiple of 100us]
+   */
+  void t1prime_poll_delay (Protocol *self, uint32_t duration);
+
+  /**
+   * \brief Updates learned secure element processing time for APDU
+   * instruction with new sample
+   *
+   * \param protocol_state T=1' protocol state holding learned times
+   * \param ins APDU instruction byte the sample belongs to
+   * \param sample Observed processing time in [multiple of 100us]
+   */
+  void t1prime_learn_processing_time (T1PrimeProtocolState *protocol_state,
+                                      uint8_t ins, uint32_t sample);
+
 /**
  * \brief Number of read retries after which \ref
  * t1prime_block_transceive(Protocol*, Block*, Block*) shall fail
@@ -413,6 +620,29 @@ extern "C"
  */
 #define T1PRIME_DEFAULT_I2C_MPOT 10
 
+/**
+ * \brief Lowest I2C clock frequency (Standard-mode) in [Hz] the clock is
+ * stepped down to after link errors
+ */
+#define T1PRIME_MIN_I2C_CLOCK_FREQUENCY 100000
+
+/**
+ * \brief Number of consecutive link errors (NACKed writes, broken or
+ * corrupted frames) after which the I2C clock frequency is stepped down
+ */
+#define T1PRIME_LINK_ERRORS_STEP_DOWN 2
+
+/**
+ * \brief Upper bound for exponential polling backoff in [multiple of 100us]
+ */
+#define T1PRIME_MAX_POLL_INTERVAL 50
+
+/**
+ * \brief Weight of new samples in learned processing times as right shift
+ * (3 -> 1/8)
+ */
+#define T1PRIME_PROCESSING_TIME_SHIFT 3
+
 
 /**
  * \brief Maximum allowed information field size
@@ -424,6 +654,27 @@ extern "C"
  */
 #define T1PRIME_DEFAULT_IFSC 0x08
 
+/**
+ * \brief Default value for maximum information field size of the host device
+ * (IFSD)
+ */
+#define T1PRIME_DEFAULT_IFSD 0x102
+
+/**
+ * \brief Largest information field size of the host device (IFSD) negotiated
+ * during activation unless configured otherwise
+ */
+#ifndef T1PRIME_DEFAULT_MAX_IFSD
+#define T1PRIME_DEFAULT_MAX_IFSD T1PRIME_MAX_IFS
+#endif
+
+/**
+ * \brief Number of bytes required to hold a complete frame with an information
+ * field of   ifs bytes
+ */
+#define T1PRIME_FRAME_SIZE(ifs)                                               \
+  (BLOCK_PROLOGUE_LENGTH + (ifs) + BLOCK_EPILOGUE_LENGTH)
+
 /**
  * \brief Default value for current block waiting time in [ms]
  */
@@ -451,6 +702,45 @@ extern "C"
    */
   int t1prime_get_ifsc (Protocol *self, size_t *ifsc_buffer);
 
+  /**
+   * \brief Returns send sequence counter N(S) of the next I block
+   *
+   * \param self T=1' protocol stack to get N(S) for
+   * \param send_counter_buffer Buffer to store N(S) (0 or 1) in
+   * \return int   PROTOCOL_GETPROTPERTY_SUCCESS if successful, any other
+   * value in case of error
+   */
+  int t1prime_get_send_counter (Protocol *self, uint8_t *send_counter_buffer);
+
+/**
+ * \brief IFX error code function identifier for \ref
+ * t1prime_frame_reserve(uint8_t**, size_t*, size_t, const Allocator*)
+ */
+#define T1PRIME_FRAME_RESERVE 0x36
+
+/**
+ * \brief Return code for successful calls to \ref
+ * t1prime_frame_reserve(uint8_t**, size_t*, size_t, const Allocator*)
+ */
+#define T1PRIME_FRAME_RESERVE_SUCCESS SUCCESS
+
+  /**
+   * \brief Ensures that a frame buffer can hold a block with the given
+   * information field size
+   *
+   * \details Frame buffers only ever grow so that steady state communication
+   * does not cause any heap traffic.
+   *
+   * \param frame Frame buffer to be (re-) allocated
+   * \param frame_size Number of bytes available in   frame
+   * \param ifs Information field size the frame must be able to hold
+   * \param allocator Allocator   frame has been allocated with
+   * \return int   T1PRIME_FRAME_RESERVE_SUCCESS if successful, any other
+   * value in case of error
+   */
+  int t1prime_frame_reserve (uint8_t **frame, size_t *frame_size, size_t ifs,
+		  const Allocator *allocator);
+
 /**
  * \brief IFX error code function identifier for \ref
  * t1prime_ifs_encode(size_t, uint8_t**, size_t*)
@@ -459,7 +749,7 @@ extern "C"
 
 /**
  * \brief Return code for successful calls to \ref t1prime_ifs_encode(size_t,
- * uint8_t**, size_t*)
+ * uint8_t**, size_t*, const Allocator*)
  */
 #define T1PRIME_IFS_ENCODE_SUCCESS SUCCESS
 
@@ -469,10 +759,26 @@ extern "C"
    * \param ifs IFS value to be encoded
    * \param buffer Buffer to store encoded data in
    * \param buffer_len Number of bytes in   buffer
+   * \param allocator Allocator   buffer is allocated with (NULL for system
+   * heap)
+   * \return int   T1PRIME_IFS_ENCODE_SUCCESS if successful, any other value
+   * in case of error
+   */
+  int t1prime_ifs_encode (size_t ifs, uint8_t **buffer, size_t *buffer_len,
+                          const Allocator *allocator);
+
+  /**
+   * \brief Encodes information field size (IFS) to its binary representation
+   * in a caller provided buffer
+   *
+   * \param ifs IFS value to be encoded
+   * \param buffer Buffer to store encoded data in
+   * \param buffer_len Buffer to store number of bytes written to   buffer in
    * \return int   T1PRIME_IFS_ENCODE_SUCCESS if successful, any other value
    * in case of error
    */
-  int t1prime_ifs_encode (size_t ifs, uint8_t **buffer, size_t *buffer_len);
+  int t1prime_ifs_encode_into (size_t ifs, uint8_t buffer[2],
+		  size_t *buffer_len);
 
 /**
  * \brief IFX error code function identifier for \ref
@@ -0,0 +1,272 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file trace.h
+ *
+ * \brief Protocol layer recording bus traffic into a ring buffer
+ *
+ * \details The trace layer is inserted between the T=1' layer and the I2C
+ * driver and records every transmit, receive and unacknowledged receive
+ * (poll) with a timestamp of the stack's \ref Clock. Events are stored in a
+ * caller provided \ref TraceBuffer, once it is full the oldest events are
+ * overwritten. Nothing is allocated while recording.
+ *
+ * Each event is stored as
+ *
+ *      type (1) || timestamp (4) || length (2) || data (length)
+ *
+ * with multi-byte values in big endian:
+ *   - type: \ref TRACE_EVENT_TRANSMIT, \ref TRACE_EVENT_RECEIVE or \ref
+ *     TRACE_EVENT_POLL, ORed with \ref TRACE_EVENT_ERROR if the driver failed
+ *   - timestamp: time the call was made in [us] since the first event
+ *     (modulo 2^32)
+ *   - length / data: bytes written or read. Polls carry no data, their length
+ *     is the number of bytes the host tried to read.
+ *
+ * \ref trace_dump(const TraceBuffer*, trace_writefunction_t, void*) writes a
+ * \ref TRACE_HEADER_LENGTH byte header ("BS2T" || version (1) || reserved (1)
+ * || overwritten events (4)) followed by all events oldest first.
+ *
+ * \example
+ *      static uint8_t memory[4096];
+ *      TraceBuffer buffer;
+ *      Protocol driver, trace, protocol;
+ *      psoc6_i2c_initialize (&driver);
+ *      trace_buffer_initialize (&buffer, memory, sizeof (memory));
+ *      trace_initialize (&trace, &driver, &buffer);
+ *      t1prime_initialize (&protocol, &trace);
+ *      ...
+ *      trace_dump_file (&buffer, stdout);
+ */
+#ifndef _IFX_TRACE_H_
+#define _IFX_TRACE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bs2go/error/error.h"
+#include "bs2go/protocol/protocol.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief IFX error code module identifer
+ */
+#define LIBTRACE 0x39
+
+/**
+ * \brief IFX error encoding function identifier for \ref
+ * trace_dump(const TraceBuffer*, trace_writefunction_t, void*)
+ */
+#define TRACE_DUMP 0x01
+
+/**
+ * \brief Return code for successful calls to \ref trace_dump(const
+ * TraceBuffer*, trace_writefunction_t, void*)
+ */
+#define TRACE_DUMP_SUCCESS SUCCESS
+
+/**
+ * \brief IFX error encoding function identifier for \ref
+ * trace_event_decode(const uint8_t*, size_t, size_t*, TraceEvent*)
+ */
+#define TRACE_EVENT_DECODE 0x02
+
+/**
+ * \brief Return code for successful calls to \ref trace_event_decode(const
+ * uint8_t*, size_t, size_t*, TraceEvent*)
+ */
+#define TRACE_EVENT_DECODE_SUCCESS SUCCESS
+
+/**
+ * \brief IFX error code reason if trace sink did not accept data
+ */
+#define TRACE_WRITE_FAILED 0x01
+
+/**
+ * \brief IFX error code reason if all events of a dumped trace have been
+ * decoded
+ */
+#define TRACE_END_OF_TRACE 0x02
+
+/**
+ * \brief IFX error code reason if dumped trace has unknown header or version
+ */
+#define TRACE_INVALID_FORMAT 0x03
+
+/**
+ * \brief Event type of data written to the driver
+ */
+#define TRACE_EVENT_TRANSMIT 0x01
+
+/**
+ * \brief Event type of data read from the driver
+ */
+#define TRACE_EVENT_RECEIVE 0x02
+
+/**
+ * \brief Event type of read not acknowledged by the driver (secure element
+ * busy)
+ */
+#define TRACE_EVENT_POLL 0x03
+
+/**
+ * \brief Event flag if driver returned an error
+ */
+#define TRACE_EVENT_ERROR 0x80
+
+/**
+ * \brief Number of bytes in front of event data
+ */
+#define TRACE_EVENT_HEADER_LENGTH 7
+
+/**
+ * \brief Number of bytes in front of dumped events
+ */
+#define TRACE_HEADER_LENGTH 10
+
+/**
+ * \brief Version of dump format
+ */
+#define TRACE_VERSION 0x01
+
+/**
+ * \brief Ring buffer holding recorded events
+ */
+typedef struct TraceBuffer
+{
+	uint8_t *buffer;   /**< Memory holding events */
+	size_t size;       /**< Number of bytes in buffer */
+	size_t head;       /**< Offset next event is written to */
+	size_t tail;       /**< Offset of oldest event */
+	size_t used;       /**< Number of bytes currently used */
+	bool started;      /**< Whether first event has been recorded */
+	uint64_t start;    /**< Time of first event in [us] */
+	size_t events;     /**< Number of events currently held */
+	size_t overwritten; /**< Number of events lost (overwritten or larger
+                           than buffer) */
+} TraceBuffer;
+
+/**
+ * \brief Event decoded from a dumped trace
+ */
+typedef struct TraceEvent
+{
+	uint8_t type;        /**< Event type (and flags) */
+	uint32_t timestamp;  /**< Time of event in [us] since first event */
+	uint16_t length;     /**< Length field of event */
+	const uint8_t *data; /**< Event data within dumped trace (  NULL for
+                            polls) */
+	size_t data_len;     /**< Number of bytes in   data */
+} TraceEvent;
+
+/**
+ * \brief Sink for dumped traces (e.g. UART, file)
+ *
+ * \param context Sink specific data
+ * \param data Data to be written
+ * \param data_len Number of bytes in   data
+ * \return int   0 if successful, any other value in case of error
+ */
+typedef int (*trace_writefunction_t) (void *context, const uint8_t *data,
+		size_t data_len);
+
+/**
+ * \brief Initializes empty ring buffer in given memory
+ *
+ * \param trace Ring buffer to be initialized
+ * \param buffer Memory to hold events
+ * \param size Number of bytes in   buffer
+ */
+void trace_buffer_initialize (TraceBuffer *trace, void *buffer, size_t size);
+
+/**
+ * \brief Drops all recorded events and restarts timestamps at next event
+ *
+ * \param trace Ring buffer to be reset
+ */
+void trace_buffer_reset (TraceBuffer *trace);
+
+/**
+ * \brief Initializes \ref Protocol object for trace layer
+ *
+ * \param self \ref Protocol object to be initialized
+ * \param driver \ref Driver layer whose traffic is recorded
+ * \param trace Ring buffer to record into (must outlive the stack)
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error
+ */
+int trace_initialize (Protocol *self, Protocol *driver, TraceBuffer *trace);
+
+/**
+ * \brief Writes header and all recorded events (oldest first) to sink
+ *
+ * \param trace Ring buffer to be dumped
+ * \param write Sink to write to
+ * \param context Sink specific data passed to   write
+ * \return int   TRACE_DUMP_SUCCESS if successful, any other value in case of
+ * error
+ */
+int trace_dump (const TraceBuffer *trace, trace_writefunction_t write,
+		void *context);
+
+/**
+ * \brief Writes header and all recorded events to file
+ *
+ * \details On the target stdout is retargeted to the debug UART, so
+ *   trace_dump_file(trace, stdout) sends the trace over UART.
+ *
+ * \param trace Ring buffer to be dumped
+ * \param file File to write to
+ * \return int   TRACE_DUMP_SUCCESS if successful, any other value in case of
+ * error
+ */
+int trace_dump_file (const TraceBuffer *trace, FILE *file);
+
+/**
+ * \brief Decodes next event of a dumped trace
+ *
+ * \details Validates and skips the dump header if   offset is 0.
+ *
+ * \param trace Dumped trace (header and events)
+ * \param trace_len Number of bytes in   trace
+ * \param offset Offset of next event, advanced past decoded event
+ * \param event Buffer to store event in (data points into   trace)
+ * \return int   TRACE_EVENT_DECODE_SUCCESS if successful, error with reason
+ * TRACE_END_OF_TRACE after last event, any other value in case of error
+ */
+int trace_event_decode (const uint8_t *trace, size_t trace_len,
+		size_t *offset, TraceEvent *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IFX_TRACE_H_*/
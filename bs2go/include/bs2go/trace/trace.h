@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file trace.h
+ *
+ * \brief Internal definitions for trace protocol layer
+ */
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/trace/ifx/trace.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * \brief Protocol Layer ID for trace layer
+ *
+ * \details Used to verify that correct protocol layer has called member
+ * functionality
+ */
+#define TRACE_PROTOCOLLAYER_ID 0x39
+
+/**
+ * \brief Returns ring buffer of trace layer in protocol stack
+ *
+ * \param self Protocol stack containing trace layer
+ * \param trace_buffer Buffer to store ring buffer in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int trace_get_buffer (Protocol *self, TraceBuffer **trace_buffer);
+
+/**
+ * \brief Appends event to ring buffer, overwriting oldest events if needed
+ *
+ * \param trace Ring buffer to record into
+ * \param type Event type (and flags)
+ * \param timestamp Time of event in [us]
+ * \param length Length field of event
+ * \param data Event data (might be   NULL)
+ * \param data_len Number of bytes in   data
+ */
+void trace_record (TraceBuffer *trace, uint8_t type, uint64_t timestamp,
+		uint16_t length, const uint8_t *data, size_t data_len);
+
+/**
+ * \brief \ref protocol_transmitfunction_t for trace layer
+ *
+ * \see protocol_transmitfunction_t
+ */
+int trace_transmit (Protocol *self, uint8_t *data, size_t data_len);
+
+/**
+ * \brief \ref protocol_receivefunction_t for trace layer
+ *
+ * \see protocol_receivefunction_t
+ */
+int trace_receive (Protocol *self, size_t expected_len, uint8_t **response,
+		size_t *response_len);
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for trace layer
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int trace_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len);
+
+/**
+ * \brief \ref protocol_destroyfunction_t for trace layer
+ *
+ * \details Detaches caller owned ring buffer so it is not released.
+ *
+ * \see protocol_destroyfunction_t
+ */
+void trace_destroy (Protocol *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACE_H_*/
@@ -35,6 +35,7 @@
 extern "C"
 {
 #endif
+#include "cyhal.h"
 #include "bs2go/blocksec2go/blocksec2go.h"
 #include <stdint.h>
 /**
@@ -45,15 +46,33 @@ extern "C"
  * \return uint16_t   SUCCESS if successful, any other value in case of error.
  */
   uint16_t se_interface_init ();
+/**
+ * \brief Initializes and activates an additional secure element
+ *
+ * \details Secure elements on the same pins share the I2C bus and are told
+ * apart by their I2C address.
+ *
+ * \param[out] protocol  T=1' protocol stack to be initialized
+ * \param[out] driver    I2C driver layer to be initialized
+ * \param[in] sda        pin used as I2C SDA
+ * \param[in] scl        pin used as I2C SCL
+ * \param[in] address    I2C address of the secure element
+ *
+ * \retval SUCCESS in case of success
+ */
+  int se_interface_open (Protocol *protocol, Protocol *driver,
+                         cyhal_gpio_t sda, cyhal_gpio_t scl,
+                         uint16_t address);
 /**
  * \brief SELECT the Blockchain Security 2Go application.
  *
  * \param[out] id         buffer to copy SE id to
- * \param[out] version    pointer to write address of allocated zero terminated
+ * \param[out] version    buffer to copy zero terminated version string to
  *
  * \retval SUCCESS in case of success
  */
-  int wrap_block2go_select (uint8_t id[BLOCK2GO_ID_LEN], char **version);
+  int wrap_block2go_select (uint8_t id[BLOCK2GO_ID_LEN],
+                            char version[BLOCK2GO_VERSION_MAX_LEN]);
 /**
  * \brief Creates new ECC public/private keypair.
  *
@@ -72,7 +91,8 @@ extern "C"
  *
  * \retval SUCCESS in case of success
  */
-  int wrap_get_pub_key (uint8_t key_index, uint8_t *public_key[65],
+  int wrap_get_pub_key (uint8_t key_index,
+                        uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN],
                         uint8_t *public_key_len,block2go_curve curve);
 /**
  * \brief Signs a given block of prehashed data using the stored private key
@@ -86,7 +106,8 @@ extern "C"
  * \retval SUCCESS in case of success
  */
   int wrap_sign (uint8_t key_index, uint8_t data_to_sign[32],
-                 uint8_t **signature, size_t *signature_len);
+                 uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN],
+                 size_t *signature_len);
 /**
  * \brief Checks whether a given ECDSA signature is valid.
  *
@@ -0,0 +1,235 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * \file se_pool.h
+ * \brief Pool of Blockchain Security 2Go secure elements sharing signing
+ *        requests
+ *
+ * \details Each secure element processes one command at a time, so signing
+ * throughput of a single chip is bound by its ECDSA time. The pool keeps one
+ * queue per secure element and drives all of them concurrently via
+ * non-blocking T=1' transceive, requests are routed to the secure element
+ * holding the key (key affinity) or to the one with the least outstanding
+ * work.
+ */
+
+#ifndef _IFX_SE_POOL_H_
+#define _IFX_SE_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/error/error.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/t1prime/t1prime.h"
+
+/**
+ * \brief IFX error code module identifer
+ */
+#define LIBSEPOOL 0x36
+
+/**
+ * \brief Maximum number of secure elements in a pool
+ */
+#ifndef SE_POOL_MAX_MEMBERS
+#define SE_POOL_MAX_MEMBERS 8
+#endif
+
+/**
+ * \brief Marker for keys that can be used on any secure element of the pool
+ */
+#define SE_POOL_ANY_MEMBER 0xff
+
+/**
+ * \brief Marker for keys not assigned to any secure element (default)
+ */
+#define SE_POOL_NO_MEMBER 0xfe
+
+/**
+ * \brief Return code for requests / pools that still have work in progress
+ */
+#define SE_POOL_PENDING 0x01
+
+/**
+ * \brief IFX error encoding function identifier for \ref se_pool_add
+ */
+#define SE_POOL_ADD 0x01
+
+/**
+ * \brief IFX error encoding function identifier for \ref se_pool_sign
+ */
+#define SE_POOL_SIGN 0x02
+
+/**
+ * \brief IFX error encoding function identifier for \ref se_pool_poll
+ */
+#define SE_POOL_POLL 0x03
+
+/**
+ * \brief IFX error encoding function identifier for \ref
+ * se_pool_set_key_affinity
+ */
+#define SE_POOL_SET_KEY_AFFINITY 0x04
+
+/**
+ * \brief IFX error code reason for signing requests with a key that has not
+ * been assigned to a secure element via \ref se_pool_set_key_affinity
+ */
+#define SE_POOL_KEY_UNASSIGNED 0x01
+
+/**
+ * \brief Signing request processed by an \ref SEPool
+ *
+ * \details Storage is provided by the caller and must stay valid until the
+ * request has been processed (status other than \ref SE_POOL_PENDING).
+ */
+typedef struct SEPoolRequest
+{
+	uint8_t key_index;         /**< Key used for signing */
+	uint8_t data_to_sign[32];  /**< Hashed data to be signed */
+	int status;                /**< SE_POOL_PENDING while queued / processed,
+                                  result of GENERATE SIGNATURE afterwards */
+	uint32_t global_counter;   /**< Remaining signatures of the card */
+	uint32_t counter;          /**< Remaining signatures of the key */
+	uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN]; /**< ASN.1 DER encoded
+                                                    signature */
+	size_t signature_len;      /**< Length of signature in bytes */
+	size_t member;             /**< Secure element processing the request */
+	uint8_t frame[T1PRIME_FRAME_SIZE (BLOCK2GO_GENERATE_SIGNATURE_APDU_LEN)];
+                               /**< I block carrying command APDU while in
+                                  flight */
+	struct SEPoolRequest *next; /**< Next request queued on same member */
+} SEPoolRequest;
+
+/**
+ * \brief Secure element of an \ref SEPool with its request queue
+ */
+typedef struct SEPoolMember
+{
+	Protocol *protocol;    /**< Activated T=1' protocol stack */
+	SEPoolRequest *head;   /**< Request currently processed */
+	SEPoolRequest *tail;   /**< Last queued request */
+	size_t outstanding;    /**< Number of queued requests (including head) */
+	uint32_t wait;         /**< Time until member needs to be polled again in
+                              [us] */
+} SEPoolMember;
+
+/**
+ * \brief Pool of secure elements processing signing requests concurrently
+ */
+typedef struct SEPool
+{
+	SEPoolMember members[SE_POOL_MAX_MEMBERS]; /**< Secure elements */
+	size_t member_count;   /**< Number of secure elements in pool */
+	uint8_t affinity[256]; /**< Secure element holding each key index,
+                              SE_POOL_ANY_MEMBER or SE_POOL_NO_MEMBER */
+} SEPool;
+
+/**
+ * \brief Initializes empty pool
+ *
+ * \details No key is assigned to a secure element yet, see \ref
+ * se_pool_set_key_affinity.
+ *
+ * \param[out] pool  pool to be initialized
+ */
+  void se_pool_initialize (SEPool *pool);
+
+/**
+ * \brief Adds secure element to pool
+ *
+ * \param[in] pool      pool to add secure element to
+ * \param[in] protocol  activated T=1' protocol stack of secure element (e.g.
+ *                      from \ref se_interface_open)
+ * \param[out] member   buffer to store index of secure element in pool in
+ *                      (may be NULL)
+ *
+ * \retval SUCCESS in case of success
+ */
+  int se_pool_add (SEPool *pool, Protocol *protocol, size_t *member);
+
+/**
+ * \brief Assigns key to secure element holding it
+ *
+ * \details Every key index must be assigned before it can be used for
+ * signing, as the same key index refers to a different private key on each
+ * secure element. Only keys that are known to be identical on all secure
+ * elements (e.g. imported from the same seed via \ref
+ * block2go_encrypted_keyimport) may be assigned to SE_POOL_ANY_MEMBER, they
+ * are routed to the secure element with the least outstanding requests.
+ *
+ * \param[in] pool       pool to configure
+ * \param[in] key_index  key index
+ * \param[in] member     secure element holding key, SE_POOL_ANY_MEMBER or
+ *                       SE_POOL_NO_MEMBER to remove the assignment
+ *
+ * \retval SUCCESS in case of success
+ */
+  int se_pool_set_key_affinity (SEPool *pool, uint8_t key_index,
+                                uint8_t member);
+
+/**
+ * \brief Queues signing request
+ *
+ * \param[in] pool          pool to process request
+ * \param[out] request      request to be queued
+ * \param[in] key_index     key index to be used for signing
+ * \param[in] data_to_sign  hashed data that should be signed
+ *
+ * \retval SUCCESS in case request has been queued
+ * \retval IFX_ERROR(LIBSEPOOL, SE_POOL_SIGN, SE_POOL_KEY_UNASSIGNED) if
+ * key_index has not been assigned to a secure element
+ */
+  int se_pool_sign (SEPool *pool, SEPoolRequest *request, uint8_t key_index,
+                    const uint8_t data_to_sign[32]);
+
+/**
+ * \brief Advances all secure elements of the pool
+ *
+ * \param[in] pool        pool to be advanced
+ * \param[in] elapsed_us  time passed since last call in [us]
+ * \param[out] wait_us    buffer to store time until next call in [us] in
+ *
+ * \retval SE_POOL_PENDING while requests are outstanding
+ * \retval SUCCESS once all queued requests have been processed
+ */
+  int se_pool_poll (SEPool *pool, uint32_t elapsed_us, uint32_t *wait_us);
+
+/**
+ * \brief Processes all queued requests (blocking)
+ *
+ * \param[in] pool  pool to be drained
+ *
+ * \retval SUCCESS once all queued requests have been processed
+ */
+  int se_pool_run (SEPool *pool);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+#endif /* _IFX_SE_POOL_H_ */
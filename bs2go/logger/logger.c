@@ -52,6 +52,7 @@ int logger_initialize(Logger *self)
     self->_log = NULL;
     self->_destructor = NULL;
     self->_level = LOG_FATAL;
+    self->_allocator = NULL;
     self->_data = NULL;
 
     return LOGGER_INITIALIZE_SUCCESS;
@@ -89,7 +90,7 @@ int logger_log(Logger* self, const char *source, LogLevel level, const char* for
     va_list args;
     va_start(args, formatter);
     size_t output_length = vsnprintf(NULL, 0, formatter, args);
-    char *output = malloc(output_length + 1);
+    char *output = allocator_malloc(self->_allocator, output_length + 1);
     if (output == NULL)
     {
         return IFX_ERROR(LIBLOGGER, LOGGER_LOG, OUT_OF_MEMORY);
@@ -111,7 +112,7 @@ int logger_log(Logger* self, const char *source, LogLevel level, const char* for
     int status = self->_log(self, source, level, output);
 
     /* Clean up */
-    free(output);
+    allocator_free(self->_allocator, output);
     va_end(args);
     return status;
 }
@@ -152,7 +153,11 @@ int logger_log_bytearray(Logger *self, const char *source, LogLevel level, const
     size_t msg_len = (msg != NULL) ? strlen(msg) : 0;
     size_t delimiter_len = (delimiter != NULL) ? strlen(delimiter) : 0;
     size_t formatted_len = msg_len + (data_len * 2) + ((data_len - 1) * delimiter_len);
-    char *formatted = malloc(formatted_len + 1);
+    char *formatted = allocator_malloc(self->_allocator, formatted_len + 1);
+    if (formatted == NULL)
+    {
+        return IFX_ERROR(LIBLOGGER, LOGGER_LOG, OUT_OF_MEMORY);
+    }
     if (msg_len > 0)
     {
         memcpy(formatted, msg, msg_len);
@@ -169,7 +174,7 @@ int logger_log_bytearray(Logger *self, const char *source, LogLevel level, const
 
     /* Actually log message */
     int status = self->_log(self, source, level, formatted);
-    free(formatted);
+    allocator_free(self->_allocator, formatted);
     return status;
 }
 
@@ -195,6 +200,26 @@ int logger_set_level(Logger* self, LogLevel level)
     return LOGGER_SET_LEVEL_SUCCESS;
 }
 
+/**
+ * \brief Sets allocator used for formatting messages
+ *
+ * \param self \ref Logger object to set allocator for
+ * \param allocator \ref Allocator to be used (might be \c NULL for system heap)
+ * \return int \c LOGGER_SET_ALLOCATOR_SUCCESS if successful, any other value in case of error
+ */
+int logger_set_allocator(Logger *self, const Allocator *allocator)
+{
+    /* Validate parameters */
+    if (self == NULL)
+    {
+        return IFX_ERROR(LIBLOGGER, LOGGER_SET_ALLOCATOR, ILLEGAL_ARGUMENT);
+    }
+
+    /* Actually set allocator */
+    self->_allocator = allocator;
+    return LOGGER_SET_ALLOCATOR_SUCCESS;
+}
+
 /**
  * \brief Frees memory associated with \ref Logger object (but not object itself)
  *
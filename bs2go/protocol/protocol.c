@@ -28,6 +28,7 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "bs2go/protocol/protocol.h"
 
@@ -116,6 +117,287 @@ protocol_transceive (Protocol *self, uint8_t *data, size_t data_len,
 	}
 }
 
+/**
+ * \brief Sends data scattered over several segments via protocol and reads
+ * back response into caller provided segments
+ *
+ * \details Uses \ref Protocol._transceive_iov if available and falls back to
+ * \ref protocol_transceive(Protocol*, uint8_t*, size_t, uint8_t**, size_t*)
+ * (joining command and copying response) otherwise.
+ *
+ * \param self \ref Protocol stack for performing necessary operations
+ * \param command Segments of data to be send via protocol
+ * \param command_count Number of segments in   command
+ * \param response Segments to store response in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of received bytes in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in case of error
+ */
+int
+protocol_transceive_iov (Protocol *self, const ProtocolSegment *command,
+		size_t command_count, const ProtocolSegment *response,
+		size_t response_count, size_t *response_len)
+{
+	/* Validate parameters */
+	if (self == NULL)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE,
+				INVALID_PROTOCOLSTACK);
+	}
+	if ((command == NULL) || (command_count == 0)
+			|| ((response == NULL) && (response_count > 0))
+			|| (response_len == NULL))
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* If protocol handles segments then directly use it */
+	if (self->_transceive_iov != NULL)
+	{
+		return self->_transceive_iov (self, command, command_count, response,
+				response_count, response_len);
+	}
+
+	/* Otherwise join command and copy response */
+	size_t data_len = protocol_segments_length (command, command_count);
+	const Allocator *allocator = protocol_get_transaction_allocator (self);
+	uint8_t *data = allocator_malloc (allocator, data_len > 0 ? data_len : 1);
+	if (data == NULL)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE, OUT_OF_MEMORY);
+	}
+	protocol_segments_gather (command, command_count, 0, data, data_len);
+
+	uint8_t *received = NULL;
+	size_t received_len = 0;
+	int status = protocol_transceive (self, data, data_len, &received,
+			&received_len);
+	allocator_free (allocator, data);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	if (protocol_segments_scatter (response, response_count, 0, received,
+			received_len) != received_len)
+	{
+		status = IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE, RESPONSE_TOO_LONG);
+	}
+	allocator_free (allocator, received);
+	*response_len = received_len;
+	return status;
+}
+
+/**
+ * \brief Sends data encoded into caller provided room of a frame buffer via
+ * protocol and reads back response into caller provided segments
+ *
+ * \details Uses \ref Protocol._transceive_inplace if available and falls
+ * back to \ref protocol_transceive_iov(Protocol*, const ProtocolSegment*,
+ * size_t, const ProtocolSegment*, size_t, size_t*) with the data only
+ * otherwise.
+ *
+ * \param self \ref Protocol stack for performing necessary operations
+ * \param buffer Frame buffer holding data to be send via protocol
+ * \param data_len Number of data bytes in   buffer
+ * \param response Segments to store response in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of received bytes in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in case of error
+ */
+int
+protocol_transceive_inplace (Protocol *self, uint8_t *buffer,
+		size_t data_len, const ProtocolSegment *response,
+		size_t response_count, size_t *response_len)
+{
+	/* Validate parameters */
+	if (self == NULL)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE,
+				INVALID_PROTOCOLSTACK);
+	}
+	if ((buffer == NULL) || ((response == NULL) && (response_count > 0))
+			|| (response_len == NULL))
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* If protocol frames data in place then directly use it */
+	if (self->_transceive_inplace != NULL)
+	{
+		return self->_transceive_inplace (self, buffer, data_len, response,
+				response_count, response_len);
+	}
+
+	/* Otherwise pass on data without reserved room */
+	ProtocolSegment command = { .data = buffer + self->_headroom,
+			.len = data_len };
+	return protocol_transceive_iov (self, &command, 1, response,
+			response_count, response_len);
+}
+
+/**
+ * \brief Returns number of bytes to be reserved in front of and behind data
+ * passed to \ref protocol_transceive_inplace(Protocol*, uint8_t*, size_t,
+ * const ProtocolSegment*, size_t, size_t*)
+ *
+ * \param self \ref Protocol object to get headroom for
+ * \param headroom Buffer to store number of bytes in front of data in
+ * \param tailroom Buffer to store number of bytes behind data in
+ */
+void
+protocol_get_headroom (Protocol *self, size_t *headroom, size_t *tailroom)
+{
+	*headroom = (self != NULL) ? self->_headroom : 0;
+	*tailroom = (self != NULL) ? self->_tailroom : 0;
+}
+
+/**
+ * \brief Returns total number of bytes in segments
+ *
+ * \param segments Segments to be summed up
+ * \param count Number of segments in   segments
+ * \return size_t Sum of all segment lengths
+ */
+size_t
+protocol_segments_length (const ProtocolSegment *segments, size_t count)
+{
+	size_t len = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		len += segments[i].len;
+	}
+	return len;
+}
+
+/**
+ * \brief Copies bytes from segments (starting at given offset) into
+ * contiguous buffer
+ *
+ * \param segments Segments to copy from
+ * \param count Number of segments in   segments
+ * \param offset Offset of first byte to be copied within segments
+ * \param buffer Buffer to copy bytes into
+ * \param len Number of bytes to be copied
+ * \return size_t Number of bytes actually copied (less than   len if segments
+ * end before)
+ */
+size_t
+protocol_segments_gather (const ProtocolSegment *segments, size_t count,
+		size_t offset, uint8_t *buffer, size_t len)
+{
+	size_t copied = 0;
+	for (size_t i = 0; (i < count) && (copied < len); i++)
+	{
+		/* Skip segments before offset */
+		if (offset >= segments[i].len)
+		{
+			offset -= segments[i].len;
+			continue;
+		}
+
+		size_t available = segments[i].len - offset;
+		size_t chunk = (len - copied) < available ? (len - copied) : available;
+		memcpy (buffer + copied, segments[i].data + offset, chunk);
+		copied += chunk;
+		offset = 0;
+	}
+	return copied;
+}
+
+/**
+ * \brief Copies contiguous data into segments (starting at given offset)
+ *
+ * \param segments Segments to copy into
+ * \param count Number of segments in   segments
+ * \param offset Offset of first byte to be written within segments
+ * \param data Data to be copied
+ * \param len Number of bytes in   data
+ * \return size_t Number of bytes actually copied (less than   len if segments
+ * end before)
+ */
+size_t
+protocol_segments_scatter (const ProtocolSegment *segments, size_t count,
+		size_t offset, const uint8_t *data, size_t len)
+{
+	size_t copied = 0;
+	for (size_t i = 0; (i < count) && (copied < len); i++)
+	{
+		/* Skip segments before offset */
+		if (offset >= segments[i].len)
+		{
+			offset -= segments[i].len;
+			continue;
+		}
+
+		size_t available = segments[i].len - offset;
+		size_t chunk = (len - copied) < available ? (len - copied) : available;
+		memcpy (segments[i].data + offset, data + copied, chunk);
+		copied += chunk;
+		offset = 0;
+	}
+	return copied;
+}
+
+/**
+ * \brief Receives data into caller provided memory
+ *
+ * \details Uses \ref Protocol._receive_into if available and falls back to
+ * \ref Protocol._receive (copying the allocated response) otherwise.
+ *
+ * \param self \ref Protocol stack for performing necessary operations.
+ * \param buffer Buffer to store response in
+ * \param buffer_len Number of bytes to be read into   buffer
+ * \param received_len Buffer to store number of received bytes in (number of
+ * bytes in   buffer)
+ * \return int PROTOCOL_RECEIVE_SUCCESS if successful, any other value in case of error
+ */
+int
+protocol_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len)
+{
+	/* Validate parameters */
+	if (self == NULL)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_RECEIVE, INVALID_PROTOCOLSTACK);
+	}
+	if ((buffer == NULL) || (buffer_len == 0) || (received_len == NULL))
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* If protocol reads into caller memory then directly use it */
+	if (self->_receive_into != NULL)
+	{
+		return self->_receive_into (self, buffer, buffer_len, received_len);
+	}
+
+	/* Otherwise copy allocated response */
+	if (self->_receive == NULL)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_RECEIVE, INVALID_PROTOCOLSTACK);
+	}
+	uint8_t *response = NULL;
+	size_t response_len = 0;
+	int status = self->_receive (self, buffer_len, &response, &response_len);
+	if (status != PROTOCOL_RECEIVE_SUCCESS)
+	{
+		return status;
+	}
+	const Allocator *allocator = protocol_get_transaction_allocator (self);
+	if (response_len > buffer_len)
+	{
+		allocator_free (allocator, response);
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
+	if (response_len > 0)
+	{
+		memcpy (buffer, response, response_len);
+	}
+	allocator_free (allocator, response);
+	*received_len = response_len;
+	return PROTOCOL_RECEIVE_SUCCESS;
+}
+
 /**
  * \brief Frees memory associated with \ref Protocol object (but not object
  * itself)
@@ -142,7 +424,7 @@ protocol_destroy (Protocol *self)
 		/* Check if properties have been missed by protocol layer */
 		if (self->_properties != NULL)
 		{
-			free (self->_properties);
+			allocator_free (self->_allocator, self->_properties);
 			self->_properties = NULL;
 		}
 
@@ -176,6 +458,136 @@ void protocol_set_logger(Protocol *self, Logger *logger)
     }
 }
 
+/**
+ * \brief Sets allocator to be used by protocol for long-lived memory
+ *
+ * \details Sets allocator for whole protocol stack, so all layers below will
+ * also use it.
+ *
+ * \param self \ref Protocol object to set allocator for
+ * \param allocator \ref Allocator to be used (might be   NULL for system
+ * heap)
+ */
+void
+protocol_set_allocator (Protocol *self, const Allocator *allocator)
+{
+	if (self != NULL)
+	{
+		/* Set allocator for current layer */
+		self->_allocator = allocator;
+
+		/* Go down protocol stack */
+		protocol_set_allocator (self->_base, allocator);
+	}
+}
+
+/**
+ * \brief Sets allocator to be used by protocol for per-transaction memory
+ *
+ * \details Sets allocator for whole protocol stack, so all layers below will
+ * also use it.
+ *
+ * \param self \ref Protocol object to set allocator for
+ * \param allocator \ref Allocator to be used (might be   NULL to use
+ * allocator set by \ref protocol_set_allocator(Protocol*, const Allocator*))
+ */
+void
+protocol_set_transaction_allocator (Protocol *self, const Allocator *allocator)
+{
+	if (self != NULL)
+	{
+		/* Set allocator for current layer */
+		self->_transaction_allocator = allocator;
+
+		/* Go down protocol stack */
+		protocol_set_transaction_allocator (self->_base, allocator);
+	}
+}
+
+/**
+ * \brief Returns allocator used by protocol for long-lived memory
+ *
+ * \param self \ref Protocol object to get allocator for
+ * \return const Allocator*   Allocator to be used (  NULL for system heap)
+ */
+const Allocator *
+protocol_get_allocator (Protocol *self)
+{
+	return (self != NULL) ? self->_allocator : NULL;
+}
+
+/**
+ * \brief Returns allocator used by protocol for per-transaction memory
+ *
+ * \param self \ref Protocol object to get allocator for
+ * \return const Allocator*   Allocator to be used (  NULL for system heap)
+ */
+const Allocator *
+protocol_get_transaction_allocator (Protocol *self)
+{
+	if (self == NULL)
+	{
+		return NULL;
+	}
+	if (self->_transaction_allocator != NULL)
+	{
+		return self->_transaction_allocator;
+	}
+	return self->_allocator;
+}
+
+/**
+ * \brief Releases all per-transaction memory at once
+ *
+ * \details Only resets an allocator installed via \ref
+ * protocol_set_transaction_allocator(Protocol*, const Allocator*), the
+ * long-lived allocator it falls back to is never reset.
+ *
+ * \param self \ref Protocol object to reset transaction allocator for
+ */
+void
+protocol_reset_transaction_allocator (Protocol *self)
+{
+	if (self != NULL)
+	{
+		allocator_reset (self->_transaction_allocator);
+	}
+}
+
+/**
+ * \brief Sets clock to be used by protocol for timing and waiting
+ *
+ * \details Sets clock for whole protocol stack, so all layers below will
+ * also use it.
+ *
+ * \param self \ref Protocol object to set clock for
+ * \param clock \ref Clock to be used (might be   NULL for system clock)
+ */
+void
+protocol_set_clock (Protocol *self, const Clock *clock)
+{
+	if (self != NULL)
+	{
+		/* Set clock for current layer */
+		self->_clock = clock;
+
+		/* Go down protocol stack */
+		protocol_set_clock (self->_base, clock);
+	}
+}
+
+/**
+ * \brief Returns clock used by protocol for timing and waiting
+ *
+ * \param self \ref Protocol object to get clock for
+ * \return const Clock*   Clock to be used (  NULL for system clock)
+ */
+const Clock *
+protocol_get_clock (Protocol *self)
+{
+	return (self != NULL) ? self->_clock : NULL;
+}
+
 /**
  * \brief Initializes \ref Protocol object by setting all members to valid
  * values
@@ -191,10 +603,18 @@ protocollayer_initialize (Protocol *self)
 	self->_layer_id = 0;
 	self->_activate = NULL;
 	self->_transceive = NULL;
+	self->_transceive_iov = NULL;
+	self->_transceive_inplace = NULL;
+	self->_headroom = 0;
+	self->_tailroom = 0;
 	self->_transmit = NULL;
 	self->_receive = NULL;
+	self->_receive_into = NULL;
 	self->_destructor = NULL;
     self->_logger = NULL;
+	self->_allocator = NULL;
+	self->_transaction_allocator = NULL;
+	self->_clock = NULL;
 	self->_properties = NULL;
 	return PROTOCOLLAYER_INITIALIZE_SUCCESS;
 }
@@ -50,49 +50,115 @@
 /*******************************************************************************
  * Global Variables
  *******************************************************************************/
-static cyhal_i2c_t mI2C; /* I2C object*/
-
-cy_rslt_t result;
-
-static uint16_t I2C_SLAVE_ADDR; /* I2C slave address to communicate with */
-
-static uint32_t I2C_FREQ; /* I2C bus frequency in Hz */
+static Psoc6I2CBus mI2C_BUSES[PSOC6_I2C_MAX_BUSES]; /* I2C buses in use */
 
 
 /**
- * \brief Initializes the I2C driver for PSoC™ 6
+ * \brief Gets shared I2C bus on given pins, initializing it on first use
  *
- * \return int CY_RSLT_SUCCESS if successful, any other value
- * in case of error
+ * \param sda Pin used as I2C SDA
+ * \param scl Pin used as I2C SCL
+ * \param frequency Initial I2C clock frequency in [Hz]
+ * \param bus_buffer Buffer to store bus in
+ * \return int   CY_RSLT_SUCCESS if successful, any other value in case of error
  */
-
-uint32_t
-i2c_init ()
+int
+psoc6_i2c_bus_acquire (cyhal_gpio_t sda, cyhal_gpio_t scl, uint32_t frequency,
+		Psoc6I2CBus **bus_buffer)
 {
+	/* Share bus with other secure elements on same pins */
+	Psoc6I2CBus *bus = NULL;
+	for (size_t i = 0; i < PSOC6_I2C_MAX_BUSES; i++)
+	{
+		if ((mI2C_BUSES[i].references > 0) && (mI2C_BUSES[i].sda == sda)
+				&& (mI2C_BUSES[i].scl == scl))
+		{
+			mI2C_BUSES[i].references++;
+			*bus_buffer = &mI2C_BUSES[i];
+			return CY_RSLT_SUCCESS;
+		}
+		if ((bus == NULL) && (mI2C_BUSES[i].references == 0))
+		{
+			bus = &mI2C_BUSES[i];
+		}
+	}
+	if (bus == NULL)
+	{
+		return IFX_ERROR (LIBPSOC6I2C, PROTOCOLLAYER_INITIALIZE, OUT_OF_MEMORY);
+	}
 
-	cyhal_i2c_cfg_t mI2C_cfg; /* I2C configuration object */
+	/* Initialize I2C master */
+	cy_rslt_t result = cyhal_i2c_init (&bus->hal, sda, scl, NULL);
+	if (result != CY_RSLT_SUCCESS)
+	{
+		return result;
+	}
 
-	/* I2C Master configuration settings */
+	/* Configure I2C Master */
+	cyhal_i2c_cfg_t mI2C_cfg; /* I2C configuration object */
 	mI2C_cfg.is_slave = false;
 	mI2C_cfg.address = 0;
-	mI2C_cfg.frequencyhal_hz = I2C_FREQ;
+	mI2C_cfg.frequencyhal_hz = frequency;
+	result = cyhal_i2c_configure (&bus->hal, &mI2C_cfg);
+	if (result != CY_RSLT_SUCCESS)
+	{
+		cyhal_i2c_free (&bus->hal);
+		return result;
+	}
+	bus->sda = sda;
+	bus->scl = scl;
+	bus->clock_frequency = frequency;
+	bus->references = 1;
+	*bus_buffer = bus;
+	return CY_RSLT_SUCCESS;
+}
 
-	/* Initialize I2C master */
-	result = cyhal_i2c_init (&mI2C, mI2C_SDA, mI2C_SCL, NULL);
+/**
+ * \brief Drops reference to shared I2C bus, deinitializing it once unused
+ *
+ * \param bus I2C bus to be released
+ */
+void
+psoc6_i2c_bus_release (Psoc6I2CBus *bus)
+{
+	if ((bus != NULL) && (bus->references > 0))
+	{
+		bus->references--;
+		if (bus->references == 0)
+		{
+			cyhal_i2c_free (&bus->hal);
+		}
+	}
+}
 
-	if (result != CY_RSLT_SUCCESS)
+/**
+ * \brief Switches shared I2C bus to clock frequency of given secure element
+ *
+ * \param protocol_state State of I2C driver layer of secure element
+ * \return int   CY_RSLT_SUCCESS if successful, any other value in case of error
+ */
+int
+psoc6_i2c_bus_configure (ProtocolState *protocol_state)
+{
+	Psoc6I2CBus *bus = protocol_state->bus;
+	if ((bus == NULL) || (bus->clock_frequency == protocol_state->clock_frequency))
 	{
-		CY_ASSERT(0);
+		return CY_RSLT_SUCCESS;
 	}
 
-	/* Configure I2C Master */
-	result = cyhal_i2c_configure (&mI2C, &mI2C_cfg);
+	cyhal_i2c_cfg_t mI2C_cfg;
+	mI2C_cfg.is_slave = false;
+	mI2C_cfg.address = 0;
+	mI2C_cfg.frequencyhal_hz = protocol_state->clock_frequency;
+	cy_rslt_t result = cyhal_i2c_configure (&bus->hal, &mI2C_cfg);
 	if (result != CY_RSLT_SUCCESS)
 	{
-		CY_ASSERT(0);
+		return result;
 	}
-	return result;
+	bus->clock_frequency = protocol_state->clock_frequency;
+	return CY_RSLT_SUCCESS;
 }
+
 /**
  * \brief Returns current protocol state for of PSoC™ 6 I2C driver layer
  *
@@ -120,7 +186,8 @@ i2c_get_protocol_state (Protocol *self, ProtocolState **protocol_state_buffer)
 	if (self->_properties == NULL)
 	{
 		/* Lazy initialize properties */
-		self->_properties = malloc (sizeof (ProtocolState));
+		self->_properties = allocator_malloc (self->_allocator,
+				sizeof (ProtocolState));
 		if (self->_properties == NULL)
 		{
 			return IFX_ERROR (LIBPSOC6I2C, PROTOCOL_GETPROPERTY, OUT_OF_MEMORY);
@@ -128,6 +195,9 @@ i2c_get_protocol_state (Protocol *self, ProtocolState **protocol_state_buffer)
 		ProtocolState *properties = (ProtocolState *)self->_properties;
 		properties->slave_address = (uint16_t)I2C_DEFAULT_SLAVE_ADDRESS;
 		properties->clock_frequency = (uint32_t)I2C_DEFAULT_CLOCK_FREQUENCY;
+		properties->max_clock_frequency = I2C_MAX_CLOCK_FREQUENCY;
+		properties->bus = NULL;
+		properties->allocator = self->_allocator;
 	}
 
 	*protocol_state_buffer = (ProtocolState *)self->_properties;
@@ -144,6 +214,22 @@ i2c_get_protocol_state (Protocol *self, ProtocolState **protocol_state_buffer)
 
 int
 psoc6_i2c_initialize (Protocol *self)
+{
+	return psoc6_i2c_initialize_bus (self, mI2C_SDA, mI2C_SCL);
+}
+
+/**
+ * \brief Initializes \ref Protocol object for PSoC™ 6 driver layer talking to
+ * a secure element on the I2C bus on given pins
+ *
+ * \param self \ref Protocol object to be initialized.
+ * \param sda Pin used as I2C SDA
+ * \param scl Pin used as I2C SCL
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error.
+ */
+int
+psoc6_i2c_initialize_bus (Protocol *self, cyhal_gpio_t sda, cyhal_gpio_t scl)
 {
 	/* Validate parameters */
 	if (self == NULL)
@@ -162,17 +248,26 @@ psoc6_i2c_initialize (Protocol *self)
 	self->_activate = NULL;
 	self->_transmit = psoc6_i2c_transmit;
 	self->_receive = psoc6_i2c_receive;
+	self->_receive_into = psoc6_i2c_receive_into;
 	self->_destructor = psoc6_i2c_destroy;
 
 	/* Set I2C clock frequency in [Hz] */
-	i2c_set_clock_frequency (self, I2C_FREQUENCY);
-
-	/*Initialization of the I2C */
-	result = i2c_init ();
+	ProtocolState *protocol_state;
+	status = i2c_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->clock_frequency = I2C_FREQUENCY;
 
-	if (result!=CY_RSLT_SUCCESS)
+	/* Initialization of the I2C (shared with secure elements on same bus) */
+	status = psoc6_i2c_bus_acquire (sda, scl, protocol_state->clock_frequency,
+			&protocol_state->bus);
+	if (status != CY_RSLT_SUCCESS)
 	{
-		return -1;
+		allocator_free (protocol_state->allocator, self->_properties);
+		self->_properties = NULL;
+		return status;
 	}
 	return PROTOCOLLAYER_INITIALIZE_SUCCESS;
 }
@@ -187,14 +282,14 @@ psoc6_i2c_destroy (Protocol *self)
 {
 	if (self != NULL)
 	{
-		/* Free properties */
+		/* Free properties and release bus (deinitialized once unused) */
 		if (self->_properties != NULL)
 		{
-			free (self->_properties);
+			ProtocolState *protocol_state = (ProtocolState *)self->_properties;
+			psoc6_i2c_bus_release (protocol_state->bus);
+			allocator_free (protocol_state->allocator, self->_properties);
 			self->_properties = NULL;
 		}
-		/* Deinitialize the i2c object */
-		cyhal_i2c_free (&mI2C);
 	}
 }
 
@@ -216,9 +311,26 @@ psoc6_i2c_transmit (Protocol *self, uint8_t *data, size_t data_len)
 		return IFX_ERROR (LIBPSOC6I2C, PROTOCOL_TRANSMIT, ILLEGAL_ARGUMENT);
 	}
 
+	/* Switch shared bus to clock frequency of this secure element */
+	ProtocolState *protocol_state;
+	int status = i2c_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	if (protocol_state->bus == NULL)
+	{
+		return IFX_ERROR (LIBPSOC6I2C, PROTOCOL_TRANSMIT, INVALID_STATE);
+	}
+	cy_rslt_t result = psoc6_i2c_bus_configure (protocol_state);
+	if (result != CY_RSLT_SUCCESS)
+	{
+		return result;
+	}
+
 	/* Send packet with command to the slave */
-	result = cyhal_i2c_master_write (&mI2C, I2C_SLAVE_ADDR, data, data_len, 0,
-			true);
+	result = cyhal_i2c_master_write (&protocol_state->bus->hal,
+			protocol_state->slave_address, data, data_len, 0, true);
 
 	if (result!= CY_RSLT_SUCCESS)
 	{
@@ -239,7 +351,6 @@ psoc6_i2c_receive (Protocol *self, size_t expected_len, uint8_t **response,
 		size_t *response_len)
 {
 
-	/* TODO: Implement */
 	/* Validate parameters */
 	if ((self == NULL) || (expected_len == 0) || (expected_len > 0xffffffff)
 			|| (response == NULL) || (response_len == NULL))
@@ -249,7 +360,8 @@ psoc6_i2c_receive (Protocol *self, size_t expected_len, uint8_t **response,
 	}
 
 	/* Allocate buffer for I2C receive */
-	*response = (uint8_t *)malloc (expected_len);
+	const Allocator *allocator = protocol_get_transaction_allocator (self);
+	*response = (uint8_t *)allocator_malloc (allocator, expected_len);
 	if ((*response) == NULL)
 	{
 
@@ -257,21 +369,60 @@ psoc6_i2c_receive (Protocol *self, size_t expected_len, uint8_t **response,
 	}
 
 	/* Read response packet from the slave */
-	result = cyhal_i2c_master_read (&mI2C, I2C_SLAVE_ADDR, (*response),
-			expected_len, 0, true);
-
-	if (result!=CY_RSLT_SUCCESS)
+	int status = psoc6_i2c_receive_into (self, *response, expected_len,
+			response_len);
+	if (status != PROTOCOL_RECEIVE_SUCCESS)
 	{
-		free (*response);
+		allocator_free (allocator, *response);
 		*response = NULL;
 		*response_len = 0;
-		
+	}
+	return status;
+}
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for PSoC™ 6 driver layer
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int
+psoc6_i2c_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (buffer == NULL) || (buffer_len == 0)
+			|| (buffer_len > 0xffff) || (received_len == NULL))
+	{
+		return IFX_ERROR (LIBPSOC6I2C, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
 
+	/* Switch shared bus to clock frequency of this secure element */
+	ProtocolState *protocol_state;
+	int status = i2c_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	if (protocol_state->bus == NULL)
+	{
+		return IFX_ERROR (LIBPSOC6I2C, PROTOCOL_RECEIVE, INVALID_STATE);
+	}
+	cy_rslt_t result = psoc6_i2c_bus_configure (protocol_state);
+	if (result != CY_RSLT_SUCCESS)
+	{
 		return result;
 	}
 
-	*response_len = expected_len;
+	/* Read response packet from the slave */
+	result = cyhal_i2c_master_read (&protocol_state->bus->hal,
+			protocol_state->slave_address, buffer, buffer_len, 0, true);
+	if (result != CY_RSLT_SUCCESS)
+	{
+		*received_len = 0;
+		return result;
+	}
 
+	*received_len = buffer_len;
 	return PROTOCOL_RECEIVE_SUCCESS;
 }
 
@@ -299,6 +450,10 @@ i2c_get_clock_frequency (Protocol *self, uint32_t *frequency_buffer)
 /**
  * \brief Sets I2C clock frequency in [Hz]
  *
+ * \details Frequencies above \ref ProtocolState.max_clock_frequency are
+ * clamped. Once the I2C master has been initialized the live bus is
+ * reconfigured whenever the frequency actually changes.
+ *
  * \param self Protocol object to set clock frequency for
  * \param frequency Desired clock frequency in [Hz]
  * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
@@ -307,14 +462,32 @@ i2c_get_clock_frequency (Protocol *self, uint32_t *frequency_buffer)
 int
 i2c_set_clock_frequency (Protocol *self, uint32_t frequency)
 {
+	/* Validate parameters */
+	if (frequency == 0)
+	{
+		return IFX_ERROR (LIBPSOC6I2C, PROTOCOL_SETPROPERTY, ILLEGAL_ARGUMENT);
+	}
+
 	ProtocolState *protocol_state;
 	int status = i2c_get_protocol_state (self, &protocol_state);
 	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
 	{
 		return status;
 	}
+	if (frequency > protocol_state->max_clock_frequency)
+	{
+		frequency = protocol_state->max_clock_frequency;
+	}
+
+	/* Reconfigure bus if already running */
+	uint32_t previous = protocol_state->clock_frequency;
 	protocol_state->clock_frequency = frequency;
-	I2C_FREQ = frequency;
+	cy_rslt_t result = psoc6_i2c_bus_configure (protocol_state);
+	if (result != CY_RSLT_SUCCESS)
+	{
+		protocol_state->clock_frequency = previous;
+		return result;
+	}
 
 	return PROTOCOL_SETPROPERTY_SUCCESS;
 }
@@ -366,6 +539,5 @@ i2c_set_slave_address (Protocol *self, uint16_t address)
 		return status;
 	}
 	protocol_state->slave_address = address;
-	I2C_SLAVE_ADDR = address;
 	return PROTOCOL_SETPROPERTY_SUCCESS;
 }
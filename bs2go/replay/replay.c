@@ -0,0 +1,487 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file replay.c
+ * \brief Driver layer answering from a recorded bus trace
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bs2go/i2c/i2c.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/replay/ifx/replay.h"
+#include "bs2go/replay/replay.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/t1prime/t1prime.h"
+#include "bs2go/trace/ifx/trace.h"
+
+void
+replay_get_default_config (ReplayConfig *config)
+{
+	config->time_scale = REPLAY_TIME_SCALE_RECORDED;
+}
+
+/**
+ * \brief Returns current protocol state of replay driver layer
+ *
+ * \param self Protocol stack containing replay driver layer
+ * \param protocol_state_buffer Buffer to store protocol state in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+replay_get_protocol_state (Protocol *self,
+		ReplayProtocolState **protocol_state_buffer)
+{
+	/* Verify that correct protocol layer called this function */
+	if (self->_layer_id != REPLAY_PROTOCOLLAYER_ID)
+	{
+		if (self->_base == NULL)
+		{
+			return IFX_ERROR (LIBREPLAY, PROTOCOL_GETPROPERTY,
+					INVALID_PROTOCOLSTACK);
+		}
+		return replay_get_protocol_state (self->_base, protocol_state_buffer);
+	}
+
+	/* Check if protocol state has been initialized */
+	if (self->_properties == NULL)
+	{
+		/* Lazy initialize properties */
+		self->_properties = allocator_malloc (self->_allocator,
+				sizeof (ReplayProtocolState));
+		if (self->_properties == NULL)
+		{
+			return IFX_ERROR (LIBREPLAY, PROTOCOL_GETPROPERTY, OUT_OF_MEMORY);
+		}
+		ReplayProtocolState *properties
+		= (ReplayProtocolState *)self->_properties;
+		memset (properties, 0, sizeof (ReplayProtocolState));
+		replay_get_default_config (&properties->config);
+		properties->slave_address = (uint16_t)0x50;
+		properties->clock_frequency = T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY;
+		properties->allocator = self->_allocator;
+	}
+
+	*protocol_state_buffer = (ReplayProtocolState *)self->_properties;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+int
+replay_initialize (Protocol *self, const uint8_t *trace, size_t trace_len,
+		const ReplayConfig *config)
+{
+	/* Validate parameters */
+	size_t offset = 0;
+	TraceEvent event;
+	if ((self == NULL) || (trace == NULL))
+	{
+		return IFX_ERROR (LIBREPLAY, PROTOCOLLAYER_INITIALIZE, ILLEGAL_ARGUMENT);
+	}
+	int status = trace_event_decode (trace, trace_len, &offset, &event);
+	if ((status != TRACE_EVENT_DECODE_SUCCESS)
+			&& (status != (int)IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE,
+					TRACE_END_OF_TRACE)))
+	{
+		return status;
+	}
+
+	/* Populate object */
+	status = protocollayer_initialize (self);
+	if (status != PROTOCOLLAYER_INITIALIZE_SUCCESS)
+	{
+		return status;
+	}
+
+	self->_layer_id = REPLAY_PROTOCOLLAYER_ID;
+	self->_transmit = replay_transmit;
+	self->_receive = replay_receive;
+	self->_receive_into = replay_receive_into;
+
+	ReplayProtocolState *protocol_state;
+	status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	if (config != NULL)
+	{
+		protocol_state->config = *config;
+	}
+	protocol_state->trace = trace;
+	protocol_state->trace_len = trace_len;
+	return PROTOCOLLAYER_INITIALIZE_SUCCESS;
+}
+
+int
+replay_get_statistics (Protocol *self, ReplayStatistics *statistics)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (statistics == NULL))
+	{
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_GETPROPERTY, ILLEGAL_ARGUMENT);
+	}
+
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Finished once no further transmission is recorded */
+	size_t offset = protocol_state->offset;
+	TraceEvent event;
+	protocol_state->statistics.finished = true;
+	while (trace_event_decode (protocol_state->trace, protocol_state->trace_len,
+			&offset, &event) == TRACE_EVENT_DECODE_SUCCESS)
+	{
+		if (event.type == TRACE_EVENT_TRANSMIT)
+		{
+			protocol_state->statistics.finished = false;
+			break;
+		}
+	}
+	*statistics = protocol_state->statistics;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Looks up next recorded successful transmission or read
+ *
+ * \details Polls and failed transmissions are skipped.
+ *
+ * \param protocol_state Replay driver layer
+ * \param event Buffer to store event in
+ * \param next Buffer to store offset following   event in
+ * \return bool   true if an event has been found
+ */
+static bool replay_event_peek (ReplayProtocolState *protocol_state,
+		TraceEvent *event, size_t *next)
+{
+	*next = protocol_state->offset;
+	while (trace_event_decode (protocol_state->trace, protocol_state->trace_len,
+			next, event) == TRACE_EVENT_DECODE_SUCCESS)
+	{
+		if ((event->type == TRACE_EVENT_TRANSMIT)
+				|| (event->type == TRACE_EVENT_RECEIVE))
+		{
+			return true;
+		}
+		protocol_state->offset = *next;
+	}
+	return false;
+}
+
+/**
+ * \brief Reassembles recorded answer following current transmission
+ *
+ * \param protocol_state Replay driver layer
+ * \param transmitted_at Recorded time of transmission in [us]
+ * \return uint32_t   Recorded time until answer has been read in [us]
+ */
+static uint32_t replay_answer_load (ReplayProtocolState *protocol_state,
+		uint32_t transmitted_at)
+{
+	uint32_t answered_at = transmitted_at;
+	size_t frame_size = sizeof (protocol_state->frame);
+	TraceEvent event;
+	size_t next;
+	protocol_state->frame_len = 0;
+	protocol_state->frame_read = 0;
+	while ((protocol_state->frame_len < frame_size)
+			&& replay_event_peek (protocol_state, &event, &next)
+			&& (event.type == TRACE_EVENT_RECEIVE))
+	{
+		protocol_state->offset = next;
+
+		/* Reads before secure element was ready do not start answer */
+		if ((protocol_state->frame_len == 0) && ((event.data_len == 0)
+				|| (event.data[0] == 0x00) || (event.data[0] == 0xff)))
+		{
+			continue;
+		}
+		if (protocol_state->frame_len == 0)
+		{
+			answered_at = event.timestamp;
+		}
+
+		/* Append read, dropping anything beyond end of frame */
+		size_t copied = frame_size - protocol_state->frame_len;
+		copied = event.data_len < copied ? event.data_len : copied;
+		memcpy (protocol_state->frame + protocol_state->frame_len, event.data,
+				copied);
+		protocol_state->frame_len += copied;
+		if (protocol_state->frame_len >= BLOCK_PROLOGUE_LENGTH)
+		{
+			size_t information_size = (protocol_state->frame[2] << 8)
+					| protocol_state->frame[3];
+			if (T1PRIME_FRAME_SIZE (information_size) < frame_size)
+			{
+				frame_size = T1PRIME_FRAME_SIZE (information_size);
+			}
+			if (protocol_state->frame_len > frame_size)
+			{
+				protocol_state->frame_len = frame_size;
+			}
+		}
+	}
+	return answered_at - transmitted_at;
+}
+
+/**
+ * \brief \ref protocol_transmitfunction_t for replay driver layer
+ *
+ * \see protocol_transmitfunction_t
+ */
+int
+replay_transmit (Protocol *self, uint8_t *data, size_t data_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (data == NULL) || (data_len == 0))
+	{
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_TRANSMIT, ILLEGAL_ARGUMENT);
+	}
+
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Unread parts of previous answer are dropped */
+	TraceEvent event;
+	size_t next;
+	bool found;
+	while ((found = replay_event_peek (protocol_state, &event, &next))
+			&& (event.type != TRACE_EVENT_TRANSMIT))
+	{
+		protocol_state->offset = next;
+	}
+	if (!found)
+	{
+		protocol_state->statistics.finished = true;
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_TRANSMIT, REPLAY_END_OF_TRACE);
+	}
+
+	/* Host must send exactly what has been recorded */
+	if ((event.data_len != data_len)
+			|| (memcmp (event.data, data, data_len) != 0))
+	{
+		protocol_state->statistics.mismatches++;
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_TRANSMIT, REPLAY_MISMATCH);
+	}
+	protocol_state->offset = next;
+	protocol_state->statistics.transmits++;
+
+	/* Answer is readable after (scaled) recorded processing time */
+	uint64_t now;
+	status = clock_now (protocol_get_clock (self), &now);
+	if (status != CLOCK_NOW_SUCCESS)
+	{
+		return status;
+	}
+	uint64_t processing_time = replay_answer_load (protocol_state,
+			event.timestamp);
+	protocol_state->ready_at = now
+			+ ((processing_time * protocol_state->config.time_scale)
+					/ REPLAY_TIME_SCALE_RECORDED);
+	return PROTOCOL_TRANSMIT_SUCCESS;
+}
+
+/**
+ * \brief \ref protocol_receivefunction_t for replay driver layer
+ *
+ * \see protocol_receivefunction_t
+ */
+int
+replay_receive (Protocol *self, size_t expected_len, uint8_t **response,
+		size_t *response_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (expected_len == 0) || (response == NULL)
+			|| (response_len == NULL))
+	{
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Allocate buffer for I2C receive */
+	const Allocator *allocator = protocol_get_transaction_allocator (self);
+	*response = (uint8_t *)allocator_malloc (allocator, expected_len);
+	if ((*response) == NULL)
+	{
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_RECEIVE, OUT_OF_MEMORY);
+	}
+
+	int status = replay_receive_into (self, *response, expected_len,
+			response_len);
+	if (status != PROTOCOL_RECEIVE_SUCCESS)
+	{
+		allocator_free (allocator, *response);
+		*response = NULL;
+		*response_len = 0;
+	}
+	return status;
+}
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for replay driver layer
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int
+replay_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (buffer == NULL) || (buffer_len == 0)
+			|| (received_len == NULL))
+	{
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Nothing to read until recorded answer is due */
+	uint64_t now;
+	status = clock_now (protocol_get_clock (self), &now);
+	if (status != CLOCK_NOW_SUCCESS)
+	{
+		return status;
+	}
+	if ((protocol_state->frame_read >= protocol_state->frame_len)
+			|| (now < protocol_state->ready_at))
+	{
+		protocol_state->statistics.nacks++;
+		*received_len = 0;
+		return IFX_ERROR (LIBREPLAY, PROTOCOL_RECEIVE, REPLAY_NACK);
+	}
+
+	/* Continue frame where last read stopped, idle bus reads as 0xff */
+	size_t available = protocol_state->frame_len - protocol_state->frame_read;
+	size_t copied = buffer_len < available ? buffer_len : available;
+	memcpy (buffer, protocol_state->frame + protocol_state->frame_read, copied);
+	memset (buffer + copied, 0xff, buffer_len - copied);
+	if (protocol_state->frame_read == 0)
+	{
+		protocol_state->statistics.frames++;
+	}
+	protocol_state->frame_read += copied;
+
+	*received_len = buffer_len;
+	return PROTOCOL_RECEIVE_SUCCESS;
+}
+
+/**
+ * \brief Getter for I2C clock frequency of replay driver layer in [Hz]
+ *
+ * \param self Protocol object to get clock frequency for
+ * \param frequency_buffer Buffer to store clock frequency in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+replay_i2c_get_clock_frequency (Protocol *self, uint32_t *frequency_buffer)
+{
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*frequency_buffer = protocol_state->clock_frequency;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Sets I2C clock frequency of replay driver layer in [Hz]
+ *
+ * \param self Protocol object to set clock frequency for
+ * \param frequency Desired clock frequency in [Hz]
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+replay_i2c_set_clock_frequency (Protocol *self, uint32_t frequency)
+{
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->clock_frequency = frequency;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Getter for I2C slave address of replay driver layer
+ *
+ * \param self Protocol object to get I2C slave address for
+ * \param address_buffer Buffer to store I2C address in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+replay_i2c_get_slave_address (Protocol *self, uint16_t *address_buffer)
+{
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*address_buffer = protocol_state->slave_address;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Sets I2C slave address of replay driver layer
+ *
+ * \param self Protocol object to set I2C slave address for
+ * \param address Desired I2C slave address
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+replay_i2c_set_slave_address (Protocol *self, uint16_t address)
+{
+	ReplayProtocolState *protocol_state;
+	int status = replay_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->slave_address = address;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "cybsp.h"
 #include "se_interface.h"
 #include "bs2go/blocksec2go/blocksec2go.h"
 #include "bs2go/error/error.h"
@@ -45,10 +46,18 @@ static Protocol driver;
 
 uint16_t
 se_interface_init ()
+{
+	return se_interface_open (&protocol, &driver, CYBSP_I2C_SDA, CYBSP_I2C_SCL,
+			I2C_ADDRESS);
+}
+
+int
+se_interface_open (Protocol *protocol, Protocol *driver, cyhal_gpio_t sda,
+		cyhal_gpio_t scl, uint16_t address)
 {
 
 	/* Initialize PSoC™ 6 I2C driver */
-	int status = psoc6_i2c_initialize (&driver);
+	int status = psoc6_i2c_initialize_bus (driver, sda, scl);
 	if (status != PROTOCOLLAYER_INITIALIZE_SUCCESS)
 	{
 		printf ("rpi error: %i\n\r", status);
@@ -56,38 +65,40 @@ se_interface_init ()
 	}
 
 	/* Initialize T=1' protocol */
-	status = t1prime_initialize (&protocol, &driver);
+	status = t1prime_initialize (protocol, driver);
 	if (status != PROTOCOLLAYER_INITIALIZE_SUCCESS)
 	{
 		printf ("t1prime error: %i\n\r", status);
-		protocol_destroy (&driver);
+		protocol_destroy (driver);
 		return status;
 	}
 
 	/* Set slave Address */
-	i2c_set_slave_address (&driver, I2C_ADDRESS);
+	i2c_set_slave_address (driver, address);
 
 	/* Activate secure element */
 	uint8_t *response = NULL;
 	size_t response_len = 0;
 
-	status = protocol_activate (&protocol, &response, &response_len);
+	status = protocol_activate (protocol, &response, &response_len);
 
 	if (status != PROTOCOL_ACTIVATE_SUCCESS)
 	{
 		printf ("activate error: %i\n\r", status);
-		protocol_destroy (&driver);
+		protocol_destroy (driver);
 		return status;
 	}
-	free (response);
+	allocator_free (protocol_get_transaction_allocator (protocol), response);
 
 	return SUCCESS;
 }
 
 int
-wrap_block2go_select (uint8_t id[BLOCK2GO_ID_LEN], char **version)
+wrap_block2go_select (uint8_t id[BLOCK2GO_ID_LEN],
+		char version[BLOCK2GO_VERSION_MAX_LEN])
 {
-	return block2go_select (&protocol, id, version);
+	return block2go_select_into (&protocol, id, version,
+			BLOCK2GO_VERSION_MAX_LEN);
 }
 
 int
@@ -104,7 +115,8 @@ wrap_gen_key (uint8_t *key_index)
 }
 
 int
-wrap_get_pub_key (uint8_t key_index, uint8_t *public_key[65],
+wrap_get_pub_key (uint8_t key_index,
+		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN],
 		uint8_t *public_key_len,block2go_curve curve)
 {
 	curve = BLOCK2GO_CURVE_NIST_P256;
@@ -112,26 +124,25 @@ wrap_get_pub_key (uint8_t key_index, uint8_t *public_key[65],
 	uint32_t counter = 0;
 	*public_key_len = BLOCK2GO_PUBLIC_KEY_LEN;
 
-	int status = block2go_get_key_info_permanent (
+	int status = block2go_get_key_info_permanent_into (
 			&protocol, key_index, &curve, &global_counter, &counter, public_key);
 
 	if (status != BLOCK2GO_GET_KEY_INFO_SUCCESS)
 	{
 		fprintf (stderr, "GET KEY INFO failed (0x%08x)\n", status);
 		protocol_destroy (&driver);
-		free (*public_key);
 	}
 	return status;
 }
 
 int
-wrap_sign (uint8_t key_index, uint8_t data_to_sign[32], uint8_t **signature,
-		size_t *signature_len)
+wrap_sign (uint8_t key_index, uint8_t data_to_sign[32],
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len)
 {
 	uint32_t counter = 0;
 	uint32_t global_counter = 0;
 
-	int status = block2go_generate_signature_permanent (
+	int status = block2go_generate_signature_permanent_into (
 			&protocol, key_index, data_to_sign, &global_counter, &counter, signature,
 			signature_len);
 	if (status != BLOCK2GO_GENERATE_SIGNATURE_SUCCESS)
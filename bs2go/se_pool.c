@@ -0,0 +1,289 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * \file se_pool.c
+ * \brief Pool of Blockchain Security 2Go secure elements sharing signing
+ *        requests
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "se_pool.h"
+#include "bs2go/apdu/apdu.h"
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/t1prime/t1prime.h"
+
+/**
+ * \brief Removes request at head of member's queue and stores its result
+ *
+ * \param member secure element that processed the request
+ * \param status result of GENERATE SIGNATURE
+ */
+static void se_pool_complete (SEPoolMember *member, int status)
+{
+	SEPoolRequest *request = member->head;
+	member->head = request->next;
+	if (member->head == NULL)
+	{
+		member->tail = NULL;
+	}
+	member->outstanding--;
+	request->next = NULL;
+	request->status = status;
+}
+
+/**
+ * \brief Starts exchange for request at head of member's queue
+ *
+ * \details Requests failing to start are completed right away and the next
+ * one is tried.
+ *
+ * \param member secure element to start next request on
+ */
+static void se_pool_start (SEPoolMember *member)
+{
+	while (member->head != NULL)
+	{
+		SEPoolRequest *request = member->head;
+
+		/* Encode command behind room for prologue and send it from there */
+		size_t apdu_len = 0;
+		int status = block2go_generate_signature_encode_into (
+				request->key_index, BLOCK2GO_KEY_TYPE_PERMANENT,
+				request->data_to_sign, request->frame + BLOCK_PROLOGUE_LENGTH,
+				BLOCK2GO_GENERATE_SIGNATURE_APDU_LEN, &apdu_len);
+		if (status == APDU_ENCODE_SUCCESS)
+		{
+			status = t1prime_transceive_begin_inplace (member->protocol,
+					request->frame, apdu_len, NULL, 0);
+			if (status == PROTOCOL_TRANSCEIVE_SUCCESS)
+			{
+				member->wait = 0;
+				return;
+			}
+		}
+		se_pool_complete (member, status);
+	}
+}
+
+void
+se_pool_initialize (SEPool *pool)
+{
+	memset (pool, 0, sizeof (SEPool));
+	memset (pool->affinity, SE_POOL_NO_MEMBER, sizeof (pool->affinity));
+}
+
+int
+se_pool_add (SEPool *pool, Protocol *protocol, size_t *member)
+{
+	/* Validate parameters */
+	if ((pool == NULL) || (protocol == NULL))
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_ADD, ILLEGAL_ARGUMENT);
+	}
+	if (pool->member_count >= SE_POOL_MAX_MEMBERS)
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_ADD, OUT_OF_MEMORY);
+	}
+
+	SEPoolMember *added = &pool->members[pool->member_count];
+	memset (added, 0, sizeof (SEPoolMember));
+	added->protocol = protocol;
+	if (member != NULL)
+	{
+		*member = pool->member_count;
+	}
+	pool->member_count++;
+	return SUCCESS;
+}
+
+int
+se_pool_set_key_affinity (SEPool *pool, uint8_t key_index, uint8_t member)
+{
+	/* Validate parameters */
+	if ((pool == NULL)
+			|| ((member >= pool->member_count) && (member != SE_POOL_ANY_MEMBER)
+					&& (member != SE_POOL_NO_MEMBER)))
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_SET_KEY_AFFINITY, ILLEGAL_ARGUMENT);
+	}
+
+	pool->affinity[key_index] = member;
+	return SUCCESS;
+}
+
+int
+se_pool_sign (SEPool *pool, SEPoolRequest *request, uint8_t key_index,
+		const uint8_t data_to_sign[32])
+{
+	/* Validate parameters */
+	if ((pool == NULL) || (request == NULL) || (data_to_sign == NULL)
+			|| (pool->member_count == 0))
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_SIGN, ILLEGAL_ARGUMENT);
+	}
+
+	/* Route to secure element holding key or to least busy one */
+	size_t target = pool->affinity[key_index];
+	if (target == SE_POOL_NO_MEMBER)
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_SIGN, SE_POOL_KEY_UNASSIGNED);
+	}
+	if (target == SE_POOL_ANY_MEMBER)
+	{
+		target = 0;
+		for (size_t i = 1; i < pool->member_count; i++)
+		{
+			if (pool->members[i].outstanding < pool->members[target].outstanding)
+			{
+				target = i;
+			}
+		}
+	}
+	else if (target >= pool->member_count)
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_SIGN, ILLEGAL_ARGUMENT);
+	}
+
+	/* Queue request */
+	request->key_index = key_index;
+	memcpy (request->data_to_sign, data_to_sign, sizeof (request->data_to_sign));
+	request->status = SE_POOL_PENDING;
+	request->global_counter = 0;
+	request->counter = 0;
+	request->signature_len = 0;
+	request->member = target;
+	request->next = NULL;
+
+	SEPoolMember *member = &pool->members[target];
+	member->outstanding++;
+	if (member->tail != NULL)
+	{
+		member->tail->next = request;
+		member->tail = request;
+		return SUCCESS;
+	}
+	member->head = request;
+	member->tail = request;
+	se_pool_start (member);
+	return SUCCESS;
+}
+
+int
+se_pool_poll (SEPool *pool, uint32_t elapsed_us, uint32_t *wait_us)
+{
+	/* Validate parameters */
+	if ((pool == NULL) || (wait_us == NULL))
+	{
+		return IFX_ERROR (LIBSEPOOL, SE_POOL_POLL, ILLEGAL_ARGUMENT);
+	}
+
+	int status = SUCCESS;
+	uint32_t next = UINT32_MAX;
+	for (size_t i = 0; i < pool->member_count; i++)
+	{
+		SEPoolMember *member = &pool->members[i];
+		if (member->head == NULL)
+		{
+			continue;
+		}
+
+		/* Only advance secure elements that are due */
+		member->wait = member->wait > elapsed_us ? member->wait - elapsed_us : 0;
+		while ((member->head != NULL) && (member->wait == 0))
+		{
+			uint32_t wait;
+			int result = t1prime_transceive_poll (member->protocol, &wait);
+			if (result == T1PRIME_TRANSCEIVE_PENDING)
+			{
+				member->wait = wait;
+				continue;
+			}
+
+			/* Collect signature straight out of the reassembly buffer and */
+			/* move on to next queued request */
+			SEPoolRequest *request = member->head;
+			uint8_t *response = NULL;
+			size_t response_len = 0;
+			result = t1prime_transceive_finish (member->protocol, &response,
+					&response_len);
+			if (result == PROTOCOL_TRANSCEIVE_SUCCESS)
+			{
+				result = block2go_generate_signature_decode_into (response,
+						response_len, &request->global_counter, &request->counter,
+						request->signature, &request->signature_len);
+			}
+			allocator_free (
+					protocol_get_transaction_allocator (member->protocol),
+					response);
+			se_pool_complete (member, result);
+			se_pool_start (member);
+		}
+
+		if (member->head != NULL)
+		{
+			status = SE_POOL_PENDING;
+			next = member->wait < next ? member->wait : next;
+		}
+	}
+
+	*wait_us = (status == SE_POOL_PENDING) ? next : 0;
+	return status;
+}
+
+int
+se_pool_run (SEPool *pool)
+{
+	/* Members are driven from one loop and share the first member's clock */
+	const Clock *clock = (pool->member_count > 0)
+			? protocol_get_clock (pool->members[0].protocol)
+					: NULL;
+	uint64_t last;
+	bool timed = clock_now (clock, &last) == CLOCK_NOW_SUCCESS;
+	uint32_t elapsed = 0;
+	uint32_t wait;
+	int status;
+	while ((status = se_pool_poll (pool, elapsed, &wait)) == SE_POOL_PENDING)
+	{
+		/* Time spent polling counts towards next wait as well */
+		clock_sleep (clock, wait);
+		uint64_t now;
+		if (timed && (clock_now (clock, &now) == CLOCK_NOW_SUCCESS)
+				&& (now > last))
+		{
+			elapsed = (uint32_t)(now - last);
+			last = now;
+		}
+		else
+		{
+			/* Without (advancing) time source only the sleep is known */
+			elapsed = wait;
+			last += wait;
+		}
+	}
+	return status;
+}
@@ -0,0 +1,821 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * \file ecdsa.c
+ * \brief Software ECDSA of the simulated secure element
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bs2go/sim-se/ecdsa.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+
+/**
+ * \brief Number of 32 bit words in 256 bit numbers (least significant first)
+ */
+#define WORDS 8
+
+/**
+ * \brief Modulus with constants for Montgomery multiplication (R = 2^256)
+ */
+typedef struct Modulus
+{
+	uint32_t m[WORDS];   /**< Odd modulus > 2^255 */
+	uint32_t m0inv;      /**< -m^-1 mod 2^32 */
+	uint32_t one[WORDS]; /**< R mod m (1 in Montgomery form) */
+	uint32_t r2[WORDS];  /**< R^2 mod m */
+} Modulus;
+
+/**
+ * \brief Short Weierstrass curve y^2 = x^3 + ax + b with field constants in
+ * Montgomery form
+ */
+typedef struct Curve
+{
+	Modulus p;          /**< Field prime */
+	Modulus n;          /**< Group order */
+	uint32_t a[WORDS];  /**< Coefficient a */
+	uint32_t b[WORDS];  /**< Coefficient b */
+	uint32_t gx[WORDS]; /**< Base point x */
+	uint32_t gy[WORDS]; /**< Base point y */
+} Curve;
+
+/**
+ * \brief Point in Jacobian coordinates (Montgomery form), Z = 0 is infinity
+ */
+typedef struct Point
+{
+	uint32_t x[WORDS];
+	uint32_t y[WORDS];
+	uint32_t z[WORDS];
+} Point;
+
+/**
+ * \brief Big endian p, n, a, b, Gx and Gy of supported curves
+ */
+static const uint8_t mCURVES[2][6][32] = {
+	/* SEC-P256K1 */
+	{ { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfc, 0x2f },
+	  { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+		0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b,
+		0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41 },
+	  { 0x00 },
+	  { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07 },
+	  { 0x79, 0xbe, 0x66, 0x7e, 0xf9, 0xdc, 0xbb, 0xac,
+		0x55, 0xa0, 0x62, 0x95, 0xce, 0x87, 0x0b, 0x07,
+		0x02, 0x9b, 0xfc, 0xdb, 0x2d, 0xce, 0x28, 0xd9,
+		0x59, 0xf2, 0x81, 0x5b, 0x16, 0xf8, 0x17, 0x98 },
+	  { 0x48, 0x3a, 0xda, 0x77, 0x26, 0xa3, 0xc4, 0x65,
+		0x5d, 0xa4, 0xfb, 0xfc, 0x0e, 0x11, 0x08, 0xa8,
+		0xfd, 0x17, 0xb4, 0x48, 0xa6, 0x85, 0x54, 0x19,
+		0x9c, 0x47, 0xd0, 0x8f, 0xfb, 0x10, 0xd4, 0xb8 } },
+	/* NIST-P256 */
+	{ { 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+	  { 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17, 0x9e, 0x84,
+		0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x51 },
+	  { 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfc },
+	  { 0x5a, 0xc6, 0x35, 0xd8, 0xaa, 0x3a, 0x93, 0xe7,
+		0xb3, 0xeb, 0xbd, 0x55, 0x76, 0x98, 0x86, 0xbc,
+		0x65, 0x1d, 0x06, 0xb0, 0xcc, 0x53, 0xb0, 0xf6,
+		0x3b, 0xce, 0x3c, 0x3e, 0x27, 0xd2, 0x60, 0x4b },
+	  { 0x6b, 0x17, 0xd1, 0xf2, 0xe1, 0x2c, 0x42, 0x47,
+		0xf8, 0xbc, 0xe6, 0xe5, 0x63, 0xa4, 0x40, 0xf2,
+		0x77, 0x03, 0x7d, 0x81, 0x2d, 0xeb, 0x33, 0xa0,
+		0xf4, 0xa1, 0x39, 0x45, 0xd8, 0x98, 0xc2, 0x96 },
+	  { 0x4f, 0xe3, 0x42, 0xe2, 0xfe, 0x1a, 0x7f, 0x9b,
+		0x8e, 0xe7, 0xeb, 0x4a, 0x7c, 0x0f, 0x9e, 0x16,
+		0x2b, 0xce, 0x33, 0x57, 0x6b, 0x31, 0x5e, 0xce,
+		0xcb, 0xb6, 0x40, 0x68, 0x37, 0xbf, 0x51, 0xf5 } } };
+
+/**
+ * \brief Reads big endian number
+ *
+ * \param r Buffer to store number in
+ * \param bytes Big endian representation of number
+ * \param len Number of bytes in   bytes (at most 32)
+ */
+static void bn_from_bytes (uint32_t r[WORDS], const uint8_t *bytes, size_t len)
+{
+	memset (r, 0, WORDS * sizeof (uint32_t));
+	for (size_t i = 0; i < len; i++)
+	{
+		size_t bit = (len - 1 - i) * 8;
+		r[bit / 32] |= (uint32_t)bytes[i] << (bit % 32);
+	}
+}
+
+/**
+ * \brief Writes number as 32 big endian bytes
+ *
+ * \param bytes Buffer to store representation in
+ * \param a Number to be written
+ */
+static void bn_to_bytes (uint8_t bytes[32], const uint32_t a[WORDS])
+{
+	for (size_t i = 0; i < 32; i++)
+	{
+		size_t bit = (31 - i) * 8;
+		bytes[i] = (uint8_t)(a[bit / 32] >> (bit % 32));
+	}
+}
+
+/**
+ * \brief Compares two numbers
+ *
+ * \return int   -1, 0 or 1 if   a is less than, equal to or greater than   b
+ */
+static int bn_cmp (const uint32_t a[WORDS], const uint32_t b[WORDS])
+{
+	for (int i = WORDS - 1; i >= 0; i--)
+	{
+		if (a[i] != b[i])
+		{
+			return a[i] < b[i] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * \brief Checks whether number is zero
+ */
+static bool bn_is_zero (const uint32_t a[WORDS])
+{
+	uint32_t bits = 0;
+	for (size_t i = 0; i < WORDS; i++)
+	{
+		bits |= a[i];
+	}
+	return bits == 0;
+}
+
+/**
+ * \brief Computes r = a + b mod 2^256
+ *
+ * \return uint32_t   Carry out of most significant word
+ */
+static uint32_t bn_add (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const uint32_t b[WORDS])
+{
+	uint64_t carry = 0;
+	for (size_t i = 0; i < WORDS; i++)
+	{
+		carry += (uint64_t)a[i] + b[i];
+		r[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+	return (uint32_t)carry;
+}
+
+/**
+ * \brief Computes r = a - b mod 2^256
+ *
+ * \return uint32_t   Borrow out of most significant word
+ */
+static uint32_t bn_sub (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const uint32_t b[WORDS])
+{
+	int64_t borrow = 0;
+	for (size_t i = 0; i < WORDS; i++)
+	{
+		borrow += (int64_t)a[i] - b[i];
+		r[i] = (uint32_t)borrow;
+		borrow = borrow < 0 ? -1 : 0;
+	}
+	return borrow != 0;
+}
+
+/**
+ * \brief Computes r = a + b mod m for a, b < m
+ */
+static void mod_add (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const uint32_t b[WORDS], const Modulus *m)
+{
+	uint32_t carry = bn_add (r, a, b);
+	if ((carry != 0) || (bn_cmp (r, m->m) >= 0))
+	{
+		bn_sub (r, r, m->m);
+	}
+}
+
+/**
+ * \brief Computes r = a - b mod m for a, b < m
+ */
+static void mod_sub (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const uint32_t b[WORDS], const Modulus *m)
+{
+	if (bn_sub (r, a, b) != 0)
+	{
+		bn_add (r, r, m->m);
+	}
+}
+
+/**
+ * \brief Computes r = a * b / R mod m (CIOS Montgomery multiplication)
+ *
+ * \details   r may alias   a or   b.
+ */
+static void mont_mul (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const uint32_t b[WORDS], const Modulus *m)
+{
+	uint32_t t[WORDS + 2] = { 0 };
+	for (size_t i = 0; i < WORDS; i++)
+	{
+		/* t += a * b[i] */
+		uint64_t carry = 0;
+		for (size_t j = 0; j < WORDS; j++)
+		{
+			carry += (uint64_t)t[j] + (uint64_t)a[j] * b[i];
+			t[j] = (uint32_t)carry;
+			carry >>= 32;
+		}
+		carry += t[WORDS];
+		t[WORDS] = (uint32_t)carry;
+		t[WORDS + 1] = (uint32_t)(carry >> 32);
+
+		/* t = (t + u * m) / 2^32 */
+		uint32_t u = t[0] * m->m0inv;
+		carry = ((uint64_t)t[0] + (uint64_t)u * m->m[0]) >> 32;
+		for (size_t j = 1; j < WORDS; j++)
+		{
+			carry += (uint64_t)t[j] + (uint64_t)u * m->m[j];
+			t[j - 1] = (uint32_t)carry;
+			carry >>= 32;
+		}
+		carry += t[WORDS];
+		t[WORDS - 1] = (uint32_t)carry;
+		t[WORDS] = t[WORDS + 1] + (uint32_t)(carry >> 32);
+	}
+
+	/* Result is below 2m */
+	if ((t[WORDS] != 0) || (bn_cmp (t, m->m) >= 0))
+	{
+		bn_sub (t, t, m->m);
+	}
+	memcpy (r, t, WORDS * sizeof (uint32_t));
+}
+
+/**
+ * \brief Prepares Montgomery constants for big endian modulus
+ */
+static void mont_setup (Modulus *m, const uint8_t modulus[32])
+{
+	bn_from_bytes (m->m, modulus, 32);
+
+	/* Newton iteration doubles number of correct low bits each step */
+	uint32_t inv = m->m[0];
+	for (size_t i = 0; i < 4; i++)
+	{
+		inv *= 2 - m->m[0] * inv;
+	}
+	m->m0inv = (uint32_t)0 - inv;
+
+	/* R mod m = 2^256 - m as m > 2^255, R^2 mod m by doubling 256 times */
+	static const uint32_t zero[WORDS] = { 0 };
+	bn_sub (m->one, zero, m->m);
+	memcpy (m->r2, m->one, sizeof (m->r2));
+	for (size_t i = 0; i < 256; i++)
+	{
+		mod_add (m->r2, m->r2, m->r2, m);
+	}
+}
+
+/**
+ * \brief Converts number below m to Montgomery form
+ */
+static void mont_to (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const Modulus *m)
+{
+	mont_mul (r, a, m->r2, m);
+}
+
+/**
+ * \brief Converts number out of Montgomery form
+ */
+static void mont_from (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const Modulus *m)
+{
+	static const uint32_t one[WORDS] = { 1 };
+	mont_mul (r, a, one, m);
+}
+
+/**
+ * \brief Computes r = a^-1 mod m in Montgomery form (Fermat, m prime)
+ */
+static void mont_inv (uint32_t r[WORDS], const uint32_t a[WORDS],
+		const Modulus *m)
+{
+	static const uint32_t two[WORDS] = { 2 };
+	uint32_t exponent[WORDS];
+	uint32_t result[WORDS];
+	bn_sub (exponent, m->m, two);
+	memcpy (result, m->one, sizeof (result));
+	for (int bit = 255; bit >= 0; bit--)
+	{
+		mont_mul (result, result, result, m);
+		if ((exponent[bit / 32] >> (bit % 32)) & 1)
+		{
+			mont_mul (result, result, a, m);
+		}
+	}
+	memcpy (r, result, sizeof (result));
+}
+
+/**
+ * \brief Loads curve constants
+ */
+static void curve_setup (Curve *curve, block2go_curve id)
+{
+	const uint8_t (*constants)[32] = mCURVES[id];
+	mont_setup (&curve->p, constants[0]);
+	mont_setup (&curve->n, constants[1]);
+
+	uint32_t plain[WORDS];
+	bn_from_bytes (plain, constants[2], 32);
+	mont_to (curve->a, plain, &curve->p);
+	bn_from_bytes (plain, constants[3], 32);
+	mont_to (curve->b, plain, &curve->p);
+	bn_from_bytes (plain, constants[4], 32);
+	mont_to (curve->gx, plain, &curve->p);
+	bn_from_bytes (plain, constants[5], 32);
+	mont_to (curve->gy, plain, &curve->p);
+}
+
+/**
+ * \brief Computes r = 2q (dbl-2007-bl), r may alias q
+ */
+static void point_double (Point *r, const Point *q, const Curve *curve)
+{
+	const Modulus *p = &curve->p;
+	if (bn_is_zero (q->z))
+	{
+		*r = *q;
+		return;
+	}
+
+	uint32_t xx[WORDS], yy[WORDS], yyyy[WORDS], zz[WORDS];
+	mont_mul (xx, q->x, q->x, p);
+	mont_mul (yy, q->y, q->y, p);
+	mont_mul (yyyy, yy, yy, p);
+	mont_mul (zz, q->z, q->z, p);
+
+	/* S = 2 * ((X + YY)^2 - XX - YYYY) */
+	uint32_t s[WORDS];
+	mod_add (s, q->x, yy, p);
+	mont_mul (s, s, s, p);
+	mod_sub (s, s, xx, p);
+	mod_sub (s, s, yyyy, p);
+	mod_add (s, s, s, p);
+
+	/* M = 3 * XX + a * ZZ^2 */
+	uint32_t m[WORDS], t[WORDS];
+	mod_add (m, xx, xx, p);
+	mod_add (m, m, xx, p);
+	mont_mul (t, zz, zz, p);
+	mont_mul (t, t, curve->a, p);
+	mod_add (m, m, t, p);
+
+	/* Z3 = (Y + Z)^2 - YY - ZZ */
+	mod_add (r->z, q->y, q->z, p);
+	mont_mul (r->z, r->z, r->z, p);
+	mod_sub (r->z, r->z, yy, p);
+	mod_sub (r->z, r->z, zz, p);
+
+	/* X3 = M^2 - 2 * S */
+	mont_mul (r->x, m, m, p);
+	mod_sub (r->x, r->x, s, p);
+	mod_sub (r->x, r->x, s, p);
+
+	/* Y3 = M * (S - X3) - 8 * YYYY */
+	mod_sub (t, s, r->x, p);
+	mont_mul (t, m, t, p);
+	mod_add (yyyy, yyyy, yyyy, p);
+	mod_add (yyyy, yyyy, yyyy, p);
+	mod_add (yyyy, yyyy, yyyy, p);
+	mod_sub (r->y, t, yyyy, p);
+}
+
+/**
+ * \brief Computes r = q1 + q2 (add-2007-bl), r may alias q1 or q2
+ */
+static void point_add (Point *r, const Point *q1, const Point *q2,
+		const Curve *curve)
+{
+	const Modulus *p = &curve->p;
+	if (bn_is_zero (q1->z))
+	{
+		*r = *q2;
+		return;
+	}
+	if (bn_is_zero (q2->z))
+	{
+		*r = *q1;
+		return;
+	}
+
+	uint32_t z1z1[WORDS], z2z2[WORDS], u1[WORDS], u2[WORDS], s1[WORDS],
+			s2[WORDS];
+	mont_mul (z1z1, q1->z, q1->z, p);
+	mont_mul (z2z2, q2->z, q2->z, p);
+	mont_mul (u1, q1->x, z2z2, p);
+	mont_mul (u2, q2->x, z1z1, p);
+	mont_mul (s1, q1->y, q2->z, p);
+	mont_mul (s1, s1, z2z2, p);
+	mont_mul (s2, q2->y, q1->z, p);
+	mont_mul (s2, s2, z1z1, p);
+
+	/* H = U2 - U1, rr = 2 * (S2 - S1) */
+	uint32_t h[WORDS], rr[WORDS];
+	mod_sub (h, u2, u1, p);
+	mod_sub (rr, s2, s1, p);
+	if (bn_is_zero (h))
+	{
+		if (bn_is_zero (rr))
+		{
+			point_double (r, q1, curve);
+		}
+		else
+		{
+			memset (r, 0, sizeof (Point));
+		}
+		return;
+	}
+	mod_add (rr, rr, rr, p);
+
+	/* I = (2 * H)^2, J = H * I, V = U1 * I */
+	uint32_t i[WORDS], j[WORDS], v[WORDS];
+	mod_add (i, h, h, p);
+	mont_mul (i, i, i, p);
+	mont_mul (j, h, i, p);
+	mont_mul (v, u1, i, p);
+
+	/* Z3 = ((Z1 + Z2)^2 - Z1Z1 - Z2Z2) * H */
+	uint32_t z3[WORDS];
+	mod_add (z3, q1->z, q2->z, p);
+	mont_mul (z3, z3, z3, p);
+	mod_sub (z3, z3, z1z1, p);
+	mod_sub (z3, z3, z2z2, p);
+	mont_mul (r->z, z3, h, p);
+
+	/* X3 = rr^2 - J - 2 * V */
+	mont_mul (r->x, rr, rr, p);
+	mod_sub (r->x, r->x, j, p);
+	mod_sub (r->x, r->x, v, p);
+	mod_sub (r->x, r->x, v, p);
+
+	/* Y3 = rr * (V - X3) - 2 * S1 * J */
+	mod_sub (v, v, r->x, p);
+	mont_mul (v, rr, v, p);
+	mont_mul (s1, s1, j, p);
+	mod_add (s1, s1, s1, p);
+	mod_sub (r->y, v, s1, p);
+}
+
+/**
+ * \brief Computes r = k * q (double and add)
+ */
+static void point_mul (Point *r, const uint32_t k[WORDS], const Point *q,
+		const Curve *curve)
+{
+	Point result;
+	memset (&result, 0, sizeof (result));
+	for (int bit = 255; bit >= 0; bit--)
+	{
+		point_double (&result, &result, curve);
+		if ((k[bit / 32] >> (bit % 32)) & 1)
+		{
+			point_add (&result, &result, q, curve);
+		}
+	}
+	*r = result;
+}
+
+/**
+ * \brief Sets affine point (Montgomery form)
+ */
+static void point_set (Point *r, const uint32_t x[WORDS],
+		const uint32_t y[WORDS], const Curve *curve)
+{
+	memcpy (r->x, x, sizeof (r->x));
+	memcpy (r->y, y, sizeof (r->y));
+	memcpy (r->z, curve->p.one, sizeof (r->z));
+}
+
+/**
+ * \brief Gets plain affine coordinates of finite point
+ */
+static void point_affine (uint32_t x[WORDS], uint32_t y[WORDS],
+		const Point *q, const Curve *curve)
+{
+	const Modulus *p = &curve->p;
+	uint32_t zinv[WORDS], zinv2[WORDS];
+	mont_inv (zinv, q->z, p);
+	mont_mul (zinv2, zinv, zinv, p);
+	mont_mul (x, q->x, zinv2, p);
+	mont_from (x, x, p);
+	if (y != NULL)
+	{
+		mont_mul (zinv2, zinv2, zinv, p);
+		mont_mul (y, q->y, zinv2, p);
+		mont_from (y, y, p);
+	}
+}
+
+/**
+ * \brief Checks that scalar is in [1, n - 1]
+ */
+static bool scalar_valid (const uint32_t k[WORDS], const Curve *curve)
+{
+	return !bn_is_zero (k) && (bn_cmp (k, curve->n.m) < 0);
+}
+
+/**
+ * \brief Encodes positive integer for ASN.1 DER
+ *
+ * \return size_t   Number of bytes written to   buffer
+ */
+static size_t der_encode_integer (uint8_t *buffer, const uint32_t a[WORDS])
+{
+	uint8_t bytes[32];
+	bn_to_bytes (bytes, a);
+	size_t offset = 0;
+	while ((offset < 31) && (bytes[offset] == 0x00))
+	{
+		offset++;
+	}
+	bool pad = (bytes[offset] & 0x80) != 0;
+	size_t len = 32 - offset + (pad ? 1 : 0);
+	buffer[0] = 0x02;
+	buffer[1] = (uint8_t)len;
+	buffer[2] = 0x00;
+	memcpy (buffer + 2 + (pad ? 1 : 0), bytes + offset, 32 - offset);
+	return 2 + len;
+}
+
+/**
+ * \brief Decodes positive ASN.1 DER integer of at most 256 bits
+ *
+ * \return size_t   Number of bytes consumed, 0 if malformed
+ */
+static size_t der_decode_integer (uint32_t a[WORDS], const uint8_t *data,
+		size_t data_len)
+{
+	if ((data_len < 3) || (data[0] != 0x02) || (data[1] == 0)
+			|| (data[1] > (data_len - 2)) || ((data[2] & 0x80) != 0))
+	{
+		return 0;
+	}
+	size_t len = data[1];
+	const uint8_t *value = data + 2;
+	while ((len > 1) && (value[0] == 0x00))
+	{
+		value++;
+		len--;
+	}
+	if (len > 32)
+	{
+		return 0;
+	}
+	bn_from_bytes (a, value, len);
+	return 2 + data[1];
+}
+
+int
+sim_se_ecdsa_public_key (block2go_curve curve_id, const uint8_t private_key[32],
+		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN])
+{
+	if ((curve_id != BLOCK2GO_CURVE_SEC_P256K1)
+			&& (curve_id != BLOCK2GO_CURVE_NIST_P256))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_PUBLIC_KEY, ILLEGAL_ARGUMENT);
+	}
+	Curve curve;
+	curve_setup (&curve, curve_id);
+
+	uint32_t d[WORDS];
+	bn_from_bytes (d, private_key, 32);
+	if (!scalar_valid (d, &curve))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_PUBLIC_KEY, ILLEGAL_ARGUMENT);
+	}
+
+	Point q;
+	point_set (&q, curve.gx, curve.gy, &curve);
+	point_mul (&q, d, &q, &curve);
+
+	uint32_t x[WORDS], y[WORDS];
+	point_affine (x, y, &q, &curve);
+	public_key[0] = 0x04;
+	bn_to_bytes (public_key + 1, x);
+	bn_to_bytes (public_key + 33, y);
+	return SIM_SE_ECDSA_SUCCESS;
+}
+
+int
+sim_se_ecdsa_sign (block2go_curve curve_id, const uint8_t private_key[32],
+		const uint8_t hash[32], const uint8_t nonce[32],
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN], size_t *signature_len)
+{
+	if ((curve_id != BLOCK2GO_CURVE_SEC_P256K1)
+			&& (curve_id != BLOCK2GO_CURVE_NIST_P256))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_SIGN, ILLEGAL_ARGUMENT);
+	}
+	Curve curve;
+	curve_setup (&curve, curve_id);
+	const Modulus *n = &curve.n;
+
+	uint32_t d[WORDS], k[WORDS], e[WORDS];
+	bn_from_bytes (d, private_key, 32);
+	bn_from_bytes (k, nonce, 32);
+	bn_from_bytes (e, hash, 32);
+	if (!scalar_valid (d, &curve) || !scalar_valid (k, &curve))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_SIGN, ILLEGAL_ARGUMENT);
+	}
+
+	/* r = x(kG) mod n */
+	Point kg;
+	point_set (&kg, curve.gx, curve.gy, &curve);
+	point_mul (&kg, k, &kg, &curve);
+	uint32_t r[WORDS];
+	point_affine (r, NULL, &kg, &curve);
+	if (bn_cmp (r, n->m) >= 0)
+	{
+		bn_sub (r, r, n->m);
+	}
+	if (bn_is_zero (r))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_SIGN, ILLEGAL_ARGUMENT);
+	}
+
+	/* s = k^-1 * (e + r * d) mod n */
+	if (bn_cmp (e, n->m) >= 0)
+	{
+		bn_sub (e, e, n->m);
+	}
+	uint32_t s[WORDS], t[WORDS];
+	mont_to (s, r, n);
+	mont_to (t, d, n);
+	mont_mul (t, s, t, n);
+	mont_to (s, e, n);
+	mod_add (t, t, s, n);
+	mont_to (s, k, n);
+	mont_inv (s, s, n);
+	mont_mul (s, s, t, n);
+	mont_from (s, s, n);
+	if (bn_is_zero (s))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_SIGN, ILLEGAL_ARGUMENT);
+	}
+
+	/* SEQUENCE { INTEGER r, INTEGER s } */
+	size_t len = der_encode_integer (signature + 2, r);
+	len += der_encode_integer (signature + 2 + len, s);
+	signature[0] = 0x30;
+	signature[1] = (uint8_t)len;
+	*signature_len = 2 + len;
+	return SIM_SE_ECDSA_SUCCESS;
+}
+
+int
+sim_se_ecdsa_verify (block2go_curve curve_id, const uint8_t *hash,
+		size_t hash_len, const uint8_t *signature, size_t signature_len,
+		const uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN])
+{
+	if ((curve_id != BLOCK2GO_CURVE_SEC_P256K1)
+			&& (curve_id != BLOCK2GO_CURVE_NIST_P256))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, ILLEGAL_ARGUMENT);
+	}
+	Curve curve;
+	curve_setup (&curve, curve_id);
+	const Modulus *p = &curve.p;
+	const Modulus *n = &curve.n;
+
+	/* Parse SEQUENCE { INTEGER r, INTEGER s } */
+	uint32_t r[WORDS], s[WORDS];
+	if ((signature_len < 2) || (signature[0] != 0x30)
+			|| (signature[1] != (signature_len - 2)))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, INVALID_SIGNATURE);
+	}
+	size_t offset = 2;
+	size_t consumed = der_decode_integer (r, signature + offset,
+			signature_len - offset);
+	offset += consumed;
+	if ((consumed == 0) || !scalar_valid (r, &curve))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, INVALID_SIGNATURE);
+	}
+	consumed = der_decode_integer (s, signature + offset,
+			signature_len - offset);
+	offset += consumed;
+	if ((consumed == 0) || (offset != signature_len)
+			|| !scalar_valid (s, &curve))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, INVALID_SIGNATURE);
+	}
+
+	/* Public key must be uncompressed point on curve */
+	uint32_t x[WORDS], y[WORDS];
+	bn_from_bytes (x, public_key + 1, 32);
+	bn_from_bytes (y, public_key + 33, 32);
+	if ((public_key[0] != 0x04) || (bn_cmp (x, p->m) >= 0)
+			|| (bn_cmp (y, p->m) >= 0))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, ILLEGAL_ARGUMENT);
+	}
+	uint32_t lhs[WORDS], rhs[WORDS], t[WORDS];
+	mont_to (x, x, p);
+	mont_to (y, y, p);
+	mont_mul (lhs, y, y, p);
+	mont_mul (rhs, x, x, p);
+	mont_mul (rhs, rhs, x, p);
+	mont_mul (t, curve.a, x, p);
+	mod_add (rhs, rhs, t, p);
+	mod_add (rhs, rhs, curve.b, p);
+	if (bn_cmp (lhs, rhs) != 0)
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, ILLEGAL_ARGUMENT);
+	}
+
+	/* e = leftmost 256 bits of hash mod n */
+	uint32_t e[WORDS];
+	bn_from_bytes (e, hash, hash_len < 32 ? hash_len : 32);
+	if (bn_cmp (e, n->m) >= 0)
+	{
+		bn_sub (e, e, n->m);
+	}
+
+	/* u1 = e / s, u2 = r / s */
+	uint32_t w[WORDS], u1[WORDS], u2[WORDS];
+	mont_to (w, s, n);
+	mont_inv (w, w, n);
+	mont_to (u1, e, n);
+	mont_mul (u1, u1, w, n);
+	mont_from (u1, u1, n);
+	mont_to (u2, r, n);
+	mont_mul (u2, u2, w, n);
+	mont_from (u2, u2, n);
+
+	/* x(u1 * G + u2 * Q) mod n must equal r */
+	Point g, q;
+	point_set (&g, curve.gx, curve.gy, &curve);
+	point_mul (&g, u1, &g, &curve);
+	point_set (&q, x, y, &curve);
+	point_mul (&q, u2, &q, &curve);
+	point_add (&q, &g, &q, &curve);
+	if (bn_is_zero (q.z))
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, INVALID_SIGNATURE);
+	}
+	point_affine (x, NULL, &q, &curve);
+	if (bn_cmp (x, n->m) >= 0)
+	{
+		bn_sub (x, x, n->m);
+	}
+	if (bn_cmp (x, r) != 0)
+	{
+		return IFX_ERROR (LIBSIMSE, SIM_SE_ECDSA_VERIFY, INVALID_SIGNATURE);
+	}
+	return SIM_SE_ECDSA_SUCCESS;
+}
@@ -0,0 +1,1307 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * \file sim-se.c
+ * \brief Simulated Blockchain Security 2Go secure element driver layer
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bs2go/crc/crc.h"
+#include "bs2go/i2c/i2c.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/sim-se/ecdsa.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/sim-se/sim-se.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/t1prime/t1prime.h"
+
+/**
+ * \brief AID of Blocksec2Go application
+ */
+static const uint8_t mBLOCK2GO_AID[13] = { 0xD2, 0x76, 0x00, 0x00, 0x04,
+		0x15, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01 };
+
+/**
+ * \brief Spends time of I2C transfer (address byte and data, 9 clocks each)
+ *
+ * \param clock Clock of protocol stack
+ * \param protocol_state Simulated secure element
+ * \param data_len Number of data bytes transferred
+ */
+static void sim_se_bus_transfer (const Clock *clock,
+		SimSEProtocolState *protocol_state, size_t data_len)
+{
+	if (!protocol_state->config.bus_timing)
+	{
+		return;
+	}
+	uint64_t clocks = (uint64_t)(data_len + 1) * 9u * 1000000u;
+	clock_sleep (clock, (uint32_t)((clocks + protocol_state->clock_frequency - 1)
+			/ protocol_state->clock_frequency));
+}
+
+/**
+ * \brief Draws next number of pseudo random generator (SplitMix64)
+ *
+ * \details Not suitable for cryptography, but reproducible for equal seeds.
+ */
+static uint64_t sim_se_random (SimSEProtocolState *protocol_state)
+{
+	uint64_t z = (protocol_state->random_state += 0x9e3779b97f4a7c15u);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+	return z ^ (z >> 31);
+}
+
+/**
+ * \brief Fills buffer with pseudo random bytes
+ */
+static void sim_se_random_bytes (SimSEProtocolState *protocol_state,
+		uint8_t *buffer, size_t buffer_len)
+{
+	for (size_t i = 0; i < buffer_len; i += 8)
+	{
+		uint64_t random = sim_se_random (protocol_state);
+		for (size_t j = i; (j < (i + 8)) && (j < buffer_len); j++)
+		{
+			buffer[j] = (uint8_t)random;
+			random >>= 8;
+		}
+	}
+}
+
+/**
+ * \brief Resets Blocksec2Go application to factory state
+ */
+static void sim_se_application_reset (SimSEProtocolState *protocol_state)
+{
+	protocol_state->random_state = protocol_state->config.seed;
+	sim_se_random_bytes (protocol_state, protocol_state->id,
+			sizeof (protocol_state->id));
+	protocol_state->protected_mode = false;
+	protocol_state->global_counter = SIM_SE_GLOBAL_COUNTER;
+	memset (&protocol_state->session_key, 0, sizeof (SimSEKey));
+	memset (protocol_state->keys, 0, sizeof (protocol_state->keys));
+	protocol_state->key_count = 0;
+	protocol_state->label_memory = SIM_SE_KEY_LABEL_MEMORY;
+	protocol_state->label_update_len = 0;
+	protocol_state->label_sequence = 0;
+	protocol_state->label_key = 0;
+	protocol_state->label_offset = 0;
+}
+
+/**
+ * \brief Resets T=1' data-link layer state
+ */
+static void sim_se_link_reset (SimSEProtocolState *protocol_state)
+{
+	protocol_state->send_counter = 0;
+	protocol_state->receive_counter = 0;
+	protocol_state->command_len = 0;
+	protocol_state->command_overflow = false;
+	protocol_state->response_len = 0;
+	protocol_state->response_sent = 0;
+	protocol_state->wtx_pending = false;
+}
+
+void
+sim_se_get_default_config (SimSEConfig *config)
+{
+	config->ifsc = SIM_SE_DEFAULT_IFSC;
+	config->max_ifsd = T1PRIME_MAX_IFS;
+	config->bwt = SIM_SE_DEFAULT_BWT;
+	config->mcf = SIM_SE_DEFAULT_MCF;
+	config->mpot = T1PRIME_DEFAULT_I2C_MPOT;
+	config->block_time = 200;
+	config->apdu_time = 2000;
+	config->generate_key_time = 90000;
+	config->generate_signature_time = 60000;
+	config->verify_signature_time = 70000;
+	config->bus_timing = true;
+	config->seed = 0x426c6f636b324730u;
+}
+
+/**
+ * \brief Returns current protocol state of simulated secure element driver
+ * layer
+ *
+ * \param self Protocol stack containing simulated secure element
+ * \param protocol_state_buffer Buffer to store protocol state in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+sim_se_get_protocol_state (Protocol *self,
+		SimSEProtocolState **protocol_state_buffer)
+{
+	/* Verify that correct protocol layer called this function */
+	if (self->_layer_id != SIM_SE_PROTOCOLLAYER_ID)
+	{
+		if (self->_base == NULL)
+		{
+			return IFX_ERROR (LIBSIMSE, PROTOCOL_GETPROPERTY,
+					INVALID_PROTOCOLSTACK);
+		}
+		return sim_se_get_protocol_state (self->_base, protocol_state_buffer);
+	}
+
+	/* Check if protocol state has been initialized */
+	if (self->_properties == NULL)
+	{
+		/* Lazy initialize properties */
+		self->_properties = allocator_malloc (self->_allocator,
+				sizeof (SimSEProtocolState));
+		if (self->_properties == NULL)
+		{
+			return IFX_ERROR (LIBSIMSE, PROTOCOL_GETPROPERTY, OUT_OF_MEMORY);
+		}
+		SimSEProtocolState *properties = (SimSEProtocolState *)self->_properties;
+		memset (properties, 0, sizeof (SimSEProtocolState));
+		sim_se_get_default_config (&properties->config);
+		properties->slave_address = (uint16_t)0x50;
+		properties->clock_frequency = T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY;
+		properties->ifsd = T1PRIME_DEFAULT_IFSD;
+		properties->allocator = self->_allocator;
+		sim_se_link_reset (properties);
+		sim_se_application_reset (properties);
+	}
+
+	*protocol_state_buffer = (SimSEProtocolState *)self->_properties;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+int
+sim_se_initialize (Protocol *self)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	return sim_se_initialize_config (self, &config);
+}
+
+int
+sim_se_initialize_config (Protocol *self, const SimSEConfig *config)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (config == NULL) || (config->ifsc == 0)
+			|| (config->ifsc > T1PRIME_MAX_IFS)
+			|| (config->max_ifsd > T1PRIME_MAX_IFS) || (config->mcf == 0))
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOLLAYER_INITIALIZE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Populate object */
+	int status = protocollayer_initialize (self);
+	if (status != PROTOCOLLAYER_INITIALIZE_SUCCESS)
+	{
+		return status;
+	}
+
+	self->_layer_id = SIM_SE_PROTOCOLLAYER_ID;
+	self->_activate = NULL;
+	self->_transmit = sim_se_transmit;
+	self->_receive = sim_se_receive;
+	self->_receive_into = sim_se_receive_into;
+	self->_destructor = NULL;
+
+	/* Power up secure element with given config */
+	SimSEProtocolState *protocol_state;
+	status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->config = *config;
+	sim_se_application_reset (protocol_state);
+	return PROTOCOLLAYER_INITIALIZE_SUCCESS;
+}
+
+int
+sim_se_get_statistics (Protocol *self, SimSEStatistics *statistics)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (statistics == NULL))
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_GETPROPERTY, ILLEGAL_ARGUMENT);
+	}
+
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*statistics = protocol_state->statistics;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+int
+sim_se_inject_errors (Protocol *self, size_t nacks, size_t crc_errors)
+{
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->inject_nacks = nacks;
+	protocol_state->inject_crc_errors = crc_errors;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief \ref protocol_transmitfunction_t for simulated secure element
+ *
+ * \see protocol_transmitfunction_t
+ */
+int
+sim_se_transmit (Protocol *self, uint8_t *data, size_t data_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (data == NULL) || (data_len == 0))
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_TRANSMIT, ILLEGAL_ARGUMENT);
+	}
+
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Busy secure element does not acknowledge its address */
+	const Clock *clock = protocol_get_clock (self);
+	uint64_t now;
+	sim_se_bus_transfer (clock, protocol_state, 0);
+	status = clock_now (clock, &now);
+	if (status != CLOCK_NOW_SUCCESS)
+	{
+		return status;
+	}
+	if ((now < protocol_state->ready_at) || (protocol_state->inject_nacks > 0))
+	{
+		if (now >= protocol_state->ready_at)
+		{
+			protocol_state->inject_nacks--;
+		}
+		protocol_state->statistics.nacks++;
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_TRANSMIT, SIM_SE_NACK);
+	}
+	sim_se_bus_transfer (clock, protocol_state, data_len - 1);
+
+	status = clock_now (clock, &now);
+	if (status != CLOCK_NOW_SUCCESS)
+	{
+		return status;
+	}
+	sim_se_frame_handle (protocol_state, data, data_len, now);
+	return PROTOCOL_TRANSMIT_SUCCESS;
+}
+
+/**
+ * \brief \ref protocol_receivefunction_t for simulated secure element
+ *
+ * \see protocol_receivefunction_t
+ */
+int
+sim_se_receive (Protocol *self, size_t expected_len, uint8_t **response,
+		size_t *response_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (expected_len == 0) || (response == NULL)
+			|| (response_len == NULL))
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Allocate buffer for I2C receive */
+	const Allocator *allocator = protocol_get_transaction_allocator (self);
+	*response = (uint8_t *)allocator_malloc (allocator, expected_len);
+	if ((*response) == NULL)
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_RECEIVE, OUT_OF_MEMORY);
+	}
+
+	int status = sim_se_receive_into (self, *response, expected_len,
+			response_len);
+	if (status != PROTOCOL_RECEIVE_SUCCESS)
+	{
+		allocator_free (allocator, *response);
+		*response = NULL;
+		*response_len = 0;
+	}
+	return status;
+}
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for simulated secure element
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int
+sim_se_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len)
+{
+	/* Validate parameters */
+	if ((self == NULL) || (buffer == NULL) || (buffer_len == 0)
+			|| (buffer_len > 0xffff) || (received_len == NULL))
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_RECEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Nothing to read until secure element has answered */
+	const Clock *clock = protocol_get_clock (self);
+	uint64_t now;
+	sim_se_bus_transfer (clock, protocol_state, 0);
+	status = clock_now (clock, &now);
+	if (status != CLOCK_NOW_SUCCESS)
+	{
+		return status;
+	}
+	if ((protocol_state->frame_read >= protocol_state->frame_len)
+			|| (now < protocol_state->ready_at))
+	{
+		protocol_state->statistics.nacks++;
+		*received_len = 0;
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_RECEIVE, SIM_SE_NACK);
+	}
+	sim_se_bus_transfer (clock, protocol_state, buffer_len);
+
+	/* Continue frame where last read stopped, idle bus reads as 0xff */
+	size_t available = protocol_state->frame_len - protocol_state->frame_read;
+	size_t copied = buffer_len < available ? buffer_len : available;
+	memcpy (buffer, protocol_state->frame + protocol_state->frame_read, copied);
+	memset (buffer + copied, 0xff, buffer_len - copied);
+	if (protocol_state->frame_read == 0)
+	{
+		protocol_state->statistics.frames_sent++;
+		protocol_state->frame_corrupt = protocol_state->inject_crc_errors > 0;
+		if (protocol_state->frame_corrupt)
+		{
+			protocol_state->inject_crc_errors--;
+		}
+	}
+
+	/* Injected CRC error only affects the bytes on the bus */
+	if (protocol_state->frame_corrupt)
+	{
+		for (size_t i = 0; i < copied; i++)
+		{
+			if ((protocol_state->frame_read + i)
+					>= (protocol_state->frame_len - BLOCK_EPILOGUE_LENGTH))
+			{
+				buffer[i] ^= 0xff;
+			}
+		}
+	}
+	protocol_state->frame_read += copied;
+
+	*received_len = buffer_len;
+	return PROTOCOL_RECEIVE_SUCCESS;
+}
+
+/**
+ * \brief Queues block as next frame to be read by host
+ *
+ * \param protocol_state Simulated secure element
+ * \param pcb Protocol control byte
+ * \param information Information field (may already be in place)
+ * \param information_size Number of bytes in   information
+ * \param ready_at Time frame can be read at in [us]
+ */
+static void sim_se_frame_send (SimSEProtocolState *protocol_state, uint8_t pcb,
+		const uint8_t *information, size_t information_size, uint64_t ready_at)
+{
+	Block block = { .nad = NAD_SE_TO_HD,
+			.pcb = pcb,
+			.information_size = information_size,
+			.information = (uint8_t *)information };
+	t1prime_block_encode_into (&block, protocol_state->frame,
+			sizeof (protocol_state->frame), &protocol_state->frame_len);
+	protocol_state->frame_read = 0;
+	protocol_state->ready_at = ready_at;
+}
+
+/**
+ * \brief Sends last frame again
+ */
+static void sim_se_frame_resend (SimSEProtocolState *protocol_state,
+		uint64_t now)
+{
+	protocol_state->statistics.retransmissions++;
+	protocol_state->frame_read = 0;
+	protocol_state->ready_at = now + protocol_state->config.block_time;
+}
+
+/**
+ * \brief Sends next I block of response APDU
+ */
+static void sim_se_response_send (SimSEProtocolState *protocol_state,
+		uint64_t ready_at)
+{
+	size_t remaining = protocol_state->response_len
+			- protocol_state->response_sent;
+	bool more = remaining > protocol_state->ifsd;
+	size_t chunk = more ? protocol_state->ifsd : remaining;
+	sim_se_frame_send (protocol_state,
+			T1PRIME_PCB_I (protocol_state->send_counter, more),
+			protocol_state->response + protocol_state->response_sent, chunk,
+			ready_at);
+	protocol_state->response_sent += chunk;
+	protocol_state->send_counter ^= 1;
+}
+
+/**
+ * \brief Sends encoded CIP of simulated secure element
+ */
+static void sim_se_cip_send (SimSEProtocolState *protocol_state, uint64_t now)
+{
+	const SimSEConfig *config = &protocol_state->config;
+	uint8_t cip[] = { 0x01,
+			/* IIN */
+			0x04, 0xD2, 0x76, 0x00, 0x04,
+			/* PLID, PLP: configuration, PWT, MCF, PST, MPOT, RWGT */
+			PLID_I2C, 0x08, 0x00, 0x00, (uint8_t)(config->mcf >> 8),
+			(uint8_t)config->mcf, 0x00, config->mpot, 0x00, 0x00,
+			/* DLLP: BWT, IFSC */
+			0x04, (uint8_t)(config->bwt >> 8), (uint8_t)config->bwt,
+			(uint8_t)(config->ifsc >> 8), (uint8_t)config->ifsc,
+			/* Historical bytes */
+			0x00 };
+	sim_se_frame_send (protocol_state, T1PRIME_PCB_S_CIP_RESP, cip, sizeof (cip),
+			now + config->block_time);
+}
+
+/**
+ * \brief Processes completely received command APDU and sends response or
+ * S(WTX request) if processing exceeds BWT
+ */
+static void sim_se_command_complete (SimSEProtocolState *protocol_state,
+		uint64_t now)
+{
+	protocol_state->statistics.apdus++;
+	uint32_t processing_time;
+	if (protocol_state->command_overflow)
+	{
+		/* Wrong length */
+		protocol_state->response[0] = 0x67;
+		protocol_state->response[1] = 0x00;
+		protocol_state->response_len = 2;
+		processing_time = protocol_state->config.apdu_time;
+	}
+	else
+	{
+		processing_time = sim_se_apdu_handle (protocol_state,
+				protocol_state->command, protocol_state->command_len);
+	}
+	protocol_state->command_len = 0;
+	protocol_state->command_overflow = false;
+	protocol_state->response_sent = 0;
+
+	/* Ask for more time before BWT expires */
+	uint32_t bwt = (uint32_t)protocol_state->config.bwt * 1000u;
+	if ((bwt > 0) && (processing_time > bwt))
+	{
+		uint32_t multiplier = (processing_time + bwt - 1) / bwt;
+		uint8_t wtx = multiplier < 0xff ? (uint8_t)multiplier : 0xff;
+		protocol_state->statistics.wtx_requests++;
+		protocol_state->wtx_pending = true;
+		protocol_state->done_at = now + processing_time;
+		sim_se_frame_send (protocol_state, T1PRIME_PCB_S_WTX_REQ, &wtx, 1,
+				now + protocol_state->config.block_time);
+		return;
+	}
+	sim_se_response_send (protocol_state, now + processing_time);
+}
+
+/**
+ * \brief Processes I block written by host
+ */
+static void sim_se_i_block_handle (SimSEProtocolState *protocol_state,
+		uint8_t pcb, const uint8_t *information, size_t information_size,
+		uint64_t now)
+{
+	/* Repeated I block -> host missed answer */
+	if (T1PRIME_PCB_I_GET_NS (pcb) != protocol_state->receive_counter)
+	{
+		sim_se_frame_resend (protocol_state, now);
+		return;
+	}
+	protocol_state->receive_counter ^= 1;
+
+	/* New command aborts response chain still in progress */
+	protocol_state->response_len = 0;
+	protocol_state->response_sent = 0;
+	if ((protocol_state->command_len + information_size)
+			> sizeof (protocol_state->command))
+	{
+		protocol_state->command_overflow = true;
+	}
+	else
+	{
+		memcpy (protocol_state->command + protocol_state->command_len,
+				information, information_size);
+		protocol_state->command_len += information_size;
+	}
+
+	if (T1PRIME_PCB_I_HAS_MORE (pcb))
+	{
+		sim_se_frame_send (protocol_state,
+				T1PRIME_PCB_R_ACK (protocol_state->receive_counter), NULL, 0,
+				now + protocol_state->config.block_time);
+		return;
+	}
+	sim_se_command_complete (protocol_state, now);
+}
+
+/**
+ * \brief Processes R block written by host
+ */
+static void sim_se_r_block_handle (SimSEProtocolState *protocol_state,
+		uint8_t pcb, uint64_t now)
+{
+	/* Acknowledgement of chained response -> next part */
+	if (T1PRIME_PCB_IS_R_ACK (pcb)
+			&& (T1PRIME_PCB_R_GET_NR (pcb) == protocol_state->send_counter)
+			&& (protocol_state->response_sent < protocol_state->response_len))
+	{
+		sim_se_response_send (protocol_state,
+				now + protocol_state->config.block_time);
+		return;
+	}
+
+	/* Anything else asks for last block again */
+	sim_se_frame_resend (protocol_state, now);
+}
+
+/**
+ * \brief Processes S block written by host
+ */
+static void sim_se_s_block_handle (SimSEProtocolState *protocol_state,
+		uint8_t pcb, const uint8_t *information, size_t information_size,
+		uint64_t now)
+{
+	uint64_t ready_at = now + protocol_state->config.block_time;
+	switch (pcb)
+	{
+	case T1PRIME_PCB_S_RESYNCH_REQ:
+		sim_se_link_reset (protocol_state);
+		sim_se_frame_send (protocol_state, T1PRIME_PCB_S_RESYNCH_RESP, NULL, 0,
+				ready_at);
+		return;
+	case T1PRIME_PCB_S_IFS_REQ:
+	{
+		size_t ifsd = 0;
+		if (information_size == 1)
+		{
+			ifsd = information[0];
+		}
+		else if (information_size == 2)
+		{
+			ifsd = (information[0] << 8) | information[1];
+		}
+		if ((ifsd == 0) || (ifsd > T1PRIME_MAX_IFS)
+				|| (protocol_state->config.max_ifsd == 0))
+		{
+			break;
+		}
+
+		/* Acknowledge smaller IFSD if requested one is not supported */
+		uint8_t acknowledged[2];
+		if (ifsd > protocol_state->config.max_ifsd)
+		{
+			ifsd = protocol_state->config.max_ifsd;
+			t1prime_ifs_encode_into (ifsd, acknowledged, &information_size);
+			information = acknowledged;
+		}
+		protocol_state->ifsd = ifsd;
+		sim_se_frame_send (protocol_state, T1PRIME_PCB_S_IFS_RESP, information,
+				information_size, ready_at);
+		return;
+	}
+	case T1PRIME_PCB_S_ABORT_REQ:
+		protocol_state->command_len = 0;
+		protocol_state->command_overflow = false;
+		protocol_state->response_len = 0;
+		protocol_state->response_sent = 0;
+		sim_se_frame_send (protocol_state, T1PRIME_PCB_S_ABORT_RESP, NULL, 0,
+				ready_at);
+		return;
+	case T1PRIME_PCB_S_WTX_RESP:
+		if (!protocol_state->wtx_pending)
+		{
+			break;
+		}
+		protocol_state->wtx_pending = false;
+		sim_se_response_send (protocol_state,
+				protocol_state->done_at > ready_at ? protocol_state->done_at
+						: ready_at);
+		return;
+	case T1PRIME_PCB_S_CIP_REQ:
+		sim_se_cip_send (protocol_state, now);
+		return;
+	case T1PRIME_PCB_S_RELEASE_REQ:
+		sim_se_frame_send (protocol_state, T1PRIME_PCB_S_RELEASE_RESP, NULL, 0,
+				ready_at);
+		return;
+	case T1PRIME_PCB_S_SWR_REQ:
+		sim_se_link_reset (protocol_state);
+		protocol_state->ifsd = T1PRIME_DEFAULT_IFSD;
+		protocol_state->protected_mode = false;
+		memset (&protocol_state->session_key, 0, sizeof (SimSEKey));
+		sim_se_frame_send (protocol_state, T1PRIME_PCB_S_SWR_RESP, NULL, 0,
+				ready_at);
+		return;
+	default:
+		break;
+	}
+
+	/* Unexpected S block */
+	sim_se_frame_send (protocol_state,
+			T1PRIME_PCB_R_ERROR (protocol_state->receive_counter), NULL, 0,
+			ready_at);
+}
+
+void
+sim_se_frame_handle (SimSEProtocolState *protocol_state, const uint8_t *frame,
+		size_t frame_len, uint64_t now)
+{
+	protocol_state->statistics.frames_received++;
+
+	/* Validate frame and ask host to send it again otherwise */
+	size_t information_size = 0;
+	if (frame_len >= T1PRIME_FRAME_SIZE (0))
+	{
+		information_size = (frame[2] << 8) | frame[3];
+	}
+	if ((frame_len < T1PRIME_FRAME_SIZE (0)) || (frame[0] != NAD_HD_TO_SE)
+			|| (T1PRIME_FRAME_SIZE (information_size) != frame_len))
+	{
+		sim_se_frame_send (protocol_state,
+				T1PRIME_PCB_R_ERROR (protocol_state->receive_counter), NULL, 0,
+				now + protocol_state->config.block_time);
+		return;
+	}
+	uint16_t crc = (frame[frame_len - 2] << 8) | frame[frame_len - 1];
+	if (crc16_ccitt_x25 ((uint8_t *)frame, frame_len - BLOCK_EPILOGUE_LENGTH)
+			!= crc)
+	{
+		protocol_state->statistics.crc_errors++;
+		sim_se_frame_send (protocol_state,
+				T1PRIME_PCB_R_CRC (protocol_state->receive_counter), NULL, 0,
+				now + protocol_state->config.block_time);
+		return;
+	}
+
+	uint8_t pcb = frame[1];
+	const uint8_t *information = frame + BLOCK_PROLOGUE_LENGTH;
+	if (T1PRIME_PCB_IS_I (pcb))
+	{
+		sim_se_i_block_handle (protocol_state, pcb, information,
+				information_size, now);
+	}
+	else if (T1PRIME_PCB_IS_R (pcb))
+	{
+		sim_se_r_block_handle (protocol_state, pcb, now);
+	}
+	else
+	{
+		sim_se_s_block_handle (protocol_state, pcb, information,
+				information_size, now);
+	}
+}
+
+/**
+ * \brief Parses command APDU without copying command data
+ *
+ * \param command Parsed command APDU
+ * \param data Encoded command APDU
+ * \param data_len Number of bytes in   data
+ * \return bool   true if APDU is well-formed
+ */
+static bool sim_se_command_parse (SimSECommand *command, const uint8_t *data,
+		size_t data_len)
+{
+	if (data_len < 4)
+	{
+		return false;
+	}
+	command->cla = data[0];
+	command->ins = data[1];
+	command->p1 = data[2];
+	command->p2 = data[3];
+	command->data = NULL;
+	command->lc = 0;
+	data += 4;
+	data_len -= 4;
+
+	/* Case 1, 2S and 2E */
+	if ((data_len == 0) || (data_len == 1)
+			|| ((data_len == 3) && (data[0] == 0x00)))
+	{
+		return true;
+	}
+
+	/* Case 3S / 4S */
+	if (data[0] != 0x00)
+	{
+		command->lc = data[0];
+		data += 1;
+		data_len -= 1;
+		command->data = data;
+		return (data_len == command->lc) || (data_len == (command->lc + 1));
+	}
+
+	/* Case 3E / 4E */
+	if (data_len < 3)
+	{
+		return false;
+	}
+	command->lc = (data[1] << 8) | data[2];
+	data += 3;
+	data_len -= 3;
+	command->data = data;
+	return (command->lc > 0) && ((data_len == command->lc)
+			|| (data_len == (command->lc + 2)));
+}
+
+/**
+ * \brief Looks up key addressed by P1 (index) and P2 (type)
+ *
+ * \return SimSEKey*   Generated key or   NULL
+ */
+static SimSEKey *sim_se_key_get (SimSEProtocolState *protocol_state,
+		uint8_t key_index, uint8_t key_type)
+{
+	SimSEKey *key = NULL;
+	if (key_type == BLOCK2GO_KEY_TYPE_SESSION)
+	{
+		key = &protocol_state->session_key;
+	}
+	else if ((key_type == BLOCK2GO_KEY_TYPE_PERMANENT) && (key_index >= 1)
+			&& (key_index <= protocol_state->key_count))
+	{
+		key = &protocol_state->keys[key_index - 1];
+	}
+	return ((key != NULL) && key->generated) ? key : NULL;
+}
+
+/**
+ * \brief Writes big endian 32 bit number
+ */
+static void sim_se_uint32_write (uint8_t *buffer, uint32_t value)
+{
+	buffer[0] = (uint8_t)(value >> 24);
+	buffer[1] = (uint8_t)(value >> 16);
+	buffer[2] = (uint8_t)(value >> 8);
+	buffer[3] = (uint8_t)value;
+}
+
+/**
+ * \brief GENERATE KEY
+ */
+static uint16_t sim_se_generate_key (SimSEProtocolState *protocol_state,
+		const SimSECommand *command, uint8_t *response, size_t *response_len)
+{
+	if ((command->p1 > BLOCK2GO_CURVE_NIST_P256)
+			|| (command->p2 > BLOCK2GO_KEY_TYPE_SESSION))
+	{
+		return 0x6A86;
+	}
+
+	SimSEKey *key = &protocol_state->session_key;
+	if (command->p2 == BLOCK2GO_KEY_TYPE_PERMANENT)
+	{
+		if (protocol_state->key_count >= SIM_SE_MAX_KEYS)
+		{
+			return 0x6A84;
+		}
+		key = &protocol_state->keys[protocol_state->key_count];
+	}
+
+	/* Draw private keys until one is in [1, n - 1] */
+	memset (key, 0, sizeof (SimSEKey));
+	key->curve = (block2go_curve)command->p1;
+	do
+	{
+		sim_se_random_bytes (protocol_state, key->private_key,
+				sizeof (key->private_key));
+	}
+	while (sim_se_ecdsa_public_key (key->curve, key->private_key,
+			key->public_key) != SIM_SE_ECDSA_SUCCESS);
+	key->counter = SIM_SE_KEY_COUNTER;
+	key->generated = true;
+
+	if (command->p2 == BLOCK2GO_KEY_TYPE_PERMANENT)
+	{
+		protocol_state->key_count++;
+		response[0] = (uint8_t)protocol_state->key_count;
+		*response_len = 1;
+	}
+	return 0x9000;
+}
+
+/**
+ * \brief GET KEY INFO
+ */
+static uint16_t sim_se_get_key_info (SimSEProtocolState *protocol_state,
+		const SimSECommand *command, uint8_t *response, size_t *response_len)
+{
+	SimSEKey *key = sim_se_key_get (protocol_state, command->p1, command->p2);
+	if (key == NULL)
+	{
+		return 0x6A88;
+	}
+	response[0] = (uint8_t)key->curve;
+	sim_se_uint32_write (response + 1, protocol_state->global_counter);
+	sim_se_uint32_write (response + 5, key->counter);
+	memcpy (response + 9, key->public_key, BLOCK2GO_PUBLIC_KEY_LEN);
+	*response_len = 9 + BLOCK2GO_PUBLIC_KEY_LEN;
+	return 0x9000;
+}
+
+/**
+ * \brief GENERATE SIGNATURE
+ */
+static uint16_t sim_se_generate_signature (SimSEProtocolState *protocol_state,
+		const SimSECommand *command, uint8_t *response, size_t *response_len)
+{
+	if (command->lc != 32)
+	{
+		return 0x6700;
+	}
+	SimSEKey *key = sim_se_key_get (protocol_state, command->p1, command->p2);
+	if (key == NULL)
+	{
+		return 0x6A88;
+	}
+	if ((key->counter == 0) || (protocol_state->global_counter == 0))
+	{
+		return 0x6985;
+	}
+
+	/* Draw nonces until one gives a valid signature */
+	uint8_t nonce[32];
+	size_t signature_len = 0;
+	do
+	{
+		sim_se_random_bytes (protocol_state, nonce, sizeof (nonce));
+	}
+	while (sim_se_ecdsa_sign (key->curve, key->private_key, command->data,
+			nonce, response + 8, &signature_len) != SIM_SE_ECDSA_SUCCESS);
+	protocol_state->statistics.signatures++;
+
+	key->counter--;
+	protocol_state->global_counter--;
+	sim_se_uint32_write (response, protocol_state->global_counter);
+	sim_se_uint32_write (response + 4, key->counter);
+	*response_len = 8 + signature_len;
+	return 0x9000;
+}
+
+/**
+ * \brief VERIFY SIGNATURE
+ */
+static uint16_t sim_se_verify_signature (const SimSECommand *command)
+{
+	/* Message length, message, DER signature, public key */
+	if ((command->p1 > BLOCK2GO_CURVE_NIST_P256) || (command->lc < 1))
+	{
+		return command->lc < 1 ? 0x6700 : 0x6A86;
+	}
+	size_t message_len = command->data[0];
+	if (command->lc < (1 + message_len + 2))
+	{
+		return 0x6700;
+	}
+	const uint8_t *signature = command->data + 1 + message_len;
+	size_t signature_len = signature[1] + 2;
+	if (command->lc
+			!= (1 + message_len + signature_len + BLOCK2GO_PUBLIC_KEY_LEN))
+	{
+		return 0x6700;
+	}
+
+	int status = sim_se_ecdsa_verify ((block2go_curve)command->p1,
+			command->data + 1, message_len, signature, signature_len,
+			signature + signature_len);
+	return status == SIM_SE_ECDSA_SUCCESS ? 0x9000 : 0x6A80;
+}
+
+/**
+ * \brief CREATE KEY LABEL
+ */
+static uint16_t sim_se_create_key_label (SimSEProtocolState *protocol_state,
+		const SimSECommand *command, uint8_t *response, size_t *response_len)
+{
+	if (command->lc != 2)
+	{
+		return 0x6700;
+	}
+	SimSEKey *key = sim_se_key_get (protocol_state, command->p1,
+			BLOCK2GO_KEY_TYPE_PERMANENT);
+	if (key == NULL)
+	{
+		return 0x6A88;
+	}
+
+	/* (Re-) reserve memory for label */
+	size_t size = (command->data[0] << 8) | command->data[1];
+	size_t memory = protocol_state->label_memory + key->label_size;
+	if ((size > BLOCK2GO_KEY_LABEL_MAX_LEN) || (size > memory))
+	{
+		return 0x6A84;
+	}
+	protocol_state->label_memory = memory - size;
+	key->label_size = (uint16_t)size;
+	key->label_len = 0;
+
+	sim_se_uint32_write (response, (uint32_t)protocol_state->label_memory);
+	*response_len = 4;
+	return 0x9000;
+}
+
+/**
+ * \brief UPDATE KEY LABEL
+ */
+static uint16_t sim_se_update_key_label (SimSEProtocolState *protocol_state,
+		const SimSECommand *command)
+{
+	/* Assemble DF1F || length || key index || label over sequence */
+	if (command->p2 == 0)
+	{
+		protocol_state->label_update_len = 0;
+		protocol_state->label_sequence = 0;
+	}
+	if (command->p2 != protocol_state->label_sequence)
+	{
+		return 0x6A86;
+	}
+	if ((protocol_state->label_update_len + command->lc)
+			> sizeof (protocol_state->label_update))
+	{
+		return 0x6700;
+	}
+	memcpy (protocol_state->label_update + protocol_state->label_update_len,
+			command->data, command->lc);
+	protocol_state->label_update_len += command->lc;
+	protocol_state->label_sequence++;
+	if (command->p1 != 0x80)
+	{
+		return 0x9000;
+	}
+
+	/* Last block -> parse BER-TLV and store label */
+	const uint8_t *data = protocol_state->label_update;
+	size_t data_len = protocol_state->label_update_len;
+	protocol_state->label_sequence = 0;
+	if ((data_len < 4) || (data[0] != 0xDF) || (data[1] != 0x1F))
+	{
+		return 0x6A80;
+	}
+	size_t offset = 3;
+	size_t length = data[2];
+	if (data[2] == 0x81)
+	{
+		length = data[3];
+		offset = 4;
+	}
+	else if (data[2] == 0x82)
+	{
+		length = (data[3] << 8) | data[4];
+		offset = 5;
+	}
+	if ((length < 1) || ((offset + length) != data_len))
+	{
+		return 0x6A80;
+	}
+	SimSEKey *key = sim_se_key_get (protocol_state, data[offset],
+			BLOCK2GO_KEY_TYPE_PERMANENT);
+	if (key == NULL)
+	{
+		return 0x6A88;
+	}
+	if ((length - 1) > key->label_size)
+	{
+		return 0x6A84;
+	}
+	memcpy (key->label, data + offset + 1, length - 1);
+	key->label_len = (uint16_t)(length - 1);
+	return 0x9000;
+}
+
+/**
+ * \brief GET KEY LABEL
+ */
+static uint16_t sim_se_get_key_label (SimSEProtocolState *protocol_state,
+		const SimSECommand *command, uint8_t *response, size_t *response_len)
+{
+	if (command->p2 == 0x00)
+	{
+		protocol_state->label_key = command->p1;
+		protocol_state->label_offset = 0;
+	}
+	else if ((command->p2 != 0x01) || (command->p1 != protocol_state->label_key))
+	{
+		return 0x6A86;
+	}
+	SimSEKey *key = sim_se_key_get (protocol_state, command->p1,
+			BLOCK2GO_KEY_TYPE_PERMANENT);
+	if ((key == NULL) || (key->label_size == 0))
+	{
+		return 0x6A88;
+	}
+
+	/* DF1F || length || part of label, 6310 while more parts follow */
+	size_t remaining = key->label_len - protocol_state->label_offset;
+	size_t chunk = remaining < SIM_SE_KEY_LABEL_CHUNK_LEN ? remaining
+			: SIM_SE_KEY_LABEL_CHUNK_LEN;
+	size_t offset = 3;
+	response[0] = 0xDF;
+	response[1] = 0x1F;
+	response[2] = (uint8_t)chunk;
+	if (chunk >= 0x80)
+	{
+		response[2] = 0x81;
+		response[3] = (uint8_t)chunk;
+		offset = 4;
+	}
+	memcpy (response + offset, key->label + protocol_state->label_offset, chunk);
+	protocol_state->label_offset += chunk;
+	*response_len = offset + chunk;
+	return protocol_state->label_offset < key->label_len ? 0x6310 : 0x9000;
+}
+
+uint32_t
+sim_se_apdu_handle (SimSEProtocolState *protocol_state, const uint8_t *command,
+		size_t command_len)
+{
+	const SimSEConfig *config = &protocol_state->config;
+	uint8_t *response = protocol_state->response;
+	size_t response_len = 0;
+	uint16_t sw;
+	uint32_t processing_time = config->apdu_time;
+
+	SimSECommand parsed;
+	if (!sim_se_command_parse (&parsed, command, command_len))
+	{
+		sw = 0x6700;
+	}
+	else if (parsed.cla != 0x00)
+	{
+		sw = 0x6E00;
+	}
+	else
+	{
+		switch (parsed.ins)
+		{
+		case 0xA4: /* SELECT */
+			if ((parsed.p1 != 0x04) || (parsed.lc != sizeof (mBLOCK2GO_AID))
+					|| (memcmp (parsed.data, mBLOCK2GO_AID, parsed.lc) != 0))
+			{
+				sw = 0x6A82;
+				break;
+			}
+			memset (&protocol_state->session_key, 0, sizeof (SimSEKey));
+			memcpy (response, protocol_state->id, BLOCK2GO_ID_LEN);
+			memcpy (response + BLOCK2GO_ID_LEN, SIM_SE_VERSION,
+					sizeof (SIM_SE_VERSION) - 1);
+			response_len = BLOCK2GO_ID_LEN + sizeof (SIM_SE_VERSION) - 1;
+			sw = 0x9000;
+			break;
+		case 0x02: /* GENERATE KEY */
+			processing_time = config->generate_key_time;
+			sw = sim_se_generate_key (protocol_state, &parsed, response,
+					&response_len);
+			break;
+		case 0x16: /* GET KEY INFO */
+			sw = sim_se_get_key_info (protocol_state, &parsed, response,
+					&response_len);
+			break;
+		case 0x18: /* GENERATE SIGNATURE */
+			processing_time = config->generate_signature_time;
+			sw = sim_se_generate_signature (protocol_state, &parsed, response,
+					&response_len);
+			break;
+		case 0x1A: /* GET RANDOM */
+			sim_se_random_bytes (protocol_state, response, parsed.p1);
+			response_len = parsed.p1;
+			sw = 0x9000;
+			break;
+		case 0x1B: /* VERIFY SIGNATURE */
+			processing_time = config->verify_signature_time;
+			sw = sim_se_verify_signature (&parsed);
+			break;
+		case 0x1D: /* CREATE KEY LABEL */
+			sw = sim_se_create_key_label (protocol_state, &parsed, response,
+					&response_len);
+			break;
+		case 0x1E: /* UPDATE KEY LABEL */
+			sw = sim_se_update_key_label (protocol_state, &parsed);
+			break;
+		case 0x1F: /* GET KEY LABEL */
+			sw = sim_se_get_key_label (protocol_state, &parsed, response,
+					&response_len);
+			break;
+		case 0xB0: /* GET STATUS */
+			if ((parsed.p1 != 0xDF) || (parsed.p2 != 0x20))
+			{
+				sw = 0x6A86;
+				break;
+			}
+			response[0] = protocol_state->protected_mode
+					? BLOCK2GO_SESSION_TYPE_PROTECTED
+							: BLOCK2GO_SESSION_TYPE_UNPROTECTED;
+			response_len = 1;
+			sw = 0x9000;
+			break;
+		case 0xD0: /* ENABLE PROTECTED MODE */
+			protocol_state->protected_mode = true;
+			sw = 0x9000;
+			break;
+		default:
+			sw = 0x6D00;
+			break;
+		}
+	}
+
+	/* Status words without data on error */
+	if ((sw != 0x9000) && (sw != 0x6310))
+	{
+		response_len = 0;
+	}
+	response[response_len] = (uint8_t)(sw >> 8);
+	response[response_len + 1] = (uint8_t)sw;
+	protocol_state->response_len = response_len + 2;
+	return processing_time;
+}
+
+/**
+ * \brief Getter for I2C clock frequency of simulated secure element in [Hz]
+ *
+ * \param self Protocol object to get clock frequency for
+ * \param frequency_buffer Buffer to store clock frequency in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+sim_se_i2c_get_clock_frequency (Protocol *self, uint32_t *frequency_buffer)
+{
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*frequency_buffer = protocol_state->clock_frequency;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Sets I2C clock frequency of simulated secure element in [Hz]
+ *
+ * \details Frequencies above the MCF announced in CIP are clamped.
+ *
+ * \param self Protocol object to set clock frequency for
+ * \param frequency Desired clock frequency in [Hz]
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+sim_se_i2c_set_clock_frequency (Protocol *self, uint32_t frequency)
+{
+	/* Validate parameters */
+	if (frequency == 0)
+	{
+		return IFX_ERROR (LIBSIMSE, PROTOCOL_SETPROPERTY, ILLEGAL_ARGUMENT);
+	}
+
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	uint32_t max_frequency = (uint32_t)protocol_state->config.mcf * 1000u;
+	protocol_state->clock_frequency = frequency < max_frequency ? frequency
+			: max_frequency;
+	protocol_state->clock_frequency_log[protocol_state->clock_frequency_changes
+			% SIM_SE_CLOCK_FREQUENCY_LOG_LEN] = protocol_state->clock_frequency;
+	protocol_state->clock_frequency_changes++;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Getter for I2C slave address of simulated secure element
+ *
+ * \param self Protocol object to get I2C slave address for
+ * \param address_buffer Buffer to store I2C address in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+sim_se_i2c_get_slave_address (Protocol *self, uint16_t *address_buffer)
+{
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*address_buffer = protocol_state->slave_address;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Sets I2C slave address of simulated secure element
+ *
+ * \details The simulated secure element answers on any address.
+ *
+ * \param self Protocol object to set I2C slave address for
+ * \param address Desired I2C slave address
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+sim_se_i2c_set_slave_address (Protocol *self, uint16_t address)
+{
+	SimSEProtocolState *protocol_state;
+	int status = sim_se_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->slave_address = address;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
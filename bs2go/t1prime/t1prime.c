@@ -66,7 +66,16 @@ t1prime_initialize (Protocol *self, Protocol *driver)
 	self->_base = driver;
 	self->_activate = t1prime_activate;
 	self->_transceive = t1prime_transceive;
+	self->_transceive_iov = t1prime_transceive_iov;
+	self->_transceive_inplace = t1prime_transceive_inplace;
+	self->_headroom = BLOCK_PROLOGUE_LENGTH;
+	self->_tailroom = BLOCK_EPILOGUE_LENGTH;
 	self->_destructor = t1prime_destroy;
+
+	/* Share allocators and clock already installed on driver layer */
+	self->_allocator = driver->_allocator;
+	self->_transaction_allocator = driver->_transaction_allocator;
+	self->_clock = driver->_clock;
 	return PROTOCOLLAYER_INITIALIZE_SUCCESS;
 }
 
@@ -87,7 +96,9 @@ t1prime_activate (Protocol *self, uint8_t **response, size_t *response_len)
 		return status;
 	}
 	protocol_state->ifsc = T1PRIME_DEFAULT_IFSC;
+	protocol_state->ifsd = T1PRIME_DEFAULT_IFSD;
 	protocol_state->bwt = T1PRIME_DEFAULT_BWT;
+	protocol_state->link_errors = 0;
 
 	status = i2c_set_clock_frequency (self, T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY);
 
@@ -96,6 +107,15 @@ t1prime_activate (Protocol *self, uint8_t **response, size_t *response_len)
 		return status;
 	}
 
+	/* Receive buffer must hold default IFSD before the first block arrives */
+	status = t1prime_frame_reserve (&protocol_state->rx_frame,
+			&protocol_state->rx_frame_size, protocol_state->ifsd,
+			protocol_state->allocator);
+	if (status != T1PRIME_FRAME_RESERVE_SUCCESS)
+	{
+		return status;
+	}
+
 	/* Read communication interface parameters to negotiate protocol parameters */
 	CIP cip;
 	status = s_cip (self, &cip);
@@ -117,6 +137,16 @@ t1prime_activate (Protocol *self, uint8_t **response, size_t *response_len)
 	protocol_state->ifsc = dllp.ifsc;
 	t1prime_dllp_destroy (&dllp);
 
+	/* Size transmit buffer for negotiated information field size */
+	status = t1prime_frame_reserve (&protocol_state->tx_frame,
+			&protocol_state->tx_frame_size, protocol_state->ifsc,
+			protocol_state->allocator);
+	if (status != T1PRIME_FRAME_RESERVE_SUCCESS)
+	{
+		t1prime_cip_destroy (&cip);
+		return status;
+	}
+
 	/* Set physical layer parameters depending on interface */
 	if (cip.plid == PLID_I2C)
 	{
@@ -137,398 +167,1210 @@ t1prime_activate (Protocol *self, uint8_t **response, size_t *response_len)
 			return status;
 		}
 
-		/* Set polling time */
-		protocol_state->mpot = plp.mpot;
-		t1prime_i2c_plp_destroy (&plp);
+		/* Set polling time */
+		protocol_state->mpot = plp.mpot;
+		t1prime_i2c_plp_destroy (&plp);
+	}
+
+	else
+	{
+		t1prime_cip_destroy (&cip);
+		return IFX_ERROR (LIBT1PRIME, T1PRIME_CIP_VALIDATE, INVALID_PLID);
+	}
+	t1prime_cip_destroy (&cip);
+
+	/* Resynchronize sequence counters */
+	status = s_resynch (self);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Advertise largest host receive buffer to avoid unnecessary chaining. */
+	/* Optional, so secure elements refusing it keep the default IFSD and */
+	/* any smaller value they acknowledge instead is adopted. */
+	size_t ifsd;
+	if ((protocol_state->max_ifsd > protocol_state->ifsd)
+			&& (t1prime_frame_reserve (&protocol_state->rx_frame,
+						&protocol_state->rx_frame_size, protocol_state->max_ifsd,
+						protocol_state->allocator)
+					== T1PRIME_FRAME_RESERVE_SUCCESS)
+			&& (t1prime_negotiate_ifsd (self, protocol_state->max_ifsd, &ifsd)
+					== PROTOCOL_SETPROPERTY_SUCCESS)
+			&& (ifsd > 0) && (ifsd <= protocol_state->max_ifsd))
+	{
+		protocol_state->ifsd = ifsd;
+	}
+
+	return PROTOCOL_ACTIVATE_SUCCESS;
+}
+
+/**
+ * \brief \ref protocol_transceivefunction_t for Global Platform T=1' protocol
+ *
+ * \details Blocking loop over \ref t1prime_transceive_begin(Protocol*,
+ * uint8_t*, size_t), \ref t1prime_transceive_poll(Protocol*, uint32_t*) and
+ * \ref t1prime_transceive_finish(Protocol*, uint8_t**, size_t*).
+ *
+ * \see protocol_transceivefunction_t
+ */
+int
+t1prime_transceive (Protocol *self, uint8_t *data, size_t data_len,
+		uint8_t **response, size_t *response_len)
+{
+	/* Validate parameters */
+	if ((response == NULL) || (response_len == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	int status = t1prime_transceive_begin (self, data, data_len);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	t1prime_exchange_run (self);
+	return t1prime_transceive_finish (self, response, response_len);
+}
+
+/**
+ * \brief \ref protocol_transceiveiovfunction_t for Global Platform T=1'
+ * protocol
+ *
+ * \details Blocking loop over \ref t1prime_transceive_begin_iov, \ref
+ * t1prime_transceive_poll(Protocol*, uint32_t*) and \ref
+ * t1prime_transceive_finish_iov(Protocol*, size_t*).
+ *
+ * \see protocol_transceiveiovfunction_t
+ */
+int
+t1prime_transceive_iov (Protocol *self, const ProtocolSegment *command,
+		size_t command_count, const ProtocolSegment *response,
+		size_t response_count, size_t *response_len)
+{
+	/* Validate parameters */
+	if ((response == NULL) || (response_len == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	int status = t1prime_transceive_begin_iov (self, command, command_count,
+			response, response_count);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	t1prime_exchange_run (self);
+	return t1prime_transceive_finish_iov (self, response_len);
+}
+
+/**
+ * \brief \ref protocol_transceiveinplacefunction_t for Global Platform T=1'
+ * protocol
+ *
+ * \details Blocking loop over \ref t1prime_transceive_begin_inplace, \ref
+ * t1prime_transceive_poll(Protocol*, uint32_t*) and \ref
+ * t1prime_transceive_finish_iov(Protocol*, size_t*).
+ *
+ * \see protocol_transceiveinplacefunction_t
+ */
+int
+t1prime_transceive_inplace (Protocol *self, uint8_t *buffer, size_t data_len,
+		const ProtocolSegment *response, size_t response_count,
+		size_t *response_len)
+{
+	/* Validate parameters */
+	if ((response == NULL) || (response_len == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	int status = t1prime_transceive_begin_inplace (self, buffer, data_len,
+			response, response_count);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	t1prime_exchange_run (self);
+	return t1prime_transceive_finish_iov (self, response_len);
+}
+
+/**
+ * \brief Blocking exchange of a command precompiled into T=1' frames
+ *
+ * \details Blocking loop over \ref t1prime_transceive_begin_frame, \ref
+ * t1prime_transceive_poll(Protocol*, uint32_t*) and \ref
+ * t1prime_transceive_finish_iov(Protocol*, size_t*).
+ *
+ * \param self T=1' protocol stack to be used
+ * \param frames Encoded I blocks for N(S) = 0 and N(S) = 1
+ * \param frame_len Number of bytes in each frame
+ * \param response Segments to store response data in
+ * \param response_count Number of segments in   response
+ * \param response_len Buffer to store number of bytes scattered into
+ * response in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_transceive_frame_iov (Protocol *self, const uint8_t *const frames[2],
+		size_t frame_len, const ProtocolSegment *response,
+		size_t response_count, size_t *response_len)
+{
+	/* Validate parameters */
+	if ((response == NULL) || (response_len == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	int status = t1prime_transceive_begin_frame (self, frames, frame_len,
+			response, response_count);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	t1prime_exchange_run (self);
+	return t1prime_transceive_finish_iov (self, response_len);
+}
+
+/**
+ * \brief Starts non-blocking exchange of command data with the secure element
+ *
+ * \param self T=1' protocol stack to be used
+ * \param data Command data to be sent
+ * \param data_len Number of bytes in   data
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started, any
+ * other value in case of error
+ */
+int
+t1prime_transceive_begin (Protocol *self, uint8_t *data, size_t data_len)
+{
+	/* Validate parameters */
+	if ((data == NULL) || (data_len == 0))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Get protocol state for communication */
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if (exchange->phase != T1PRIME_EXCHANGE_IDLE)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+
+	/* Contiguous data is a single segment kept in exchange */
+	exchange->command_data.data = data;
+	exchange->command_data.len = data_len;
+	return t1prime_transceive_begin_iov (self, &exchange->command_data, 1,
+			NULL, 0);
+}
+
+/**
+ * \brief Starts non-blocking exchange of command data scattered over several
+ * segments with the secure element
+ *
+ * \param self T=1' protocol stack to be used
+ * \param command Segments of command data to be sent
+ * \param command_count Number of segments in   command
+ * \param response Segments to store response data in (NULL to collect
+ * response in buffer returned by \ref t1prime_transceive_finish(Protocol*,
+ * uint8_t**, size_t*))
+ * \param response_count Number of segments in   response
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started, any
+ * other value in case of error
+ */
+int
+t1prime_transceive_begin_iov (Protocol *self, const ProtocolSegment *command,
+		size_t command_count, const ProtocolSegment *response,
+		size_t response_count)
+{
+	/* Validate parameters */
+	if ((command == NULL) || ((response == NULL) && (response_count > 0)))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+	size_t data_len = protocol_segments_length (command, command_count);
+	if (data_len == 0)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Get protocol state for communication */
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if (exchange->phase != T1PRIME_EXCHANGE_IDLE)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+
+	/* Prepare first block to be send */
+	exchange->block_only = false;
+	exchange->command = command;
+	exchange->command_count = command_count;
+	exchange->frame = NULL;
+	exchange->data_len = data_len;
+	exchange->offset = 0;
+	exchange->chunk_size
+	= data_len < protocol_state->ifsc ? data_len : protocol_state->ifsc;
+	exchange->receiving = false;
+	exchange->aborted = false;
+	exchange->allocator = protocol_get_transaction_allocator (self);
+	exchange->response_data = NULL;
+	exchange->response_len = 0;
+	exchange->response_capacity = 0;
+	exchange->response_segments = response;
+	exchange->response_segment_count = response_count;
+	uint8_t ins = 0x00;
+	protocol_segments_gather (command, command_count, 1, &ins, 1);
+	protocol_state->apdu_ins = ins;
+
+	Block request;
+	status = t1prime_exchange_chunk (protocol_state, &request);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+	t1prime_exchange_send (protocol_state, &request);
+	return PROTOCOL_TRANSCEIVE_SUCCESS;
+}
+
+/**
+ * \brief Starts non-blocking exchange of a command precompiled into T=1'
+ * frames
+ *
+ * \details The frame matching the current N(S) is sent without encoding it or
+ * calculating its CRC. Frames for the other N(S) may be NULL. Falls back to
+ * regular chaining of the information field if no frame matches or the
+ * command does not fit into a single I block.
+ *
+ * \param self T=1' protocol stack to be used
+ * \param frames Encoded I blocks for N(S) = 0 and N(S) = 1
+ * \param frame_len Number of bytes in each frame
+ * \param response Segments to store response data in (NULL to collect
+ * response in buffer returned by \ref t1prime_transceive_finish(Protocol*,
+ * uint8_t**, size_t*) instead)
+ * \param response_count Number of segments in   response
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started, any
+ * other value in case of error
+ */
+int
+t1prime_transceive_begin_frame (Protocol *self,
+		const uint8_t *const frames[2], size_t frame_len,
+		const ProtocolSegment *response, size_t response_count)
+{
+	/* Validate parameters */
+	if ((frames == NULL) || ((frames[0] == NULL) && (frames[1] == NULL))
+			|| (frame_len <= T1PRIME_FRAME_SIZE (0)))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Get protocol state for communication */
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if (exchange->phase != T1PRIME_EXCHANGE_IDLE)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+
+	/* Information field is the same in both frames */
+	const uint8_t *frame = frames[protocol_state->send_counter];
+	const uint8_t *any = (frame != NULL) ? frame : frames[0] ? frames[0] :
+			frames[1];
+	size_t information_size = frame_len - T1PRIME_FRAME_SIZE (0);
+	exchange->command_data.data = (uint8_t *)any + BLOCK_PROLOGUE_LENGTH;
+	exchange->command_data.len = information_size;
+	status = t1prime_transceive_begin_iov (self, &exchange->command_data, 1,
+			response, response_count);
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Only use frame if it matches the I block that is about to be sent */
+	if ((frame != NULL) && (information_size <= protocol_state->ifsc)
+			&& (frame[0] == NAD_HD_TO_SE)
+			&& (frame[1] == T1PRIME_PCB_I (protocol_state->send_counter, false))
+			&& ((size_t)((frame[2] << 8) | frame[3]) == information_size))
+	{
+		exchange->frame = frame;
+	}
+	return PROTOCOL_TRANSCEIVE_SUCCESS;
+}
+
+/**
+ * \brief Starts non-blocking exchange of command data encoded into a frame
+ * buffer with room for the T=1' prologue and CRC
+ *
+ * \details If the command fits into a single I block, prologue and CRC are
+ * written around the data and the frame is sent right from   buffer
+ * (retransmissions included). Otherwise the data is chained as usual.
+ *
+ * \param self T=1' protocol stack to be used
+ * \param buffer Frame buffer holding BLOCK_PROLOGUE_LENGTH reserved bytes,
+ * command data and BLOCK_EPILOGUE_LENGTH reserved bytes
+ * \param data_len Number of command data bytes in   buffer
+ * \param response Segments to store response data in (NULL to collect
+ * response in buffer returned by \ref t1prime_transceive_finish(Protocol*,
+ * uint8_t**, size_t*))
+ * \param response_count Number of segments in   response
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if exchange has been started, any
+ * other value in case of error
+ */
+int
+t1prime_transceive_begin_inplace (Protocol *self, uint8_t *buffer,
+		size_t data_len, const ProtocolSegment *response,
+		size_t response_count)
+{
+	/* Validate parameters */
+	if ((buffer == NULL) || (data_len == 0))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Get protocol state for communication */
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if (exchange->phase != T1PRIME_EXCHANGE_IDLE)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+
+	/* Chain commands exceeding a single I block from within buffer */
+	if (data_len > protocol_state->ifsc)
+	{
+		exchange->command_data.data = buffer + BLOCK_PROLOGUE_LENGTH;
+		exchange->command_data.len = data_len;
+		return t1prime_transceive_begin_iov (self, &exchange->command_data, 1,
+				response, response_count);
+	}
+
+	/* Frame data where it is (information field already in place) */
+	Block block = { .nad = NAD_HD_TO_SE,
+			.pcb = T1PRIME_PCB_I (protocol_state->send_counter, false),
+			.information_size = data_len,
+			.information = buffer + BLOCK_PROLOGUE_LENGTH };
+	size_t frame_len = 0;
+	status = t1prime_block_encode_into (&block, buffer,
+			T1PRIME_FRAME_SIZE (data_len), &frame_len);
+	if (status != T1PRIME_BLOCK_ENCODE_SUCCESS)
+	{
+		return status;
+	}
+
+	const uint8_t *frames[2] = { NULL, NULL };
+	frames[protocol_state->send_counter] = buffer;
+	return t1prime_transceive_begin_frame (self, frames, frame_len, response,
+			response_count);
+}
+
+/**
+ * \brief Advances exchange by at most one bus operation
+ *
+ * \param self T=1' protocol stack to be used
+ * \param wait_us Buffer to store time until next call in [us] in
+ * \return int   T1PRIME_TRANSCEIVE_PENDING if exchange is still in progress,
+ * PROTOCOL_TRANSCEIVE_SUCCESS if response is ready to be collected, any other
+ * value in case of error
+ */
+int
+t1prime_transceive_poll (Protocol *self, uint32_t *wait_us)
+{
+	/* Validate parameters */
+	if (wait_us == NULL)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+	*wait_us = 0;
+
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+
+	switch (exchange->phase)
+	{
+	case T1PRIME_EXCHANGE_TRANSMIT:
+	{
+		/* Answer to last I block is when SE actually processes the APDU */
+		/* (possibly interrupted by S(WTX request)) */
+		if (!exchange->block_only && T1PRIME_PCB_IS_I (exchange->to_send.pcb)
+				&& !T1PRIME_PCB_I_HAS_MORE (exchange->to_send.pcb))
+		{
+			protocol_state->apdu_pending = true;
+			exchange->apdu_elapsed = 0;
+		}
+		else if (exchange->to_send.pcb != T1PRIME_PCB_S_WTX_RESP)
+		{
+			protocol_state->apdu_pending = false;
+		}
+
+		/* Precompiled frame is sent as is (also for retransmissions) */
+		Block *to_send = &exchange->to_send;
+		if ((exchange->frame != NULL) && (to_send->pcb == exchange->frame[1])
+				&& (to_send->information
+						== (exchange->frame + BLOCK_PROLOGUE_LENGTH))
+				&& (to_send->information_size == exchange->data_len))
+		{
+			protocol_state->tx_frame_len = 0;
+			status = t1prime_frame_transmit (self, protocol_state,
+					exchange->frame, T1PRIME_FRAME_SIZE (exchange->data_len));
+		}
+		else
+		{
+			status = exchange->retransmit
+					? t1prime_block_retransmit (self, to_send)
+							: t1prime_block_transmit (self, to_send);
+		}
+		if (status != PROTOCOL_TRANSMIT_SUCCESS)
+		{
+			/* Secure element might not have accepted the write (NACK), */
+			/* send block again after minimum polling time */
+			int link_status = t1prime_link_update (self, protocol_state, status);
+			if ((link_status == PROTOCOL_SETPROPERTY_SUCCESS)
+					&& ((++exchange->tries) <= T1PRIME_BLOCK_TRANSCEIVE_RETRIES))
+			{
+				exchange->retransmit = true;
+				*wait_us = protocol_state->mpot * 100u;
+				return T1PRIME_TRANSCEIVE_PENDING;
+			}
+			t1prime_exchange_complete (protocol_state, status);
+			return status;
+		}
+
+		t1prime_poll_start (protocol_state);
+		exchange->phase = T1PRIME_EXCHANGE_RECEIVE;
+		*wait_us = exchange->wait * 100u;
+		return T1PRIME_TRANSCEIVE_PENDING;
+	}
+	case T1PRIME_EXCHANGE_RECEIVE:
+	{
+		status = t1prime_block_poll (self, protocol_state, &exchange->response);
+		if (status == T1PRIME_TRANSCEIVE_PENDING)
+		{
+			*wait_us = exchange->wait * 100u;
+			return status;
+		}
+		int link_status = t1prime_link_update (self, protocol_state, status);
+		if (link_status != PROTOCOL_SETPROPERTY_SUCCESS)
+		{
+			t1prime_block_destroy (&exchange->response);
+			t1prime_exchange_complete (protocol_state, link_status);
+			return link_status;
+		}
+
+		/* Validate that correct block has been received or retry */
+		status = t1prime_exchange_validate (protocol_state, status);
+		if (status == T1PRIME_TRANSCEIVE_PENDING)
+		{
+			return status;
+		}
+		if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+		{
+			/* Secure element aborted response chain */
+			if (exchange->receiving && exchange->aborted)
+			{
+				status = IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
+						TRANSCEIVE_ABORTED);
+			}
+			t1prime_exchange_complete (protocol_state, status);
+			return status;
+		}
+
+		/* Single block exchanges are done now */
+		if (exchange->block_only)
+		{
+			t1prime_exchange_complete (protocol_state,
+					PROTOCOL_TRANSCEIVE_SUCCESS);
+			return PROTOCOL_TRANSCEIVE_SUCCESS;
+		}
+
+		/* Otherwise let transceive logic decide on next step */
+		status = t1prime_exchange_handle (protocol_state);
+		if (status != T1PRIME_TRANSCEIVE_PENDING)
+		{
+			t1prime_exchange_complete (protocol_state, status);
+		}
+		return status;
+	}
+	case T1PRIME_EXCHANGE_COMPLETE:
+		return exchange->status;
+	default:
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+}
+
+/**
+ * \brief Collects result of exchange and resets exchange state
+ *
+ * \param self T=1' protocol stack to be used
+ * \param response Buffer to store response data in
+ * \param response_len Buffer to store number of bytes in   response in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_transceive_finish (Protocol *self, uint8_t **response,
+		size_t *response_len)
+{
+	/* Validate parameters */
+	if ((response == NULL) || (response_len == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if ((exchange->phase != T1PRIME_EXCHANGE_COMPLETE) || exchange->block_only
+			|| (exchange->response_segments != NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+
+	/* Hand over response */
+	*response = exchange->response_data;
+	*response_len = exchange->response_len;
+	exchange->response_data = NULL;
+	exchange->response_len = 0;
+	exchange->response_capacity = 0;
+	exchange->phase = T1PRIME_EXCHANGE_IDLE;
+	return exchange->status;
+}
+
+/**
+ * \brief Collects result of exchange started by \ref
+ * t1prime_transceive_begin_iov and resets exchange state
+ *
+ * \param self T=1' protocol stack to be used
+ * \param response_len Buffer to store number of bytes scattered into response
+ * segments in
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_transceive_finish_iov (Protocol *self, size_t *response_len)
+{
+	/* Validate parameters */
+	if (response_len == NULL)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+	}
+
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if ((exchange->phase != T1PRIME_EXCHANGE_COMPLETE) || exchange->block_only
+			|| (exchange->response_segments == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+
+	/* Response already is in caller's segments */
+	*response_len = exchange->response_len;
+	exchange->response_len = 0;
+	exchange->response_segments = NULL;
+	exchange->response_segment_count = 0;
+	exchange->phase = T1PRIME_EXCHANGE_IDLE;
+	return exchange->status;
+}
+
+/**
+ * \brief Drives current exchange until it completes by waiting in between
+ * polling attempts
+ *
+ * \param self T=1' protocol stack to be used
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_exchange_run (Protocol *self)
+{
+	uint32_t wait_us;
+	int status;
+	while ((status = t1prime_transceive_poll (self, &wait_us))
+			== T1PRIME_TRANSCEIVE_PENDING)
+	{
+		t1prime_poll_delay (self, wait_us / 100u);
+	}
+	return status;
+}
+
+/**
+ * \brief Schedules new request block for transmission
+ *
+ * \param protocol_state T=1' protocol state holding exchange
+ * \param request Block to be sent (information field is referenced)
+ */
+void
+t1prime_exchange_send (T1PrimeProtocolState *protocol_state, Block *request)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	exchange->request = *request;
+	exchange->to_send = *request;
+	exchange->tries = 0;
+	exchange->retransmit = false;
+	exchange->phase = T1PRIME_EXCHANGE_TRANSMIT;
+}
+
+/**
+ * \brief Prepares I block carrying current chunk of command data
+ *
+ * \details Chunks within a single command segment are referenced directly.
+ * Chunks spanning several segments are gathered right behind the prologue of
+ * the transmit frame buffer, so that encoding the block does not copy them
+ * again.
+ *
+ * \param protocol_state T=1' protocol state holding exchange
+ * \param request Block to be populated
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_exchange_chunk (T1PrimeProtocolState *protocol_state, Block *request)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	request->nad = NAD_HD_TO_SE;
+	request->pcb = T1PRIME_PCB_I (protocol_state->send_counter,
+			(exchange->offset + exchange->chunk_size) < exchange->data_len);
+	request->information_size = exchange->chunk_size;
+	request->borrowed = true;
+
+	/* Reference chunk within single segment */
+	size_t offset = exchange->offset;
+	for (size_t i = 0; i < exchange->command_count; i++)
+	{
+		const ProtocolSegment *segment = &exchange->command[i];
+		if (offset < segment->len)
+		{
+			if (exchange->chunk_size <= (segment->len - offset))
+			{
+				request->information = segment->data + offset;
+				return PROTOCOL_TRANSCEIVE_SUCCESS;
+			}
+			break;
+		}
+		offset -= segment->len;
+	}
+
+	/* Otherwise gather chunk in place (invalidates frame encoded before) */
+	int status = t1prime_frame_reserve (&protocol_state->tx_frame,
+			&protocol_state->tx_frame_size, exchange->chunk_size,
+			protocol_state->allocator);
+	if (status != T1PRIME_FRAME_RESERVE_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->tx_frame_len = 0;
+	request->information = protocol_state->tx_frame + BLOCK_PROLOGUE_LENGTH;
+	protocol_segments_gather (exchange->command, exchange->command_count,
+			exchange->offset, request->information, exchange->chunk_size);
+	return PROTOCOL_TRANSCEIVE_SUCCESS;
+}
+
+/**
+ * \brief Finishes exchange with given status
+ *
+ * \details Partial response data is released in case of error.
+ *
+ * \param protocol_state T=1' protocol state holding exchange
+ * \param status Final status of the exchange
+ */
+void
+t1prime_exchange_complete (T1PrimeProtocolState *protocol_state, int status)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		allocator_free (exchange->allocator, exchange->response_data);
+		exchange->response_data = NULL;
+		exchange->response_len = 0;
+		exchange->response_capacity = 0;
+	}
+	protocol_state->apdu_pending = false;
+	exchange->status = status;
+	exchange->phase = T1PRIME_EXCHANGE_COMPLETE;
+}
+
+/**
+ * \brief Validates received block against current request and schedules
+ * retries
+ *
+ * \details All blocks besides S(? request) trigger retransmissions by sending
+ * R(N(R)), S(? request) blocks are sent again.
+ *
+ * \param protocol_state T=1' protocol state holding exchange
+ * \param status Status of receiving the response block
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if valid response block has been
+ * received, T1PRIME_TRANSCEIVE_PENDING if retry has been scheduled, any other
+ * value in case of error
+ */
+int
+t1prime_exchange_validate (T1PrimeProtocolState *protocol_state, int status)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	Block *request = &exchange->request;
+	Block *response = &exchange->response;
+
+	/* Validate correct block has been received */
+	if (status == PROTOCOL_RECEIVE_SUCCESS)
+	{
+		/* Special case S(? request) */
+		if (T1PRIME_PCB_IS_S (request->pcb)
+				&& T1PRIME_PCB_S_IS_REQUEST (request->pcb))
+		{
+			/* S(? response) must match request type */
+			if (T1PRIME_PCB_IS_S (response->pcb)
+					&& (!T1PRIME_PCB_S_IS_REQUEST (response->pcb)))
+			{
+				if (T1PRIME_PCB_S_GET_TYPE (request->pcb)
+						== T1PRIME_PCB_S_GET_TYPE (response->pcb))
+				{
+					return PROTOCOL_TRANSCEIVE_SUCCESS;
+				}
+			}
+			/* R(N(R)) must have correct sequence counter */
+			else if (T1PRIME_PCB_IS_R (response->pcb))
+			{
+				if (T1PRIME_PCB_R_GET_NR (response->pcb)
+						!= protocol_state->send_counter)
+				{
+					t1prime_block_destroy (response);
+					return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
+							INVALID_BLOCK);
+				}
+			}
+			/* I(N(S), M) invalid */
+			else if (T1PRIME_PCB_IS_I (response->pcb))
+			{
+				t1prime_block_destroy (response);
+				return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+			}
+
+			/* Invalidate read status */
+			status = IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+		}
+		else
+		{
+			return PROTOCOL_TRANSCEIVE_SUCCESS;
+		}
+	}
+
+	/* Give up after configured number of retries */
+	if ((++exchange->tries) > T1PRIME_BLOCK_TRANSCEIVE_RETRIES)
+	{
+		return status;
+	}
+	if (!T1PRIME_PCB_IS_S (request->pcb)
+			|| !T1PRIME_PCB_S_IS_REQUEST (request->pcb))
+	{
+		/* Invalid LEN is reported as other error, anything else as CRC error */
+		exchange->to_send.nad = NAD_HD_TO_SE;
+		exchange->to_send.pcb
+		= T1PRIME_PCB_R_CRC (protocol_state->receive_counter);
+		if (status
+				== (int)IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_DECODE, INVALID_BLOCK))
+		{
+			exchange->to_send.pcb
+			= T1PRIME_PCB_R_ERROR (protocol_state->receive_counter);
+		}
+		exchange->to_send.information = NULL;
+		exchange->to_send.information_size = 0;
+		exchange->to_send.borrowed = false;
+		exchange->retransmit = false;
+	}
+	else
+	{
+		exchange->retransmit = true;
+	}
+	exchange->phase = T1PRIME_EXCHANGE_TRANSMIT;
+	return T1PRIME_TRANSCEIVE_PENDING;
+}
+
+/**
+ * \brief Decides on next step of T=1' transceive logic based on received
+ * block
+ *
+ * \details Handles chaining in both directions, retransmission requests,
+ * S(WTX request), S(IFS request) and S(ABORT request).
+ *
+ * \param protocol_state T=1' protocol state holding exchange
+ * \return int   T1PRIME_TRANSCEIVE_PENDING if next block has been scheduled,
+ * PROTOCOL_TRANSCEIVE_SUCCESS if complete response has been received, any
+ * other value in case of error
+ */
+int
+t1prime_exchange_handle (T1PrimeProtocolState *protocol_state)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	Block *response = &exchange->response;
+	Block request = { .nad = NAD_HD_TO_SE,
+			.pcb = 0x00,
+			.information_size = 0,
+			.information = NULL,
+			.borrowed = false };
+	bool last_chunk
+	= (exchange->offset + exchange->chunk_size) >= exchange->data_len;
+
+	/* Handle blocks while sending command */
+	if (!exchange->receiving)
+	{
+		/* I(N(S), M) -> SE starts sending response */
+		if (T1PRIME_PCB_IS_I (response->pcb))
+		{
+			/* Cannot receive I block response while not all data has been sent */
+			if (!last_chunk)
+			{
+				return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+			}
+			protocol_state->send_counter ^= 0x01;
+			exchange->receiving = true;
+			exchange->aborted = false;
+		}
+		/* R(N(R)) -> SE wants (another) block */
+		else if (T1PRIME_PCB_IS_R (response->pcb))
+		{
+			/* SE expects next block */
+			bool next = (protocol_state->send_counter ^ 0x01)
+					== T1PRIME_PCB_R_GET_NR (response->pcb);
+			if (next)
+			{
+				/* Check if chain was aborted */
+				if (exchange->aborted)
+				{
+					return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
+							TRANSCEIVE_ABORTED);
+				}
+
+				/* SE has last block */
+				if (last_chunk)
+				{
+					request.pcb = T1PRIME_PCB_R_CRC (protocol_state->receive_counter);
+					t1prime_exchange_send (protocol_state, &request);
+					return T1PRIME_TRANSCEIVE_PENDING;
+				}
+
+				/* Update state to move to next part of data */
+				exchange->offset += exchange->chunk_size;
+				protocol_state->send_counter ^= 0x01;
+				size_t remaining = exchange->data_len - exchange->offset;
+				exchange->chunk_size = remaining < protocol_state->ifsc
+						? remaining
+								: protocol_state->ifsc;
+			}
+
+			/* Send next I block or retransmit last one */
+			int status = t1prime_exchange_chunk (protocol_state, &request);
+			if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+			{
+				return status;
+			}
+			t1prime_exchange_send (protocol_state, &request);
+			exchange->retransmit = !next;
+			return T1PRIME_TRANSCEIVE_PENDING;
+		}
+		/* S(WTX REQ) -> SE needs more time */
+		else if (response->pcb == T1PRIME_PCB_S_WTX_REQ)
+		{
+			/* Verify information field */
+			if ((response->information == NULL)
+					|| (response->information_size != 1))
+			{
+				return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+			}
+			protocol_state->wtx_delay
+			= response->information[0] * protocol_state->bwt;
+			protocol_state->statistics.wtx_requests++;
+			protocol_state->statistics.wtx_extension += protocol_state->wtx_delay;
+
+			/* Send S(WTX RESP) */
+			request.pcb = T1PRIME_PCB_S_WTX_RESP;
+			request.information = response->information;
+			request.information_size = response->information_size;
+			request.borrowed = true;
+			t1prime_exchange_send (protocol_state, &request);
+			return T1PRIME_TRANSCEIVE_PENDING;
+		}
+		/* S(IFS REQ) -> SE wants to indicate that it can send more or less data */
+		else if (response->pcb == T1PRIME_PCB_S_IFS_REQ)
+		{
+			/* Verify IFS value */
+			size_t ifs;
+			int status = t1prime_ifs_decode (&ifs, response->information,
+					response->information_size);
+			if (status != T1PRIME_IFS_DECODE_SUCCESS)
+			{
+				return status;
+			}
+
+			/* Update state in case new IFSC is smaller and SE wants a */
+			/* retransmission, following blocks use new IFSC */
+			exchange->chunk_size
+			= ifs < exchange->chunk_size ? ifs : exchange->chunk_size;
+			protocol_state->ifsc = ifs;
+
+			/* Send S(IFS RESP) */
+			request.pcb = T1PRIME_PCB_S_IFS_RESP;
+			request.information = response->information;
+			request.information_size = response->information_size;
+			request.borrowed = true;
+			t1prime_exchange_send (protocol_state, &request);
+			return T1PRIME_TRANSCEIVE_PENDING;
+		}
+		/* S(ABORT REQ) -> SE wants to stop chain request */
+		else if (response->pcb == T1PRIME_PCB_S_ABORT_REQ)
+		{
+			/* Send S(ABORT RESP) */
+			request.pcb = T1PRIME_PCB_S_ABORT_RESP;
+			exchange->aborted = true;
+			t1prime_exchange_send (protocol_state, &request);
+			return T1PRIME_TRANSCEIVE_PENDING;
+		}
+		else
+		{
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+		}
+	}
+
+	/* Response chain has been aborted and S(ABORT response) sent */
+	if (exchange->aborted)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, TRANSCEIVE_ABORTED);
+	}
+
+	/* I(N(S), M) -> SE sent response */
+	if (T1PRIME_PCB_IS_I (response->pcb))
+	{
+		/* Validate sequence counter */
+		if (T1PRIME_PCB_I_GET_NS (response->pcb)
+				!= protocol_state->receive_counter)
+		{
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+		}
+
+		/* First response I block must contain data */
+		if ((exchange->response_len == 0) && (response->information_size == 0))
+		{
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+		}
+
+		/* Append to response buffer (special case of forced acknowledgement */
+		/* without data) */
+		int status = t1prime_exchange_append (protocol_state,
+				response->information, response->information_size,
+				T1PRIME_PCB_I_HAS_MORE (response->pcb));
+		if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+		{
+			return status;
+		}
+		protocol_state->receive_counter ^= 0x01;
+
+		/* All data received */
+		if (!T1PRIME_PCB_I_HAS_MORE (response->pcb))
+		{
+			protocol_state->statistics.apdus++;
+			return PROTOCOL_TRANSCEIVE_SUCCESS;
+		}
+
+		/* Acknowledge and request next block */
+		request.pcb = T1PRIME_PCB_R_ACK (protocol_state->receive_counter);
+		t1prime_exchange_send (protocol_state, &request);
+		return T1PRIME_TRANSCEIVE_PENDING;
 	}
-
-	else
+	/* R(N(R)) -> SE needs a retransmission */
+	else if (T1PRIME_PCB_IS_R (response->pcb))
 	{
-		t1prime_cip_destroy (&cip);
-		return IFX_ERROR (LIBT1PRIME, T1PRIME_CIP_VALIDATE, INVALID_PLID);
-	}
-	t1prime_cip_destroy (&cip);
+		/* Validate that card sent correct R(N(R)) */
+		if (T1PRIME_PCB_R_GET_NR (response->pcb)
+				!= protocol_state->send_counter)
+		{
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+		}
 
-	/* Resynchronize sequence counters */
-	status = s_resynch (self);
-	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+		/* Send retransmission request */
+		request.pcb = T1PRIME_PCB_R_ACK (protocol_state->receive_counter);
+		t1prime_exchange_send (protocol_state, &request);
+		return T1PRIME_TRANSCEIVE_PENDING;
+	}
+	/* S(ABORT request) -> end chain */
+	else if (response->pcb == T1PRIME_PCB_S_ABORT_REQ)
 	{
-		return status;
+		/* Delete response cache (segments are simply overwritten) */
+		allocator_free (exchange->allocator, exchange->response_data);
+		exchange->response_data = NULL;
+		exchange->response_len = 0;
+		exchange->response_capacity = 0;
+
+		/* Answer with S(ABORT response) */
+		request.pcb = T1PRIME_PCB_S_ABORT_RESP;
+		exchange->aborted = true;
+		t1prime_exchange_send (protocol_state, &request);
+		return T1PRIME_TRANSCEIVE_PENDING;
 	}
 
-	return PROTOCOL_ACTIVATE_SUCCESS;
+	/* TODO: Handle other blocks */
+	return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
 }
 
 /**
- * \brief \ref protocol_transceivefunction_t for Global Platform T=1' protocol
+ * \brief Keeps track of link errors and steps down the I2C clock frequency
+ * once they pile up
  *
- * \see protocol_transceivefunction_t
+ * \details NACKed writes, frames cut short and CRC errors count as link
+ * errors, a valid block resets the counter. After \ref
+ * T1PRIME_LINK_ERRORS_STEP_DOWN consecutive errors the clock falls back from
+ * Fast-mode Plus to Fast-mode and from there to Standard-mode. A secure
+ * element not answering in time is no link error.
+ *
+ * \param self Protocol stack for performing necessary operations
+ * \param protocol_state T=1' protocol state
+ * \param status Status of last bus operation or received block
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value in
+ * case of error
  */
 int
-t1prime_transceive (Protocol *self, uint8_t *data, size_t data_len,
-		uint8_t **response, size_t *response_len)
+t1prime_link_update (Protocol *self, T1PrimeProtocolState *protocol_state,
+		int status)
 {
-	/* Validate parameters */
-	if ((data == NULL) || (data_len == 0) || (response == NULL)
-			|| (response_len == NULL))
+	if (status == PROTOCOL_RECEIVE_SUCCESS)
 	{
-		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, ILLEGAL_ARGUMENT);
+		protocol_state->link_errors = 0;
+		return PROTOCOL_SETPROPERTY_SUCCESS;
 	}
+	if ((status
+				== (int)IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, RECEIVE_TIMEOUT))
+			|| ((++protocol_state->link_errors) < T1PRIME_LINK_ERRORS_STEP_DOWN))
+	{
+		return PROTOCOL_SETPROPERTY_SUCCESS;
+	}
+	protocol_state->link_errors = 0;
 
-	/* Get protocol state for communication */
-	T1PrimeProtocolState *protocol_state;
-	int status = t1prime_get_protocol_state (self, &protocol_state);
-
+	/* Step down to next slower I2C mode */
+	uint32_t frequency;
+	status = i2c_get_clock_frequency (self, &frequency);
 	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
 	{
 		return status;
 	}
-
-	/* Prepare first block to be send */
-	Block transmission_block;
-	transmission_block.information_size
-	= data_len < protocol_state->ifsc ? data_len : protocol_state->ifsc;
-	size_t last_information_size = transmission_block.information_size;
-	size_t offset = 0;
-	size_t remaining = data_len;
-	transmission_block.nad = 0x21;
-	transmission_block.pcb = T1PRIME_PCB_I (
-			protocol_state->send_counter, (remaining - last_information_size) > 0);
-	transmission_block.information
-	= malloc (transmission_block.information_size);
-	if (transmission_block.information == NULL)
+	if (frequency <= T1PRIME_MIN_I2C_CLOCK_FREQUENCY)
 	{
-		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, OUT_OF_MEMORY);
+		return PROTOCOL_SETPROPERTY_SUCCESS;
 	}
-	memcpy (transmission_block.information, data,
-			transmission_block.information_size);
+	frequency = frequency > T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY
+			? T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY
+					: T1PRIME_MIN_I2C_CLOCK_FREQUENCY;
+	return i2c_set_clock_frequency (self, frequency);
+}
 
-	/* Send blocks in loop to handle state */
-	Block response_block;
-	bool aborted = false;
-	while (true)
-	{
-		status = t1prime_block_transceive (self, &transmission_block,
-				&response_block);
+/**
+ * \brief Appends information field of received I block to response of
+ * exchange
+ *
+ * \details Chained responses are reassembled in a buffer that is reserved
+ * for one more full I block up front and grown geometrically afterwards, so
+ * that long chains do not reallocate (and copy) the response for every
+ * block. Spare capacity is released once the last block has been received.
+ *
+ * \param protocol_state T=1' protocol state holding exchange
+ * \param data Information field to be appended
+ * \param data_len Number of bytes in data
+ * \param more Whether more I blocks will follow in chain
+ * \return int   PROTOCOL_TRANSCEIVE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_exchange_append (T1PrimeProtocolState *protocol_state,
+		const uint8_t *data, size_t data_len, bool more)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	size_t required = exchange->response_len + data_len;
 
-		t1prime_block_destroy (&transmission_block);
-		if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	/* Scatter into caller provided segments */
+	if (exchange->response_segments != NULL)
+	{
+		if (protocol_segments_scatter (exchange->response_segments,
+				exchange->response_segment_count, exchange->response_len, data,
+				data_len) != data_len)
 		{
-			return status;
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, RESPONSE_TOO_LONG);
 		}
-
-		/* I(N(S), M) -> SE starts sending response */
-				if (T1PRIME_PCB_IS_I (response_block.pcb))
-				{
-					/* Cannot receive I block response while not all data has been sent */
-					if ((remaining - last_information_size) > 0)
-					{
-						t1prime_block_destroy (&response_block);
-						return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-								INVALID_BLOCK);
-					}
-					protocol_state->send_counter ^= 0x01;
-					break;
-				}
-				/* R(N(R)) -> SE wants (another) block */
-				else if (T1PRIME_PCB_IS_R (response_block.pcb))
-				{
-					/* SE expects next block */
-					if ((protocol_state->send_counter ^ 0x01)
-							== T1PRIME_PCB_R_GET_NR (response_block.pcb))
-					{
-						t1prime_block_destroy (&response_block);
-
-						/* Check if chain was aborted */
-						if (aborted)
-						{
-							return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-									TRANSCEIVE_ABORTED);
-						}
-
-						/* SE has last last block */
-						if ((remaining - last_information_size) == 0)
-						{
-							transmission_block.pcb
-							= T1PRIME_PCB_R_CRC (protocol_state->receive_counter);
-							transmission_block.information = NULL;
-							transmission_block.information_size = 0;
-						}
-						else
-						{
-							/* Update state to move to next part of data */
-							remaining -= last_information_size;
-							offset += last_information_size;
-							protocol_state->send_counter ^= 0x01;
-
-							/* Prepare next block */
-							transmission_block.information_size
-							= remaining < protocol_state->ifsc
-							? remaining
-									: protocol_state->ifsc;
-							last_information_size = transmission_block.information_size;
-							transmission_block.pcb = T1PRIME_PCB_I (
-									protocol_state->send_counter,
-									(remaining - last_information_size) > 0);
-							transmission_block.information
-							= malloc (transmission_block.information_size);
-							if (transmission_block.information == NULL)
-							{
-								t1prime_block_destroy (&response_block);
-								return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-										OUT_OF_MEMORY);
-							}
-							memcpy (transmission_block.information, data + offset,
-									transmission_block.information_size);
-						}
-					}
-					/* SE wants a retransmission */
-					else
-					{
-						t1prime_block_destroy (&response_block);
-
-						/* Retransmit last I block */
-						transmission_block.pcb
-						= T1PRIME_PCB_I (protocol_state->send_counter,
-								(remaining - last_information_size) > 0);
-						transmission_block.information_size = last_information_size;
-						transmission_block.information
-						= malloc (transmission_block.information_size);
-						if (transmission_block.information == NULL)
-						{
-							return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-									OUT_OF_MEMORY);
-						}
-						memcpy (transmission_block.information, data + offset,
-								transmission_block.information_size);
-					}
-				}
-				/* S(WTX REQ) -> SE needs more time */
-				else if (response_block.pcb == T1PRIME_PCB_S_WTX_REQ)
-				{
-					/* Verify information field */
-					if ((response_block.information == NULL)
-							|| (response_block.information_size != 1))
-					{
-						t1prime_block_destroy (&response_block);
-						return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-								INVALID_BLOCK);
-					}
-					protocol_state->wtx_delay
-					= response_block.information[0] * protocol_state->bwt;
-
-					/* Send S(WTX RESP) */
-					transmission_block.pcb = T1PRIME_PCB_S_WTX_RESP;
-					transmission_block.information = response_block.information;
-					transmission_block.information_size
-					= response_block.information_size;
-				}
-				/* S(IFS REQ) -> SE wants to indicate that it can send more or less data */
-				else if (response_block.pcb == T1PRIME_PCB_S_IFS_REQ)
-				{
-					/* Verify IFS value */
-					size_t ifs;
-					status = t1prime_ifs_decode (&ifs, response_block.information,
-							response_block.information_size);
-					if (status != T1PRIME_IFS_DECODE_SUCCESS)
-					{
-						t1prime_block_destroy (&response_block);
-						return status;
-					}
-
-					/* Update state in case new IFSC is smaller and SE wants a */
-					/* retransmission */
-					last_information_size
-					= ifs < last_information_size ? ifs : last_information_size;
-
-					/* Send S(IFS RESP) */
-					transmission_block.pcb = T1PRIME_PCB_S_IFS_RESP;
-					transmission_block.information = response_block.information;
-					transmission_block.information_size
-					= response_block.information_size;
-				}
-				/* S(ABORT REQ) -> SE wants to stop chain request */
-				else if (response_block.pcb == T1PRIME_PCB_S_ABORT_REQ)
-				{
-					/* Send S(ABORT RESP) */
-					t1prime_block_destroy (&response_block);
-					transmission_block.pcb = T1PRIME_PCB_S_ABORT_RESP;
-					transmission_block.information = NULL;
-					transmission_block.information_size = 0;
-					aborted = true;
-				}
-				else
-				{
-					t1prime_block_destroy (&response_block);
-					return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
-				}
+		exchange->response_len = required;
+		return PROTOCOL_TRANSCEIVE_SUCCESS;
 	}
-	/* Validate response in loop to handle state */
-	*response = NULL;
-	*response_len = 0;
-	while (true)
-	{
-		/* I(N(S), M) -> SE sent response */
-		if (T1PRIME_PCB_IS_I (response_block.pcb))
-		{
-			/* Validate sequence counter */
-			if (T1PRIME_PCB_I_GET_NS (response_block.pcb)
-					!= protocol_state->receive_counter)
-			{
-				t1prime_block_destroy (&response_block);
-				if ((*response) != NULL)
-				{
-					free (*response);
-					*response = NULL;
-				}
-				*response_len = 0;
-				return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-						INVALID_BLOCK);
-			}
-
-			/* Create new buffer for first response I block */
-			if ((*response) == NULL)
-			{
-				/* Check that data available */
-				if (response_block.information_size == 0)
-				{
-					t1prime_block_destroy (&response_block);
-					return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-							INVALID_BLOCK);
-				}
-				*response = response_block.information;
-				*response_len = response_block.information_size;
-				response_block.information = NULL;
-				response_block.information_size = 0;
-			}
-			/* Otherwise append to buffer */
-			else
-			{
-				/* Check for special case of forced acknowledgement */
-				if (response_block.information_size > 0)
-				{
-					uint8_t *realloc_cache = *response;
-					*response = realloc (*response,
-							*response_len
-							+ response_block.information_size);
-					if ((*response) == NULL)
-					{
-						free (realloc_cache);
-						*response_len = 0;
-						t1prime_block_destroy (&response_block);
-						return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-								OUT_OF_MEMORY);
-					}
-					memcpy ((*response) + *response_len,
-							response_block.information,
-							response_block.information_size);
-					*response_len += response_block.information_size;
-				}
-			}
 
-			t1prime_block_destroy (&response_block);
-			protocol_state->receive_counter ^= 0x01;
-
-			/* Check if more data will be transmitted */
-			if (T1PRIME_PCB_I_HAS_MORE (response_block.pcb))
-			{
-				transmission_block.pcb
-				= T1PRIME_PCB_R_ACK (protocol_state->receive_counter);
-				transmission_block.information = NULL;
-				transmission_block.information_size = 0;
-				status = t1prime_block_transceive (self, &transmission_block,
-						&response_block);
-				t1prime_block_destroy (&transmission_block);
-				if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
-				{
-					if ((*response) != NULL)
-					{
-						free (*response);
-						*response = NULL;
-					}
-					*response_len = 0;
-					return status;
-				}
-			}
-			/* All data received */
-			else
-			{
-				break;
-			}
-		}
-		/* R(N(R)) -> SE needs a retransmission */
-		else if (T1PRIME_PCB_IS_R (response_block.pcb))
+	/* Grow buffer (exactly for unchained responses) */
+	if (required > exchange->response_capacity)
+	{
+		size_t capacity = required;
+		if (more)
 		{
-			/* Validate that card sent correct R(N(R)) */
-			if (T1PRIME_PCB_R_GET_NR (response_block.pcb)
-					!= protocol_state->send_counter)
-			{
-				t1prime_block_destroy (&response_block);
-				if ((*response) != NULL)
-				{
-					free (*response);
-					*response = NULL;
-				}
-				*response_len = 0;
-			}
-
-			/* Send retransmission request */
-			t1prime_block_destroy (&response_block);
-			transmission_block.pcb
-			= T1PRIME_PCB_R_ACK (protocol_state->receive_counter);
-			transmission_block.information = NULL;
-			transmission_block.information_size = 0;
-			status = t1prime_block_transceive (self, &transmission_block,
-					&response_block);
-			t1prime_block_destroy (&transmission_block);
-			if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+			capacity += protocol_state->ifsd;
+			if (capacity < (exchange->response_capacity * 2))
 			{
-				if ((*response) != NULL)
-				{
-					free (*response);
-					*response = NULL;
-				}
-				*response_len = 0;
-				return status;
+				capacity = exchange->response_capacity * 2;
 			}
 		}
-		/* S(ABORT request) -> end chain */
-		else if (response_block.pcb == T1PRIME_PCB_S_ABORT_REQ)
+		uint8_t *resized = allocator_realloc (exchange->allocator,
+				exchange->response_data, capacity);
+		if (resized == NULL)
 		{
-			/* Delete response cache */
-			if ((*response) != NULL)
-			{
-				free (*response);
-				*response = NULL;
-			}
-			*response_len = 0;
-
-			/* Answer with S(ABORT response) */
-			transmission_block.pcb = T1PRIME_PCB_S_ABORT_RESP;
-			transmission_block.information = NULL;
-			transmission_block.information_size = 0;
-			t1prime_block_transceive (self, &transmission_block,
-					&response_block);
-			t1prime_block_destroy (&transmission_block);
-			t1prime_block_destroy (&response_block);
-
-			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-					TRANSCEIVE_ABORTED);
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, OUT_OF_MEMORY);
 		}
-		else
+		exchange->response_data = resized;
+		exchange->response_capacity = capacity;
+	}
+
+	/* Append data (special case of forced acknowledgement without data) */
+	if (data_len > 0)
+	{
+		memcpy (exchange->response_data + exchange->response_len, data,
+				data_len);
+		exchange->response_len = required;
+	}
+
+	/* Release spare capacity after last block */
+	if (!more && (exchange->response_capacity > exchange->response_len))
+	{
+		uint8_t *shrunk = allocator_realloc (exchange->allocator,
+				exchange->response_data, exchange->response_len);
+		if (shrunk != NULL)
 		{
-			/* TODO: Handle other blocks */
-			t1prime_block_destroy (&response_block);
-			if ((*response) != NULL)
-			{
-				free (*response);
-				*response = NULL;
-			}
-			*response_len = 0;
-			return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
+			exchange->response_data = shrunk;
+			exchange->response_capacity = exchange->response_len;
 		}
 	}
-
 	return PROTOCOL_TRANSCEIVE_SUCCESS;
 }
 
@@ -544,7 +1386,13 @@ t1prime_destroy (Protocol *self)
 	{
 		if (self->_properties != NULL)
 		{
-			free (self->_properties);
+			T1PrimeProtocolState *protocol_state
+			= (T1PrimeProtocolState *)self->_properties;
+			allocator_free (protocol_state->exchange.allocator,
+					protocol_state->exchange.response_data);
+			allocator_free (protocol_state->allocator, protocol_state->tx_frame);
+			allocator_free (protocol_state->allocator, protocol_state->rx_frame);
+			allocator_free (protocol_state->allocator, self->_properties);
 			self->_properties = NULL;
 		}
 	}
@@ -632,6 +1480,7 @@ s_cip (Protocol *self, CIP *cip)
 	}
 
 	/* Decode CIP information (implicitely validating data) */
+	cip->allocator = protocol_get_allocator (self);
 	status = t1prime_cip_decode (cip, response.information,
 			response.information_size);
 	t1prime_block_destroy (&response);
@@ -721,25 +1570,101 @@ t1prime_block_transmit (Protocol *self, Block *block)
 		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSMIT, ILLEGAL_ARGUMENT);
 	}
 
-	/* Encode block */
-	uint8_t *encoded;
+	/* Encode block into frame buffer */
+	status = t1prime_frame_reserve (&protocol_state->tx_frame,
+			&protocol_state->tx_frame_size, block->information_size,
+			protocol_state->allocator);
+	if (status != T1PRIME_FRAME_RESERVE_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->tx_frame_len = 0;
 	size_t encoded_len;
-	status = t1prime_block_encode (block, &encoded, &encoded_len);
+	status = t1prime_block_encode_into (block, protocol_state->tx_frame,
+			protocol_state->tx_frame_size, &encoded_len);
 	if (status != T1PRIME_BLOCK_ENCODE_SUCCESS)
 	{
 
 		return status;
 	}
+	protocol_state->tx_frame_len = encoded_len;
 
 	/* Actually transmit block */
-	status = self->_base->_transmit (self->_base, encoded, encoded_len);
-	free (encoded);
+	return t1prime_frame_transmit (self, protocol_state,
+			protocol_state->tx_frame, encoded_len);
+}
+
+/**
+ * \brief Sends \ref Block to secure element again
+ *
+ * \details Reuses the frame still encoded in the transmit buffer if it
+ * matches the given block, falls back to \ref
+ * t1prime_block_transmit(Protocol*, Block*) otherwise.
+ *
+ * \param self Protocol stack for performing necessary operations
+ * \param block Block object that has been sent to secure element before
+ * \return int   PROTOCOL_TRANSMIT_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_block_retransmit (Protocol *self, Block *block)
+{
+	/* Validate protocol stack */
+	if ((self->_base == NULL) || (self->_base->_transmit == NULL))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSMIT, INVALID_PROTOCOLSTACK);
+	}
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Encode block again if frame buffer holds a different one */
+	size_t frame_len = protocol_state->tx_frame_len;
+	uint8_t *frame = protocol_state->tx_frame;
+	if ((frame_len != T1PRIME_FRAME_SIZE (block->information_size))
+			|| (frame[0] != block->nad) || (frame[1] != block->pcb))
+	{
+		return t1prime_block_transmit (self, block);
+	}
+
+	/* Send frame as is */
+	return t1prime_frame_transmit (self, protocol_state, frame, frame_len);
+}
+
+/**
+ * \brief Sends already encoded frame to secure element
+ *
+ * \param self Protocol stack for performing necessary operations
+ * \param protocol_state T=1' protocol state to update statistics of
+ * \param frame Encoded frame to be sent
+ * \param frame_len Number of bytes in   frame
+ * \return int   PROTOCOL_TRANSMIT_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_frame_transmit (Protocol *self, T1PrimeProtocolState *protocol_state,
+		const uint8_t *frame, size_t frame_len)
+{
+	protocol_state->statistics.transactions++;
+	int status = self->_base->_transmit (self->_base, (uint8_t *)frame,
+			frame_len);
+	if (status == PROTOCOL_TRANSMIT_SUCCESS)
+	{
+		protocol_state->statistics.bytes_written += frame_len;
+		protocol_state->statistics.blocks_sent++;
+	}
 	return status;
 }
 
 /**
  * \brief Reads \ref Block from secure element
  *
+ * \details Blocking wrapper polling via \ref t1prime_block_poll(Protocol*,
+ * T1PrimeProtocolState*, Block*) until a block arrives or BWT has passed.
+ *
  * \param self Protocol stack for performing necessary operations
  * \param block Block object to store received data in
  * \return int   PROTOCOL_RECEIVE_SUCCESS if successful, any other value in
@@ -748,119 +1673,289 @@ t1prime_block_transmit (Protocol *self, Block *block)
 int
 t1prime_block_receive (Protocol *self, Block *block)
 {
+	/* Get protocol state for timing information */
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	t1prime_poll_start (protocol_state);
+	do
+	{
+		t1prime_poll_delay (self, protocol_state->exchange.wait);
+		status = t1prime_block_poll (self, protocol_state, block);
+	}
+	while (status == T1PRIME_TRANSCEIVE_PENDING);
+	return status;
+}
+
+/**
+ * \brief Prepares polling timing for next response block
+ *
+ * \details First poll happens after minimum polling time or shortly before
+ * the answer to the current APDU is expected. Further polls back off
+ * exponentially until BWT has passed. A pending waiting time extension
+ * (S(WTX request)) replaces BWT as deadline for this block only, polling
+ * continues during the extension.
+ *
+ * \param protocol_state T=1' protocol state to prepare polling for
+ */
+void
+t1prime_poll_start (T1PrimeProtocolState *protocol_state)
+{
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	uint32_t waiting_time = protocol_state->wtx_delay > 0
+			? (uint32_t)protocol_state->wtx_delay
+					: protocol_state->bwt;
+	protocol_state->wtx_delay = 0;
+	exchange->deadline = waiting_time * 10u;
+	exchange->elapsed = 0;
+	exchange->interval = protocol_state->mpot > 0 ? protocol_state->mpot : 1;
+	exchange->wait = exchange->interval;
+	if (protocol_state->apdu_pending)
+	{
+		uint32_t predicted
+		= protocol_state->processing_time[protocol_state->apdu_ins];
+		predicted -= predicted >> 4;
+		predicted = predicted > exchange->apdu_elapsed
+				? predicted - exchange->apdu_elapsed
+						: 0;
+		exchange->wait
+		= predicted > exchange->wait ? predicted : exchange->wait;
+	}
+	exchange->wait = exchange->wait < exchange->deadline ? exchange->wait
+			: exchange->deadline;
+}
 
+/**
+ * \brief Performs single polling attempt for \ref Block from secure element
+ *
+ * \details Expects that \ref T1PrimeExchange.wait has passed since the last
+ * attempt (or \ref t1prime_poll_start(T1PrimeProtocolState*, uint32_t)).
+ *
+ * \param self Protocol stack for performing necessary operations
+ * \param protocol_state T=1' protocol state holding polling timing
+ * \param block Block object to store received data in
+ * \return int   PROTOCOL_RECEIVE_SUCCESS if block has been received,
+ * T1PRIME_TRANSCEIVE_PENDING if secure element is not ready yet, any other
+ * value in case of error
+ */
+int
+t1prime_block_poll (Protocol *self, T1PrimeProtocolState *protocol_state,
+		Block *block)
+{
 	/* Validate protocol stack */
-	if ((self->_base == NULL) || (self->_base->_receive == NULL))
+	if ((self->_base == NULL) || ((self->_base->_receive == NULL)
+			&& (self->_base->_receive_into == NULL)))
 	{
 		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, INVALID_PROTOCOLSTACK);
 	}
 
-	/* Get protocol state for timing information */
-	T1PrimeProtocolState *protocol_state;
-	int status = t1prime_get_protocol_state (self, &protocol_state);
-	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	/* Frame buffer is sized for IFSD by activation / S(IFS), never here */
+	if ((protocol_state->rx_frame == NULL) || (protocol_state->rx_frame_size
+			< T1PRIME_FRAME_SIZE (protocol_state->ifsd)))
 	{
-		return status;
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, INVALID_STATE);
+	}
+	uint8_t *frame = protocol_state->rx_frame;
+
+	/* Coalesced mode optimistically reads the whole expected frame at once */
+	size_t poll_len = 1;
+	if (protocol_state->coalesced_read)
+	{
+		size_t hint = protocol_state->rx_hint < protocol_state->ifsd
+				? protocol_state->rx_hint
+						: protocol_state->ifsd;
+		poll_len = T1PRIME_FRAME_SIZE (hint);
 	}
 
-	/* Poll for NAD */
+	/* Try to read NAD */
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	exchange->elapsed += exchange->wait;
 	block->nad = 0x00;
-	cyhal_system_delay_ms (protocol_state->bwt);
-	uint8_t ifx_invalid_nad = 0;
-	while (!ifx_invalid_nad)
-	{
-		/* Try to read NAD */
-		uint8_t *nad_buffer = NULL;
-		size_t nad_length;
-		status
-		= self->_base->_receive (self->_base, 1, &nad_buffer, &nad_length);
-		if (status == PROTOCOL_RECEIVE_SUCCESS)
+	block->information = NULL;
+	block->information_size = 0;
+	block->borrowed = false;
+	int status = t1prime_bus_receive (self, protocol_state, frame, poll_len);
+	if ((status != PROTOCOL_RECEIVE_SUCCESS) || (frame[0] == 0x00)
+			|| (frame[0] == 0xff))
+	{
+		/* Invalid NAD -> give up after BWT or back off */
+		if (exchange->elapsed >= exchange->deadline)
 		{
-			/* Check if valid NAD */
-			if ((nad_buffer != NULL) && (nad_length == 1))
-			{
-				if ((nad_buffer[0] != 0x00) && (nad_buffer[0] != 0xff))
-				{
-					block->nad = nad_buffer[0];
-					free (nad_buffer);
-					break;
-				}
-			}
-			/* Invalid NAD -> wait for polling time */
-			if ((nad_buffer != NULL) && (nad_length > 0))
-			{
-				free (nad_buffer);
-				nad_buffer = NULL;
-			}
-			cyhal_system_delay_us (protocol_state->mpot);
+			return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, RECEIVE_TIMEOUT);
+		}
+		exchange->wait = exchange->interval;
+		if ((exchange->elapsed + exchange->wait) > exchange->deadline)
+		{
+			exchange->wait = exchange->deadline - exchange->elapsed;
 		}
+		exchange->interval = (exchange->interval << 1) < T1PRIME_MAX_POLL_INTERVAL
+				? (exchange->interval << 1)
+						: T1PRIME_MAX_POLL_INTERVAL;
+		return T1PRIME_TRANSCEIVE_PENDING;
 	}
-	if (block->nad == 0x00)
+	block->nad = frame[0];
+	size_t received = poll_len;
+
+	/* Read (remaining) fixed length prologue */
+	if (received < BLOCK_PROLOGUE_LENGTH)
 	{
+		status = t1prime_bus_receive (self, protocol_state, frame + received,
+				BLOCK_PROLOGUE_LENGTH - received);
+		if (status != PROTOCOL_RECEIVE_SUCCESS)
+		{
+			return status;
+		}
+		received = BLOCK_PROLOGUE_LENGTH;
+	}
+	block->pcb = frame[1];
+	size_t information_size = (frame[2] << 8) | frame[3];
+	size_t frame_len = T1PRIME_FRAME_SIZE (information_size);
 
-		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, TOO_LITTLE_DATA);
+	/* LEN above IFSD violates the protocol (or is corrupted) -> skip frame */
+	if (information_size > protocol_state->ifsd)
+	{
+		while ((received < frame_len) && (status == PROTOCOL_RECEIVE_SUCCESS))
+		{
+			size_t chunk = frame_len - received;
+			chunk = chunk < protocol_state->rx_frame_size
+					? chunk
+							: protocol_state->rx_frame_size;
+			status = t1prime_bus_receive (self, protocol_state, frame, chunk);
+			received += chunk;
+		}
+		return IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_DECODE, INVALID_BLOCK);
 	}
 
-	/* Read fixed length prologue */
-	uint8_t *binary;
-	size_t binary_len;
-	status = self->_base->_receive (self->_base, BLOCK_PROLOGUE_LENGTH - 1,
-			&binary, &binary_len);
-	if (status != PROTOCOL_RECEIVE_SUCCESS)
+	/* Fold CRC over frame as each part arrives */
+	CRC16 crc_state;
+	crc16_init (&crc_state, CRC16_CCITT_X25);
+	size_t folded = received < (frame_len - BLOCK_EPILOGUE_LENGTH)
+			? received
+					: (frame_len - BLOCK_EPILOGUE_LENGTH);
+	crc16_update (&crc_state, frame, folded);
+
+	/* Read information field and epilogue unless already received */
+	if (received < frame_len)
 	{
-		return status;
+		status = t1prime_bus_receive (self, protocol_state, frame + received,
+				frame_len - received);
+		if (status != PROTOCOL_RECEIVE_SUCCESS)
+		{
+			return status;
+		}
+		crc16_update (&crc_state, frame + folded,
+				frame_len - BLOCK_EPILOGUE_LENGTH - folded);
 	}
-	if (binary_len != (BLOCK_PROLOGUE_LENGTH - 1))
+
+	/* Validate CRC */
+	uint16_t crc = (frame[frame_len - 2] << 8) | frame[frame_len - 1];
+	if (crc16_final (&crc_state) != crc)
 	{
-		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, TOO_LITTLE_DATA);
+
+		return IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_DECODE, INVALID_CRC);
+	}
+	protocol_state->statistics.blocks_received++;
+
+	/* Information field stays in frame buffer until next block is received */
+	if (information_size > 0)
+	{
+		block->information = frame + BLOCK_PROLOGUE_LENGTH;
+		block->information_size = information_size;
+		block->borrowed = true;
+	}
+
+	/* Remember size of I blocks for next coalesced read */
+	if (T1PRIME_PCB_IS_I (block->pcb))
+	{
+		protocol_state->rx_hint = information_size;
+	}
+
+	/* Learn processing time once APDU has actually been answered */
+	if (protocol_state->apdu_pending)
+	{
+		exchange->apdu_elapsed += exchange->elapsed;
+		if (T1PRIME_PCB_IS_I (block->pcb))
+		{
+			t1prime_learn_processing_time (protocol_state,
+					protocol_state->apdu_ins, exchange->apdu_elapsed);
+			protocol_state->apdu_pending = false;
+		}
+	}
+
+	return PROTOCOL_RECEIVE_SUCCESS;
+}
+
+/**
+ * \brief Waits for given time before next polling attempt
+ *
+ * \details Sleeps on the \ref Clock installed for the protocol stack.
+ *
+ * \param self Protocol stack to wait for
+ * \param duration Time to wait in [multiple of 100us]
+ */
+void
+t1prime_poll_delay (Protocol *self, uint32_t duration)
+{
+	clock_sleep (protocol_get_clock (self), duration * 100u);
+}
+
+/**
+ * \brief Updates learned secure element processing time for APDU instruction
+ * with new sample
+ *
+ * \param protocol_state T=1' protocol state holding learned times
+ * \param ins APDU instruction byte the sample belongs to
+ * \param sample Observed processing time in [multiple of 100us]
+ */
+void
+t1prime_learn_processing_time (T1PrimeProtocolState *protocol_state,
+		uint8_t ins, uint32_t sample)
+{
+	sample = sample < UINT16_MAX ? sample : UINT16_MAX;
+	int32_t learned = protocol_state->processing_time[ins];
+	if (learned == 0)
+	{
+		learned = (int32_t)sample;
 	}
-	block->pcb = binary[0];
-	block->information = NULL;
-	block->information_size = 0;
-	size_t information_size = (binary[1] << 8) | binary[2];
-	free (binary);
-
-	/* Read optional dynamic length information field */
-	if (information_size > 0)
+	else
 	{
-		status = self->_base->_receive (self->_base, information_size,
-				&block->information,
-				&block->information_size);
-		if (status != PROTOCOL_RECEIVE_SUCCESS)
-		{
-			return status;
-		}
-		if (block->information_size != information_size)
-		{
-			return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, TOO_LITTLE_DATA);
-		}
+		learned += ((int32_t)sample - learned) >> T1PRIME_PROCESSING_TIME_SHIFT;
 	}
-	block->information_size = information_size;
+	protocol_state->processing_time[ins] = (uint16_t)(learned > 0 ? learned : 1);
+}
 
-	/* Read fixed length epilogue */
-	status = self->_base->_receive (self->_base, BLOCK_EPILOGUE_LENGTH, &binary,
-			&binary_len);
+/**
+ * \brief Reads data from driver layer into buffer and keeps track of bus
+ * statistics
+ *
+ * \param self Protocol stack for performing necessary operations
+ * \param protocol_state T=1' protocol state to update statistics in
+ * \param buffer Buffer to store received data in
+ * \param expected_len Number of bytes to be read
+ * \return int   PROTOCOL_RECEIVE_SUCCESS if exactly   expected_len bytes have
+ * been read, any other value in case of error
+ */
+int
+t1prime_bus_receive (Protocol *self, T1PrimeProtocolState *protocol_state,
+		uint8_t *buffer, size_t expected_len)
+{
+	size_t received_len = 0;
+	protocol_state->statistics.transactions++;
+	int status = protocol_receive_into (self->_base, buffer, expected_len,
+			&received_len);
 	if (status != PROTOCOL_RECEIVE_SUCCESS)
 	{
-		t1prime_block_destroy (block);
 		return status;
 	}
-	if (binary_len != BLOCK_EPILOGUE_LENGTH)
+	protocol_state->statistics.bytes_read += received_len;
+	if (received_len != expected_len)
 	{
-		t1prime_block_destroy (block);
 		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, TOO_LITTLE_DATA);
 	}
-	uint16_t crc = (binary[0] << 8) | binary[1];
-	free (binary);
-
-	/* Validate CRC */
-	if (t1prime_validate_crc (block, crc) != T1PRIME_VALIDATE_CRC_SUCCESS)
-	{
-
-		t1prime_block_destroy (block);
-		return IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_DECODE, INVALID_CRC);
-	}
-
 	return PROTOCOL_RECEIVE_SUCCESS;
 }
 
@@ -883,94 +1978,32 @@ t1prime_block_transceive (Protocol *self, Block *block, Block *response_buffer)
 	{
 		return status;
 	}
-
-	/* Send and receive blocks in loop */
-	Block to_send = *block;
-	size_t try = 0;
-	do
+	T1PrimeExchange *exchange = &protocol_state->exchange;
+	if (exchange->phase != T1PRIME_EXCHANGE_IDLE)
 	{
-		/* Send block to SE */
-		status = t1prime_block_transmit (self, &to_send);
-
-		if (status != PROTOCOL_TRANSMIT_SUCCESS)
-		{
-
-			return status;
-		}
-
-		/* Wait if in WTX state */
-		if (protocol_state->wtx_delay > 0)
-		{
-
-			cyhal_system_delay_ms (protocol_state->wtx_delay * 100);
-
-			protocol_state->wtx_delay = 0;
-
-		}
-
-		/* Read response from SE */
-		status = t1prime_block_receive (self, response_buffer);
-
-		/* Validate correct block has been received */
-		if (status == PROTOCOL_RECEIVE_SUCCESS)
-		{
-			/* Special case S(? request) */
-			if (T1PRIME_PCB_IS_S (block->pcb)
-					&& T1PRIME_PCB_S_IS_REQUEST (block->pcb))
-			{
-				/* S(? response) must match request type */
-				if (T1PRIME_PCB_IS_S (response_buffer->pcb)
-						&& (!T1PRIME_PCB_S_IS_REQUEST (response_buffer->pcb)))
-				{
-					if (T1PRIME_PCB_S_GET_TYPE (block->pcb)
-							== T1PRIME_PCB_S_GET_TYPE (response_buffer->pcb))
-					{
-						return status;
-					}
-				}
-				/* R(N(R)) must have correct sequence counter */
-				else if (T1PRIME_PCB_IS_R (response_buffer->pcb))
-				{
-					if (T1PRIME_PCB_R_GET_NR (response_buffer->pcb)
-							!= protocol_state->send_counter)
-					{
-						t1prime_block_destroy (response_buffer);
-						return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-								INVALID_BLOCK);
-					}
-				}
-				/* I(N(S), M) invalid */
-				else if (T1PRIME_PCB_IS_I (response_buffer->pcb))
-				{
-					t1prime_block_destroy (response_buffer);
-					return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE,
-							INVALID_BLOCK);
-				}
-
-				/* Invalidate read status */
-				status
-				= IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_BLOCK);
-			}
-			else
-			{
-				return status;
-			}
-		}
-
-		/* All blocks besides S(? request) trigger retranmsissions by sending */
-		/* R(N(R)) */
-		if (!T1PRIME_PCB_IS_S (block->pcb)
-				|| !T1PRIME_PCB_S_IS_REQUEST (block->pcb))
-		{
-			to_send.nad = 0x21;
-			to_send.pcb = T1PRIME_PCB_R_CRC (protocol_state->receive_counter);
-			to_send.information = NULL;
-			to_send.information_size = 0;
-		}
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_TRANSCEIVE, INVALID_STATE);
 	}
-	while ((++try) <= T1PRIME_BLOCK_TRANSCEIVE_RETRIES);
 
-	return status;
+	/* Send and receive blocks until valid response or retries exceeded */
+	exchange->block_only = true;
+	exchange->frame = NULL;
+	exchange->response_data = NULL;
+	exchange->response_len = 0;
+	exchange->response_capacity = 0;
+	exchange->response_segments = NULL;
+	exchange->response_segment_count = 0;
+	t1prime_exchange_send (protocol_state, block);
+	status = t1prime_exchange_run (self);
+	exchange->phase = T1PRIME_EXCHANGE_IDLE;
+	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
+	{
+		response_buffer->information = NULL;
+		response_buffer->information_size = 0;
+		response_buffer->borrowed = false;
+		return status;
+	}
+	*response_buffer = exchange->response;
+	return PROTOCOL_TRANSCEIVE_SUCCESS;
 }
 
 /**
@@ -984,29 +2017,24 @@ t1prime_block_transceive (Protocol *self, Block *block, Block *response_buffer)
 int
 t1prime_validate_crc (Block *block, uint16_t expected)
 {
-	/* Allocate memory for CRC calculation data (prologue + information field) */
-	uint8_t *binary = malloc (BLOCK_PROLOGUE_LENGTH + block->information_size);
-	if (binary == NULL)
-	{
-		return IFX_ERROR (LIBT1PRIME, T1PRIME_VALIDATE_CRC, OUT_OF_MEMORY);
-	}
-
-	/* Put fixed length prologue data */
-	binary[0] = block->nad;
-	binary[1] = block->pcb;
-	binary[2] = (block->information_size & 0xff00) >> 8;
-	binary[3] = block->information_size & 0xff;
-
-	/* Put variable length optional information field */
+	/* Encode fixed length prologue */
+	uint8_t prologue[BLOCK_PROLOGUE_LENGTH];
+	prologue[0] = block->nad;
+	prologue[1] = block->pcb;
+	prologue[2] = (block->information_size & 0xff00) >> 8;
+	prologue[3] = block->information_size & 0xff;
+
+	/* Fold CRC over prologue and variable length optional information field */
+	CRC16 crc_state;
+	crc16_init (&crc_state, CRC16_CCITT_X25);
+	crc16_update (&crc_state, prologue, BLOCK_PROLOGUE_LENGTH);
 	if (block->information_size > 0)
 	{
-		memcpy (binary + 4, block->information, block->information_size);
+		crc16_update (&crc_state, block->information, block->information_size);
 	}
 
 	/* Actually Validate CRC */
-	uint16_t actual
-	= crc16_ccitt_x25 (binary, (1 + 1 + 2 + block->information_size));
-	free (binary);
+	uint16_t actual = crc16_final (&crc_state);
 	if (actual != expected)
 	{
 		return IFX_ERROR (LIBT1PRIME, T1PRIME_VALIDATE_CRC, INVALID_CRC);
@@ -1028,32 +2056,68 @@ int
 t1prime_block_encode (Block *block, uint8_t **buffer, size_t *buffer_len)
 {
 	/* Allocate memory for binary data */
-	*buffer_len = BLOCK_PROLOGUE_LENGTH + block->information_size
-			+ BLOCK_EPILOGUE_LENGTH;
-	*buffer = malloc (*buffer_len);
+	*buffer_len = T1PRIME_FRAME_SIZE (block->information_size);
+	*buffer = allocator_malloc (block->allocator, *buffer_len);
 	if (*buffer == NULL)
 	{
 		*buffer_len = 0;
 		return IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_ENCODE, OUT_OF_MEMORY);
 	}
 
+	int status = t1prime_block_encode_into (block, *buffer, *buffer_len,
+			buffer_len);
+	if (status != T1PRIME_BLOCK_ENCODE_SUCCESS)
+	{
+		allocator_free (block->allocator, *buffer);
+		*buffer = NULL;
+		*buffer_len = 0;
+	}
+	return status;
+}
+
+/**
+ * \brief Encodes \ref Block to its binary representation in a caller provided
+ * buffer
+ *
+ * \param block Block to be encoded
+ * \param buffer Buffer to store encoded data in
+ * \param buffer_size Number of bytes available in   buffer
+ * \param encoded_len Pointer for storing number of bytes written to   buffer
+ * \return int   T1PRIME_BLOCK_ENCODE_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_block_encode_into (Block *block, uint8_t *buffer, size_t buffer_size,
+		size_t *encoded_len)
+{
+	/* Validate that frame fits into buffer */
+	size_t frame_len = T1PRIME_FRAME_SIZE (block->information_size);
+	if ((buffer == NULL) || (buffer_size < frame_len))
+	{
+		return IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_ENCODE, ILLEGAL_ARGUMENT);
+	}
+
 	/* Encode fixed length prologue */
-	(*buffer)[0] = block->nad;
-	(*buffer)[1] = block->pcb;
-	(*buffer)[2] = (block->information_size & 0xff00) >> 8;
-	(*buffer)[3] = block->information_size & 0x00ff;
+	buffer[0] = block->nad;
+	buffer[1] = block->pcb;
+	buffer[2] = (block->information_size & 0xff00) >> 8;
+	buffer[3] = block->information_size & 0x00ff;
 
-	/* Encode variable length optional information field */
-	if (block->information_size > 0)
+	/* Encode variable length optional information field (unless already in */
+	/* place) */
+	if ((block->information_size > 0)
+			&& (block->information != (buffer + BLOCK_PROLOGUE_LENGTH)))
 	{
-		memcpy ((*buffer) + 4, block->information, block->information_size);
+		memcpy (buffer + BLOCK_PROLOGUE_LENGTH, block->information,
+				block->information_size);
 	}
 
 	/* Encode fixed length epilogue */
-	uint16_t crc = crc16_ccitt_x25 (*buffer, (*buffer_len) - 2);
-	(*buffer)[(*buffer_len) - 2] = (crc & 0xff00) >> 8;
-	(*buffer)[(*buffer_len) - 1] = crc & 0x00ff;
+	uint16_t crc = crc16_ccitt_x25 (buffer, frame_len - BLOCK_EPILOGUE_LENGTH);
+	buffer[frame_len - 2] = (crc & 0xff00) >> 8;
+	buffer[frame_len - 1] = crc & 0x00ff;
 
+	*encoded_len = frame_len;
 	return T1PRIME_BLOCK_ENCODE_SUCCESS;
 }
 
@@ -1078,6 +2142,7 @@ t1prime_block_decode (Block *block, uint8_t *data, size_t data_len)
 	/* Clear buffers just to be sure */
 	block->information_size = 0;
 	block->information = NULL;
+	block->borrowed = false;
 
 	/* Parse prologue */
 	block->nad = data[0];
@@ -1097,7 +2162,8 @@ t1prime_block_decode (Block *block, uint8_t *data, size_t data_len)
 	/* Parse variable length optional information field */
 	if (block->information_size > 0)
 	{
-		block->information = malloc (block->information_size);
+		block->information = allocator_malloc (block->allocator,
+				block->information_size);
 		if (block->information == NULL)
 		{
 			t1prime_block_destroy (block);
@@ -1129,19 +2195,22 @@ t1prime_block_decode (Block *block, uint8_t *data, size_t data_len)
  * t1prime_block_decode(Block*, uint8_t *, size_t)). Users would need to
  * manually check which members have been dynamically allocated and free them
  * themselves. Calling this function will ensure that all dynamically allocated
- * members have been freed.
+ * members have been freed. Borrowed information fields (see \ref
+ * Block.borrowed) are left untouched.
  *
  * \param block Block object whose data shall be freed
  */
 void
 t1prime_block_destroy (Block *block)
 {
-	if ((block->information_size != 0) && (block->information != NULL))
+	if ((block->information_size != 0) && (block->information != NULL)
+			&& !block->borrowed)
 	{
-		free (block->information);
+		allocator_free (block->allocator, block->information);
 	}
 	block->information = NULL;
 	block->information_size = 0;
+	block->borrowed = false;
 }
 
 /**
@@ -1185,7 +2254,7 @@ t1prime_cip_decode (CIP *cip, uint8_t *data, size_t data_len)
 	}
 	if (cip->iin_len > 0)
 	{
-		cip->iin = malloc (cip->iin_len);
+		cip->iin = allocator_malloc (cip->allocator, cip->iin_len);
 		if (cip->iin == NULL)
 		{
 			return IFX_ERROR (LIBT1PRIME, T1PRIME_CIP_DECODE, OUT_OF_MEMORY);
@@ -1206,7 +2275,7 @@ t1prime_cip_decode (CIP *cip, uint8_t *data, size_t data_len)
 	}
 	if (cip->plp_len > 0)
 	{
-		cip->plp = malloc (cip->plp_len);
+		cip->plp = allocator_malloc (cip->allocator, cip->plp_len);
 		if (cip->plp == NULL)
 		{
 			t1prime_cip_destroy (cip);
@@ -1225,7 +2294,7 @@ t1prime_cip_decode (CIP *cip, uint8_t *data, size_t data_len)
 	}
 	if (cip->dllp_len > 0)
 	{
-		cip->dllp = malloc (cip->dllp_len);
+		cip->dllp = allocator_malloc (cip->allocator, cip->dllp_len);
 		if (cip->dllp == NULL)
 		{
 			t1prime_cip_destroy (cip);
@@ -1244,7 +2313,7 @@ t1prime_cip_decode (CIP *cip, uint8_t *data, size_t data_len)
 	}
 	if (cip->hb_len > 0)
 	{
-		cip->hb = malloc (cip->hb_len);
+		cip->hb = allocator_malloc (cip->allocator, cip->hb_len);
 		if (cip->hb == NULL)
 		{
 			t1prime_cip_destroy (cip);
@@ -1327,7 +2396,7 @@ t1prime_cip_destroy (CIP *cip)
 	/* Issuer identification number */
 	if ((cip->iin_len > 0) && (cip->iin != NULL))
 	{
-		free (cip->iin);
+		allocator_free (cip->allocator, cip->iin);
 	}
 	cip->iin_len = 0;
 	cip->iin = NULL;
@@ -1335,7 +2404,7 @@ t1prime_cip_destroy (CIP *cip)
 	/* Physical layer parameters */
 	if ((cip->plp_len > 0) && (cip->plp != NULL))
 	{
-		free (cip->plp);
+		allocator_free (cip->allocator, cip->plp);
 	}
 	cip->plp_len = 0;
 	cip->plp = NULL;
@@ -1343,7 +2412,7 @@ t1prime_cip_destroy (CIP *cip)
 	/* Data-link layer parameters */
 	if ((cip->dllp_len > 0) && (cip->dllp != NULL))
 	{
-		free (cip->dllp);
+		allocator_free (cip->allocator, cip->dllp);
 	}
 	cip->dllp_len = 0;
 	cip->dllp = NULL;
@@ -1351,7 +2420,7 @@ t1prime_cip_destroy (CIP *cip)
 	/* Historical bytes */
 	if ((cip->hb_len > 0) && (cip->hb != NULL))
 	{
-		free (cip->hb);
+		allocator_free (cip->allocator, cip->hb);
 	}
 	cip->hb_len = 0;
 	cip->hb = NULL;
@@ -1440,11 +2509,14 @@ t1prime_i2c_plp_destroy (I2CPLP *plp)
  * \param ifs IFS value to be encoded
  * \param buffer Buffer to store encoded data in
  * \param buffer_len Number of bytes in   buffer
+ * \param allocator Allocator   buffer is allocated with (NULL for system
+ * heap)
  * \return int   T1PRIME_IFS_ENCODE_SUCCESS if successful, any other value in
  * case of error
  */
 int
-t1prime_ifs_encode (size_t ifs, uint8_t **buffer, size_t *buffer_len)
+t1prime_ifs_encode (size_t ifs, uint8_t **buffer, size_t *buffer_len,
+		const Allocator *allocator)
 {
 	/* Check that desired IFS value is in range */
 	if ((ifs == 0) || (ifs > T1PRIME_MAX_IFS))
@@ -1454,21 +2526,44 @@ t1prime_ifs_encode (size_t ifs, uint8_t **buffer, size_t *buffer_len)
 
 	/* Allocate buffer for binary encoding */
 	*buffer_len = (ifs <= 0xfe) ? 1 : 2;
-	*buffer = malloc (*buffer_len);
+	*buffer = (uint8_t *)allocator_malloc (allocator, *buffer_len);
 	if (*buffer == NULL)
 	{
 		return IFX_ERROR (LIBT1PRIME, PROTOCOL_SETPROPERTY, OUT_OF_MEMORY);
 	}
+	return t1prime_ifs_encode_into (ifs, *buffer, buffer_len);
+}
+
+/**
+ * \brief Encodes information field size (IFS) to its binary representation in
+ * a caller provided buffer
+ *
+ * \param ifs IFS value to be encoded
+ * \param buffer Buffer to store encoded data in
+ * \param buffer_len Buffer to store number of bytes written to   buffer in
+ * \return int   T1PRIME_IFS_ENCODE_SUCCESS if successful, any other value in
+ * case of error
+ */
+int
+t1prime_ifs_encode_into (size_t ifs, uint8_t buffer[2], size_t *buffer_len)
+{
+	/* Check that desired IFS value is in range */
+	if ((ifs == 0) || (ifs > T1PRIME_MAX_IFS))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_SETPROPERTY, ILLEGAL_ARGUMENT);
+	}
 
 	/* Actually encode data */
-	if ((*buffer_len) == 1)
+	if (ifs <= 0xfe)
 	{
-		(*buffer)[0] = ifs & 0xff;
+		buffer[0] = ifs & 0xff;
+		*buffer_len = 1;
 	}
 	else
 	{
-		(*buffer)[0] = (ifs & 0x0f00) >> 8;
-		(*buffer)[1] = ifs & 0x00ff;
+		buffer[0] = (ifs & 0x0f00) >> 8;
+		buffer[1] = ifs & 0x00ff;
+		*buffer_len = 2;
 	}
 
 	return T1PRIME_IFS_ENCODE_SUCCESS;
@@ -1531,6 +2626,66 @@ t1prime_get_ifsc (Protocol *self, size_t *ifsc_buffer)
 	return PROTOCOL_GETPROPERTY_SUCCESS;
 }
 
+/**
+ * \brief Returns send sequence counter N(S) of the next I block
+ *
+ * \param self T=1' protocol stack to get N(S) for
+ * \param send_counter_buffer Buffer to store N(S) (0 or 1) in
+ * \return int   PROTOCOL_GETPROTPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_get_send_counter (Protocol *self, uint8_t *send_counter_buffer)
+{
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*send_counter_buffer = protocol_state->send_counter;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Ensures that a frame buffer can hold a block with the given
+ * information field size
+ *
+ * \param frame Frame buffer to be (re-) allocated
+ * \param frame_size Number of bytes available in   frame
+ * \param ifs Information field size the frame must be able to hold
+ * \param allocator Allocator   frame has been allocated with
+ * \return int   T1PRIME_FRAME_RESERVE_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_frame_reserve (uint8_t **frame, size_t *frame_size, size_t ifs,
+		const Allocator *allocator)
+{
+	/* Validate parameters */
+	if (ifs > T1PRIME_MAX_IFS)
+	{
+		return IFX_ERROR (LIBT1PRIME, T1PRIME_FRAME_RESERVE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Buffers only ever grow */
+	size_t required = T1PRIME_FRAME_SIZE (ifs);
+	if (((*frame) != NULL) && ((*frame_size) >= required))
+	{
+		return T1PRIME_FRAME_RESERVE_SUCCESS;
+	}
+
+	/* Keep old buffer in case of error */
+	uint8_t *resized = allocator_realloc (allocator, *frame, required);
+	if (resized == NULL)
+	{
+		return IFX_ERROR (LIBT1PRIME, T1PRIME_FRAME_RESERVE, OUT_OF_MEMORY);
+	}
+	*frame = resized;
+	*frame_size = required;
+	return T1PRIME_FRAME_RESERVE_SUCCESS;
+}
+
 /**
  * \brief Sets maximum information field size of the host device (IFSD)
  *
@@ -1544,13 +2699,59 @@ t1prime_get_ifsc (Protocol *self, size_t *ifsc_buffer)
  */
 int
 t1prime_set_ifsd (Protocol *self, size_t ifsd)
+{
+	/* Make sure host can actually receive blocks of this size */
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	status = t1prime_frame_reserve (&protocol_state->rx_frame,
+			&protocol_state->rx_frame_size, ifsd,
+			protocol_state->allocator);
+	if (status != T1PRIME_FRAME_RESERVE_SUCCESS)
+	{
+		return status;
+	}
+
+	/* Check that negotiated value matches */
+	size_t response_ifs;
+	status = t1prime_negotiate_ifsd (self, ifsd, &response_ifs);
+	if (status != PROTOCOL_SETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	if (response_ifs != ifsd)
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, INVALID_BLOCK);
+	}
+	protocol_state->ifsd = ifsd;
+
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Sends S(IFS request) to the secure element and returns the IFSD it
+ * acknowledged
+ *
+ * \param self T=1' protocol stack to be used
+ * \param ifsd IFS value to be requested
+ * \param ifsd_buffer Buffer to store IFS value of S(IFS response) in
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_negotiate_ifsd (Protocol *self, size_t ifsd, size_t *ifsd_buffer)
 {
 	/* Encode IFS information */
-	Block request = { .nad = 0x21,
+	uint8_t encoded_ifs[2];
+	Block request = { .nad = NAD_HD_TO_SE,
 			.pcb = T1PRIME_PCB_S_IFS_REQ,
 			.information_size = 0,
-			.information = NULL };
-	int status = t1prime_ifs_encode (ifsd, &(request.information),
+			.information = encoded_ifs,
+			.borrowed = true };
+	int status = t1prime_ifs_encode_into (ifsd, encoded_ifs,
 			&(request.information_size));
 	if (status != T1PRIME_IFS_ENCODE_SUCCESS)
 	{
@@ -1560,7 +2761,6 @@ t1prime_set_ifsd (Protocol *self, size_t ifsd)
 	/* Send S(IFS request) to secure element and read back response */
 	Block response;
 	status = t1prime_block_transceive (self, &request, &response);
-	t1prime_block_destroy (&request);
 	if (status != PROTOCOL_TRANSCEIVE_SUCCESS)
 	{
 		return status;
@@ -1575,8 +2775,7 @@ t1prime_set_ifsd (Protocol *self, size_t ifsd)
 	}
 
 	/* Decode IFS response */
-	size_t response_ifs;
-	status = t1prime_ifs_decode (&response_ifs, response.information,
+	status = t1prime_ifs_decode (ifsd_buffer, response.information,
 			response.information_size);
 	t1prime_block_destroy (&response);
 	if (status != T1PRIME_IFS_DECODE_SUCCESS)
@@ -1584,12 +2783,6 @@ t1prime_set_ifsd (Protocol *self, size_t ifsd)
 		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, INVALID_BLOCK);
 	}
 
-	/* Check that negotiated value matches */
-	if (response_ifs != ifsd)
-	{
-		return IFX_ERROR (LIBT1PRIME, PROTOCOL_RECEIVE, INVALID_BLOCK);
-	}
-
 	return PROTOCOL_SETPROPERTY_SUCCESS;
 }
 
@@ -1635,6 +2828,97 @@ t1prime_set_bwt (Protocol *self, uint16_t bwt)
 	return PROTOCOL_SETPROPERTY_SUCCESS;
 }
 
+/**
+ * \brief Sets largest information field size of the host device (IFSD)
+ * negotiated during activation
+ *
+ * \param self T=1' protocol stack to configure
+ * \param max_ifsd Largest IFSD to be advertised
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_set_max_ifsd (Protocol *self, size_t max_ifsd)
+{
+	/* Validate parameters */
+	if ((max_ifsd == 0) || (max_ifsd > T1PRIME_MAX_IFS))
+	{
+		return IFX_ERROR (LIBT1PRIME, PROTOCOL_SETPROPERTY, ILLEGAL_ARGUMENT);
+	}
+
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->max_ifsd = max_ifsd;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Enables or disables coalesced frame reads
+ *
+ * \param self T=1' protocol stack to configure
+ * \param enable   true to enable coalesced frame reads
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_set_coalesced_read (Protocol *self, bool enable)
+{
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	protocol_state->coalesced_read = enable;
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Returns communication statistics collected since initialization or
+ * last reset
+ *
+ * \param self T=1' protocol stack to get statistics for
+ * \param statistics_buffer Buffer to store statistics in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_get_statistics (Protocol *self, T1PrimeStatistics *statistics_buffer)
+{
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	*statistics_buffer = protocol_state->statistics;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Resets communication statistics
+ *
+ * \param self T=1' protocol stack to reset statistics for
+ * \return int   PROTOCOL_SETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+t1prime_reset_statistics (Protocol *self)
+{
+	T1PrimeProtocolState *protocol_state;
+	int status = t1prime_get_protocol_state (self, &protocol_state);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+	memset (&protocol_state->statistics, 0, sizeof (T1PrimeStatistics));
+	return PROTOCOL_SETPROPERTY_SUCCESS;
+}
+
 /**
  * \brief Returns current protocol state for Global Platform T=1' protocol
  *
@@ -1662,7 +2946,8 @@ t1prime_get_protocol_state (Protocol *self,
 	if (self->_properties == NULL)
 	{
 		/* Lazy initialize properties */
-		self->_properties = malloc (sizeof (T1PrimeProtocolState));
+		self->_properties = allocator_malloc (self->_allocator,
+				sizeof (T1PrimeProtocolState));
 		if (self->_properties == NULL)
 		{
 			return IFX_ERROR (LIBT1PRIME, PROTOCOL_GETPROPERTY, OUT_OF_MEMORY);
@@ -1675,6 +2960,24 @@ t1prime_get_protocol_state (Protocol *self,
 		properties->receive_counter = 0x00;
 		properties->wtx_delay = 0x00;
 		properties->mpot = T1PRIME_DEFAULT_I2C_MPOT;
+		properties->ifsd = T1PRIME_DEFAULT_IFSD;
+		properties->max_ifsd = T1PRIME_DEFAULT_MAX_IFSD;
+		properties->tx_frame = NULL;
+		properties->tx_frame_size = 0;
+		properties->tx_frame_len = 0;
+		properties->link_errors = 0;
+		properties->rx_frame = NULL;
+		properties->rx_frame_size = 0;
+		properties->coalesced_read = false;
+		properties->rx_hint = 0;
+		memset (&properties->statistics, 0, sizeof (T1PrimeStatistics));
+		properties->apdu_ins = 0x00;
+		properties->apdu_pending = false;
+		memset (properties->processing_time, 0,
+				sizeof (properties->processing_time));
+		memset (&properties->exchange, 0, sizeof (T1PrimeExchange));
+		properties->exchange.phase = T1PRIME_EXCHANGE_IDLE;
+		properties->allocator = self->_allocator;
 	}
 
 	*protocol_state_buffer = (T1PrimeProtocolState *)self->_properties;
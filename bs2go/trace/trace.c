@@ -0,0 +1,482 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file trace.c
+ * \brief Protocol layer recording bus traffic into a ring buffer
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/trace/ifx/trace.h"
+#include "bs2go/trace/trace.h"
+
+/**
+ * \brief Initializes empty ring buffer in given memory
+ *
+ * \param trace Ring buffer to be initialized
+ * \param buffer Memory to hold events
+ * \param size Number of bytes in   buffer
+ */
+void
+trace_buffer_initialize (TraceBuffer *trace, void *buffer, size_t size)
+{
+	trace->buffer = (uint8_t *)buffer;
+	trace->size = size;
+	trace_buffer_reset (trace);
+}
+
+/**
+ * \brief Drops all recorded events and restarts timestamps at next event
+ *
+ * \param trace Ring buffer to be reset
+ */
+void
+trace_buffer_reset (TraceBuffer *trace)
+{
+	trace->head = 0;
+	trace->tail = 0;
+	trace->used = 0;
+	trace->started = false;
+	trace->start = 0;
+	trace->events = 0;
+	trace->overwritten = 0;
+}
+
+/**
+ * \brief Copies data into ring buffer at given offset, wrapping around at its
+ * end
+ */
+static void
+trace_ring_write (TraceBuffer *trace, size_t offset, const uint8_t *data,
+		size_t data_len)
+{
+	size_t first = trace->size - offset;
+	if (data_len <= first)
+	{
+		memcpy (trace->buffer + offset, data, data_len);
+		return;
+	}
+	memcpy (trace->buffer + offset, data, first);
+	memcpy (trace->buffer, data + first, data_len - first);
+}
+
+/**
+ * \brief Drops oldest event from ring buffer
+ */
+static void
+trace_ring_drop (TraceBuffer *trace)
+{
+	/* Length field is at offset 5 of event header */
+	uint8_t length_high = trace->buffer[(trace->tail + 5) % trace->size];
+	uint8_t length_low = trace->buffer[(trace->tail + 6) % trace->size];
+	uint8_t type = trace->buffer[trace->tail];
+	size_t event_len = TRACE_EVENT_HEADER_LENGTH;
+	if ((type & ~TRACE_EVENT_ERROR) != TRACE_EVENT_POLL)
+	{
+		event_len += (length_high << 8) | length_low;
+	}
+	trace->tail = (trace->tail + event_len) % trace->size;
+	trace->used -= event_len;
+	trace->events--;
+	trace->overwritten++;
+}
+
+/**
+ * \brief Appends event to ring buffer, overwriting oldest events if needed
+ *
+ * \param trace Ring buffer to record into
+ * \param type Event type (and flags)
+ * \param timestamp Time of event in [us]
+ * \param length Length field of event
+ * \param data Event data (might be   NULL)
+ * \param data_len Number of bytes in   data
+ */
+void
+trace_record (TraceBuffer *trace, uint8_t type, uint64_t timestamp,
+		uint16_t length, const uint8_t *data, size_t data_len)
+{
+	/* Timestamps are relative to first event */
+	if (!trace->started)
+	{
+		trace->start = timestamp;
+		trace->started = true;
+	}
+	uint32_t time = (uint32_t)(timestamp - trace->start);
+
+	size_t event_len = TRACE_EVENT_HEADER_LENGTH + data_len;
+	if (event_len > trace->size)
+	{
+		trace->overwritten++;
+		return;
+	}
+	while ((trace->size - trace->used) < event_len)
+	{
+		trace_ring_drop (trace);
+	}
+
+	uint8_t header[TRACE_EVENT_HEADER_LENGTH] = { type, (uint8_t)(time >> 24),
+			(uint8_t)(time >> 16), (uint8_t)(time >> 8), (uint8_t)time,
+			(uint8_t)(length >> 8), (uint8_t)length };
+	trace_ring_write (trace, trace->head, header, sizeof (header));
+	if (data_len > 0)
+	{
+		trace_ring_write (trace,
+				(trace->head + TRACE_EVENT_HEADER_LENGTH) % trace->size, data,
+				data_len);
+	}
+	trace->head = (trace->head + event_len) % trace->size;
+	trace->used += event_len;
+	trace->events++;
+}
+
+/**
+ * \brief Initializes \ref Protocol object for trace layer
+ *
+ * \param self \ref Protocol object to be initialized
+ * \param driver \ref Driver layer whose traffic is recorded
+ * \param trace Ring buffer to record into (must outlive the stack)
+ * \return int   PROTOCOLLAYER_INITIALIZE_SUCCESS if successful, any other
+ * value in case of error
+ */
+int
+trace_initialize (Protocol *self, Protocol *driver, TraceBuffer *trace)
+{
+	/* Validate parameters */
+	if ((driver == NULL) || (driver->_transmit == NULL)
+			|| (driver->_receive == NULL))
+	{
+		return IFX_ERROR (LIBTRACE, PROTOCOLLAYER_INITIALIZE,
+				INVALID_PROTOCOLSTACK);
+	}
+	if ((trace == NULL) || (trace->buffer == NULL))
+	{
+		return IFX_ERROR (LIBTRACE, PROTOCOLLAYER_INITIALIZE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Populate object */
+	int status = protocollayer_initialize (self);
+	if (status != PROTOCOLLAYER_INITIALIZE_SUCCESS)
+	{
+		return status;
+	}
+	self->_layer_id = TRACE_PROTOCOLLAYER_ID;
+	self->_base = driver;
+	self->_transmit = trace_transmit;
+	self->_receive = trace_receive;
+	self->_receive_into = trace_receive_into;
+	self->_destructor = trace_destroy;
+	self->_properties = trace;
+
+	/* Share allocators and clock already installed on driver layer */
+	self->_allocator = driver->_allocator;
+	self->_transaction_allocator = driver->_transaction_allocator;
+	self->_clock = driver->_clock;
+	return PROTOCOLLAYER_INITIALIZE_SUCCESS;
+}
+
+/**
+ * \brief Returns ring buffer of trace layer in protocol stack
+ *
+ * \param self Protocol stack containing trace layer
+ * \param trace_buffer Buffer to store ring buffer in
+ * \return int   PROTOCOL_GETPROPERTY_SUCCESS if successful, any other value
+ * in case of error
+ */
+int
+trace_get_buffer (Protocol *self, TraceBuffer **trace_buffer)
+{
+	/* Verify that correct protocol layer called this function */
+	if (self->_layer_id != TRACE_PROTOCOLLAYER_ID)
+	{
+		if (self->_base == NULL)
+		{
+			return IFX_ERROR (LIBTRACE, PROTOCOL_GETPROPERTY,
+					INVALID_PROTOCOLSTACK);
+		}
+		return trace_get_buffer (self->_base, trace_buffer);
+	}
+	if (self->_properties == NULL)
+	{
+		return IFX_ERROR (LIBTRACE, PROTOCOL_GETPROPERTY, INVALID_PROTOCOLSTACK);
+	}
+
+	*trace_buffer = (TraceBuffer *)self->_properties;
+	return PROTOCOL_GETPROPERTY_SUCCESS;
+}
+
+/**
+ * \brief Returns time of event about to be recorded
+ *
+ * \details Events are recorded without timing (timestamp 0) if the stack has
+ * no time source.
+ */
+static uint64_t
+trace_timestamp (Protocol *self)
+{
+	uint64_t now;
+	clock_now (protocol_get_clock (self), &now);
+	return now;
+}
+
+/**
+ * \brief \ref protocol_transmitfunction_t for trace layer
+ *
+ * \see protocol_transmitfunction_t
+ */
+int
+trace_transmit (Protocol *self, uint8_t *data, size_t data_len)
+{
+	TraceBuffer *trace;
+	int status = trace_get_buffer (self, &trace);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	uint64_t timestamp = trace_timestamp (self);
+	status = self->_base->_transmit (self->_base, data, data_len);
+	trace_record (trace,
+			(status == PROTOCOL_TRANSMIT_SUCCESS) ? TRACE_EVENT_TRANSMIT
+					: (TRACE_EVENT_TRANSMIT | TRACE_EVENT_ERROR), timestamp,
+			(uint16_t)data_len, data, data_len);
+	return status;
+}
+
+/**
+ * \brief \ref protocol_receivefunction_t for trace layer
+ *
+ * \see protocol_receivefunction_t
+ */
+int
+trace_receive (Protocol *self, size_t expected_len, uint8_t **response,
+		size_t *response_len)
+{
+	TraceBuffer *trace;
+	int status = trace_get_buffer (self, &trace);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	uint64_t timestamp = trace_timestamp (self);
+	status = self->_base->_receive (self->_base, expected_len, response,
+			response_len);
+	if (status != PROTOCOL_RECEIVE_SUCCESS)
+	{
+		trace_record (trace, TRACE_EVENT_POLL, timestamp, (uint16_t)expected_len,
+				NULL, 0);
+		return status;
+	}
+	trace_record (trace, TRACE_EVENT_RECEIVE, timestamp,
+			(uint16_t)*response_len, *response, *response_len);
+	return status;
+}
+
+/**
+ * \brief \ref protocol_receiveintofunction_t for trace layer
+ *
+ * \see protocol_receiveintofunction_t
+ */
+int
+trace_receive_into (Protocol *self, uint8_t *buffer, size_t buffer_len,
+		size_t *received_len)
+{
+	TraceBuffer *trace;
+	int status = trace_get_buffer (self, &trace);
+	if (status != PROTOCOL_GETPROPERTY_SUCCESS)
+	{
+		return status;
+	}
+
+	uint64_t timestamp = trace_timestamp (self);
+	status = protocol_receive_into (self->_base, buffer, buffer_len,
+			received_len);
+	if (status != PROTOCOL_RECEIVE_SUCCESS)
+	{
+		trace_record (trace, TRACE_EVENT_POLL, timestamp, (uint16_t)buffer_len,
+				NULL, 0);
+		return status;
+	}
+	trace_record (trace, TRACE_EVENT_RECEIVE, timestamp,
+			(uint16_t)*received_len, buffer, *received_len);
+	return status;
+}
+
+/**
+ * \brief \ref protocol_destroyfunction_t for trace layer
+ *
+ * \see protocol_destroyfunction_t
+ */
+void
+trace_destroy (Protocol *self)
+{
+	if (self != NULL)
+	{
+		/* Ring buffer is owned by caller */
+		self->_properties = NULL;
+	}
+}
+
+/**
+ * \brief Writes header and all recorded events (oldest first) to sink
+ *
+ * \param trace Ring buffer to be dumped
+ * \param write Sink to write to
+ * \param context Sink specific data passed to   write
+ * \return int   TRACE_DUMP_SUCCESS if successful, any other value in case of
+ * error
+ */
+int
+trace_dump (const TraceBuffer *trace, trace_writefunction_t write,
+		void *context)
+{
+	/* Validate parameters */
+	if ((trace == NULL) || (write == NULL))
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_DUMP, ILLEGAL_ARGUMENT);
+	}
+
+	uint32_t overwritten = (uint32_t)trace->overwritten;
+	uint8_t header[TRACE_HEADER_LENGTH] = { 'B', 'S', '2', 'T', TRACE_VERSION,
+			0x00, (uint8_t)(overwritten >> 24), (uint8_t)(overwritten >> 16),
+			(uint8_t)(overwritten >> 8), (uint8_t)overwritten };
+	if (write (context, header, sizeof (header)) != 0)
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_DUMP, TRACE_WRITE_FAILED);
+	}
+
+	/* Events might wrap around at end of buffer */
+	size_t first = trace->size - trace->tail;
+	first = trace->used < first ? trace->used : first;
+	if ((first > 0)
+			&& (write (context, trace->buffer + trace->tail, first) != 0))
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_DUMP, TRACE_WRITE_FAILED);
+	}
+	if ((trace->used > first)
+			&& (write (context, trace->buffer, trace->used - first) != 0))
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_DUMP, TRACE_WRITE_FAILED);
+	}
+	return TRACE_DUMP_SUCCESS;
+}
+
+/**
+ * \brief \ref trace_writefunction_t writing to a `FILE`
+ */
+static int
+trace_file_write (void *context, const uint8_t *data, size_t data_len)
+{
+	return (fwrite (data, 1, data_len, (FILE *)context) == data_len) ? 0 : -1;
+}
+
+/**
+ * \brief Writes header and all recorded events to file
+ *
+ * \param trace Ring buffer to be dumped
+ * \param file File to write to
+ * \return int   TRACE_DUMP_SUCCESS if successful, any other value in case of
+ * error
+ */
+int
+trace_dump_file (const TraceBuffer *trace, FILE *file)
+{
+	if (file == NULL)
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_DUMP, ILLEGAL_ARGUMENT);
+	}
+	int status = trace_dump (trace, trace_file_write, file);
+	if ((status == TRACE_DUMP_SUCCESS) && (fflush (file) != 0))
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_DUMP, TRACE_WRITE_FAILED);
+	}
+	return status;
+}
+
+/**
+ * \brief Decodes next event of a dumped trace
+ *
+ * \param trace Dumped trace (header and events)
+ * \param trace_len Number of bytes in   trace
+ * \param offset Offset of next event, advanced past decoded event
+ * \param event Buffer to store event in (data points into   trace)
+ * \return int   TRACE_EVENT_DECODE_SUCCESS if successful, error with reason
+ * TRACE_END_OF_TRACE after last event, any other value in case of error
+ */
+int
+trace_event_decode (const uint8_t *trace, size_t trace_len, size_t *offset,
+		TraceEvent *event)
+{
+	/* Validate parameters */
+	if ((trace == NULL) || (offset == NULL) || (event == NULL))
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE, ILLEGAL_ARGUMENT);
+	}
+
+	/* Skip header in front of first event */
+	if (*offset == 0)
+	{
+		if ((trace_len < TRACE_HEADER_LENGTH) || (trace[0] != 'B')
+				|| (trace[1] != 'S') || (trace[2] != '2') || (trace[3] != 'T')
+				|| (trace[4] != TRACE_VERSION))
+		{
+			return IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE, TRACE_INVALID_FORMAT);
+		}
+		*offset = TRACE_HEADER_LENGTH;
+	}
+	if (*offset >= trace_len)
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE, TRACE_END_OF_TRACE);
+	}
+	if ((trace_len - *offset) < TRACE_EVENT_HEADER_LENGTH)
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE, TOO_LITTLE_DATA);
+	}
+
+	const uint8_t *header = trace + *offset;
+	event->type = header[0];
+	event->timestamp = ((uint32_t)header[1] << 24) | ((uint32_t)header[2] << 16)
+			| ((uint32_t)header[3] << 8) | header[4];
+	event->length = (uint16_t)((header[5] << 8) | header[6]);
+	event->data = NULL;
+	event->data_len = 0;
+	if ((event->type & ~TRACE_EVENT_ERROR) != TRACE_EVENT_POLL)
+	{
+		event->data_len = event->length;
+	}
+	if ((trace_len - *offset - TRACE_EVENT_HEADER_LENGTH) < event->data_len)
+	{
+		return IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE, TOO_LITTLE_DATA);
+	}
+	if (event->data_len > 0)
+	{
+		event->data = header + TRACE_EVENT_HEADER_LENGTH;
+	}
+	*offset += TRACE_EVENT_HEADER_LENGTH + event->data_len;
+	return TRACE_EVENT_DECODE_SUCCESS;
+}
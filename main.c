@@ -65,7 +65,7 @@ int main(void)
 {
 	cy_rslt_t status;
 	uint8_t read_data; /* Stores the received character from the user*/
-	uint8_t *public_key = 0; /* Stores the Public key */
+	uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN] = {0}; /* Stores the Public key */
 	uint8_t public_key_len = 0; /* length of the Public key  */
 
 	/* SHA-256 digest used for Signing*/
@@ -73,10 +73,10 @@ int main(void)
 			0xE6,0xC9,0x9F,0xDA,0xB0,0x8E,0xE7,0x31,0xD6,0xCD,0x64,0x4C,
 			0x13,0x12,0x23,0xFD,0x2F,0x4F,0xED,0x2A};
 
-	uint8_t *signature=0;	/* Signature */
+	uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN]={0};	/* Signature */
 	size_t signature_len=0; /* length of the signature */
 	uint8_t key_index; /* Stores the generated key index */
-	char *version = 0;  /* Version */
+	char version[BLOCK2GO_VERSION_MAX_LEN] = {0};  /* Version */
 	uint8_t id[BLOCK2GO_ID_LEN]; /* Stores the ID of the Secure Element*/
 	block2go_curve curve; /* ECC curve type*/
 
@@ -133,7 +133,7 @@ int main(void)
 			case '2':
 			{
 				/* Execute the SELECT APP command */
-				status = wrap_block2go_select(id, &version);
+				status = wrap_block2go_select(id, version);
 				if (status!=CY_RSLT_SUCCESS)
 				{
 					break;
@@ -154,7 +154,7 @@ int main(void)
 			case '3':
 			{
 				/* Execute the GET KEY INFO command */
-				status = wrap_get_pub_key(KEY_INDEX, &public_key, &public_key_len,curve);
+				status = wrap_get_pub_key(KEY_INDEX, public_key, &public_key_len,curve);
 				if (status!=CY_RSLT_SUCCESS)
 				{
 					break;
@@ -172,7 +172,7 @@ int main(void)
 			{
 				/* Execute the GENERATE SIGNATURE command */
 				printf("Signing the digest using the key at index %d.\n\r\n",KEY_INDEX);
-				status=wrap_sign(KEY_INDEX,data_to_sign,&signature,&signature_len);
+				status=wrap_sign(KEY_INDEX,data_to_sign,signature,&signature_len);
 				if(status!=CY_RSLT_SUCCESS)
 				{
 					break;
@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+
+/**
+ * \file bench.h
+ * \brief Blocksec2Go session against the simulated secure element shared by
+ * the host benchmarks
+ */
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/clock/clock.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/t1prime/t1prime.h"
+
+#include "test.h"
+
+/**
+ * \brief Length of key label read by GET KEY LABEL
+ */
+#define BENCH_LABEL_LEN 700
+
+/**
+ * \brief Key and data shared by the commands
+ */
+typedef struct BenchContext
+{
+	uint8_t slot; /**< Permanent key used by the commands */
+	uint8_t hash[32]; /**< Hash signed by GENERATE SIGNATURE */
+	uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN]; /**< Last signature */
+	uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN]; /**< Public key of slot */
+} BenchContext;
+
+/**
+ * \brief Command under benchmark, sends exactly one APDU
+ */
+typedef void (*bench_command_t) (Protocol *protocol, BenchContext *context);
+
+static void
+bench_select (Protocol *protocol, BenchContext *context)
+{
+	(void)context;
+	uint8_t id[BLOCK2GO_ID_LEN];
+	char version[32];
+	TEST_CHECK_SUCCESS (block2go_select_into (protocol, id, version,
+			sizeof (version)));
+}
+
+static void
+bench_get_key_info (Protocol *protocol, BenchContext *context)
+{
+	block2go_curve curve;
+	uint32_t global_counter;
+	uint32_t counter;
+	TEST_CHECK_SUCCESS (block2go_get_key_info_permanent_into (protocol,
+			context->slot, &curve, &global_counter, &counter,
+			context->public_key));
+}
+
+static void
+bench_generate_signature (Protocol *protocol, BenchContext *context)
+{
+	uint32_t global_counter;
+	uint32_t counter;
+	size_t signature_len;
+	TEST_CHECK_SUCCESS (block2go_generate_signature_permanent_into (protocol,
+			context->slot, context->hash, &global_counter, &counter,
+			context->signature, &signature_len));
+}
+
+static void
+bench_get_random (Protocol *protocol, BenchContext *context)
+{
+	(void)context;
+	uint8_t random[32];
+	TEST_CHECK_SUCCESS (block2go_get_random_into (protocol, sizeof (random),
+			random));
+}
+
+static void
+bench_verify_signature (Protocol *protocol, BenchContext *context)
+{
+	TEST_CHECK_SUCCESS (block2go_verify_signature (protocol,
+			BLOCK2GO_CURVE_NIST_P256, context->hash, sizeof (context->hash),
+			context->signature, context->public_key));
+}
+
+static void
+bench_get_key_label (Protocol *protocol, BenchContext *context)
+{
+	uint8_t label[BENCH_LABEL_LEN];
+	uint16_t label_len;
+	TEST_CHECK_SUCCESS (block2go_get_key_label_into (protocol, context->slot,
+			label, sizeof (label), &label_len));
+	TEST_CHECK (label_len == BENCH_LABEL_LEN);
+}
+
+/**
+ * \brief Commands in order of the reports
+ */
+static const struct
+{
+	const char *name; /**< Command name */
+	uint8_t ins;      /**< Instruction byte of APDU */
+	bench_command_t run; /**< Sends command */
+} bench_commands[] = {
+	{ "SELECT", 0xA4, bench_select },
+	{ "GET KEY INFO", 0x16, bench_get_key_info },
+	{ "GENERATE SIGNATURE", 0x18, bench_generate_signature },
+	{ "GET RANDOM", 0x1A, bench_get_random },
+	{ "VERIFY SIGNATURE", 0x1B, bench_verify_signature },
+	{ "GET KEY LABEL", 0x1F, bench_get_key_label },
+};
+
+/**
+ * \brief Number of entries in \ref bench_commands
+ */
+#define BENCH_COMMAND_COUNT (sizeof (bench_commands) / sizeof (bench_commands[0]))
+
+/**
+ * \brief Activates protocol stack on simulated secure element and prepares
+ * key, key label and signature used by \ref bench_commands
+ *
+ * \param protocol Protocol stack to initialize
+ * \param driver Driver layer to initialize
+ * \param config Behaviour and timing of secure element
+ * \param clock Virtual clock installed for the stack
+ * \param context Context to populate
+ */
+static void
+bench_open (Protocol *protocol, Protocol *driver, const SimSEConfig *config,
+		ClockVirtual *clock, BenchContext *context)
+{
+	TEST_CHECK_SUCCESS (sim_se_initialize_config (driver, config));
+	TEST_CHECK_SUCCESS (t1prime_initialize (protocol, driver));
+	protocol_set_clock (protocol, clock_virtual_initialize (clock, 0));
+	uint8_t *response = NULL;
+	size_t response_len;
+	TEST_CHECK_SUCCESS (protocol_activate (protocol, &response, &response_len));
+	free (response);
+
+	uint8_t label[BENCH_LABEL_LEN];
+	for (size_t i = 0; i < sizeof (label); i++)
+	{
+		label[i] = (uint8_t)i;
+	}
+	uint32_t memory;
+	memset (context, 0, sizeof (*context));
+	bench_select (protocol, context);
+	TEST_CHECK_SUCCESS (block2go_generate_key_permanent (protocol,
+			BLOCK2GO_CURVE_NIST_P256, &context->slot));
+	TEST_CHECK_SUCCESS (block2go_create_key_label (protocol, context->slot,
+			sizeof (label), &memory));
+	TEST_CHECK_SUCCESS (block2go_update_key_label (protocol, context->slot,
+			label, sizeof (label)));
+	bench_get_key_info (protocol, context);
+	bench_generate_signature (protocol, context);
+}
+
+#endif /* _BENCH_H_ */
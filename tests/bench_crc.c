@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file bench_crc.c
+ * \brief Throughput of the CRC16 engines across T=1' frame sizes
+ *
+ * \details Includes crc.c directly, so the Makefile builds this benchmark
+ * once per \ref CRC16_SLICE_BY value. Reports bytes per cycle of the
+ * configured engine and of \ref crc16_update (which additionally dispatches
+ * to the carry-less multiplication kernel) for frame sizes from 4 bytes (empty
+ * frame) to 258 bytes (frame with 254 bytes of information). Cycles are TSC
+ * cycles on x86, other hosts report bytes per nanosecond.
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "../bs2go/crc/crc.c"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycle"
+#else
+#define BENCH_UNIT "ns"
+#endif
+
+/**
+ * \brief Number of CRC calculations per timed sample
+ */
+#define BENCH_ITERATIONS 2000
+
+/**
+ * \brief Number of timed samples per frame size (fastest one is reported)
+ */
+#define BENCH_SAMPLES 50
+
+/**
+ * \brief Keeps calculated CRCs alive
+ */
+static volatile uint16_t bench_sink;
+
+/**
+ * \brief Returns current time in cycles or nanoseconds
+ */
+static uint64_t
+bench_now (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc ();
+#else
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * \brief Engine under test
+ */
+typedef uint16_t (*bench_function_t) (const uint8_t *data, size_t data_len);
+
+/**
+ * \brief Configured engine without runtime dispatch
+ */
+static uint16_t
+bench_engine (const uint8_t *data, size_t data_len)
+{
+	return crc16_reflected_update (
+			CRC16_ENGINE (crc16_table_8408, CRC16_POLYNOMIAL_CCITT), 0xffff, data,
+			data_len);
+}
+
+/**
+ * \brief Public incremental API as used by T=1'
+ */
+static uint16_t
+bench_update (const uint8_t *data, size_t data_len)
+{
+	CRC16 ctx;
+	crc16_init (&ctx, CRC16_CCITT_X25);
+	crc16_update (&ctx, data, data_len);
+	return crc16_final (&ctx);
+}
+
+/**
+ * \brief Measures bytes per cycle (or nanosecond) of engine
+ */
+static double
+bench_run (bench_function_t function, uint8_t *data, size_t data_len)
+{
+	uint64_t best = UINT64_MAX;
+	for (int sample = 0; sample < BENCH_SAMPLES; sample++)
+	{
+		uint16_t crc = 0;
+		uint64_t start = bench_now ();
+		for (int i = 0; i < BENCH_ITERATIONS; i++)
+		{
+			/* Chain frames so calculations cannot be hoisted or overlapped */
+			data[0] = (uint8_t)crc;
+			crc = function (data, data_len);
+		}
+		uint64_t duration = bench_now () - start;
+		bench_sink = crc;
+		if (duration < best)
+		{
+			best = duration;
+		}
+	}
+	return (double)data_len * BENCH_ITERATIONS / (double)best;
+}
+
+int
+main (void)
+{
+	static const size_t frame_sizes[] = { 4, 8, 16, 32, 64, 128, 192, 258 };
+	uint8_t frame[258];
+	for (size_t i = 0; i < sizeof (frame); i++)
+	{
+		frame[i] = (uint8_t)((i * 0x9d) ^ 0x5a);
+	}
+
+#if CRC16_CLMUL
+	const char *dispatch = crc16_clmul_available () ? "tables + clmul"
+													 : "tables";
+#else
+	const char *dispatch = "tables";
+#endif
+	printf ("CRC16_SLICE_BY=%d, bytes/" BENCH_UNIT "\n", CRC16_SLICE_BY);
+	printf ("%10s %12s %16s\n", "frame", "engine", dispatch);
+	for (size_t i = 0; i < sizeof (frame_sizes) / sizeof (frame_sizes[0]); i++)
+	{
+		printf ("%10zu %12.3f %16.3f\n", frame_sizes[i],
+				bench_run (bench_engine, frame, frame_sizes[i]),
+				bench_run (bench_update, frame, frame_sizes[i]));
+	}
+	return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+
+/**
+ * \file bench_labels.c
+ * \brief Reallocations per APDU while reassembling chained GET KEY LABEL
+ * responses
+ *
+ * \details Reads key labels up to \ref BLOCK2GO_KEY_LABEL_MAX_LEN through
+ * \ref protocol_transceive(Protocol*, uint8_t*, size_t, uint8_t**, size_t*),
+ * so T=1' reassembles every response chain in a buffer of the transaction
+ * allocator. A counting \ref Allocator on top of the system heap reports how
+ * often that buffer is resized per APDU. The secure element answers at most 240 bytes
+ * of label per APDU, the IFSD it acknowledges decides the number of chained
+ * I blocks per response.
+ */
+#include <stdio.h>
+
+#include "bench.h"
+
+/**
+ * \brief Number of label reads per configuration
+ */
+#define BENCH_RUNS 10
+
+/**
+ * \brief Calls into counting allocator
+ */
+typedef struct BenchCounts
+{
+	size_t allocations;   /**< Calls to allocate */
+	size_t reallocations; /**< Calls to reallocate existing memory */
+	size_t releases;      /**< Calls to release */
+} BenchCounts;
+
+static void *
+bench_allocate (void *context, size_t size)
+{
+	((BenchCounts *)context)->allocations++;
+	return malloc (size);
+}
+
+static void *
+bench_reallocate (void *context, void *ptr, size_t size)
+{
+	/* Reallocating NULL is the first allocation of a response */
+	if (ptr == NULL)
+	{
+		((BenchCounts *)context)->allocations++;
+	}
+	else
+	{
+		((BenchCounts *)context)->reallocations++;
+	}
+	return realloc (ptr, size);
+}
+
+static void
+bench_release (void *context, void *ptr)
+{
+	((BenchCounts *)context)->releases++;
+	free (ptr);
+}
+
+/**
+ * \brief Reads key label with raw GET KEY LABEL APDUs
+ *
+ * \param protocol Activated protocol stack
+ * \param slot Key to read label of
+ * \return size_t   Number of label bytes received
+ */
+static size_t
+bench_read_label (Protocol *protocol, uint8_t slot)
+{
+	const Allocator *allocator = protocol_get_transaction_allocator (protocol);
+	size_t label_len = 0;
+	uint8_t p2 = 0x00;
+	uint16_t sw = 0x6310;
+	while (sw == 0x6310)
+	{
+		uint8_t command[] = { 0x00, 0x1F, slot, p2, 0x00 };
+		uint8_t *response = NULL;
+		size_t response_len = 0;
+		TEST_CHECK_SUCCESS (protocol_transceive (protocol, command,
+				sizeof (command), &response, &response_len));
+		if (response_len < 2)
+		{
+			allocator_free (allocator, response);
+			break;
+		}
+		sw = (uint16_t)((response[response_len - 2] << 8)
+				| response[response_len - 1]);
+		label_len += response_len - 2;
+		allocator_free (allocator, response);
+		p2 = 0x01;
+	}
+	TEST_CHECK (sw == 0x9000);
+	return label_len;
+}
+
+/**
+ * \brief Measures reallocations per APDU for one label length and IFSD
+ *
+ * \param label_len Length of key label in [byte]
+ * \param ifsd IFSD acknowledged by secure element
+ */
+static void
+bench_run (size_t label_len, uint16_t ifsd)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.max_ifsd = ifsd;
+	config.bus_timing = false;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	BenchContext context;
+	bench_open (&protocol, &driver, &config, &clock, &context);
+
+	uint8_t label[BLOCK2GO_KEY_LABEL_MAX_LEN];
+	for (size_t i = 0; i < label_len; i++)
+	{
+		label[i] = (uint8_t)(i * 5);
+	}
+	uint8_t slot;
+	uint32_t memory;
+	TEST_CHECK_SUCCESS (block2go_generate_key_permanent (&protocol,
+			BLOCK2GO_CURVE_NIST_P256, &slot));
+	TEST_CHECK_SUCCESS (block2go_create_key_label (&protocol, slot,
+			(uint16_t)label_len, &memory));
+	TEST_CHECK_SUCCESS (block2go_update_key_label (&protocol, slot, label,
+			(uint16_t)label_len));
+
+	BenchCounts counts = { 0 };
+	Allocator allocator = { .allocate = bench_allocate,
+			.reallocate = bench_reallocate,
+			.release = bench_release,
+			.reset = NULL,
+			.context = &counts };
+	protocol_set_transaction_allocator (&protocol, &allocator);
+	TEST_CHECK_SUCCESS (t1prime_reset_statistics (&protocol));
+	size_t received = 0;
+	for (int run = 0; run < BENCH_RUNS; run++)
+	{
+		received += bench_read_label (&protocol, slot);
+	}
+	T1PrimeStatistics statistics;
+	TEST_CHECK_SUCCESS (t1prime_get_statistics (&protocol, &statistics));
+	TEST_CHECK (counts.allocations == counts.releases);
+	protocol_set_transaction_allocator (&protocol, NULL);
+
+	double apdus = (double)statistics.apdus;
+	printf ("%6zu %6u %8.1f %8.1f %10.2f %10.1f\n", label_len, ifsd,
+			apdus / BENCH_RUNS, (double)statistics.blocks_received / apdus,
+			(double)counts.reallocations / apdus,
+			(double)(received / BENCH_RUNS));
+	protocol_destroy (&protocol);
+}
+
+int
+main (void)
+{
+	static const size_t label_lens[] = { 256, 512, BLOCK2GO_KEY_LABEL_MAX_LEN };
+	static const uint16_t ifsds[] = { 16, 32, 64, 254 };
+
+	printf ("GET KEY LABEL response reassembly\n");
+	printf ("%6s %6s %8s %8s %10s %10s\n", "label", "IFSD", "APDUs",
+			"blocks", "reallocs", "received");
+	for (size_t i = 0; i < sizeof (label_lens) / sizeof (label_lens[0]); i++)
+	{
+		for (size_t j = 0; j < sizeof (ifsds) / sizeof (ifsds[0]); j++)
+		{
+			bench_run (label_lens[i], ifsds[j]);
+		}
+	}
+	return test_result ("bench_labels");
+}
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+
+/**
+ * \file bench_latency.c
+ * \brief Latency per APDU instruction before and after the processing time
+ * estimate has warmed up
+ *
+ * \details Runs each Blocksec2Go command against the simulated secure element
+ * on the virtual clock. The cold run starts with no learned processing time
+ * for its INS, so polling starts after MPOT and backs off. Warm runs are
+ * averaged after the EWMA in T1PrimeProtocolState::processing_time has
+ * converged, so the first poll is scheduled just before the response is
+ * ready. If that poll comes too early, the next one follows only after MPOT,
+ * which is why short commands can be slower warm than cold.
+ */
+#include <stdio.h>
+
+#include "bench.h"
+
+/**
+ * \brief Number of runs letting the estimate converge
+ */
+#define BENCH_WARMUP_RUNS 30
+
+/**
+ * \brief Number of averaged warm runs per command
+ */
+#define BENCH_RUNS 20
+
+int
+main (void)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	BenchContext context;
+	bench_open (&protocol, &driver, &config, &clock, &context);
+	T1PrimeProtocolState *protocol_state;
+	TEST_CHECK_SUCCESS (t1prime_get_protocol_state (&protocol,
+			&protocol_state));
+
+	printf ("Simulated latency per INS in [ms]\n");
+	printf ("%-20s %4s %10s %10s %10s %13s\n", "", "INS", "cold", "warm",
+			"estimate", "transactions");
+	for (size_t command = 0; command < BENCH_COMMAND_COUNT; command++)
+	{
+		uint8_t ins = bench_commands[command].ins;
+
+		/* Forget what bench_open() has learned for this INS */
+		protocol_state->processing_time[ins] = 0;
+		uint64_t start = clock.now;
+		bench_commands[command].run (&protocol, &context);
+		double cold = (double)(clock.now - start) / 1000.0;
+
+		for (int run = 0; run < BENCH_WARMUP_RUNS; run++)
+		{
+			bench_commands[command].run (&protocol, &context);
+		}
+		TEST_CHECK (protocol_state->processing_time[ins] != 0);
+		TEST_CHECK_SUCCESS (t1prime_reset_statistics (&protocol));
+		start = clock.now;
+		for (int run = 0; run < BENCH_RUNS; run++)
+		{
+			bench_commands[command].run (&protocol, &context);
+		}
+		double warm = (double)(clock.now - start) / 1000.0 / BENCH_RUNS;
+		T1PrimeStatistics statistics;
+		TEST_CHECK_SUCCESS (t1prime_get_statistics (&protocol, &statistics));
+
+		printf ("%-20s %4.2X %10.2f %10.2f %10.2f %13.1f\n",
+				bench_commands[command].name, ins, cold, warm,
+				(double)protocol_state->processing_time[ins] / 10.0,
+				(double)statistics.transactions / (double)statistics.apdus);
+	}
+	protocol_destroy (&protocol);
+	return test_result ("bench_latency");
+}
@@ -0,0 +1,104 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+
+/**
+ * \file bench_link.c
+ * \brief Wire-time model of Blocksec2Go commands per I2C clock frequency
+ *
+ * \details Runs each command against the simulated secure element with bus
+ * timing enabled (9 clocks per byte plus address byte) and reports the
+ * simulated time per APDU. The secure element announces the respective
+ * frequency as MCF in its CIP, so 100 kHz models a bus that never leaves the
+ * frequency of i2c_init() and 1 MHz a bus running at the negotiated
+ * Fast-mode Plus.
+ */
+#include <stdio.h>
+
+#include "bench.h"
+
+/**
+ * \brief Number of runs per command
+ */
+#define BENCH_RUNS 20
+
+/**
+ * \brief Measures simulated milliseconds per APDU of every command
+ *
+ * \param mcf Maximum clock frequency announced by secure element in [kHz]
+ * \param ms_per_apdu Buffer to store results in, one per command
+ */
+static void
+bench_run (uint16_t mcf, double ms_per_apdu[BENCH_COMMAND_COUNT])
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.mcf = mcf;
+	config.bus_timing = true;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	BenchContext context;
+	bench_open (&protocol, &driver, &config, &clock, &context);
+	for (size_t command = 0; command < BENCH_COMMAND_COUNT; command++)
+	{
+		SimSEStatistics before;
+		SimSEStatistics after;
+		TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &before));
+		uint64_t start = clock.now;
+		for (int run = 0; run < BENCH_RUNS; run++)
+		{
+			bench_commands[command].run (&protocol, &context);
+		}
+		TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &after));
+		ms_per_apdu[command] = (double)(clock.now - start) / 1000.0
+				/ (double)(after.apdus - before.apdus);
+	}
+	protocol_destroy (&protocol);
+}
+
+int
+main (void)
+{
+	static const uint16_t frequencies[] = { 100, 400, 1000 };
+	double results[sizeof (frequencies) / sizeof (frequencies[0])]
+			[BENCH_COMMAND_COUNT];
+	for (size_t i = 0; i < sizeof (frequencies) / sizeof (frequencies[0]); i++)
+	{
+		bench_run (frequencies[i], results[i]);
+	}
+
+	printf ("Simulated ms/APDU per I2C clock frequency\n");
+	printf ("%-20s %10s %10s %10s\n", "", "100 kHz", "400 kHz", "1 MHz");
+	for (size_t command = 0; command < BENCH_COMMAND_COUNT; command++)
+	{
+		printf ("%-20s %10.1f %10.1f %10.1f\n", bench_commands[command].name,
+				results[0][command], results[1][command], results[2][command]);
+	}
+	return test_result ("bench_link");
+}
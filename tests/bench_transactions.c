@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+
+/**
+ * \file bench_transactions.c
+ * \brief Bus transactions and bytes per APDU with and without coalesced
+ * frame reads
+ *
+ * \details Runs each Blocksec2Go command against the simulated secure element
+ * and reports \ref T1PrimeStatistics per APDU, once reading NAD, prologue
+ * and information field in separate transactions and once with \ref
+ * t1prime_set_coalesced_read(Protocol*, bool) enabled. Every command runs
+ * once before measuring, so the coalesced read hint is warm. Transactions
+ * include polls not acknowledged while the secure element is busy.
+ */
+#include <stdio.h>
+
+#include "bench.h"
+
+/**
+ * \brief Number of runs per command
+ */
+#define BENCH_RUNS 20
+
+/**
+ * \brief Statistics per APDU of one command
+ */
+typedef struct BenchResult
+{
+	double transactions; /**< Bus transactions per APDU */
+	double bytes_written; /**< Bytes written per APDU */
+	double bytes_read; /**< Bytes read per APDU */
+} BenchResult;
+
+/**
+ * \brief Measures bus statistics per APDU of every command
+ *
+ * \param coalesced Whether to enable coalesced frame reads
+ * \param results Buffer to store results in, one per command
+ */
+static void
+bench_run (bool coalesced, BenchResult results[BENCH_COMMAND_COUNT])
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	BenchContext context;
+	bench_open (&protocol, &driver, &config, &clock, &context);
+	TEST_CHECK_SUCCESS (t1prime_set_coalesced_read (&protocol, coalesced));
+	for (size_t command = 0; command < BENCH_COMMAND_COUNT; command++)
+	{
+		bench_commands[command].run (&protocol, &context);
+		TEST_CHECK_SUCCESS (t1prime_reset_statistics (&protocol));
+		for (int run = 0; run < BENCH_RUNS; run++)
+		{
+			bench_commands[command].run (&protocol, &context);
+		}
+		T1PrimeStatistics statistics;
+		TEST_CHECK_SUCCESS (t1prime_get_statistics (&protocol, &statistics));
+		double apdus = (double)statistics.apdus;
+		results[command].transactions = (double)statistics.transactions / apdus;
+		results[command].bytes_written = (double)statistics.bytes_written
+				/ apdus;
+		results[command].bytes_read = (double)statistics.bytes_read / apdus;
+	}
+	protocol_destroy (&protocol);
+}
+
+int
+main (void)
+{
+	BenchResult split[BENCH_COMMAND_COUNT];
+	BenchResult coalesced[BENCH_COMMAND_COUNT];
+	bench_run (false, split);
+	bench_run (true, coalesced);
+
+	printf ("Bus transactions and bytes (written + read) per APDU\n");
+	printf ("%-20s %22s %22s\n", "", "split", "coalesced");
+	for (size_t command = 0; command < BENCH_COMMAND_COUNT; command++)
+	{
+		printf ("%-20s %6.1f %7.1f + %6.1f %6.1f %7.1f + %6.1f\n",
+				bench_commands[command].name, split[command].transactions,
+				split[command].bytes_written, split[command].bytes_read,
+				coalesced[command].transactions, coalesced[command].bytes_written,
+				coalesced[command].bytes_read);
+	}
+	return test_result ("bench_transactions");
+}
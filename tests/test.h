@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test.h
+ * \brief Minimal helpers shared by the host tests
+ */
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <stdio.h>
+
+/**
+ * \brief Number of failed checks of the running test program
+ */
+static int test_failures = 0;
+
+/**
+ * \brief Checks that expression is true, reports location otherwise
+ */
+#define TEST_CHECK(expression)                                                 \
+	do                                                                         \
+	{                                                                          \
+		if (!(expression))                                                     \
+		{                                                                      \
+			printf ("%s:%d: check failed: %s\n", __FILE__, __LINE__,          \
+					#expression);                                              \
+			test_failures++;                                                   \
+		}                                                                      \
+	} while (0)
+
+/**
+ * \brief Checks that call returned status code 0 (SUCCESS)
+ */
+#define TEST_CHECK_SUCCESS(call)                                               \
+	do                                                                         \
+	{                                                                          \
+		int test_status = (call);                                              \
+		if (test_status != 0)                                                  \
+		{                                                                      \
+			printf ("%s:%d: %s returned 0x%08x\n", __FILE__, __LINE__, #call,  \
+					(unsigned int)test_status);                                \
+			test_failures++;                                                   \
+		}                                                                      \
+	} while (0)
+
+/**
+ * \brief Prints summary of test program
+ *
+ * \param name Name of test program
+ * \return int   Exit code of test program
+ */
+static inline int
+test_result (const char *name)
+{
+	printf ("%s: %s (%d failed checks)\n", name,
+			(test_failures == 0) ? "PASSED" : "FAILED", test_failures);
+	return (test_failures == 0) ? 0 : 1;
+}
+
+#endif /* _TEST_H_ */
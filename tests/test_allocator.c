@@ -0,0 +1,231 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_allocator.c
+ * \brief Bump arena edge cases and heap-free steady state signing
+ *
+ * \details Linked with `-Wl,--wrap` for `malloc()`, `realloc()`, `calloc()`
+ * and `free()` so every system heap call of the protocol stack is counted.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/allocator/allocator.h"
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/clock/clock.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+
+#include "test.h"
+
+/**
+ * \brief Number of signatures of each kind in steady state loop
+ */
+#define TEST_ALLOCATOR_SIGNATURES 20
+
+/**
+ * \brief Number of system heap calls while counting is enabled
+ */
+static size_t heap_calls = 0;
+
+/**
+ * \brief Whether system heap calls are counted
+ */
+static bool heap_counting = false;
+
+void *__real_malloc (size_t size);
+void *__real_realloc (void *ptr, size_t size);
+void *__real_calloc (size_t count, size_t size);
+void __real_free (void *ptr);
+
+void *
+__wrap_malloc (size_t size)
+{
+	heap_calls += heap_counting ? 1 : 0;
+	return __real_malloc (size);
+}
+
+void *
+__wrap_realloc (void *ptr, size_t size)
+{
+	heap_calls += heap_counting ? 1 : 0;
+	return __real_realloc (ptr, size);
+}
+
+void *
+__wrap_calloc (size_t count, size_t size)
+{
+	heap_calls += heap_counting ? 1 : 0;
+	return __real_calloc (count, size);
+}
+
+void
+__wrap_free (void *ptr)
+{
+	heap_calls += heap_counting ? 1 : 0;
+	__real_free (ptr);
+}
+
+/**
+ * \brief Checks in place resizing, moves, releases, exhaustion and reset
+ */
+static void
+check_arena (void)
+{
+	static uint64_t memory[32];
+	AllocatorArena arena;
+	const Allocator *allocator = allocator_arena_initialize (&arena, memory,
+			sizeof (memory));
+
+	/* Resizing most recent block keeps it in place */
+	uint8_t *first = allocator_malloc (allocator, 10);
+	TEST_CHECK (first != NULL);
+	TEST_CHECK (((uintptr_t)first % ALLOCATOR_ARENA_ALIGNMENT) == 0);
+	memset (first, 0x11, 10);
+	size_t used = arena.used;
+	uint8_t *grown = allocator_realloc (allocator, first, 40);
+	TEST_CHECK (grown == first);
+	TEST_CHECK (arena.used > used);
+	used = arena.used;
+	uint8_t *shrunk = allocator_realloc (allocator, grown, 4);
+	TEST_CHECK (shrunk == first);
+	TEST_CHECK (arena.used < used);
+	TEST_CHECK (first[3] == 0x11);
+
+	/* Resizing older block moves it and keeps its content */
+	uint8_t *second = allocator_malloc (allocator, 16);
+	TEST_CHECK (second != NULL);
+	memset (second, 0x22, 16);
+	uint8_t *moved = allocator_realloc (allocator, first, 24);
+	TEST_CHECK ((moved != NULL) && (moved != first) && (moved > second));
+	TEST_CHECK ((moved != NULL) && (moved[0] == 0x11) && (moved[3] == 0x11));
+	TEST_CHECK (second[15] == 0x22);
+
+	/* Releasing older block does not give back memory */
+	used = arena.used;
+	allocator_free (allocator, second);
+	TEST_CHECK (arena.used == used);
+
+	/* Releasing most recent block does */
+	allocator_free (allocator, moved);
+	TEST_CHECK (arena.used < used);
+
+	/* Exhaustion returns NULL and leaves arena usable */
+	used = arena.used;
+	TEST_CHECK (allocator_malloc (allocator, sizeof (memory)) == NULL);
+	TEST_CHECK (arena.used == used);
+	uint8_t *last = allocator_malloc (allocator, 8);
+	TEST_CHECK (last != NULL);
+	TEST_CHECK (allocator_realloc (allocator, last, sizeof (memory)) == NULL);
+	TEST_CHECK (allocator_malloc (allocator, SIZE_MAX - 4) == NULL);
+
+	/* Reset gives back everything, peak is kept */
+	size_t peak = arena.peak;
+	allocator_reset (allocator);
+	TEST_CHECK (arena.used == 0);
+	TEST_CHECK (arena.peak == peak);
+	TEST_CHECK (allocator_malloc (allocator, 8) == first);
+	allocator_arena_reset (&arena);
+	TEST_CHECK (arena.used == 0);
+}
+
+/**
+ * \brief Signs on simulated secure element with arena as transaction
+ * allocator and counts system heap calls
+ */
+static void
+check_steady_state (void)
+{
+	static uint64_t memory[512];
+	AllocatorArena arena;
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	TEST_CHECK_SUCCESS (sim_se_initialize (&driver));
+	TEST_CHECK_SUCCESS (t1prime_initialize (&protocol, &driver));
+	protocol_set_clock (&protocol, clock_virtual_initialize (&clock, 0));
+	protocol_set_transaction_allocator (&protocol,
+			allocator_arena_initialize (&arena, memory, sizeof (memory)));
+
+	/* Long-lived memory still comes from the (counted) system heap */
+	uint8_t *response = NULL;
+	size_t response_len;
+	heap_counting = true;
+	TEST_CHECK_SUCCESS (protocol_activate (&protocol, &response, &response_len));
+	heap_counting = false;
+	TEST_CHECK (heap_calls > 0);
+	allocator_free (protocol_get_transaction_allocator (&protocol), response);
+
+	uint8_t slot;
+	TEST_CHECK_SUCCESS (block2go_generate_key_permanent (&protocol,
+			BLOCK2GO_CURVE_NIST_P256, &slot));
+
+	/* Warm up: frame buffers and protocol states are allocated once */
+	uint8_t hash[32] = { 0 };
+	uint32_t global_counter;
+	uint32_t counter;
+	uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN];
+	size_t signature_len;
+	TEST_CHECK_SUCCESS (block2go_generate_signature_permanent_into (&protocol,
+			slot, hash, &global_counter, &counter, signature, &signature_len));
+
+	heap_calls = 0;
+	heap_counting = true;
+	for (int i = 0; i < TEST_ALLOCATOR_SIGNATURES; i++)
+	{
+		hash[0] = (uint8_t)i;
+		TEST_CHECK_SUCCESS (block2go_generate_signature_permanent_into (
+				&protocol, slot, hash, &global_counter, &counter, signature,
+				&signature_len));
+
+		uint8_t *allocated = NULL;
+		size_t allocated_len;
+		TEST_CHECK_SUCCESS (block2go_generate_signature_permanent (&protocol,
+				slot, hash, &global_counter, &counter, &allocated,
+				&allocated_len));
+		TEST_CHECK ((allocated >= (uint8_t *)memory)
+				&& (allocated < (uint8_t *)memory + sizeof (memory)));
+		allocator_free (protocol_get_transaction_allocator (&protocol),
+				allocated);
+	}
+	heap_counting = false;
+	TEST_CHECK (heap_calls == 0);
+	printf ("steady state: %zu system heap calls for %d signatures, arena "
+			"peak %zu bytes\n",
+			heap_calls, 2 * TEST_ALLOCATOR_SIGNATURES, arena.peak);
+
+	protocol_destroy (&protocol);
+}
+
+int
+main (void)
+{
+	check_arena ();
+	check_steady_state ();
+	return test_result ("test_allocator");
+}
@@ -0,0 +1,237 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_apdu.c
+ * \brief Round-trip fuzzer for APDU encoding and decoding
+ *
+ * \details Encodes random short and extended length APDUs of all ISO7816-3
+ * cases and checks that \ref apdu_encode, \ref apdu_encode_into and \ref
+ * apdu_encoded_size agree and that decoding restores the APDU. Random bytes
+ * are decoded as well, any successfully decoded APDU must survive another
+ * round trip.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/apdu/apdu.h"
+
+#include "test.h"
+
+/**
+ * \brief Number of random APDUs per check
+ */
+#define TEST_APDU_ROUNDS 20000
+
+/**
+ * \brief Largest encoded APDU (Case 4E with 0xffff bytes of data)
+ */
+#define TEST_APDU_MAX_LEN (4 + 3 + 0xffff + 2)
+
+/**
+ * \brief State of xorshift pseudo random number generator
+ */
+static uint32_t random_state = 0x9e3779b9;
+
+/**
+ * \brief Returns next pseudo random number
+ */
+static uint32_t
+random_next (void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+/**
+ * \brief Returns random length, favouring the short / extended boundaries
+ *
+ * \param limit Largest length to be returned
+ */
+static size_t
+random_length (size_t limit)
+{
+	static const size_t boundaries[] = { 0, 1, 0xfe, 0xff, 0x100, 0x101,
+		0xfffe, 0xffff, 0x10000 };
+	size_t length;
+	switch (random_next () % 4)
+	{
+	case 0:
+		length = boundaries[random_next ()
+				% (sizeof (boundaries) / sizeof (boundaries[0]))];
+		break;
+	case 1:
+		length = random_next () % 0x100;
+		break;
+	case 2:
+		length = random_next () % 0x400;
+		break;
+	default:
+		length = random_next () % (limit + 1);
+		break;
+	}
+	return (length > limit) ? limit : length;
+}
+
+/**
+ * \brief Checks that both encoders agree and decoding restores   apdu
+ */
+static void
+check_round_trip (APDU *apdu)
+{
+	static uint8_t encoded_into[TEST_APDU_MAX_LEN];
+	size_t encoded_size = apdu_encoded_size (apdu);
+	TEST_CHECK (encoded_size <= sizeof (encoded_into));
+
+	uint8_t *encoded = NULL;
+	size_t encoded_len = 0;
+	TEST_CHECK_SUCCESS (apdu_encode (apdu, &encoded, &encoded_len));
+	TEST_CHECK (encoded_len == encoded_size);
+
+	size_t encoded_into_len = 0;
+	TEST_CHECK_SUCCESS (apdu_encode_into (apdu, encoded_into,
+			sizeof (encoded_into), &encoded_into_len));
+	TEST_CHECK (encoded_into_len == encoded_size);
+	TEST_CHECK ((encoded != NULL)
+			&& (memcmp (encoded, encoded_into, encoded_size) == 0));
+
+	/* Buffer one byte too small must be refused */
+	if (encoded_size > 0)
+	{
+		TEST_CHECK (apdu_encode_into (apdu, encoded_into, encoded_size - 1,
+				&encoded_into_len) != APDU_ENCODE_SUCCESS);
+	}
+
+	/* Short length encodings only if both LC and LE allow it */
+	bool extended_length = (apdu->lc > 0xff) || (apdu->le > APDU_LE_ANY);
+	TEST_CHECK (extended_length || (encoded_size <= APDU_SHORT_MAX_LEN));
+
+	APDU decoded;
+	memset (&decoded, 0, sizeof (decoded));
+	decoded.allocator = apdu->allocator;
+	TEST_CHECK_SUCCESS (apdu_decode (&decoded, encoded, encoded_len));
+	TEST_CHECK (decoded.cla == apdu->cla);
+	TEST_CHECK (decoded.ins == apdu->ins);
+	TEST_CHECK (decoded.p1 == apdu->p1);
+	TEST_CHECK (decoded.p2 == apdu->p2);
+	TEST_CHECK (decoded.lc == apdu->lc);
+	TEST_CHECK (decoded.le == apdu->le);
+	TEST_CHECK ((apdu->lc == 0)
+			|| ((decoded.data != NULL)
+					&& (memcmp (decoded.data, apdu->data, apdu->lc) == 0)));
+
+	apdu_destroy (&decoded);
+	allocator_free (apdu->allocator, encoded);
+}
+
+/**
+ * \brief Round trip of random valid APDUs
+ */
+static void
+check_valid (void)
+{
+	static uint8_t data[0xffff];
+	for (size_t i = 0; i < sizeof (data); i++)
+	{
+		data[i] = (uint8_t)random_next ();
+	}
+
+	for (int round = 0; round < TEST_APDU_ROUNDS; round++)
+	{
+		APDU apdu;
+		memset (&apdu, 0, sizeof (apdu));
+		uint32_t header = random_next ();
+		apdu.cla = (uint8_t)header;
+		apdu.ins = (uint8_t)(header >> 8);
+		apdu.p1 = (uint8_t)(header >> 16);
+		apdu.p2 = (uint8_t)(header >> 24);
+
+		/* LC is limited to 0xffff, LE may use the 0x10000 special case */
+		switch (random_next () % 4)
+		{
+		case 0: /* Case 1 */
+			break;
+		case 1: /* Case 2 */
+			apdu.le = random_length (APDU_LE_ANY_EXTENDED);
+			break;
+		case 2: /* Case 3 */
+			apdu.lc = random_length (0xffff);
+			break;
+		default: /* Case 4 */
+			apdu.lc = random_length (0xffff);
+			apdu.le = random_length (APDU_LE_ANY_EXTENDED);
+			break;
+		}
+		apdu.data = (apdu.lc > 0) ? data + (random_next () % (sizeof (data)
+				- apdu.lc + 1)) : NULL;
+		check_round_trip (&apdu);
+	}
+}
+
+/**
+ * \brief Decodes random bytes and re-encodes anything accepted
+ */
+static void
+check_random (void)
+{
+	static uint8_t buffer[0x200];
+	size_t accepted = 0;
+	for (int round = 0; round < TEST_APDU_ROUNDS; round++)
+	{
+		size_t buffer_len = random_next () % sizeof (buffer);
+		for (size_t i = 0; i < buffer_len; i++)
+		{
+			buffer[i] = (uint8_t)random_next ();
+		}
+		/* Plausible length fields make accepted inputs more likely */
+		if ((buffer_len > 4) && (random_next () % 2))
+		{
+			buffer[4] = (uint8_t)(buffer_len - 5 - (random_next () % 3));
+		}
+
+		APDU apdu;
+		memset (&apdu, 0, sizeof (apdu));
+		if (apdu_decode (&apdu, buffer, buffer_len) == APDU_DECODE_SUCCESS)
+		{
+			accepted++;
+			check_round_trip (&apdu);
+			apdu_destroy (&apdu);
+		}
+	}
+	printf ("random bytes: %zu of %d inputs decoded\n", accepted,
+			TEST_APDU_ROUNDS);
+	TEST_CHECK (accepted > 0);
+}
+
+int
+main (void)
+{
+	check_valid ();
+	check_random ();
+	return test_result ("test_apdu");
+}
@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+
+
+/**
+ * \file test_blocksec2go.c
+ * \brief Blocksec2Go commands against malformed secure element responses
+ *
+ * \details A scripted protocol layer answers every APDU with the same
+ * response, so commands can be checked against answers the simulated
+ * secure element never gives.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/protocol/protocol.h"
+
+#include "test.h"
+
+/**
+ * \brief APDUs answered by scripted layer before it fails (ends endless
+ * loops)
+ */
+#define SCRIPT_MAX_APDUS 100
+
+/**
+ * \brief Response returned for every APDU
+ */
+static const uint8_t *script_response;
+
+/**
+ * \brief Number of bytes in \ref script_response
+ */
+static size_t script_response_len;
+
+/**
+ * \brief Number of APDUs received by scripted layer
+ */
+static size_t script_apdus;
+
+/**
+ * \brief \ref protocol_transceivefunction_t answering with scripted response
+ */
+static int
+script_transceive (Protocol *self, uint8_t *data, size_t data_len,
+		uint8_t **response, size_t *response_len)
+{
+	(void)data;
+	(void)data_len;
+	if ((++script_apdus) > SCRIPT_MAX_APDUS)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE, INVALID_STATE);
+	}
+	*response = (uint8_t *)allocator_malloc (
+			protocol_get_transaction_allocator (self), script_response_len);
+	if (*response == NULL)
+	{
+		return IFX_ERROR (LIBPROTOCOL, PROTOCOL_TRANSCEIVE, OUT_OF_MEMORY);
+	}
+	memcpy (*response, script_response, script_response_len);
+	*response_len = script_response_len;
+	return PROTOCOL_TRANSCEIVE_SUCCESS;
+}
+
+/**
+ * \brief Initializes scripted layer answering with given response
+ */
+static void
+script_initialize (Protocol *protocol, const uint8_t *response,
+		size_t response_len)
+{
+	TEST_CHECK_SUCCESS (protocollayer_initialize (protocol));
+	protocol->_transceive = script_transceive;
+	script_response = response;
+	script_response_len = response_len;
+	script_apdus = 0;
+}
+
+/**
+ * \brief Checks GET KEY LABEL against occurrences without label data
+ */
+static void
+check_get_key_label (void)
+{
+	Protocol protocol;
+	uint8_t label[BLOCK2GO_KEY_LABEL_MAX_LEN];
+	uint16_t label_len;
+
+	/* Empty occurrence announcing more (6310) must not loop forever */
+	static const uint8_t empty_more[] = { 0xDF, 0x1F, 0x00, 0x63, 0x10 };
+	script_initialize (&protocol, empty_more, sizeof (empty_more));
+	TEST_CHECK (block2go_get_key_label_into (&protocol, 1, label,
+			sizeof (label), &label_len)
+			== (int)BLOCK2GO_GET_KEY_LABEL_INVALID_DATA_LENGTH);
+	TEST_CHECK (script_apdus == 1);
+	protocol_destroy (&protocol);
+
+	/* Empty last occurrence is an empty label */
+	static const uint8_t empty_last[] = { 0xDF, 0x1F, 0x00, 0x90, 0x00 };
+	script_initialize (&protocol, empty_last, sizeof (empty_last));
+	TEST_CHECK_SUCCESS (block2go_get_key_label_into (&protocol, 1, label,
+			sizeof (label), &label_len));
+	TEST_CHECK (label_len == 0);
+	TEST_CHECK (script_apdus == 1);
+	protocol_destroy (&protocol);
+
+	/* Label data keeps being delivered up to the buffer size */
+	static const uint8_t full_more[] = { 0xDF, 0x1F, 0x02, 0x41, 0x42, 0x63,
+			0x10 };
+	script_initialize (&protocol, full_more, sizeof (full_more));
+	TEST_CHECK (block2go_get_key_label_into (&protocol, 1, label, 8,
+			&label_len) == (int)BLOCK2GO_GET_KEY_LABEL_INVALID_DATA_LENGTH);
+	TEST_CHECK (script_apdus == 5);
+	protocol_destroy (&protocol);
+}
+
+int
+main (void)
+{
+	check_get_key_label ();
+	return test_result ("test_blocksec2go");
+}
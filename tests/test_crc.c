@@ -0,0 +1,223 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_crc.c
+ * \brief Conformance of the CRC16 engines against a bit-serial reference
+ *
+ * \details Includes crc.c directly to reach the internal engines, so the
+ * Makefile builds this test once per \ref CRC16_SLICE_BY value. Random
+ * lengths, start values, alignments and split points are checked for the
+ * configured table engine, the carry-less multiplication kernel (if
+ * available) and the incremental API.
+ */
+#include <string.h>
+
+#include "../bs2go/crc/crc.c"
+
+#include "test.h"
+
+/**
+ * \brief Largest random input length in bytes
+ */
+#define TEST_CRC_MAX_LEN 8192
+
+/**
+ * \brief Number of random inputs per check
+ */
+#define TEST_CRC_ROUNDS 2000
+
+/**
+ * \brief State of xorshift pseudo random number generator
+ */
+static uint32_t random_state = 0x2545f491;
+
+/**
+ * \brief Returns next pseudo random number
+ */
+static uint32_t
+random_next (void)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+/**
+ * \brief Bit-serial reference of reflected 16 bit CRC register update
+ */
+static uint16_t
+reference_update (uint16_t polynomial, uint16_t crc, const uint8_t *data,
+		size_t data_len)
+{
+	for (size_t i = 0; i < data_len; i++)
+	{
+		crc ^= data[i];
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ polynomial)
+							: (uint16_t)(crc >> 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * \brief Reference CRC of complete input for algorithm
+ */
+static uint16_t
+reference_crc (crc16_algorithm algorithm, const uint8_t *data,
+		size_t data_len)
+{
+	if (algorithm == CRC16_T1GD)
+	{
+		return reference_update (CRC16_POLYNOMIAL_T1GD, 0xffff, data, data_len);
+	}
+	uint16_t crc = reference_update (CRC16_POLYNOMIAL_CCITT, 0xffff, data,
+			data_len);
+	return (algorithm == CRC16_CCITT_X25) ? (uint16_t)(crc ^ 0xffff) : crc;
+}
+
+/**
+ * \brief Checks published check values over "123456789"
+ */
+static void
+check_values (void)
+{
+	uint8_t check[] = "123456789";
+	TEST_CHECK (crc16_ccitt_x25 (check, 9) == 0x906e);
+	TEST_CHECK (crc16_mcrf4xx (check, 9) == 0x6f91);
+	TEST_CHECK (crc16_t1gd (check, 9) == reference_crc (CRC16_T1GD, check, 9));
+	TEST_CHECK (lrc8 (check, 9) == 0x31);
+}
+
+/**
+ * \brief Compares internal engines with reference for random inputs
+ */
+static void
+check_engines (uint8_t *buffer)
+{
+#if CRC16_CLMUL
+	/* Kernel must be used wherever the CPU supports it */
+	__builtin_cpu_init ();
+	bool clmul = crc16_clmul_available ();
+	TEST_CHECK (clmul
+			== (__builtin_cpu_supports ("sse2")
+					&& __builtin_cpu_supports ("pclmul")));
+	printf ("CRC16_SLICE_BY=%d, carry-less multiplication %s\n", CRC16_SLICE_BY,
+			clmul ? "available" : "unavailable");
+#else
+	printf ("CRC16_SLICE_BY=%d, carry-less multiplication disabled\n",
+			CRC16_SLICE_BY);
+#endif
+	for (int round = 0; round < TEST_CRC_ROUNDS; round++)
+	{
+		/* Favour short frames but reach the largest length as well */
+		size_t data_len = (round < TEST_CRC_ROUNDS / 2)
+				? random_next () % 300
+				: random_next () % (TEST_CRC_MAX_LEN + 1);
+		const uint8_t *data = buffer + (random_next () % 16);
+		uint16_t crc = (uint16_t)random_next ();
+
+		uint16_t expected = reference_update (CRC16_POLYNOMIAL_CCITT, crc, data,
+				data_len);
+		TEST_CHECK (crc16_reflected_update (
+				CRC16_ENGINE (crc16_table_8408, CRC16_POLYNOMIAL_CCITT), crc, data,
+				data_len) == expected);
+#if CRC16_CLMUL
+		if (clmul && (data_len >= 16))
+		{
+			TEST_CHECK (crc16_clmul_update (crc, data, data_len) == expected);
+		}
+#endif
+		TEST_CHECK (crc16_reflected_update (
+				CRC16_ENGINE (crc16_table_0408, CRC16_POLYNOMIAL_T1GD), crc, data,
+				data_len)
+				== reference_update (CRC16_POLYNOMIAL_T1GD, crc, data, data_len));
+	}
+}
+
+/**
+ * \brief Compares incremental API split at random points with reference
+ */
+static void
+check_incremental (uint8_t *buffer)
+{
+	for (int round = 0; round < TEST_CRC_ROUNDS; round++)
+	{
+		crc16_algorithm algorithm = (crc16_algorithm)(random_next () % 3);
+		size_t data_len = random_next () % (TEST_CRC_MAX_LEN + 1);
+		const uint8_t *data = buffer + (random_next () % 16);
+
+		CRC16 ctx;
+		crc16_init (&ctx, algorithm);
+		size_t offset = 0;
+		while (offset < data_len)
+		{
+			/* Mix parts around the carry-less multiplication threshold */
+			size_t part = (random_next () % 2)
+					? random_next () % 64
+					: random_next () % (data_len - offset + 1);
+			if (part > data_len - offset)
+			{
+				part = data_len - offset;
+			}
+			crc16_update (&ctx, data + offset, part);
+			offset += part;
+		}
+		uint16_t expected = reference_crc (algorithm, data, data_len);
+		TEST_CHECK (crc16_final (&ctx) == expected);
+
+		/* One-shot functions use the same engines */
+		if (algorithm == CRC16_CCITT_X25)
+		{
+			TEST_CHECK (crc16_ccitt_x25 ((uint8_t *)data, data_len) == expected);
+		}
+		else if (algorithm == CRC16_MCRF4XX)
+		{
+			TEST_CHECK (crc16_mcrf4xx ((uint8_t *)data, data_len) == expected);
+		}
+		else
+		{
+			TEST_CHECK (crc16_t1gd ((uint8_t *)data, data_len) == expected);
+		}
+	}
+}
+
+int
+main (void)
+{
+	static uint8_t buffer[TEST_CRC_MAX_LEN + 16];
+	for (size_t i = 0; i < sizeof (buffer); i++)
+	{
+		buffer[i] = (uint8_t)random_next ();
+	}
+	check_values ();
+	check_engines (buffer);
+	check_incremental (buffer);
+	return test_result ("test_crc");
+}
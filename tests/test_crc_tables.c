@@ -0,0 +1,145 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_crc_tables.c
+ * \brief Rebuilds the CRC16 lookup tables and compares them with crc.c
+ *
+ * \details The tables in crc.c are constant data so they end up in ROM, and
+ * the C preprocessor cannot derive them without exponential expansion. They
+ * are generated by this program instead:
+ *
+ *     make -C tests build/test_crc_tables
+ *     tests/build/test_crc_tables -p
+ *
+ * prints the initializers of both tables in the layout used by crc.c.
+ * Without arguments it checks that crc.c still holds the generated values.
+ */
+#include <string.h>
+
+#define CRC16_SLICE_BY 8
+#include "../bs2go/crc/crc.c"
+
+#include "test.h"
+
+/**
+ * \brief Generates lookup tables for reflected polynomial
+ *
+ * \param polynomial Reflected CRC polynomial
+ * \param table Tables to be generated (slice-by-8)
+ */
+static void
+tables_generate (uint16_t polynomial, uint16_t table[8][256])
+{
+	for (unsigned int i = 0; i < 256; i++)
+	{
+		uint16_t crc = (uint16_t)i;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ polynomial)
+							: (uint16_t)(crc >> 1);
+		}
+		table[0][i] = crc;
+	}
+	for (int k = 1; k < 8; k++)
+	{
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			table[k][i] = (table[k - 1][i] >> 8)
+					^ table[0][table[k - 1][i] & 0xff];
+		}
+	}
+}
+
+/**
+ * \brief Prints table initializer in the layout of crc.c
+ *
+ * \param polynomial Reflected CRC polynomial
+ * \param table Generated tables (slice-by-8)
+ */
+static void
+tables_print (uint16_t polynomial, uint16_t table[8][256])
+{
+	printf ("static const uint16_t crc16_table_%04x[CRC16_TABLE_COUNT][256] "
+			"= {\n",
+			polynomial);
+	for (int k = 0; k < 8; k++)
+	{
+		if (k == 1)
+		{
+			printf ("#if CRC16_SLICE_BY >= 4\n");
+		}
+		else if (k == 4)
+		{
+			printf ("#endif\n#if CRC16_SLICE_BY >= 8\n");
+		}
+		printf ("\t{\n");
+		for (int i = 0; i < 256; i++)
+		{
+			printf ("%s0x%04x,%s", ((i % 8) == 0) ? "\t\t" : " ", table[k][i],
+					((i % 8) == 7) ? "\n" : "");
+		}
+		printf ("\t},\n");
+	}
+	printf ("#endif\n};\n");
+}
+
+int
+main (int argc, char **argv)
+{
+	static uint16_t table_8408[8][256];
+	static uint16_t table_0408[8][256];
+	tables_generate (CRC16_POLYNOMIAL_CCITT, table_8408);
+	tables_generate (CRC16_POLYNOMIAL_T1GD, table_0408);
+
+	if ((argc > 1) && (strcmp (argv[1], "-p") == 0))
+	{
+		tables_print (CRC16_POLYNOMIAL_CCITT, table_8408);
+		printf ("\n");
+		tables_print (CRC16_POLYNOMIAL_T1GD, table_0408);
+		return 0;
+	}
+
+	for (int k = 0; k < 8; k++)
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			if (crc16_table_8408[k][i] != table_8408[k][i])
+			{
+				printf ("crc16_table_8408[%d][%d] is 0x%04x, expected 0x%04x\n",
+						k, i, crc16_table_8408[k][i], table_8408[k][i]);
+				test_failures++;
+			}
+			if (crc16_table_0408[k][i] != table_0408[k][i])
+			{
+				printf ("crc16_table_0408[%d][%d] is 0x%04x, expected 0x%04x\n",
+						k, i, crc16_table_0408[k][i], table_0408[k][i]);
+				test_failures++;
+			}
+		}
+	}
+	return test_result ("test_crc_tables");
+}
@@ -0,0 +1,448 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_replay.c
+ * \brief Records session against simulated secure element and replays it
+ *
+ * \details Captures traffic with the trace layer, dumps the trace into memory
+ * and replays it in the same process at different time scales. The replayed
+ * session must produce the same responses as the recorded one.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/clock/clock.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/replay/ifx/replay.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/trace/ifx/trace.h"
+#include "bs2go/trace/trace.h"
+
+#include "test.h"
+
+/**
+ * \brief Number of signatures generated in recorded session
+ */
+#define SESSION_SIGNATURES 20
+
+/**
+ * \brief Signature whose hash is altered to provoke a mismatch
+ */
+#define SESSION_ALTERED_SIGNATURE 10
+
+/**
+ * \brief Memory sink for dumped trace
+ */
+typedef struct TraceSink
+{
+	uint8_t data[1 << 20]; /**< Dumped trace */
+	size_t len;            /**< Number of bytes in   data */
+	size_t writes;         /**< Number of chunks written */
+} TraceSink;
+
+/**
+ * \brief \ref trace_writefunction_t appending to \ref TraceSink
+ */
+static int
+trace_sink_write (void *context, const uint8_t *data, size_t data_len)
+{
+	TraceSink *sink = (TraceSink *)context;
+	if (data_len > (sizeof (sink->data) - sink->len))
+	{
+		return -1;
+	}
+	memcpy (sink->data + sink->len, data, data_len);
+	sink->len += data_len;
+	sink->writes++;
+	return 0;
+}
+
+/**
+ * \brief Runs session on activated stack
+ *
+ * \param protocol Activated T=1' stack
+ * \param altered Value of first hash byte of \ref SESSION_ALTERED_SIGNATURE
+ * \param checksum Checksum over all responses
+ * \return int   0 if whole session succeeded, status of failing command
+ * otherwise
+ */
+static int
+session_run (Protocol *protocol, uint8_t altered, uint32_t *checksum)
+{
+	*checksum = 0;
+	uint8_t id[BLOCK2GO_ID_LEN];
+	char *version = NULL;
+	int status = block2go_select (protocol, id, &version);
+	if (status != SUCCESS)
+	{
+		return status;
+	}
+	allocator_free (protocol_get_transaction_allocator (protocol), version);
+
+	uint8_t slot;
+	status = block2go_generate_key_permanent (protocol,
+			BLOCK2GO_CURVE_NIST_P256, &slot);
+	if (status != SUCCESS)
+	{
+		return status;
+	}
+
+	uint8_t hash[32] = { 0 };
+	for (int i = 0; i < SESSION_SIGNATURES; i++)
+	{
+		hash[0] = (i == SESSION_ALTERED_SIGNATURE) ? altered : 0;
+		hash[1] = (uint8_t)i;
+		uint32_t global_counter;
+		uint32_t counter;
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN];
+		size_t signature_len;
+		status = block2go_generate_signature_permanent_into (protocol, slot,
+				hash, &global_counter, &counter, signature, &signature_len);
+		if (status != SUCCESS)
+		{
+			return status;
+		}
+		for (size_t j = 0; j < signature_len; j++)
+		{
+			*checksum = *checksum * 31 + signature[j];
+		}
+	}
+
+	uint8_t random[100];
+	status = block2go_get_random_into (protocol, sizeof (random), random);
+	if (status != SUCCESS)
+	{
+		return status;
+	}
+	for (size_t j = 0; j < sizeof (random); j++)
+	{
+		*checksum = *checksum * 31 + random[j];
+	}
+	return SUCCESS;
+}
+
+/**
+ * \brief Activates T=1' stack on top of given driver with virtual clock
+ */
+static void
+session_open (Protocol *protocol, Protocol *driver, ClockVirtual *clock)
+{
+	uint8_t *response = NULL;
+	size_t response_len;
+	TEST_CHECK_SUCCESS (t1prime_initialize (protocol, driver));
+	protocol_set_clock (protocol, clock_virtual_initialize (clock, 0));
+	TEST_CHECK_SUCCESS (protocol_activate (protocol, &response, &response_len));
+	free (response);
+}
+
+/**
+ * \brief Records session against simulated secure element into   sink
+ *
+ * \return uint64_t   Simulated duration of session in [us]
+ */
+static uint64_t
+record (TraceSink *sink, uint32_t *checksum)
+{
+	static uint8_t memory[1 << 20];
+	TraceBuffer trace;
+	trace_buffer_initialize (&trace, memory, sizeof (memory));
+
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.ifsc = 64;
+
+	Protocol driver;
+	Protocol tracer;
+	Protocol protocol;
+	ClockVirtual clock;
+	TEST_CHECK_SUCCESS (sim_se_initialize_config (&driver, &config));
+	TEST_CHECK_SUCCESS (trace_initialize (&tracer, &driver, &trace));
+	session_open (&protocol, &tracer, &clock);
+	TEST_CHECK_SUCCESS (session_run (&protocol, 0, checksum));
+	TEST_CHECK (trace.overwritten == 0);
+
+	sink->len = 0;
+	sink->writes = 0;
+	TEST_CHECK_SUCCESS (trace_dump (&trace, trace_sink_write, sink));
+	printf ("record: %zu events, %zu bytes, simulated %.3f ms\n", trace.events,
+			sink->len, (double)clock.now / 1000.0);
+	protocol_destroy (&protocol);
+	return clock.now;
+}
+
+/**
+ * \brief Replays recorded session
+ *
+ * \param sink Recorded trace
+ * \param time_scale \ref ReplayConfig::time_scale
+ * \param coalesced Whether T=1' reads header and body of frames at once
+ * \param altered Value of first hash byte of \ref SESSION_ALTERED_SIGNATURE
+ * \param checksum Checksum over all responses
+ * \param statistics Statistics of replay driver at end of session
+ * \return uint64_t   Simulated duration of session in [us]
+ */
+static uint64_t
+replay (const TraceSink *sink, uint32_t time_scale, bool coalesced,
+		uint8_t altered, uint32_t *checksum, ReplayStatistics *statistics)
+{
+	ReplayConfig config;
+	replay_get_default_config (&config);
+	config.time_scale = time_scale;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	TEST_CHECK_SUCCESS (replay_initialize (&driver, sink->data, sink->len,
+			&config));
+	session_open (&protocol, &driver, &clock);
+	TEST_CHECK_SUCCESS (t1prime_set_coalesced_read (&protocol, coalesced));
+	int status = session_run (&protocol, altered, checksum);
+	if (altered == 0)
+	{
+		TEST_CHECK_SUCCESS (status);
+	}
+	else
+	{
+		TEST_CHECK (status != SUCCESS);
+	}
+	TEST_CHECK_SUCCESS (replay_get_statistics (&protocol, statistics));
+	printf ("replay (scale %u, %s): %zu transmits, %zu NACKs, %zu mismatches, "
+			"simulated %.3f ms\n",
+			time_scale, coalesced ? "coalesced" : "split", statistics->transmits,
+			statistics->nacks, statistics->mismatches,
+			(double)clock.now / 1000.0);
+	protocol_destroy (&protocol);
+	return clock.now;
+}
+
+/**
+ * \brief Decodes all events of dumped trace
+ *
+ * \param sink Dumped trace
+ * \param events Buffer to store events in
+ * \param max_events Number of events fitting into   events
+ * \return size_t   Number of decoded events
+ */
+static size_t
+trace_decode_all (const TraceSink *sink, TraceEvent *events,
+		size_t max_events)
+{
+	size_t count = 0;
+	size_t offset = 0;
+	TraceEvent event;
+	int status;
+	while ((status = trace_event_decode (sink->data, sink->len, &offset,
+			&event)) == TRACE_EVENT_DECODE_SUCCESS)
+	{
+		if (count < max_events)
+		{
+			events[count] = event;
+		}
+		count++;
+	}
+
+	/* Walk ends exactly at end of dump */
+	TEST_CHECK (status
+			== (int)IFX_ERROR (LIBTRACE, TRACE_EVENT_DECODE, TRACE_END_OF_TRACE));
+	TEST_CHECK (offset == sink->len);
+	return count;
+}
+
+/**
+ * \brief Checks that events are equal (data compared by content)
+ */
+static bool
+trace_event_equal (const TraceEvent *a, const TraceEvent *b)
+{
+	return (a->type == b->type) && (a->timestamp == b->timestamp)
+			&& (a->length == b->length) && (a->data_len == b->data_len)
+			&& ((a->data_len == 0)
+					|| (memcmp (a->data, b->data, a->data_len) == 0));
+}
+
+/**
+ * \brief Records same session into a ring buffer too small to hold it
+ *
+ * \details Only the newest events must be kept, in order and unchanged
+ * compared to the complete recording.
+ *
+ * \param full Complete recording of session
+ */
+static void
+ring_run (const TraceSink *full)
+{
+	static uint8_t memory[300];
+	TraceBuffer trace;
+	trace_buffer_initialize (&trace, memory, sizeof (memory));
+
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.ifsc = 64;
+
+	Protocol driver;
+	Protocol tracer;
+	Protocol protocol;
+	ClockVirtual clock;
+	uint32_t checksum;
+	TEST_CHECK_SUCCESS (sim_se_initialize_config (&driver, &config));
+	TEST_CHECK_SUCCESS (trace_initialize (&tracer, &driver, &trace));
+	session_open (&protocol, &tracer, &clock);
+	TEST_CHECK_SUCCESS (session_run (&protocol, 0, &checksum));
+	TEST_CHECK (trace.overwritten > 0);
+	TEST_CHECK (trace.used <= sizeof (memory));
+
+	static TraceSink sink;
+	sink.len = 0;
+	sink.writes = 0;
+	TEST_CHECK_SUCCESS (trace_dump (&trace, trace_sink_write, &sink));
+	TEST_CHECK (sink.len == TRACE_HEADER_LENGTH + trace.used);
+	uint32_t overwritten = ((uint32_t)sink.data[6] << 24)
+			| ((uint32_t)sink.data[7] << 16) | ((uint32_t)sink.data[8] << 8)
+			| sink.data[9];
+	TEST_CHECK (overwritten == trace.overwritten);
+
+	static TraceEvent events[64];
+	static TraceEvent full_events[1024];
+	size_t count = trace_decode_all (&sink, events, 64);
+	size_t full_count = trace_decode_all (full, full_events, 1024);
+	TEST_CHECK (count == trace.events);
+	TEST_CHECK (count <= 64);
+	TEST_CHECK (full_count <= 1024);
+	TEST_CHECK ((count + trace.overwritten) == full_count);
+	for (size_t i = 0; (i < count) && (i < 64) && (count <= full_count); i++)
+	{
+		TEST_CHECK (trace_event_equal (&events[i],
+				&full_events[full_count - count + i]));
+	}
+	printf ("ring (%zu bytes): %zu events kept, %zu overwritten\n",
+			sizeof (memory), trace.events, trace.overwritten);
+	protocol_destroy (&protocol);
+}
+
+/**
+ * \brief Checks wrap around, dropping and dumping of a tiny ring buffer
+ *
+ * \details 37 bytes hold a transmit of 10 bytes (17 bytes) and a poll
+ * (7 bytes). A following receive of 10 bytes drops the transmit and wraps,
+ * so the dump is written in two chunks.
+ */
+static void
+ring_wrap_run (void)
+{
+	uint8_t memory[37];
+	TraceBuffer trace;
+	trace_buffer_initialize (&trace, memory, sizeof (memory));
+
+	uint8_t transmitted[10] = { 0x5a, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+			0x06, 0x07, 0x08 };
+	uint8_t received[10] = { 0xa5, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,
+			0x17, 0x18 };
+	trace_record (&trace, TRACE_EVENT_TRANSMIT, 1000, sizeof (transmitted),
+			transmitted, sizeof (transmitted));
+	trace_record (&trace, TRACE_EVENT_POLL, 1100, 3, NULL, 0);
+	TEST_CHECK (trace.events == 2);
+	TEST_CHECK (trace.overwritten == 0);
+	trace_record (&trace, TRACE_EVENT_RECEIVE, 1250, sizeof (received),
+			received, sizeof (received));
+	TEST_CHECK (trace.events == 2);
+	TEST_CHECK (trace.overwritten == 1);
+	TEST_CHECK (trace.head < trace.tail);
+
+	/* Event larger than whole buffer is lost without touching others */
+	uint8_t large[40] = { 0 };
+	trace_record (&trace, TRACE_EVENT_RECEIVE, 1300, sizeof (large), large,
+			sizeof (large));
+	TEST_CHECK (trace.events == 2);
+	TEST_CHECK (trace.overwritten == 2);
+
+	static TraceSink sink;
+	sink.len = 0;
+	sink.writes = 0;
+	TEST_CHECK_SUCCESS (trace_dump (&trace, trace_sink_write, &sink));
+	TEST_CHECK (sink.writes == 3);
+	TEST_CHECK (sink.len == TRACE_HEADER_LENGTH + 7 + 17);
+
+	TraceEvent events[2];
+	TEST_CHECK (trace_decode_all (&sink, events, 2) == 2);
+	TEST_CHECK (events[0].type == TRACE_EVENT_POLL);
+	TEST_CHECK (events[0].timestamp == 100);
+	TEST_CHECK (events[0].length == 3);
+	TEST_CHECK (events[0].data_len == 0);
+	TEST_CHECK (events[1].type == TRACE_EVENT_RECEIVE);
+	TEST_CHECK (events[1].timestamp == 250);
+	TEST_CHECK ((events[1].data_len == sizeof (received))
+			&& (memcmp (events[1].data, received, sizeof (received)) == 0));
+}
+
+int
+main (void)
+{
+	static TraceSink sink;
+	uint32_t recorded;
+	uint64_t recorded_time = record (&sink, &recorded);
+	ring_run (&sink);
+	ring_wrap_run ();
+
+	/* Scale 0 answers immediately, so only link overhead remains */
+	static const uint32_t time_scales[] = { 0, 500, 1000, 2000 };
+	uint64_t previous = 0;
+	for (size_t i = 0; i < sizeof (time_scales) / sizeof (time_scales[0]); i++)
+	{
+		uint32_t replayed;
+		ReplayStatistics statistics;
+		uint64_t replayed_time = replay (&sink, time_scales[i], false, 0,
+				&replayed, &statistics);
+		TEST_CHECK (replayed == recorded);
+		TEST_CHECK (statistics.mismatches == 0);
+		TEST_CHECK (statistics.finished);
+		TEST_CHECK (replayed_time > previous);
+		previous = replayed_time;
+		if (time_scales[i] == 1000)
+		{
+			/* Unscaled replay takes about as long as the recording */
+			TEST_CHECK (replayed_time > recorded_time * 9 / 10);
+			TEST_CHECK (replayed_time < recorded_time * 11 / 10);
+		}
+	}
+
+	/* Different read pattern of the host must not matter */
+	uint32_t replayed;
+	ReplayStatistics statistics;
+	replay (&sink, 1000, true, 0, &replayed, &statistics);
+	TEST_CHECK (replayed == recorded);
+	TEST_CHECK (statistics.mismatches == 0);
+	TEST_CHECK (statistics.finished);
+
+	/* Diverging host is detected */
+	replay (&sink, 1000, false, 0x5a, &replayed, &statistics);
+	TEST_CHECK (statistics.mismatches > 0);
+	TEST_CHECK (!statistics.finished);
+
+	return test_result ("test_replay");
+}
@@ -0,0 +1,236 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_se_pool.c
+ * \brief Signing throughput of pools of simulated secure elements
+ *
+ * \details Runs the same batch of signatures on pools of 1, 2, 4 and 8
+ * simulated secure elements sharing one virtual clock, and checks key
+ * affinity handling.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/clock/clock.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "se_pool.h"
+
+#include "test.h"
+
+/**
+ * \brief Number of signatures per scaling run
+ */
+#define POOL_SIGNATURES 200
+
+/**
+ * \brief Key generated first on every secure element
+ */
+#define POOL_KEY 1
+
+static Protocol drivers[SE_POOL_MAX_MEMBERS];
+static Protocol protocols[SE_POOL_MAX_MEMBERS];
+static SEPoolRequest requests[POOL_SIGNATURES];
+
+/**
+ * \brief Activates simulated secure elements and generates \ref POOL_KEY
+ *
+ * \param count Number of secure elements
+ * \param distinct Whether secure elements use different seeds (and thus
+ * hold different keys)
+ * \param clock Clock shared by all secure elements
+ */
+static void
+members_open (size_t count, bool distinct, const Clock *clock)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		SimSEConfig config;
+		sim_se_get_default_config (&config);
+		config.seed = distinct ? (i + 1) : 1;
+		TEST_CHECK_SUCCESS (sim_se_initialize_config (&drivers[i], &config));
+		TEST_CHECK_SUCCESS (t1prime_initialize (&protocols[i], &drivers[i]));
+		protocol_set_clock (&protocols[i], clock);
+
+		uint8_t *response = NULL;
+		size_t response_len;
+		TEST_CHECK_SUCCESS (protocol_activate (&protocols[i], &response,
+				&response_len));
+		free (response);
+
+		uint8_t slot;
+		TEST_CHECK_SUCCESS (block2go_generate_key_permanent (&protocols[i],
+				BLOCK2GO_CURVE_SEC_P256K1, &slot));
+		TEST_CHECK (slot == POOL_KEY);
+	}
+}
+
+/**
+ * \brief Destroys stacks opened by \ref members_open
+ */
+static void
+members_close (size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		protocol_destroy (&protocols[i]);
+	}
+}
+
+/**
+ * \brief Signs \ref POOL_SIGNATURES hashes on pool of identical members
+ *
+ * \param count Number of secure elements in pool
+ * \return uint64_t   Simulated duration of batch in [us]
+ */
+static uint64_t
+scaling_run (size_t count)
+{
+	ClockVirtual clock;
+	members_open (count, false, clock_virtual_initialize (&clock, 0));
+
+	SEPool pool;
+	se_pool_initialize (&pool);
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t member;
+		TEST_CHECK_SUCCESS (se_pool_add (&pool, &protocols[i], &member));
+		TEST_CHECK (member == i);
+	}
+	/* All members derive the same key from the same seed */
+	TEST_CHECK_SUCCESS (se_pool_set_key_affinity (&pool, POOL_KEY,
+			SE_POOL_ANY_MEMBER));
+
+	uint8_t hash[32] = { 0 };
+	for (size_t i = 0; i < POOL_SIGNATURES; i++)
+	{
+		hash[0] = (uint8_t)i;
+		TEST_CHECK_SUCCESS (se_pool_sign (&pool, &requests[i], POOL_KEY, hash));
+	}
+
+	uint64_t start = clock.now;
+	TEST_CHECK_SUCCESS (se_pool_run (&pool));
+	uint64_t duration = clock.now - start;
+
+	size_t used[SE_POOL_MAX_MEMBERS] = { 0 };
+	for (size_t i = 0; i < POOL_SIGNATURES; i++)
+	{
+		TEST_CHECK_SUCCESS (requests[i].status);
+		TEST_CHECK (requests[i].member < count);
+		used[requests[i].member]++;
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		TEST_CHECK (used[i] > 0);
+	}
+
+	printf ("%zu members: %d signatures, simulated %.1f ms (%.2f ms per "
+			"signature)\n",
+			count, POOL_SIGNATURES, (double)duration / 1000.0,
+			(double)duration / 1000.0 / POOL_SIGNATURES);
+	members_close (count);
+	return duration;
+}
+
+/**
+ * \brief Checks that pinned keys are only used on their member and keys
+ * without affinity are rejected
+ */
+static void
+affinity_run (void)
+{
+	static const size_t count = 4;
+	static const uint8_t pinned = 2;
+	ClockVirtual clock;
+	members_open (count, true, clock_virtual_initialize (&clock, 0));
+
+	SEPool pool;
+	se_pool_initialize (&pool);
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t member;
+		TEST_CHECK_SUCCESS (se_pool_add (&pool, &protocols[i], &member));
+	}
+
+	uint8_t hash[32] = { 0x42 };
+	TEST_CHECK (se_pool_sign (&pool, &requests[0], POOL_KEY, hash)
+			== (int)IFX_ERROR (LIBSEPOOL, SE_POOL_SIGN, SE_POOL_KEY_UNASSIGNED));
+	TEST_CHECK (se_pool_set_key_affinity (&pool, POOL_KEY, (uint8_t)count)
+			== (int)IFX_ERROR (LIBSEPOOL, SE_POOL_SET_KEY_AFFINITY,
+					ILLEGAL_ARGUMENT));
+
+	TEST_CHECK_SUCCESS (se_pool_set_key_affinity (&pool, POOL_KEY, pinned));
+	for (size_t i = 0; i < 8; i++)
+	{
+		hash[1] = (uint8_t)i;
+		TEST_CHECK_SUCCESS (se_pool_sign (&pool, &requests[i], POOL_KEY, hash));
+	}
+	TEST_CHECK_SUCCESS (se_pool_run (&pool));
+
+	/* Signatures must verify against the key of the pinned member */
+	block2go_curve curve;
+	uint32_t global_counter;
+	uint32_t counter;
+	uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN];
+	TEST_CHECK_SUCCESS (block2go_get_key_info_permanent_into (
+			&protocols[pinned], POOL_KEY, &curve, &global_counter, &counter,
+			public_key));
+	for (size_t i = 0; i < 8; i++)
+	{
+		hash[1] = (uint8_t)i;
+		TEST_CHECK_SUCCESS (requests[i].status);
+		TEST_CHECK (requests[i].member == pinned);
+		TEST_CHECK_SUCCESS (block2go_verify_signature (&protocols[pinned], curve,
+				hash, sizeof (hash), requests[i].signature, public_key));
+	}
+
+	/* Revoking the affinity rejects the key again */
+	TEST_CHECK_SUCCESS (se_pool_set_key_affinity (&pool, POOL_KEY,
+			SE_POOL_NO_MEMBER));
+	TEST_CHECK (se_pool_sign (&pool, &requests[0], POOL_KEY, hash) != SUCCESS);
+	members_close (count);
+}
+
+int
+main (void)
+{
+	uint64_t previous = 0;
+	for (size_t count = 1; count <= SE_POOL_MAX_MEMBERS; count *= 2)
+	{
+		uint64_t duration = scaling_run (count);
+		if (previous != 0)
+		{
+			/* Doubling the pool must save at least a third of the time */
+			TEST_CHECK (duration * 3 < previous * 2);
+		}
+		previous = duration;
+	}
+	affinity_run ();
+	return test_result ("test_se_pool");
+}
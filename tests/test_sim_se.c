@@ -0,0 +1,557 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Infineon Technologies AG
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+
+/**
+ * \file test_sim_se.c
+ * \brief End-to-end session of the protocol stack against the simulated
+ * secure element
+ *
+ * \details Runs the Blocksec2Go command set through T=1' and the simulated
+ * secure element on a virtual clock for different link configurations.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "bs2go/blocksec2go/blocksec2go.h"
+#include "bs2go/clock/clock.h"
+#include "bs2go/i2c/i2c.h"
+#include "bs2go/protocol/protocol.h"
+#include "bs2go/sim-se/ifx/sim-se.h"
+#include "bs2go/sim-se/sim-se.h"
+#include "bs2go/t1prime/ifx/t1prime.h"
+#include "bs2go/t1prime/t1prime.h"
+
+#include "test.h"
+
+/**
+ * \brief Opens activated T=1' stack on simulated secure element
+ */
+static void
+session_open (Protocol *protocol, Protocol *driver, const SimSEConfig *config,
+		ClockVirtual *clock)
+{
+	uint8_t *response = NULL;
+	size_t response_len;
+	TEST_CHECK_SUCCESS (sim_se_initialize_config (driver, config));
+	TEST_CHECK_SUCCESS (t1prime_initialize (protocol, driver));
+	protocol_set_clock (protocol, clock_virtual_initialize (clock, 0));
+	TEST_CHECK_SUCCESS (protocol_activate (protocol, &response, &response_len));
+	free (response);
+}
+
+/**
+ * \brief Generates keys, signs and verifies on both curves
+ */
+static void
+session_sign (Protocol *protocol)
+{
+	for (int curve = BLOCK2GO_CURVE_SEC_P256K1; curve <= BLOCK2GO_CURVE_NIST_P256;
+			curve++)
+	{
+		uint8_t slot;
+		block2go_curve key_curve;
+		uint32_t global_counter;
+		uint32_t counter;
+		uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN];
+		TEST_CHECK_SUCCESS (
+				block2go_generate_key_permanent (protocol, curve, &slot));
+		TEST_CHECK_SUCCESS (block2go_get_key_info_permanent_into (protocol, slot,
+				&key_curve, &global_counter, &counter, public_key));
+		TEST_CHECK (key_curve == (block2go_curve)curve);
+		TEST_CHECK (public_key[0] == 0x04);
+
+		uint8_t hash[32];
+		for (size_t i = 0; i < sizeof (hash); i++)
+		{
+			hash[i] = (uint8_t)(i * 7 + curve);
+		}
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN];
+		size_t signature_len;
+		uint32_t global_after;
+		uint32_t counter_after;
+		TEST_CHECK_SUCCESS (block2go_generate_signature_permanent_into (
+				protocol, slot, hash, &global_after, &counter_after, signature,
+				&signature_len));
+		TEST_CHECK (global_after == global_counter - 1);
+		TEST_CHECK (counter_after == counter - 1);
+		TEST_CHECK_SUCCESS (block2go_verify_signature (protocol, curve, hash,
+				sizeof (hash), signature, public_key));
+
+		/* Tampered signature must be rejected */
+		signature[signature_len - 1] ^= 0x01;
+		TEST_CHECK (block2go_verify_signature (protocol, curve, hash,
+				sizeof (hash), signature, public_key) != SUCCESS);
+
+		/* Session key */
+		TEST_CHECK_SUCCESS (block2go_generate_key_session (protocol, curve));
+		TEST_CHECK_SUCCESS (block2go_get_key_info_session_into (protocol,
+				&key_curve, &global_counter, &counter, public_key));
+		TEST_CHECK_SUCCESS (block2go_generate_signature_session_into (protocol,
+				hash, &global_after, &counter_after, signature, &signature_len));
+		TEST_CHECK_SUCCESS (block2go_verify_signature (protocol, curve, hash,
+				sizeof (hash), signature, public_key));
+
+		/* Allocating variant */
+		uint8_t *allocated = NULL;
+		size_t allocated_len;
+		TEST_CHECK_SUCCESS (block2go_generate_signature_permanent (protocol,
+				slot, hash, &global_after, &counter_after, &allocated,
+				&allocated_len));
+		TEST_CHECK (allocated != NULL);
+		allocator_free (protocol_get_transaction_allocator (protocol), allocated);
+	}
+
+	/* Unknown key */
+	block2go_curve key_curve;
+	uint32_t global_counter;
+	uint32_t counter;
+	uint8_t public_key[BLOCK2GO_PUBLIC_KEY_LEN];
+	TEST_CHECK (block2go_get_key_info_permanent_into (protocol, 9, &key_curve,
+			&global_counter, &counter, public_key) != SUCCESS);
+}
+
+/**
+ * \brief Exercises random numbers, key labels (chained APDUs) and modes
+ */
+static void
+session_misc (Protocol *protocol)
+{
+	uint8_t random[200];
+	TEST_CHECK_SUCCESS (block2go_get_random_into (protocol, sizeof (random),
+			random));
+
+	uint8_t label[700];
+	for (size_t i = 0; i < sizeof (label); i++)
+	{
+		label[i] = (uint8_t)(i * 3);
+	}
+	uint32_t memory;
+	uint8_t read_back[800];
+	uint16_t read_back_len = 0;
+	TEST_CHECK_SUCCESS (block2go_create_key_label (protocol, 1, sizeof (label),
+			&memory));
+	TEST_CHECK_SUCCESS (block2go_update_key_label (protocol, 1, label,
+			sizeof (label)));
+	TEST_CHECK_SUCCESS (block2go_get_key_label_into (protocol, 1, read_back,
+			sizeof (read_back), &read_back_len));
+	TEST_CHECK (read_back_len == sizeof (label));
+	TEST_CHECK (memcmp (read_back, label, sizeof (label)) == 0);
+
+	block2go_session_type session_type;
+	TEST_CHECK_SUCCESS (block2go_get_status (protocol, &session_type));
+	TEST_CHECK (session_type == BLOCK2GO_SESSION_TYPE_UNPROTECTED);
+	TEST_CHECK_SUCCESS (block2go_enable_protected_mode (protocol));
+	TEST_CHECK_SUCCESS (block2go_get_status (protocol, &session_type));
+	TEST_CHECK (session_type == BLOCK2GO_SESSION_TYPE_PROTECTED);
+}
+
+/**
+ * \brief Runs full session with given secure element configuration
+ */
+static void
+session_run (const char *name, const SimSEConfig *config)
+{
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	session_open (&protocol, &driver, config, &clock);
+
+	uint8_t id[BLOCK2GO_ID_LEN];
+	char *version = NULL;
+	TEST_CHECK_SUCCESS (block2go_select (&protocol, id, &version));
+	TEST_CHECK (version != NULL);
+	allocator_free (protocol_get_transaction_allocator (&protocol), version);
+	session_sign (&protocol);
+	session_misc (&protocol);
+
+	/* Re-activation after APDUs sent as precompiled frames */
+	uint8_t *response = NULL;
+	size_t response_len;
+	TEST_CHECK_SUCCESS (protocol_activate (&protocol, &response, &response_len));
+	free (response);
+	TEST_CHECK_SUCCESS (block2go_select (&protocol, id, &version));
+	allocator_free (protocol_get_transaction_allocator (&protocol), version);
+
+	SimSEStatistics statistics;
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &statistics));
+	TEST_CHECK (statistics.crc_errors == 0);
+	TEST_CHECK (statistics.signatures == 6);
+
+	/* Every S(WTX request) reaches the host, needed if signing exceeds BWT */
+	T1PrimeStatistics link_statistics;
+	TEST_CHECK_SUCCESS (t1prime_get_statistics (&protocol, &link_statistics));
+	TEST_CHECK (link_statistics.wtx_requests == statistics.wtx_requests);
+	if (config->generate_signature_time > config->bwt * 1000u)
+	{
+		TEST_CHECK (link_statistics.wtx_requests >= statistics.signatures);
+	}
+	printf ("%s: %zu APDUs, %zu frames, %zu NACKs, %zu WTX, simulated %.3f ms\n",
+			name, statistics.apdus, statistics.frames_received, statistics.nacks,
+			statistics.wtx_requests, (double)clock.now / 1000.0);
+	protocol_destroy (&protocol);
+}
+
+/**
+ * \brief Checks IFSD negotiated during activation
+ *
+ * \param max_ifsd Largest IFSD acknowledged by secure element (0 to refuse)
+ * \param expected IFSD expected to be used by the host
+ * \return size_t   Number of blocks received for a 257 byte response
+ */
+static size_t
+ifsd_run (uint16_t max_ifsd, size_t expected)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.max_ifsd = max_ifsd;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	session_open (&protocol, &driver, &config, &clock);
+
+	T1PrimeProtocolState *protocol_state;
+	TEST_CHECK_SUCCESS (t1prime_get_protocol_state (&protocol,
+			&protocol_state));
+	TEST_CHECK (protocol_state->ifsd == expected);
+
+	/* Response chaining still works with the negotiated IFSD */
+	uint8_t random[255];
+	TEST_CHECK_SUCCESS (t1prime_reset_statistics (&protocol));
+	TEST_CHECK_SUCCESS (block2go_get_random_into (&protocol, sizeof (random),
+			random));
+	T1PrimeStatistics statistics;
+	TEST_CHECK_SUCCESS (t1prime_get_statistics (&protocol, &statistics));
+	TEST_CHECK (statistics.blocks_received
+			== (sizeof (random) + 2 + expected - 1) / expected);
+	protocol_destroy (&protocol);
+	return statistics.blocks_received;
+}
+
+/**
+ * \brief Checks that blocks with LEN above IFSD are rejected without
+ * growing the receive buffer
+ */
+static void
+oversized_run (void)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.max_ifsd = 0;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	session_open (&protocol, &driver, &config, &clock);
+
+	/* Host expects less than secure element will send */
+	T1PrimeProtocolState *protocol_state;
+	TEST_CHECK_SUCCESS (t1prime_get_protocol_state (&protocol,
+			&protocol_state));
+	size_t rx_frame_size = protocol_state->rx_frame_size;
+	protocol_state->ifsd = 16;
+
+	uint8_t random[100];
+	TEST_CHECK (block2go_get_random_into (&protocol, sizeof (random), random)
+			== (int)IFX_ERROR (LIBT1PRIME, T1PRIME_BLOCK_DECODE, INVALID_BLOCK));
+	TEST_CHECK (protocol_state->rx_frame_size == rx_frame_size);
+
+	/* Stack recovers after re-activation */
+	uint8_t *response = NULL;
+	size_t response_len;
+	TEST_CHECK_SUCCESS (protocol_activate (&protocol, &response, &response_len));
+	free (response);
+	TEST_CHECK_SUCCESS (block2go_get_random_into (&protocol, sizeof (random),
+			random));
+	TEST_CHECK (protocol_state->rx_frame_size == rx_frame_size);
+	protocol_destroy (&protocol);
+}
+
+/**
+ * \brief Checks waiting time extensions requested for GENERATE SIGNATURE
+ *
+ * \details The response must arrive shortly after the modelled processing
+ * time, not after the granted extension.
+ */
+static void
+wtx_run (void)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.bwt = 40;
+	config.generate_signature_time = 45000;
+	config.bus_timing = false;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	session_open (&protocol, &driver, &config, &clock);
+	uint8_t slot;
+	TEST_CHECK_SUCCESS (block2go_generate_key_permanent (&protocol,
+			BLOCK2GO_CURVE_NIST_P256, &slot));
+	TEST_CHECK_SUCCESS (t1prime_reset_statistics (&protocol));
+	SimSEStatistics se_statistics;
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &se_statistics));
+	size_t se_wtx_requests = se_statistics.wtx_requests;
+
+	static const int signatures = 5;
+	uint64_t longest = 0;
+	for (int i = 0; i < signatures; i++)
+	{
+		uint8_t hash[32] = { (uint8_t)i };
+		uint32_t global_counter;
+		uint32_t counter;
+		uint8_t signature[BLOCK2GO_SIGNATURE_MAX_LEN];
+		size_t signature_len;
+		uint64_t start = clock.now;
+		TEST_CHECK_SUCCESS (block2go_generate_signature_permanent_into (
+				&protocol, slot, hash, &global_counter, &counter, signature,
+				&signature_len));
+		uint64_t duration = clock.now - start;
+		TEST_CHECK (duration >= config.generate_signature_time);
+		longest = duration > longest ? duration : longest;
+	}
+
+	/* Each signature needs one extension of ceil(processing time / BWT) */
+	uint32_t bwt = config.bwt * 1000u;
+	uint32_t multiplier = (config.generate_signature_time + bwt - 1) / bwt;
+	T1PrimeStatistics statistics;
+	TEST_CHECK_SUCCESS (t1prime_get_statistics (&protocol, &statistics));
+	TEST_CHECK (statistics.wtx_requests == (size_t)signatures);
+	TEST_CHECK (statistics.wtx_extension
+			== statistics.wtx_requests * multiplier * config.bwt);
+
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &se_statistics));
+	TEST_CHECK ((se_statistics.wtx_requests - se_wtx_requests)
+			== statistics.wtx_requests);
+
+	/* Polling continues during the extension */
+	TEST_CHECK (longest < config.generate_signature_time + 5000);
+	TEST_CHECK (longest < (uint64_t)multiplier * bwt);
+	printf ("wtx: %zu requests, %zu ms granted, slowest signature %.3f ms "
+			"(processing %.3f ms)\n",
+			statistics.wtx_requests, statistics.wtx_extension,
+			(double)longest / 1000.0,
+			(double)config.generate_signature_time / 1000.0);
+	protocol_destroy (&protocol);
+}
+
+/**
+ * \brief Checks number of UPDATE KEY LABEL APDUs for a 1000 byte label
+ *
+ * \details Command data (tag, length, key index and label) is spread evenly
+ * over the fewest short APDUs, rounded up so that each APDU fills whole
+ * blocks of IFSC where that still fits a short APDU.
+ *
+ * \param ifsc Maximum information field size of secure element
+ */
+static void
+label_run (uint16_t ifsc)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	config.ifsc = ifsc;
+	config.bus_timing = false;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	session_open (&protocol, &driver, &config, &clock);
+	uint8_t id[BLOCK2GO_ID_LEN];
+	char version[32];
+	TEST_CHECK_SUCCESS (block2go_select_into (&protocol, id, version,
+			sizeof (version)));
+	uint8_t slot;
+	TEST_CHECK_SUCCESS (block2go_generate_key_permanent (&protocol,
+			BLOCK2GO_CURVE_NIST_P256, &slot));
+	uint8_t label[1000];
+	for (size_t i = 0; i < sizeof (label); i++)
+	{
+		label[i] = (uint8_t)(i * 11);
+	}
+	uint32_t memory;
+	TEST_CHECK_SUCCESS (block2go_create_key_label (&protocol, slot,
+			sizeof (label), &memory));
+
+	/* DF 1F, three byte length, key index */
+	size_t data_len = 2 + 3 + 1 + sizeof (label);
+	size_t count = (data_len + 0xff - 1) / 0xff;
+	size_t chunk_len = (data_len + count - 1) / count;
+	size_t aligned = ((5 + chunk_len + ifsc - 1) / ifsc) * ifsc - 5;
+	chunk_len = aligned <= 0xff ? aligned : chunk_len;
+	size_t expected = (data_len + chunk_len - 1) / chunk_len;
+
+	SimSEStatistics before;
+	SimSEStatistics after;
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &before));
+	TEST_CHECK_SUCCESS (block2go_update_key_label (&protocol, slot, label,
+			sizeof (label)));
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (&protocol, &after));
+	TEST_CHECK ((after.apdus - before.apdus) == expected);
+
+	uint8_t read_back[sizeof (label)];
+	uint16_t read_back_len;
+	TEST_CHECK_SUCCESS (block2go_get_key_label_into (&protocol, slot,
+			read_back, sizeof (read_back), &read_back_len));
+	TEST_CHECK (read_back_len == sizeof (label));
+	TEST_CHECK (memcmp (read_back, label, sizeof (label)) == 0);
+	protocol_destroy (&protocol);
+}
+
+/**
+ * \brief Runs GET RANDOM with injected link errors and checks resulting I2C
+ * clock frequency
+ *
+ * \param protocol Activated protocol stack
+ * \param nacks Number of writes not acknowledged
+ * \param crc_errors Number of frames read with invalid CRC
+ * \param expected Clock frequency expected afterwards in [Hz]
+ */
+static void
+link_errors_run (Protocol *protocol, size_t nacks, size_t crc_errors,
+		uint32_t expected)
+{
+	SimSEStatistics before;
+	SimSEStatistics after;
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (protocol, &before));
+	TEST_CHECK_SUCCESS (sim_se_inject_errors (protocol, nacks, crc_errors));
+	uint8_t random[32];
+	TEST_CHECK_SUCCESS (block2go_get_random_into (protocol, sizeof (random),
+			random));
+	TEST_CHECK_SUCCESS (sim_se_get_statistics (protocol, &after));
+	TEST_CHECK ((after.nacks - before.nacks) >= nacks);
+	TEST_CHECK ((after.retransmissions - before.retransmissions)
+			== crc_errors);
+
+	uint32_t frequency;
+	TEST_CHECK_SUCCESS (i2c_get_clock_frequency (protocol, &frequency));
+	TEST_CHECK (frequency == expected);
+}
+
+/**
+ * \brief Checks I2C clock frequency negotiation and step-down on link errors
+ */
+static void
+link_run (void)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	uint32_t cip_frequency = (uint32_t)config.mcf * 1000u;
+
+	Protocol driver;
+	Protocol protocol;
+	ClockVirtual clock;
+	TEST_CHECK_SUCCESS (sim_se_initialize_config (&driver, &config));
+	TEST_CHECK_SUCCESS (t1prime_initialize (&protocol, &driver));
+	protocol_set_clock (&protocol, clock_virtual_initialize (&clock, 0));
+
+	/* Bus comes up in Standard-mode like after i2c_init() */
+	TEST_CHECK_SUCCESS (i2c_set_clock_frequency (&protocol,
+			T1PRIME_MIN_I2C_CLOCK_FREQUENCY));
+	uint8_t *response = NULL;
+	size_t response_len;
+	TEST_CHECK_SUCCESS (protocol_activate (&protocol, &response, &response_len));
+	free (response);
+	uint32_t frequency;
+	TEST_CHECK_SUCCESS (i2c_get_clock_frequency (&protocol, &frequency));
+	TEST_CHECK (frequency == cip_frequency);
+
+	/* Single errors followed by a valid block do not step down */
+	link_errors_run (&protocol, 1, 0, cip_frequency);
+	link_errors_run (&protocol, 0, 1, cip_frequency);
+
+	/* Consecutive errors step down once per mode, Standard-mode is the floor */
+	link_errors_run (&protocol, 0, T1PRIME_LINK_ERRORS_STEP_DOWN,
+			T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY);
+	link_errors_run (&protocol, T1PRIME_LINK_ERRORS_STEP_DOWN, 0,
+			T1PRIME_MIN_I2C_CLOCK_FREQUENCY);
+	link_errors_run (&protocol, 0, T1PRIME_LINK_ERRORS_STEP_DOWN,
+			T1PRIME_MIN_I2C_CLOCK_FREQUENCY);
+
+	/* Re-activation negotiates CIP frequency again */
+	TEST_CHECK_SUCCESS (protocol_activate (&protocol, &response, &response_len));
+	free (response);
+	TEST_CHECK_SUCCESS (i2c_get_clock_frequency (&protocol, &frequency));
+	TEST_CHECK (frequency == cip_frequency);
+
+	/* Every frequency set on the bus, in order */
+	static const uint32_t expected[] = { T1PRIME_MIN_I2C_CLOCK_FREQUENCY,
+			T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY, SIM_SE_DEFAULT_MCF * 1000u,
+			T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY, T1PRIME_MIN_I2C_CLOCK_FREQUENCY,
+			T1PRIME_DEFAULT_I2C_CLOCK_FREQUENCY, SIM_SE_DEFAULT_MCF * 1000u };
+	SimSEProtocolState *protocol_state;
+	TEST_CHECK_SUCCESS (sim_se_get_protocol_state (&protocol,
+			&protocol_state));
+	TEST_CHECK (protocol_state->clock_frequency_changes
+			== sizeof (expected) / sizeof (expected[0]));
+	for (size_t i = 0; (i < sizeof (expected) / sizeof (expected[0]))
+			&& (i < protocol_state->clock_frequency_changes); i++)
+	{
+		TEST_CHECK (protocol_state->clock_frequency_log[i] == expected[i]);
+	}
+	protocol_destroy (&protocol);
+}
+
+int
+main (void)
+{
+	SimSEConfig config;
+	sim_se_get_default_config (&config);
+	session_run ("default", &config);
+
+	/* Small IFSC and BWT force chaining and WTX */
+	sim_se_get_default_config (&config);
+	config.ifsc = 16;
+	config.bwt = 20;
+	config.seed = 7;
+	session_run ("small", &config);
+
+	/* Bus timing of every transfer */
+	sim_se_get_default_config (&config);
+	config.bus_timing = true;
+	config.ifsc = 64;
+	session_run ("bus", &config);
+
+	/* Secure elements refusing or limiting S(IFS) */
+	ifsd_run (0, T1PRIME_DEFAULT_IFSD);
+	ifsd_run (16, 16);
+	ifsd_run (T1PRIME_MAX_IFS, T1PRIME_DEFAULT_MAX_IFSD);
+
+	/* Larger IFSD saves blocks once responses exceed 254 bytes */
+	size_t chained_blocks = ifsd_run (0xFE, 0xFE);
+	TEST_CHECK (ifsd_run (300, 300) < chained_blocks);
+
+	/* Key label chunks follow IFSC */
+	label_run (16);
+	label_run (130);
+	label_run (SIM_SE_DEFAULT_IFSC);
+
+	oversized_run ();
+	wtx_run ();
+	link_run ();
+
+	return test_result ("test_sim_se");
+}